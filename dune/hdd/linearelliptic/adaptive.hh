@@ -0,0 +1,346 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_ADAPTIVE_HH
+#define DUNE_HDD_LINEARELLIPTIC_ADAPTIVE_HH
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include <boost/numeric/conversion/cast.hpp>
+
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/dynvector.hh>
+
+#include <dune/geometry/referenceelements.hh>
+
+#include <dune/stuff/common/configuration.hh>
+#include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/common/memory.hh>
+#include <dune/stuff/common/ranges.hh>
+#include <dune/stuff/common/timedlogging.hh>
+#include <dune/stuff/grid/provider/interface.hh>
+
+#include <dune/gdt/discretefunction/default.hh>
+
+#include "estimators/swipdg.hh"
+
+namespace Dune {
+namespace HDD {
+namespace LinearElliptic {
+namespace internal {
+
+
+/**
+ * \brief Transfers a piecewise linear (continuous or discontinuous) function to a refined grid.
+ *
+ *        Before the grid is adapted, store() keeps the values of the function at the corners of each entity (identified
+ *        by its local id). After the adaptation, apply() evaluates the stored linear function of the nearest ancestor
+ *        of each new entity at its corners and interpolates these values in the new space. Since the function is
+ *        linear on each old entity, the transfer is exact.
+ * \note  Only implemented for scalar linear spaces on simplices and only for refinement (not for coarsening).
+ */
+template< class GridType, class RangeFieldType >
+class PiecewiseLinearTransfer
+{
+  static const unsigned int dimDomain = GridType::dimension;
+  typedef typename GridType::ctype                              DomainFieldType;
+  typedef typename GridType::LocalIdSet::IdType                 IdType;
+  typedef typename GridType::template Codim< 0 >::Entity        EntityType;
+  typedef typename GridType::template Codim< 0 >::EntityPointer EntityPointerType;
+  typedef FieldVector< DomainFieldType, dimDomain >             DomainType;
+
+public:
+  explicit PiecewiseLinearTransfer(const GridType& grid)
+    : grid_(grid)
+  {}
+
+  template< class SpaceType, class VectorType >
+  void store(const SpaceType& space, const VectorType& vector)
+  {
+    static_assert(SpaceType::dimRange == 1, "Only implemented for scalar spaces!");
+    corner_values_.clear();
+    const GDT::ConstDiscreteFunction< SpaceType, VectorType > function(space, vector);
+    typename SpaceType::BaseFunctionSetType::RangeType value(0.0);
+    for (const auto& entity : Stuff::Common::entityRange(space.grid_view())) {
+      if (!entity.type().isSimplex())
+        DUNE_THROW(NotImplemented, "Only implemented for simplices!");
+      const auto& reference_element = ReferenceElements< DomainFieldType, dimDomain >::general(entity.type());
+      const auto local_function = function.local_function(entity);
+      auto& values = corner_values_[grid_.localIdSet().id(entity)];
+      values.resize(reference_element.size(dimDomain));
+      for (size_t cc = 0; cc < values.size(); ++cc) {
+        local_function->evaluate(reference_element.position(int(cc), dimDomain), value);
+        values[cc] = value[0];
+      }
+    }
+  } // ... store(...)
+
+  template< class SpaceType, class VectorType >
+  void apply(const SpaceType& space, VectorType& vector) const
+  {
+    static_assert(SpaceType::dimRange == 1, "Only implemented for scalar spaces!");
+    if (vector.size() != space.mapper().size())
+      DUNE_THROW(Stuff::Exceptions::shapes_do_not_match,
+                 "vector.size() = " << vector.size() << ", space.mapper().size() = " << space.mapper().size());
+    std::vector< typename SpaceType::BaseFunctionSetType::RangeType > basis_values;
+    for (const auto& entity : Stuff::Common::entityRange(space.grid_view())) {
+      const auto& reference_element = ReferenceElements< DomainFieldType, dimDomain >::general(entity.type());
+      const auto basis = space.base_function_set(entity);
+      const int num_corners = reference_element.size(dimDomain);
+      if (basis.size() != size_t(num_corners))
+        DUNE_THROW(NotImplemented, "Only implemented for linear spaces!");
+      // evaluate the stored function at the corners of this entity
+      DynamicVector< RangeFieldType > values(num_corners, 0.0);
+      for (int cc = 0; cc < num_corners; ++cc)
+        values[cc] = evaluate(entity, reference_element.position(cc, dimDomain));
+      // interpolate (the basis need not be nodal)
+      DynamicMatrix< RangeFieldType > nodal_values(num_corners, num_corners, 0.0);
+      basis_values.resize(basis.size());
+      for (int cc = 0; cc < num_corners; ++cc) {
+        basis.evaluate(reference_element.position(cc, dimDomain), basis_values);
+        for (int ii = 0; ii < num_corners; ++ii)
+          nodal_values[cc][ii] = basis_values[ii][0];
+      }
+      DynamicVector< RangeFieldType > local_dofs(num_corners, 0.0);
+      nodal_values.solve(local_dofs, values);
+      for (int ii = 0; ii < num_corners; ++ii)
+        vector.set_entry(space.mapper().mapToGlobal(entity, ii), local_dofs[ii]);
+    }
+  } // ... apply(...)
+
+private:
+  RangeFieldType evaluate(const EntityType& entity, const DomainType& local_point) const
+  {
+    DomainType xx = local_point;
+    EntityPointerType ancestor(entity);
+    auto search_result = corner_values_.find(grid_.localIdSet().id(*ancestor));
+    while (search_result == corner_values_.end()) {
+      if (!ancestor->hasFather())
+        DUNE_THROW(Stuff::Exceptions::internal_error, "Could not find an ancestor with stored values!");
+      xx = ancestor->geometryInFather().global(xx);
+      ancestor = ancestor->father();
+      search_result = corner_values_.find(grid_.localIdSet().id(*ancestor));
+    }
+    // linear interpolation in barycentric coordinates of the reference simplex
+    const auto& values = search_result->second;
+    RangeFieldType ret = values[0];
+    for (size_t dd = 0; dd < dimDomain; ++dd)
+      ret += xx[dd] * (values[dd + 1] - values[0]);
+    return ret;
+  } // ... evaluate(...)
+
+  const GridType& grid_;
+  std::map< IdType, std::vector< RangeFieldType > > corner_values_;
+}; // class PiecewiseLinearTransfer
+
+
+/**
+ * \brief Doerfler marking: the smallest set of entities with the largest indicators, the sum of which is at least
+ *        marking_fraction of the sum of all indicators.
+ */
+template< class IndicatorsType, class RangeFieldType >
+std::vector< bool > doerfler_marking(const IndicatorsType& indicators, const RangeFieldType& marking_fraction)
+{
+  std::vector< size_t > order(indicators.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](const size_t& ii, const size_t& jj) {
+    return indicators[ii] > indicators[jj];
+  });
+  RangeFieldType total = 0.0;
+  for (size_t ii = 0; ii < indicators.size(); ++ii)
+    total += indicators[ii];
+  std::vector< bool > marked(indicators.size(), false);
+  RangeFieldType sum = 0.0;
+  for (const size_t& ii : order) {
+    if (sum >= marking_fraction * total)
+      break;
+    marked[ii] = true;
+    sum += indicators[ii];
+  }
+  return marked;
+} // ... doerfler_marking(...)
+
+
+} // namespace internal
+
+
+/**
+ * \brief Adaptive loop for the CG and SWIPDG discretizations: solve, compute the local indicators of ESV2007 (see
+ *        Estimators::SWIPDG), mark by the bulk criterion of Doerfler, refine and rebuild the discretization.
+ *
+ *        The solution of the previous step is transferred to the refined grid and used as initial value for the
+ *        solver of the next step (which only pays off for iterative solvers).
+ * \note  The discretization has to live on the leaf of the grid given by the grid provider (i.e., use
+ *        Stuff::Grid::ChooseLayer::leaf) and the grid has to support local refinement, as ALUGrid< 2, 2, simplex,
+ *        conforming > does.
+ */
+template< class DiscretizationImp >
+class AdaptiveDriver
+{
+public:
+  typedef DiscretizationImp                            DiscretizationType;
+  typedef typename DiscretizationType::GridType        GridType;
+  typedef typename DiscretizationType::ProblemType     ProblemType;
+  typedef typename DiscretizationType::AnsatzSpaceType SpaceType;
+  typedef typename DiscretizationType::VectorType      VectorType;
+  typedef typename DiscretizationType::RangeFieldType  RangeFieldType;
+  typedef Stuff::Grid::ProviderInterface< GridType >   GridProviderType;
+
+  typedef Estimators::SWIPDG< SpaceType, VectorType, ProblemType, GridType > EstimatorType;
+
+  struct Step
+  {
+    size_t num_entities;
+    size_t num_dofs;
+    RangeFieldType estimate;
+  }; // struct Step
+
+private:
+  typedef typename EstimatorType::SessionType EstimatorSessionType;
+  static_assert(EstimatorSessionType::available, "The estimators are not available for this grid!");
+
+public:
+  static std::string static_id()
+  {
+    return "hdd.linearelliptic.adaptive";
+  }
+
+  static Stuff::Common::Configuration default_config()
+  {
+    Stuff::Common::Configuration config;
+    config["estimator"] = Estimators::internal::SWIPDG::ESV2007Base::id();
+    config["marking_fraction"] = "0.5";
+    config["max_steps"] = "10";
+    config["max_dofs"] = "1000000";
+    config["tolerance"] = "0";
+    return config;
+  } // ... default_config(...)
+
+  AdaptiveDriver(GridProviderType& grid_provider,
+                 const Stuff::Common::Configuration& boundary_info,
+                 const ProblemType& problem,
+                 const Stuff::Common::Configuration& config = default_config())
+    : grid_provider_(grid_provider)
+    , boundary_info_(boundary_info)
+    , problem_(problem)
+    , estimator_(config.get("estimator", default_config().get< std::string >("estimator")))
+    , marking_fraction_(config.get("marking_fraction", default_config().get< RangeFieldType >("marking_fraction")))
+    , max_steps_(config.get("max_steps", default_config().get< size_t >("max_steps")))
+    , max_dofs_(config.get("max_dofs", default_config().get< size_t >("max_dofs")))
+    , tolerance_(config.get("tolerance", default_config().get< RangeFieldType >("tolerance")))
+    , solver_type_(config.get("solver", std::string()))
+  {
+    if (!(marking_fraction_ > 0.0 && marking_fraction_ <= 1.0))
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                 "marking_fraction has to be in (0, 1], is " << marking_fraction_ << "!");
+    const auto available = EstimatorType::available_local();
+    if (std::find(available.begin(), available.end(), estimator_) == available.end())
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                 "Given estimator '" << estimator_ << "' is not one of EstimatorType::available_local()!");
+  } // AdaptiveDriver(...)
+
+  /**
+   * \brief Runs the adaptive loop until max_steps is reached, the estimate is below tolerance or max_dofs is exceeded,
+   *        returns the number of DoFs and the estimate of each step.
+   */
+  const std::vector< Step >& run()
+  {
+    auto logger = DSC::TimedLogger().get(static_id());
+    auto& grid = grid_provider_.grid();
+    steps_.clear();
+    std::unique_ptr< VectorType > initial_guess;
+    discretization_.reset();
+    for (size_t step = 0; step < max_steps_; ++step) {
+      // (re)build and solve
+      if (!discretization_)
+        discretization_ = Stuff::Common::make_unique< DiscretizationType >(grid_provider_, boundary_info_, problem_);
+      discretization_->init();
+      const auto& space = discretization_->ansatz_space();
+      solution_ = Stuff::Common::make_unique< VectorType >(initial_guess ? *initial_guess
+                                                                         : discretization_->create_vector());
+      discretization_->solve(discretization_->solver_options(solver_type_), *solution_);
+      // estimate (the session shares all local contributions between the estimate and the indicators)
+      RangeFieldType estimate = 0.0;
+      Stuff::LA::CommonDenseVector< RangeFieldType > indicators;
+      {
+        EstimatorSessionType estimator(space, *solution_, problem_);
+        estimate = estimator.estimate(estimator_);
+        indicators = estimator.estimate_local(estimator_);
+      }
+      steps_.push_back({boost::numeric_cast< size_t >(space.grid_view().indexSet().size(0)),
+                        space.mapper().size(),
+                        estimate});
+      logger.info() << "step " << step << ": " << steps_.back().num_dofs << " DoFs (" << steps_.back().num_entities
+                    << " entities), estimate " << estimate << std::endl;
+      if (estimate <= tolerance_ || step + 1 == max_steps_ || steps_.back().num_dofs >= max_dofs_)
+        break;
+      // mark
+      const auto marked = internal::doerfler_marking(indicators, marking_fraction_);
+      size_t num_marked = 0;
+      for (const auto& entity : Stuff::Common::entityRange(space.grid_view()))
+        if (marked[space.grid_view().indexSet().index(entity)]) {
+          grid.mark(1, entity);
+          ++num_marked;
+        }
+      logger.debug() << "  marked " << num_marked << " entities" << std::endl;
+      // refine and transfer the solution
+      internal::PiecewiseLinearTransfer< GridType, RangeFieldType > transfer(grid);
+      transfer.store(space, *solution_);
+      solution_.reset();
+      discretization_.reset();
+      grid.preAdapt();
+      grid.adapt();
+      grid.postAdapt();
+      discretization_ = Stuff::Common::make_unique< DiscretizationType >(grid_provider_, boundary_info_, problem_);
+      initial_guess = Stuff::Common::make_unique< VectorType >(discretization_->ansatz_space().mapper().size());
+      transfer.apply(discretization_->ansatz_space(), *initial_guess);
+    }
+    return steps_;
+  } // ... run(...)
+
+  const std::vector< Step >& steps() const
+  {
+    return steps_;
+  }
+
+  const DiscretizationType& discretization() const
+  {
+    if (!discretization_)
+      DUNE_THROW(Stuff::Exceptions::you_are_using_this_wrong, "There is no discretization, call run() first!");
+    return *discretization_;
+  }
+
+  const VectorType& solution() const
+  {
+    if (!solution_)
+      DUNE_THROW(Stuff::Exceptions::you_are_using_this_wrong, "There is no solution, call run() first!");
+    return *solution_;
+  }
+
+private:
+  GridProviderType& grid_provider_;
+  const Stuff::Common::Configuration boundary_info_;
+  const ProblemType& problem_;
+  const std::string estimator_;
+  const RangeFieldType marking_fraction_;
+  const size_t max_steps_;
+  const size_t max_dofs_;
+  const RangeFieldType tolerance_;
+  const std::string solver_type_;
+  std::unique_ptr< DiscretizationType > discretization_;
+  std::unique_ptr< VectorType > solution_;
+  std::vector< Step > steps_;
+}; // class AdaptiveDriver
+
+
+} // namespace LinearElliptic
+} // namespace HDD
+} // namespace Dune
+
+#endif // DUNE_HDD_LINEARELLIPTIC_ADAPTIVE_HH
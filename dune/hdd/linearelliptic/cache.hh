@@ -0,0 +1,130 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_CACHE_HH
+#define DUNE_HDD_LINEARELLIPTIC_CACHE_HH
+
+#include <functional>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Dune {
+namespace HDD {
+namespace LinearElliptic {
+namespace internal {
+
+
+/**
+ * \brief Keeps values which were computed from a set of objects held by shared_ptrs (e.g. the multiscale grid and the
+ *        data functions of a problem), so that they can be shared by everyone using the same objects.
+ *
+ *        An entry is identified by its dependencies and an optional key (e.g. a parameter). Since only weak references
+ *        to the dependencies are held, an entry is dropped as soon as one of them is destroyed and can thus never be
+ *        confused with data of a new object that happens to live at the same address. At most max_entries entries are
+ *        kept, the least recently used one is dropped first. Values are computed without holding the lock.
+ */
+template< class ValueType >
+class DependentCache
+{
+public:
+  typedef std::vector< std::shared_ptr< const void > > DependenciesType;
+  typedef std::function< std::shared_ptr< const ValueType >() > CreateType;
+
+  explicit DependentCache(const size_t max_entries = std::numeric_limits< size_t >::max())
+    : max_entries_(max_entries)
+  {}
+
+  std::shared_ptr< const ValueType > get(const DependenciesType& dependencies,
+                                         const std::string& key,
+                                         const CreateType& create)
+  {
+    {
+      std::lock_guard< std::mutex > lock(mutex_);
+      if (auto value = find(dependencies, key))
+        return value;
+    }
+    auto value = create();
+    std::lock_guard< std::mutex > lock(mutex_);
+    // another thread might have been faster
+    if (auto existing = find(dependencies, key))
+      return existing;
+    Entry entry;
+    entry.dependencies = std::vector< std::weak_ptr< const void > >(dependencies.begin(), dependencies.end());
+    for (const auto& dependency : dependencies)
+      entry.addresses.push_back(dependency.get());
+    entry.key = key;
+    entry.value = value;
+    entries_.push_back(entry);
+    while (entries_.size() > max_entries_)
+      entries_.pop_front();
+    return value;
+  } // ... get(...)
+
+  std::shared_ptr< const ValueType > get(const DependenciesType& dependencies, const CreateType& create)
+  {
+    return get(dependencies, "", create);
+  }
+
+  size_t size() const
+  {
+    std::lock_guard< std::mutex > lock(mutex_);
+    return entries_.size();
+  }
+
+  void clear()
+  {
+    std::lock_guard< std::mutex > lock(mutex_);
+    entries_.clear();
+  }
+
+private:
+  struct Entry
+  {
+    std::vector< std::weak_ptr< const void > > dependencies;
+    std::vector< const void* > addresses;
+    std::string key;
+    std::shared_ptr< const ValueType > value;
+  }; // struct Entry
+
+  // requires the lock to be held
+  std::shared_ptr< const ValueType > find(const DependenciesType& dependencies, const std::string& key)
+  {
+    for (auto it = entries_.begin(); it != entries_.end();) {
+      bool expired = false;
+      for (const auto& dependency : it->dependencies)
+        expired = expired || dependency.expired();
+      if (expired) {
+        it = entries_.erase(it);
+        continue;
+      }
+      bool equal = it->key == key && it->addresses.size() == dependencies.size();
+      for (size_t ii = 0; equal && ii < dependencies.size(); ++ii)
+        equal = it->addresses[ii] == dependencies[ii].get();
+      if (equal) {
+        // mark as most recently used
+        entries_.splice(entries_.end(), entries_, it);
+        return entries_.back().value;
+      }
+      ++it;
+    }
+    return nullptr;
+  } // ... find(...)
+
+  const size_t max_entries_;
+  mutable std::mutex mutex_;
+  std::list< Entry > entries_;
+}; // class DependentCache
+
+
+} // namespace internal
+} // namespace LinearElliptic
+} // namespace HDD
+} // namespace Dune
+
+#endif // DUNE_HDD_LINEARELLIPTIC_CACHE_HH
@@ -0,0 +1,653 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_DISCRETIZATIONS_AFFINE_DIFFUSION_HH
+#define DUNE_HDD_LINEARELLIPTIC_DISCRETIZATIONS_AFFINE_DIFFUSION_HH
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/fvector.hh>
+
+#include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/grid/walker.hh>
+
+#include <dune/pymor/parameters/base.hh>
+#include <dune/pymor/parameters/functional.hh>
+
+#include <dune/gdt/localevaluation/interface.hh>
+#include <dune/gdt/localevaluation/elliptic.hh>
+#include <dune/gdt/playground/localevaluation/swipdg.hh>
+#include <dune/gdt/localoperator/codim0.hh>
+#include <dune/gdt/localoperator/codim1.hh>
+#include <dune/gdt/localfunctional/codim1.hh>
+#include <dune/gdt/assembler/local/codim0.hh>
+#include <dune/gdt/assembler/local/codim1.hh>
+
+#include <dune/hdd/linearelliptic/problems/interfaces.hh>
+
+namespace Dune {
+namespace HDD {
+namespace LinearElliptic {
+namespace Discretizations {
+namespace internal {
+
+
+/**
+ * \brief The product of two coefficients of affine decompositions (an empty coefficient stands for the affine part).
+ */
+inline std::shared_ptr< const Pymor::ParameterFunctional >
+multiply_coefficients(const std::shared_ptr< const Pymor::ParameterFunctional >& first,
+                      const std::shared_ptr< const Pymor::ParameterFunctional >& second)
+{
+  if (!first)
+    return second;
+  if (!second)
+    return first;
+  Pymor::ParameterType param;
+  for (const auto& key : first->parameter_type().keys())
+    param.set(key, first->parameter_type().get(key));
+  for (const auto& key : second->parameter_type().keys())
+    param.set(key, second->parameter_type().get(key));
+  return std::make_shared< const Pymor::ParameterFunctional >(param,
+                                                              "(" + first->expression() + ")*("
+                                                              + second->expression() + ")");
+} // ... multiply_coefficients(...)
+
+
+// forwards
+template< class DiffusionFactorType, class DiffusionTensorType >
+class FixedWeightsInner;
+
+template< class DiffusionFactorType, class DiffusionTensorType >
+class BoundaryPenalty;
+
+
+template< class DiffusionFactorType, class DiffusionTensorType >
+class FixedWeightsInnerTraits
+{
+public:
+  typedef FixedWeightsInner< DiffusionFactorType, DiffusionTensorType > derived_type;
+  typedef typename DiffusionFactorType::EntityType                      EntityType;
+  typedef typename DiffusionFactorType::DomainFieldType                 DomainFieldType;
+  static const unsigned int                                             dimDomain = DiffusionFactorType::dimDomain;
+  typedef std::tuple< std::shared_ptr< typename DiffusionFactorType::LocalfunctionType >,
+                      std::shared_ptr< typename DiffusionTensorType::LocalfunctionType >,
+                      std::shared_ptr< typename DiffusionTensorType::LocalfunctionType > > LocalfunctionTupleType;
+}; // class FixedWeightsInnerTraits
+
+
+template< class DiffusionFactorType, class DiffusionTensorType >
+class BoundaryPenaltyTraits
+{
+public:
+  typedef BoundaryPenalty< DiffusionFactorType, DiffusionTensorType > derived_type;
+  typedef typename DiffusionFactorType::EntityType                    EntityType;
+  typedef typename DiffusionFactorType::DomainFieldType               DomainFieldType;
+  static const unsigned int                                           dimDomain = DiffusionFactorType::dimDomain;
+  typedef std::tuple< std::shared_ptr< typename DiffusionFactorType::LocalfunctionType >,
+                      std::shared_ptr< typename DiffusionTensorType::LocalfunctionType > > LocalfunctionTupleType;
+}; // class BoundaryPenaltyTraits
+
+
+/**
+ * \brief The SWIPDG coupling of one term \kappa_t A_t of the diffusion (scalar case), where the weights are computed
+ *        from a given reference tensor instead of A_t (see AffineDiffusion).
+ *
+ *        Coincides with GDT::LocalEvaluation::SWIPDG::Inner if A_t is the reference tensor. If penalty_only is set,
+ *        only the penalty term is evaluated.
+ */
+template< class DiffusionFactorType, class DiffusionTensorType >
+class FixedWeightsInner
+  : public GDT::LocalEvaluation::Codim1Interface< FixedWeightsInnerTraits< DiffusionFactorType, DiffusionTensorType >,
+                                                  4 >
+{
+  typedef FixedWeightsInnerTraits< DiffusionFactorType, DiffusionTensorType > Traits;
+public:
+  typedef typename Traits::EntityType             EntityType;
+  typedef typename Traits::DomainFieldType        DomainFieldType;
+  typedef typename Traits::LocalfunctionTupleType LocalfunctionTupleType;
+  static const unsigned int                       dimDomain = Traits::dimDomain;
+
+  FixedWeightsInner(const DiffusionFactorType& diffusion_factor,
+                    const DiffusionTensorType& diffusion_tensor,
+                    const DiffusionTensorType& reference_tensor,
+                    const bool penalty_only = false)
+    : diffusion_factor_(diffusion_factor)
+    , diffusion_tensor_(diffusion_tensor)
+    , reference_tensor_(reference_tensor)
+    , penalty_only_(penalty_only)
+  {}
+
+  LocalfunctionTupleType localFunctions(const EntityType& entity) const
+  {
+    return LocalfunctionTupleType(diffusion_factor_.local_function(entity),
+                                  diffusion_tensor_.local_function(entity),
+                                  reference_tensor_.local_function(entity));
+  }
+
+  template< class TestBaseEntityType, class AnsatzBaseEntityType,
+            class TestBaseNeighborType, class AnsatzBaseNeighborType >
+  size_t order(const LocalfunctionTupleType& local_functions_entity,
+               const LocalfunctionTupleType& local_functions_neighbor,
+               const TestBaseEntityType& test_base_entity,
+               const AnsatzBaseEntityType& ansatz_base_entity,
+               const TestBaseNeighborType& test_base_neighbor,
+               const AnsatzBaseNeighborType& ansatz_base_neighbor) const
+  {
+    return std::max(std::get< 0 >(local_functions_entity)->order() + std::get< 1 >(local_functions_entity)->order(),
+                    std::get< 0 >(local_functions_neighbor)->order()
+                    + std::get< 1 >(local_functions_neighbor)->order())
+        + std::max(test_base_entity.order(), test_base_neighbor.order())
+        + std::max(ansatz_base_entity.order(), ansatz_base_neighbor.order());
+  } // ... order(...)
+
+  template< class TestBaseEntityType, class AnsatzBaseEntityType,
+            class TestBaseNeighborType, class AnsatzBaseNeighborType,
+            class IntersectionType, class R >
+  void evaluate(const LocalfunctionTupleType& local_functions_entity,
+                const LocalfunctionTupleType& local_functions_neighbor,
+                const TestBaseEntityType& test_base_entity,
+                const AnsatzBaseEntityType& ansatz_base_entity,
+                const TestBaseNeighborType& test_base_neighbor,
+                const AnsatzBaseNeighborType& ansatz_base_neighbor,
+                const IntersectionType& intersection,
+                const FieldVector< DomainFieldType, dimDomain - 1 >& local_point,
+                DynamicMatrix< R >& entity_entity_ret,
+                DynamicMatrix< R >& neighbor_neighbor_ret,
+                DynamicMatrix< R >& entity_neighbor_ret,
+                DynamicMatrix< R >& neighbor_entity_ret) const
+  {
+    const auto local_point_entity = intersection.geometryInInside().global(local_point);
+    const auto local_point_neighbor = intersection.geometryInOutside().global(local_point);
+    const auto normal = intersection.unitOuterNormal(local_point);
+    // the weights, computed from the reference tensor
+    const R delta_entity = normal_diffusion(std::get< 2 >(local_functions_entity)->evaluate(local_point_entity),
+                                            normal);
+    const R delta_neighbor = normal_diffusion(std::get< 2 >(local_functions_neighbor)->evaluate(local_point_neighbor),
+                                              normal);
+    if (!(delta_entity > 0.0) || !(delta_neighbor > 0.0))
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                 "The reference diffusion tensor has to be positive definite (normal diffusivities are "
+                 << delta_entity << " and " << delta_neighbor << ")!");
+    const R weight_entity = delta_neighbor / (delta_entity + delta_neighbor);
+    const R weight_neighbor = delta_entity / (delta_entity + delta_neighbor);
+    // the penalty of this term: for A_t = A_ref this is the one of SWIPDG::Inner, since
+    // weight_entity * delta_entity + weight_neighbor * delta_neighbor = 2 * gamma
+    const R factor_entity = std::get< 0 >(local_functions_entity)->evaluate(local_point_entity)[0];
+    const R factor_neighbor = std::get< 0 >(local_functions_neighbor)->evaluate(local_point_neighbor)[0];
+    const auto tensor_entity = std::get< 1 >(local_functions_entity)->evaluate(local_point_entity);
+    const auto tensor_neighbor = std::get< 1 >(local_functions_neighbor)->evaluate(local_point_neighbor);
+    const size_t max_polorder = std::max(std::max(test_base_entity.order(), ansatz_base_entity.order()),
+                                         std::max(test_base_neighbor.order(), ansatz_base_neighbor.order()));
+    const R sigma = GDT::LocalEvaluation::SIPDG::internal::inner_sigma(max_polorder);
+    const R beta = GDT::LocalEvaluation::SIPDG::internal::default_beta(dimDomain);
+    const R penalty = factor_entity * factor_neighbor * sigma * 0.5
+                      * (weight_entity * normal_diffusion(tensor_entity, normal)
+                         + weight_neighbor * normal_diffusion(tensor_neighbor, normal))
+                      / std::pow(intersection.geometry().volume(), beta);
+    // evaluate the bases
+    const size_t rows_entity = test_base_entity.size();
+    const size_t cols_entity = ansatz_base_entity.size();
+    const size_t rows_neighbor = test_base_neighbor.size();
+    const size_t cols_neighbor = ansatz_base_neighbor.size();
+    assert(entity_entity_ret.rows() >= rows_entity && entity_entity_ret.cols() >= cols_entity);
+    assert(entity_neighbor_ret.rows() >= rows_entity && entity_neighbor_ret.cols() >= cols_neighbor);
+    assert(neighbor_entity_ret.rows() >= rows_neighbor && neighbor_entity_ret.cols() >= cols_entity);
+    assert(neighbor_neighbor_ret.rows() >= rows_neighbor && neighbor_neighbor_ret.cols() >= cols_neighbor);
+    const auto test_values_entity = test_base_entity.evaluate(local_point_entity);
+    const auto ansatz_values_entity = ansatz_base_entity.evaluate(local_point_entity);
+    const auto test_values_neighbor = test_base_neighbor.evaluate(local_point_neighbor);
+    const auto ansatz_values_neighbor = ansatz_base_neighbor.evaluate(local_point_neighbor);
+    // the weighted fluxes (\kappa_t A_t \nabla \phi) \cdot n
+    std::vector< R > test_fluxes_entity(rows_entity, 0.0);
+    std::vector< R > ansatz_fluxes_entity(cols_entity, 0.0);
+    std::vector< R > test_fluxes_neighbor(rows_neighbor, 0.0);
+    std::vector< R > ansatz_fluxes_neighbor(cols_neighbor, 0.0);
+    if (!penalty_only_) {
+      const auto test_gradients_entity = test_base_entity.jacobian(local_point_entity);
+      const auto ansatz_gradients_entity = ansatz_base_entity.jacobian(local_point_entity);
+      const auto test_gradients_neighbor = test_base_neighbor.jacobian(local_point_neighbor);
+      const auto ansatz_gradients_neighbor = ansatz_base_neighbor.jacobian(local_point_neighbor);
+      for (size_t ii = 0; ii < rows_entity; ++ii)
+        test_fluxes_entity[ii] = weight_entity * factor_entity
+                                 * flux(tensor_entity, test_gradients_entity[ii][0], normal);
+      for (size_t jj = 0; jj < cols_entity; ++jj)
+        ansatz_fluxes_entity[jj] = weight_entity * factor_entity
+                                   * flux(tensor_entity, ansatz_gradients_entity[jj][0], normal);
+      for (size_t ii = 0; ii < rows_neighbor; ++ii)
+        test_fluxes_neighbor[ii] = weight_neighbor * factor_neighbor
+                                   * flux(tensor_neighbor, test_gradients_neighbor[ii][0], normal);
+      for (size_t jj = 0; jj < cols_neighbor; ++jj)
+        ansatz_fluxes_neighbor[jj] = weight_neighbor * factor_neighbor
+                                     * flux(tensor_neighbor, ansatz_gradients_neighbor[jj][0], normal);
+    }
+    // -({\kappa_t A_t \nabla u}_\omega \cdot n)[v] - ({\kappa_t A_t \nabla v}_\omega \cdot n)[u] + penalty [u][v]
+    for (size_t ii = 0; ii < rows_entity; ++ii) {
+      const R vv = test_values_entity[ii][0];
+      for (size_t jj = 0; jj < cols_entity; ++jj)
+        entity_entity_ret[ii][jj] = - ansatz_fluxes_entity[jj] * vv
+                                    - test_fluxes_entity[ii] * ansatz_values_entity[jj][0]
+                                    + penalty * ansatz_values_entity[jj][0] * vv;
+      for (size_t jj = 0; jj < cols_neighbor; ++jj)
+        entity_neighbor_ret[ii][jj] = - ansatz_fluxes_neighbor[jj] * vv
+                                      + test_fluxes_entity[ii] * ansatz_values_neighbor[jj][0]
+                                      - penalty * ansatz_values_neighbor[jj][0] * vv;
+    }
+    for (size_t ii = 0; ii < rows_neighbor; ++ii) {
+      const R vv = test_values_neighbor[ii][0];
+      for (size_t jj = 0; jj < cols_entity; ++jj)
+        neighbor_entity_ret[ii][jj] = ansatz_fluxes_entity[jj] * vv
+                                      - test_fluxes_neighbor[ii] * ansatz_values_entity[jj][0]
+                                      - penalty * ansatz_values_entity[jj][0] * vv;
+      for (size_t jj = 0; jj < cols_neighbor; ++jj)
+        neighbor_neighbor_ret[ii][jj] = ansatz_fluxes_neighbor[jj] * vv
+                                        + test_fluxes_neighbor[ii] * ansatz_values_neighbor[jj][0]
+                                        + penalty * ansatz_values_neighbor[jj][0] * vv;
+    }
+  } // ... evaluate(...)
+
+private:
+  template< class TensorValueType, class NormalType >
+  static typename TensorValueType::field_type normal_diffusion(const TensorValueType& tensor, const NormalType& normal)
+  {
+    NormalType tmp(0.0);
+    tensor.mv(normal, tmp);
+    return tmp * normal;
+  }
+
+  template< class TensorValueType, class GradientType, class NormalType >
+  static typename TensorValueType::field_type flux(const TensorValueType& tensor,
+                                                   const GradientType& gradient,
+                                                   const NormalType& normal)
+  {
+    NormalType tmp(0.0);
+    tensor.mv(gradient, tmp);
+    return tmp * normal;
+  }
+
+  const DiffusionFactorType& diffusion_factor_;
+  const DiffusionTensorType& diffusion_tensor_;
+  const DiffusionTensorType& reference_tensor_;
+  const bool penalty_only_;
+}; // class FixedWeightsInner
+
+
+/**
+ * \brief The penalty term of GDT::LocalEvaluation::SWIPDG::BoundaryLHS (scalar case).
+ */
+template< class DiffusionFactorType, class DiffusionTensorType >
+class BoundaryPenalty
+  : public GDT::LocalEvaluation::Codim1Interface< BoundaryPenaltyTraits< DiffusionFactorType, DiffusionTensorType >,
+                                                  2 >
+{
+  typedef BoundaryPenaltyTraits< DiffusionFactorType, DiffusionTensorType > Traits;
+public:
+  typedef typename Traits::EntityType             EntityType;
+  typedef typename Traits::DomainFieldType        DomainFieldType;
+  typedef typename Traits::LocalfunctionTupleType LocalfunctionTupleType;
+  static const unsigned int                       dimDomain = Traits::dimDomain;
+
+  BoundaryPenalty(const DiffusionFactorType& diffusion_factor, const DiffusionTensorType& diffusion_tensor)
+    : diffusion_factor_(diffusion_factor)
+    , diffusion_tensor_(diffusion_tensor)
+  {}
+
+  LocalfunctionTupleType localFunctions(const EntityType& entity) const
+  {
+    return LocalfunctionTupleType(diffusion_factor_.local_function(entity), diffusion_tensor_.local_function(entity));
+  }
+
+  template< class TestBaseType, class AnsatzBaseType >
+  size_t order(const LocalfunctionTupleType& local_functions,
+               const TestBaseType& test_base,
+               const AnsatzBaseType& ansatz_base) const
+  {
+    return std::get< 0 >(local_functions)->order() + std::get< 1 >(local_functions)->order()
+        + test_base.order() + ansatz_base.order();
+  }
+
+  template< class TestBaseType, class AnsatzBaseType, class IntersectionType, class R >
+  void evaluate(const LocalfunctionTupleType& local_functions,
+                const TestBaseType& test_base,
+                const AnsatzBaseType& ansatz_base,
+                const IntersectionType& intersection,
+                const FieldVector< DomainFieldType, dimDomain - 1 >& local_point,
+                DynamicMatrix< R >& ret) const
+  {
+    const auto local_point_entity = intersection.geometryInInside().global(local_point);
+    const auto normal = intersection.unitOuterNormal(local_point);
+    const R factor = std::get< 0 >(local_functions)->evaluate(local_point_entity)[0];
+    const auto tensor = std::get< 1 >(local_functions)->evaluate(local_point_entity);
+    auto tmp = normal;
+    tensor.mv(normal, tmp);
+    const R sigma = GDT::LocalEvaluation::SIPDG::internal::boundary_sigma(std::max(test_base.order(),
+                                                                                   ansatz_base.order()));
+    const R beta = GDT::LocalEvaluation::SIPDG::internal::default_beta(dimDomain);
+    const R penalty = factor * sigma * (tmp * normal) / std::pow(intersection.geometry().volume(), beta);
+    const size_t rows = test_base.size();
+    const size_t cols = ansatz_base.size();
+    assert(ret.rows() >= rows && ret.cols() >= cols);
+    const auto test_values = test_base.evaluate(local_point_entity);
+    const auto ansatz_values = ansatz_base.evaluate(local_point_entity);
+    for (size_t ii = 0; ii < rows; ++ii)
+      for (size_t jj = 0; jj < cols; ++jj)
+        ret[ii][jj] = penalty * ansatz_values[jj][0] * test_values[ii][0];
+  } // ... evaluate(...)
+
+private:
+  const DiffusionFactorType& diffusion_factor_;
+  const DiffusionTensorType& diffusion_tensor_;
+}; // class BoundaryPenalty
+
+
+/**
+ * \brief The affine decomposition of the diffusion \kappa_\mu A_\mu = \sum_t \theta_t(\mu) \kappa_t A_t, where the
+ *        terms are all products of the components (and affine parts) of the diffusion factor and the diffusion tensor,
+ *        together with the local operators and functionals of the SWIPDG discretization of these terms.
+ *
+ *        If only the diffusion factor is parametric, the terms are the components of the diffusion factor (times the
+ *        affine part of the tensor), followed by its affine part, i.e., the same decomposition as used by the
+ *        SWIPDG discretization in that case. If the tensor is parametric, the SWIPDG weights (and thus the SWIPDG
+ *        bilinear form) depend on \mu in a nonlinear way. To retain an affine decomposition, we compute the weights
+ *        \omega^\pm once from the reference tensor A_ref = A_{\mu_ref}, where \mu_ref is given by
+ *        ProblemInterface::set_diffusion_tensor_reference() (A_ref thus has to be positive definite), and use the
+ *        penalty \frac{1}{2}(\omega^+ \delta^+_t + \omega^- \delta^-_t) for each term, where \delta^\pm_t are the
+ *        normal diffusivities of A_t (see FixedWeightsInner). For \mu = \mu_ref the sum of all terms coincides with
+ *        the SWIPDG discretization of the problem for \mu_ref, for all other \mu it is a consistent weighted interior
+ *        penalty discretization (since \omega^+ + \omega^- = 1), the penalty of which scales with the diffusion.
+ *
+ *        The add_* methods add the local assemblers of all terms to a GDT::SystemAssembler (or the CouplingAssembler
+ *        of BlockSWIPDG), which thus has to be assembled while this object exists.
+ */
+template< class ProblemType >
+class AffineDiffusion
+{
+public:
+  typedef typename ProblemType::DiffusionFactorType::NonparametricType DiffusionFactorType;
+  typedef typename ProblemType::DiffusionTensorType::NonparametricType DiffusionTensorType;
+  typedef typename ProblemType::FunctionType::NonparametricType        FunctionType;
+  typedef typename ProblemType::RangeFieldType                         RangeFieldType;
+  typedef std::shared_ptr< const Pymor::ParameterFunctional >          CoefficientType;
+
+  struct Term
+  {
+    std::shared_ptr< const DiffusionFactorType > factor;
+    std::shared_ptr< const DiffusionTensorType > tensor;
+    CoefficientType coefficient; // <- empty for the affine part
+  }; // struct Term
+
+  struct DirichletTerm
+  {
+    Term diffusion;
+    std::shared_ptr< const FunctionType > dirichlet;
+    CoefficientType coefficient; // <- empty for the affine part
+  }; // struct DirichletTerm
+
+private:
+  typedef GDT::LocalOperator::Codim0Integral< GDT::LocalEvaluation::Elliptic< DiffusionFactorType,
+                                                                              DiffusionTensorType > >
+      VolumeOperatorType;
+  typedef GDT::LocalOperator::Codim1CouplingIntegral< FixedWeightsInner< DiffusionFactorType, DiffusionTensorType > >
+      InnerOperatorType;
+  typedef GDT::LocalOperator::Codim1BoundaryIntegral< GDT::LocalEvaluation::SWIPDG::BoundaryLHS< DiffusionFactorType,
+                                                                                                 DiffusionTensorType > >
+      BoundaryOperatorType;
+  typedef GDT::LocalOperator::Codim1BoundaryIntegral< BoundaryPenalty< DiffusionFactorType, DiffusionTensorType > >
+      BoundaryPenaltyOperatorType;
+  typedef GDT::LocalFunctional::Codim1Integral< GDT::LocalEvaluation::SWIPDG::BoundaryRHS< DiffusionFactorType,
+                                                                                           FunctionType,
+                                                                                           DiffusionTensorType > >
+      DirichletFunctionalType;
+  typedef GDT::LocalAssembler::Codim0Matrix< VolumeOperatorType >                  VolumeAssemblerType;
+  typedef GDT::LocalAssembler::Codim1CouplingMatrix< InnerOperatorType >           InnerAssemblerType;
+  typedef GDT::LocalAssembler::Codim1BoundaryMatrix< BoundaryOperatorType >        BoundaryAssemblerType;
+  typedef GDT::LocalAssembler::Codim1BoundaryMatrix< BoundaryPenaltyOperatorType > BoundaryPenaltyAssemblerType;
+  typedef GDT::LocalAssembler::Codim1Vector< DirichletFunctionalType >             DirichletAssemblerType;
+
+  template< class OperatorType, class AssemblerType >
+  struct TermAssembler
+  {
+    std::shared_ptr< const OperatorType > local_operator;
+    std::shared_ptr< const AssemblerType > assembler;
+  }; // struct TermAssembler
+
+  template< class OperatorType, class AssemblerType, class... Args >
+  TermAssembler< OperatorType, AssemblerType > create_local_assembler(Args&& ...args) const
+  {
+    TermAssembler< OperatorType, AssemblerType > ret;
+    ret.local_operator = std::make_shared< const OperatorType >(over_integrate_, std::forward< Args >(args)...);
+    ret.assembler = std::make_shared< const AssemblerType >(*ret.local_operator);
+    return ret;
+  }
+
+  static std::shared_ptr< const DiffusionTensorType > create_reference_tensor(const ProblemType& problem)
+  {
+    const auto& diffusion_tensor = problem.diffusion_tensor();
+    if (!diffusion_tensor->parametric()) {
+      if (!diffusion_tensor->has_affine_part())
+        DUNE_THROW(Stuff::Exceptions::wrong_input_given, "The diffusion tensor must not be empty!");
+      return diffusion_tensor->affine_part();
+    }
+    if (!problem.has_diffusion_tensor_reference())
+      DUNE_THROW(Stuff::Exceptions::requirements_not_met,
+                 "The SWIPDG weights of a parametric diffusion tensor are computed for a fixed parameter, call "
+                 << "set_diffusion_tensor_reference() on the problem before creating the discretization!");
+    return Problems::internal::FrozenFunction< typename ProblemType::DiffusionTensorType >::create(
+          diffusion_tensor, problem.diffusion_tensor_reference());
+  } // ... create_reference_tensor(...)
+
+public:
+  explicit AffineDiffusion(const ProblemType& problem, const size_t over_integrate = 0)
+    : tensor_parametric_(problem.diffusion_tensor()->parametric())
+    , over_integrate_(over_integrate)
+    , reference_tensor_(create_reference_tensor(problem))
+  {
+    const auto& diffusion_factor = *problem.diffusion_factor();
+    const auto& diffusion_tensor = *problem.diffusion_tensor();
+    std::vector< std::pair< std::shared_ptr< const DiffusionFactorType >, CoefficientType > > factor_parts;
+    for (DUNE_STUFF_SSIZE_T qq = 0; qq < diffusion_factor.num_components(); ++qq)
+      factor_parts.emplace_back(diffusion_factor.component(qq), diffusion_factor.coefficient(qq));
+    if (diffusion_factor.has_affine_part())
+      factor_parts.emplace_back(diffusion_factor.affine_part(), nullptr);
+    std::vector< std::pair< std::shared_ptr< const DiffusionTensorType >, CoefficientType > > tensor_parts;
+    for (DUNE_STUFF_SSIZE_T qq = 0; qq < diffusion_tensor.num_components(); ++qq)
+      tensor_parts.emplace_back(diffusion_tensor.component(qq), diffusion_tensor.coefficient(qq));
+    if (diffusion_tensor.has_affine_part())
+      tensor_parts.emplace_back(diffusion_tensor.affine_part(), nullptr);
+    // the affine part (if any) is the last term, since it is the product of the two last parts
+    for (const auto& factor_part : factor_parts)
+      for (const auto& tensor_part : tensor_parts)
+        terms_.push_back({factor_part.first,
+                          tensor_part.first,
+                          multiply_coefficients(factor_part.second, tensor_part.second)});
+    const auto& dirichlet = *problem.dirichlet();
+    std::vector< std::pair< std::shared_ptr< const FunctionType >, CoefficientType > > dirichlet_parts;
+    for (DUNE_STUFF_SSIZE_T qq = 0; qq < dirichlet.num_components(); ++qq)
+      dirichlet_parts.emplace_back(dirichlet.component(qq), dirichlet.coefficient(qq));
+    if (dirichlet.has_affine_part())
+      dirichlet_parts.emplace_back(dirichlet.affine_part(), nullptr);
+    for (const auto& term : terms_)
+      for (const auto& dirichlet_part : dirichlet_parts)
+        dirichlet_terms_.push_back({term,
+                                    dirichlet_part.first,
+                                    multiply_coefficients(term.coefficient, dirichlet_part.second)});
+    // the local operators and functionals
+    for (const auto& term : terms_) {
+      volume_.push_back(create_local_assembler< VolumeOperatorType, VolumeAssemblerType >(*term.factor,
+                                                                                          *term.tensor));
+      inner_.push_back(create_local_assembler< InnerOperatorType, InnerAssemblerType >(*term.factor,
+                                                                                       *term.tensor,
+                                                                                       *reference_tensor_));
+      inner_penalty_.push_back(create_local_assembler< InnerOperatorType, InnerAssemblerType >(*term.factor,
+                                                                                               *term.tensor,
+                                                                                               *reference_tensor_,
+                                                                                               true));
+      boundary_.push_back(create_local_assembler< BoundaryOperatorType, BoundaryAssemblerType >(*term.factor,
+                                                                                                *term.tensor));
+      boundary_penalty_.push_back(create_local_assembler< BoundaryPenaltyOperatorType,
+                                                          BoundaryPenaltyAssemblerType >(*term.factor, *term.tensor));
+    }
+    for (const auto& term : dirichlet_terms_)
+      dirichlet_rhs_.push_back(create_local_assembler< DirichletFunctionalType, DirichletAssemblerType >(
+          *term.diffusion.factor, *term.diffusion.tensor, *term.dirichlet));
+  } // AffineDiffusion(...)
+
+  bool tensor_parametric() const
+  {
+    return tensor_parametric_;
+  }
+
+  const std::vector< Term >& terms() const
+  {
+    return terms_;
+  }
+
+  bool has_affine_part() const
+  {
+    return !terms_.empty() && !terms_.back().coefficient;
+  }
+
+  /**
+   * \brief The number of terms with a coefficient.
+   */
+  size_t num_components() const
+  {
+    return has_affine_part() ? terms_.size() - 1 : terms_.size();
+  }
+
+  /**
+   * \brief All products of the terms of the diffusion and the components (and affine part) of the dirichlet values.
+   */
+  const std::vector< DirichletTerm >& dirichlet_terms() const
+  {
+    return dirichlet_terms_;
+  }
+
+  /**
+   * \brief Adds the volume, inner face and dirichlet boundary contributions of each term, one matrix per term.
+   */
+  template< class SystemAssemblerType, class BoundaryInfoType, class MatrixType >
+  void add_operator(SystemAssemblerType& system_assembler,
+                    const BoundaryInfoType& boundary_info,
+                    const std::vector< MatrixType* >& matrices) const
+  {
+    typedef typename SystemAssemblerType::GridViewType GridViewType;
+    assert(matrices.size() == terms_.size());
+    for (size_t tt = 0; tt < terms_.size(); ++tt) {
+      system_assembler.add(*volume_[tt].assembler, *matrices[tt]);
+      system_assembler.add(*inner_[tt].assembler,
+                           *matrices[tt],
+                           new Stuff::Grid::ApplyOn::InnerIntersectionsPrimally< GridViewType >());
+      system_assembler.add(*boundary_[tt].assembler,
+                           *matrices[tt],
+                           new Stuff::Grid::ApplyOn::DirichletIntersections< GridViewType >(boundary_info));
+    }
+  } // ... add_operator(...)
+
+  /**
+   * \brief Adds the inner face and dirichlet boundary penalty terms of each term (i.e., the SWIPDG penalty product),
+   *        one matrix per term.
+   */
+  template< class SystemAssemblerType, class BoundaryInfoType, class MatrixType >
+  void add_penalty(SystemAssemblerType& system_assembler,
+                   const BoundaryInfoType& boundary_info,
+                   const std::vector< MatrixType* >& matrices) const
+  {
+    typedef typename SystemAssemblerType::GridViewType GridViewType;
+    assert(matrices.size() == terms_.size());
+    for (size_t tt = 0; tt < terms_.size(); ++tt) {
+      system_assembler.add(*inner_penalty_[tt].assembler,
+                           *matrices[tt],
+                           new Stuff::Grid::ApplyOn::InnerIntersectionsPrimally< GridViewType >());
+      system_assembler.add(*boundary_penalty_[tt].assembler,
+                           *matrices[tt],
+                           new Stuff::Grid::ApplyOn::DirichletIntersections< GridViewType >(boundary_info));
+    }
+  } // ... add_penalty(...)
+
+  /**
+   * \brief Adds the dirichlet boundary contributions of each term, one matrix per term.
+   */
+  template< class SystemAssemblerType, class BoundaryInfoType, class MatrixType >
+  void add_dirichlet(SystemAssemblerType& system_assembler,
+                     const BoundaryInfoType& boundary_info,
+                     const std::vector< MatrixType* >& matrices) const
+  {
+    typedef typename SystemAssemblerType::GridViewType GridViewType;
+    assert(matrices.size() == terms_.size());
+    for (size_t tt = 0; tt < terms_.size(); ++tt)
+      system_assembler.add(*boundary_[tt].assembler,
+                           *matrices[tt],
+                           new Stuff::Grid::ApplyOn::DirichletIntersections< GridViewType >(boundary_info));
+  } // ... add_dirichlet(...)
+
+  /**
+   * \brief Adds the dirichlet boundary contributions to the right hand side, one vector per dirichlet_terms().
+   */
+  template< class SystemAssemblerType, class BoundaryInfoType, class VectorType >
+  void add_dirichlet_rhs(SystemAssemblerType& system_assembler,
+                         const BoundaryInfoType& boundary_info,
+                         const std::vector< VectorType* >& vectors) const
+  {
+    typedef typename SystemAssemblerType::GridViewType GridViewType;
+    assert(vectors.size() == dirichlet_terms_.size());
+    for (size_t tt = 0; tt < dirichlet_terms_.size(); ++tt)
+      system_assembler.add(*dirichlet_rhs_[tt].assembler,
+                           *vectors[tt],
+                           new Stuff::Grid::ApplyOn::DirichletIntersections< GridViewType >(boundary_info));
+  } // ... add_dirichlet_rhs(...)
+
+  /**
+   * \brief Adds the coupling contributions of each term to the CouplingAssembler of BlockSWIPDG, one matrix per term
+   *        and block.
+   */
+  template< class CouplingAssemblerType, class MatrixType >
+  void add_coupling(CouplingAssemblerType& coupling_assembler,
+                    const std::vector< MatrixType* >& inside_inside_matrices,
+                    const std::vector< MatrixType* >& inside_outside_matrices,
+                    const std::vector< MatrixType* >& outside_inside_matrices,
+                    const std::vector< MatrixType* >& outside_outside_matrices) const
+  {
+    assert(inside_inside_matrices.size() == terms_.size());
+    assert(inside_outside_matrices.size() == terms_.size());
+    assert(outside_inside_matrices.size() == terms_.size());
+    assert(outside_outside_matrices.size() == terms_.size());
+    for (size_t tt = 0; tt < terms_.size(); ++tt)
+      coupling_assembler.addLocalAssembler(*inner_[tt].assembler,
+                                           *inside_inside_matrices[tt],
+                                           *inside_outside_matrices[tt],
+                                           *outside_inside_matrices[tt],
+                                           *outside_outside_matrices[tt]);
+  } // ... add_coupling(...)
+
+private:
+  const bool tensor_parametric_;
+  const size_t over_integrate_;
+  const std::shared_ptr< const DiffusionTensorType > reference_tensor_;
+  std::vector< Term > terms_;
+  std::vector< DirichletTerm > dirichlet_terms_;
+  std::vector< TermAssembler< VolumeOperatorType, VolumeAssemblerType > > volume_;
+  std::vector< TermAssembler< InnerOperatorType, InnerAssemblerType > > inner_;
+  std::vector< TermAssembler< InnerOperatorType, InnerAssemblerType > > inner_penalty_;
+  std::vector< TermAssembler< BoundaryOperatorType, BoundaryAssemblerType > > boundary_;
+  std::vector< TermAssembler< BoundaryPenaltyOperatorType, BoundaryPenaltyAssemblerType > > boundary_penalty_;
+  std::vector< TermAssembler< DirichletFunctionalType, DirichletAssemblerType > > dirichlet_rhs_;
+}; // class AffineDiffusion
+
+
+} // namespace internal
+} // namespace Discretizations
+} // namespace LinearElliptic
+} // namespace HDD
+} // namespace Dune
+
+#endif // DUNE_HDD_LINEARELLIPTIC_DISCRETIZATIONS_AFFINE_DIFFUSION_HH
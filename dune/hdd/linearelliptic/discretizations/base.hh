@@ -12,6 +12,8 @@
 
 #include <map>
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 
 #include <dune/stuff/common/crtp.hh>
 #include <dune/stuff/common/exceptions.hh>
@@ -29,7 +31,11 @@
 #include <dune/gdt/products/h1.hh>
 #include <dune/gdt/products/l2.hh>
 
+#include "affine-diffusion.hh"
 #include "interfaces.hh"
+#include "renumbering.hh"
+#include "serialization.hh"
+#include "shared.hh"
 
 namespace Dune {
 namespace HDD {
@@ -204,6 +210,14 @@ public:
     CHECK_AND_CALL_CRTP(this->as_imp().uncached_solve(options, vector, mu));
   }
 
+  /**
+   * \brief Drops all cached solutions (the cache is not bounded otherwise).
+   */
+  void clear_cache() const
+  {
+    cache_.clear();
+  }
+
 protected:
   const TestSpaceType test_space_;
   const AnsatzSpaceType ansatz_space_;
@@ -241,6 +255,7 @@ protected:
   typedef Pymor::LA::AffinelyDecomposedContainer< MatrixType > AffinelyDecomposedMatrixType;
   typedef Pymor::LA::AffinelyDecomposedContainer< VectorType > AffinelyDecomposedVectorType;
   typedef Stuff::LA::Solver< MatrixType > SolverType;
+  typedef SharedAffinelyDecomposedMatrix< MatrixType > SharedMatrixType;
 
 public:
   static std::string static_id() { return "hdd.linearelliptic.discretizations.containerbased"; }
@@ -255,6 +270,7 @@ public:
     , matrix_(std::make_shared< AffinelyDecomposedMatrixType >())
     , rhs_(std::make_shared< AffinelyDecomposedVectorType >())
     , pattern_(nullptr)
+    , shared_matrix_(nullptr)
   {}
 
   ContainerBasedDefault(const ThisType& other) = default;
@@ -263,11 +279,13 @@ public:
 
   std::shared_ptr< AffinelyDecomposedMatrixType >& system_matrix()
   {
+    assert_not_attached("system_matrix");
     return matrix_;
   }
 
   const std::shared_ptr< const AffinelyDecomposedMatrixType >& system_matrix() const
   {
+    assert_not_attached("system_matrix");
     return matrix_;
   }
 
@@ -289,6 +307,7 @@ public:
   OperatorType get_operator() const
   {
     assert_everything_is_ready();
+    assert_not_attached("get_operator");
     return OperatorType(*matrix_);
   }
 
@@ -340,6 +359,284 @@ public:
     return *(result->second);
   } // ... get_vector(...)
 
+  /**
+   * \brief Writes the assembled data (pattern, affinely decomposed system matrix and rhs, products and vectors,
+   *        including the coefficients of all components) to a binary file, to be restored by load().
+   *
+   *        The file starts with the type of the discretization, the sizes of its spaces and a fingerprint of its grid
+   *        view and problem (see internal::fingerprint()), followed by write_containers().
+   */
+  void save(const std::string filename) const
+  {
+    assert_everything_is_ready();
+    assert_not_attached("save");
+    internal::BinaryWriter writer(filename);
+    write_header(writer);
+    write_containers(writer);
+    writer.commit();
+  } // ... save(...)
+
+  /**
+   * \brief Restores the data written by save() instead of assembling it, to be called instead of init().
+   * \return false if the file does not exist (or was written by another version), in which case nothing is changed
+   *         and init() has to be called as usual.
+   * \note   The file is memory mapped, but its contents are copied into the containers, which own their memory.
+   * \throws Stuff::Exceptions::wrong_input_given if the file was written by another type of discretization or for
+   *         other spaces, another grid view or another problem.
+   */
+  bool load(const std::string filename)
+  {
+    if (container_based_initialized_)
+      DUNE_THROW(Stuff::Exceptions::you_are_using_this_wrong, "Do not call load() after init()!");
+    internal::MappedReader reader(filename);
+    if (!read_header(reader, filename))
+      return false;
+    read_containers(reader);
+    return true;
+  } // ... load(...)
+
+  /**
+   * \brief Writes all containers (without any header), including those of derived classes (see
+   *        write_additional_data()), as save() does.
+   * \note  Meant for discretizations which store others within their files, use save() otherwise.
+   */
+  void write_containers(internal::BinaryWriter& writer) const
+  {
+    assert_everything_is_ready();
+    assert_not_attached("write_containers");
+    using namespace internal;
+    writer.write(std::uint64_t(purely_neumann_));
+    write_pattern(writer, *pattern_);
+    const auto write_matrix = write_container< MatrixType, PatternType >;
+    const auto write_vec = write_vector< VectorType, PatternType >;
+    write_affinely_decomposed(writer, *matrix_, *pattern_, write_matrix);
+    write_affinely_decomposed(writer, *rhs_, *pattern_, write_vec);
+    writer.write(std::uint64_t(products_.size()));
+    for (const auto& element : products_) {
+      writer.write(element.first);
+      write_affinely_decomposed(writer, *element.second, *pattern_, write_matrix);
+    }
+    writer.write(std::uint64_t(vectors_.size()));
+    for (const auto& element : vectors_) {
+      writer.write(element.first);
+      write_affinely_decomposed(writer, *element.second, *pattern_, write_vec);
+    }
+    write_permutation(writer);
+    this->as_imp().write_additional_data(writer);
+  } // ... write_containers(...)
+
+  /**
+   * \brief Restores the containers written by write_containers() and finalizes the discretization, as load() does.
+   */
+  void read_containers(internal::MappedReader& reader)
+  {
+    if (container_based_initialized_)
+      DUNE_THROW(Stuff::Exceptions::you_are_using_this_wrong, "Do not call read_containers() after init()!");
+    using namespace internal;
+    const bool purely_neumann = reader.read_uint();
+    auto pattern = read_pattern< PatternType >(reader);
+    if (pattern->size() != this->test_space().mapper().size())
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                 "The stored pattern (" << pattern->size() << " rows) does not match the test space ("
+                 << this->test_space().mapper().size() << " DoFs)!");
+    const auto read_mat = read_matrix< MatrixType, PatternType >;
+    const auto read_vec = read_vector< VectorType, PatternType >;
+    auto matrix = read_affinely_decomposed< MatrixType >(reader, *pattern, read_mat);
+    auto rhs = read_affinely_decomposed< VectorType >(reader, *pattern, read_vec);
+    std::map< std::string, std::shared_ptr< AffinelyDecomposedMatrixType > > products;
+    const size_t num_products = reader.read_uint();
+    for (size_t ii = 0; ii < num_products; ++ii) {
+      const std::string id = reader.read_string();
+      products.insert(std::make_pair(id, read_affinely_decomposed< MatrixType >(reader, *pattern, read_mat)));
+    }
+    std::map< std::string, std::shared_ptr< AffinelyDecomposedVectorType > > vectors;
+    const size_t num_vectors = reader.read_uint();
+    for (size_t ii = 0; ii < num_vectors; ++ii) {
+      const std::string id = reader.read_string();
+      vectors.insert(std::make_pair(id, read_affinely_decomposed< VectorType >(reader, *pattern, read_vec)));
+    }
+    auto permutation = read_permutation(reader);
+    // the derived classes restore their data first, so that this discretization is only finalized if all of it was
+    // read successfully
+    this->as_imp().read_additional_data(reader);
+    purely_neumann_ = purely_neumann;
+    permutation_ = permutation;
+    pattern_ = pattern;
+    matrix_ = matrix;
+    rhs_ = rhs;
+    products_ = products;
+    vectors_ = vectors;
+    finalize_init(false);
+  } // ... read_containers(...)
+
+  /**
+   * \brief Writes the system matrix (see SharedAffinelyDecomposedMatrix), followed by the header of save(), the rhs,
+   *        the vectors and the data of derived classes, to a file to be attached to by attach_shared() in other
+   *        processes.
+   *
+   *        Several processes may race to export the same file, it is written to a temporary file and moved.
+   */
+  void export_shared(const std::string filename) const
+  {
+    assert_everything_is_ready();
+    assert_not_attached("export_shared");
+    using namespace internal;
+    BinaryWriter writer(filename);
+    SharedMatrixType::write(writer, *matrix_, *pattern_);
+    write_header(writer);
+    writer.write(std::uint64_t(purely_neumann_));
+    const auto write_vec = write_vector< VectorType, PatternType >;
+    write_affinely_decomposed(writer, *rhs_, *pattern_, write_vec);
+    writer.write(std::uint64_t(vectors_.size()));
+    for (const auto& element : vectors_) {
+      writer.write(element.first);
+      write_affinely_decomposed(writer, *element.second, *pattern_, write_vec);
+    }
+    write_permutation(writer);
+    this->as_imp().write_additional_data(writer);
+    writer.commit();
+  } // ... export_shared(...)
+
+  /**
+   * \brief Attaches to a file written by export_shared(), to be called instead of init(), e.g. by the worker
+   *        processes of a parameter sweep on one node.
+   *
+   *        The components of the system matrix are used in place from the (read-only and thus shared) mapping of the
+   *        file, only the system matrix for the current parameter is assembled privately in solve(). The rhs, the
+   *        vectors and the data of derived classes are copied.
+   * \attention Since the system matrix is only available to solve(), system_matrix(), get_operator(), save() and
+   *            export_shared() throw, and there are no products (these are only required offline).
+   * \return false if the file does not exist, in which case nothing is changed.
+   * \throws Stuff::Exceptions::wrong_input_given as load() does.
+   */
+  bool attach_shared(const std::string filename)
+  {
+    if (container_based_initialized_)
+      DUNE_THROW(Stuff::Exceptions::you_are_using_this_wrong, "Do not call attach_shared() after init()!");
+    if (!SharedMatrixType::exists(filename))
+      return false;
+    using namespace internal;
+    auto shared_matrix = std::make_shared< SharedMatrixType >(filename);
+    auto& reader = shared_matrix->reader();
+    if (!read_header(reader, filename))
+      DUNE_THROW(IOError, "The file '" << filename << "' was not written by export_shared() (of this version)!");
+    if (shared_matrix->rows() != this->test_space().mapper().size()
+        || shared_matrix->cols() != this->ansatz_space().mapper().size())
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                 "The spaces do not match the ones of the matrix stored in '" << filename << "'!");
+    auto pattern = shared_matrix->template pattern< PatternType >();
+    const bool purely_neumann = reader.read_uint();
+    const auto read_vec = read_vector< VectorType, PatternType >;
+    auto rhs = read_affinely_decomposed< VectorType >(reader, *pattern, read_vec);
+    std::map< std::string, std::shared_ptr< AffinelyDecomposedVectorType > > vectors;
+    const size_t num_vectors = reader.read_uint();
+    for (size_t ii = 0; ii < num_vectors; ++ii) {
+      const std::string id = reader.read_string();
+      vectors.insert(std::make_pair(id, read_affinely_decomposed< VectorType >(reader, *pattern, read_vec)));
+    }
+    auto permutation = read_permutation(reader);
+    this->as_imp().read_additional_data(reader);
+    purely_neumann_ = purely_neumann;
+    permutation_ = permutation;
+    pattern_ = pattern;
+    // only carries the parameter type and the coefficients, see assert_not_attached()
+    matrix_ = shared_matrix->placeholder();
+    rhs_ = rhs;
+    vectors_ = vectors;
+    shared_matrix_ = shared_matrix;
+    finalize_init(false);
+    return true;
+  } // ... attach_shared(...)
+
+  /**
+   * \brief Renumbers the DoFs of all containers (pattern, system matrix, rhs, products and vectors) consistently, to
+   *        be called after init().
+   *
+   *        Available types are
+   *        - "rcm":     reverse Cuthill-McKee ordering of the pattern, reduces the bandwidth (and thus the fill-in of
+   *                     direct and ILU factorizations),
+   *        - "hilbert": numbers the DoFs element by element along a Hilbert curve, improves the locality of SpMV.
+   *
+   *        All vectors (solutions, rhs, ...) of this discretization are then given in the new numbering, use
+   *        to_space_numbering() and from_space_numbering() to convert from and to the numbering of the spaces
+   *        (visualize() does so itself). Anything given a space and a vector (discrete functions, the estimators)
+   *        expects the numbering of the space. The permutation is stored by save() and export_shared().
+   */
+  void renumber(const std::string type = "rcm")
+  {
+    assert_renumberable();
+    auto logger = DSC::TimedLogger().get(static_id() + ".renumber");
+    logger.info() << "renumbering " << pattern_->size() << " DoFs (" << type << ")... " << std::endl;
+    std::vector< size_t > permutation;
+    if (type == "rcm")
+      permutation = internal::reverse_cuthill_mckee(*pattern_);
+    else if (type == "hilbert")
+      permutation = internal::hilbert_ordering(this->ansatz_space());
+    else
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                 "Unknown type '" << type << "', has to be one of 'rcm' and 'hilbert'!");
+    apply_permutation(permutation);
+  } // ... renumber(...)
+
+  /**
+   * \brief The new index of each DoF of the spaces, empty if renumber() was not called.
+   */
+  const std::vector< size_t >& permutation() const
+  {
+    return permutation_;
+  }
+
+  VectorType to_space_numbering(const VectorType& vector) const
+  {
+    if (permutation_.empty())
+      return vector.copy();
+    VectorType ret(vector.size());
+    for (size_t ii = 0; ii < permutation_.size(); ++ii)
+      ret.set_entry(ii, vector.get_entry(permutation_[ii]));
+    return ret;
+  } // ... to_space_numbering(...)
+
+  VectorType from_space_numbering(const VectorType& vector) const
+  {
+    if (permutation_.empty())
+      return vector.copy();
+    VectorType ret(vector.size());
+    for (size_t ii = 0; ii < permutation_.size(); ++ii)
+      ret.set_entry(permutation_[ii], vector.get_entry(ii));
+    return ret;
+  } // ... from_space_numbering(...)
+
+  void visualize(const VectorType& vector,
+                 const std::string filename,
+                 const std::string name,
+                 const bool add_dirichlet = true,
+                 Pymor::Parameter mu = Pymor::Parameter()) const
+  {
+    if (permutation_.empty()) {
+      BaseType::visualize(vector, filename, name, add_dirichlet, mu);
+      return;
+    }
+    // add the dirichlet values in the new numbering, before converting back
+    VectorType tmp = vector.copy();
+    const auto vectors = this->available_vectors();
+    if (add_dirichlet && std::find(vectors.begin(), vectors.end(), "dirichlet") != vectors.end()) {
+      const auto dirichlet_vector = this->get_vector("dirichlet");
+      if (dirichlet_vector.parametric())
+        tmp += dirichlet_vector.freeze_parameter(mu);
+      else
+        tmp += *(dirichlet_vector.affine_part());
+    }
+    BaseType::visualize(to_space_numbering(tmp), filename, name, false, mu);
+  } // ... visualize(...)
+
+  void visualize(const VectorType& vector,
+                 const std::string filename,
+                 const std::string name,
+                 Pymor::Parameter mu) const
+  {
+    visualize(vector, filename, name, true, mu);
+  }
+
   std::vector< std::string > solver_types() const
   {
     return SolverType::types();
@@ -363,15 +660,21 @@ public:
       DUNE_THROW(Pymor::Exceptions::wrong_parameter_type, mu.type() << " vs. " << this->parameter_type());
     const auto& rhs = *(this->rhs_);
     const auto& matrix = *(this->matrix_);
-    if (purely_neumann_) {
+    if (shared_matrix_ || purely_neumann_) {
+      // assemble the system matrix for mu explicitly, to modify it or since there is no operator to freeze
       VectorType tmp_rhs = rhs.parametric() ? rhs.freeze_parameter(this->map_parameter(mu, "rhs"))
                                             : *(rhs.affine_part());
-      MatrixType tmp_system_matrix = matrix.parametric() ? matrix.freeze_parameter(this->map_parameter(mu, "lhs"))
-                                                         : *(matrix.affine_part());
-      tmp_system_matrix.unit_row(0);
-      tmp_rhs.set_entry(0, 0.0);
+      const Pymor::Parameter mu_lhs = matrix.parametric() ? this->map_parameter(mu, "lhs") : Pymor::Parameter();
+      MatrixType tmp_system_matrix = shared_matrix_ ? shared_matrix_->freeze_parameter(mu_lhs, *pattern_)
+                                                    : (matrix.parametric() ? matrix.freeze_parameter(mu_lhs)
+                                                                           : *(matrix.affine_part()));
+      if (purely_neumann_) {
+        tmp_system_matrix.unit_row(0);
+        tmp_rhs.set_entry(0, 0.0);
+      }
       SolverType(tmp_system_matrix).apply(tmp_rhs, vector, options);
-      vector -= vector.mean();
+      if (purely_neumann_)
+        vector -= vector.mean();
     } else {
       // compute right hand side vector
       logger.debug() << "computing right hand side..." << std::endl;
@@ -472,9 +775,8 @@ protected:
       system_assembler.add(*semi_h1_product);
     }
     // elliptic
-    const auto& diffusion_factor = *this->problem().diffusion_factor();
     const auto& diffusion_tensor = *this->problem().diffusion_tensor();
-    assert(!diffusion_tensor.parametric());
+    const Discretizations::internal::AffineDiffusion< ProblemType > affine_diffusion(this->problem(), over_integrate);
     typedef Products::EllipticAssemblable< MatrixType, typename ProblemType::DiffusionFactorType::NonparametricType,
                                            TestSpaceType, GridViewType, AnsatzSpaceType, RangeFieldType,
                                            typename ProblemType::DiffusionTensorType::NonparametricType > EllipticProductType;
@@ -483,30 +785,31 @@ protected:
     if (   std::find(only_these_products.begin(), only_these_products.end(), "elliptic") != only_these_products.end()
         || std::find(only_these_products.begin(), only_these_products.end(), "elliptic_0") != only_these_products.end()
         || std::find(only_these_products.begin(), only_these_products.end(), "elliptic_penalty") != only_these_products.end()) {
-      for (DUNE_STUFF_SSIZE_T qq = 0; qq < diffusion_factor.num_components(); ++qq) {
-        const auto id = elliptic_product_matrix->register_component(diffusion_factor.coefficient(qq),
-                                                                    this->test_space().mapper().size(),
-                                                                    this->ansatz_space().mapper().size(),
-                                                                    *pattern_);
-        elliptic_products.emplace_back(new EllipticProductType(*elliptic_product_matrix->component(id),
-                                                               this->test_space(),
-                                                               this->grid_view(),
-                                                               this->ansatz_space(),
-                                                               *diffusion_factor.component(qq),
-                                                               *diffusion_tensor.affine_part(),
-                                                               over_integrate));
-      }
-      if (diffusion_factor.has_affine_part()) {
-        elliptic_product_matrix->register_affine_part(this->test_space().mapper().size(),
-                                                      this->ansatz_space().mapper().size(),
-                                                      *pattern_);
-        elliptic_products.emplace_back(new EllipticProductType(*elliptic_product_matrix->affine_part(),
-                                                               this->test_space(),
-                                                               this->grid_view(),
-                                                               this->ansatz_space(),
-                                                               *diffusion_factor.affine_part(),
-                                                               *diffusion_tensor.affine_part(),
-                                                               over_integrate));
+      for (const auto& term : affine_diffusion.terms()) {
+        if (term.coefficient) {
+          const auto id = elliptic_product_matrix->register_component(term.coefficient,
+                                                                      this->test_space().mapper().size(),
+                                                                      this->ansatz_space().mapper().size(),
+                                                                      *pattern_);
+          elliptic_products.emplace_back(new EllipticProductType(*elliptic_product_matrix->component(id),
+                                                                 this->test_space(),
+                                                                 this->grid_view(),
+                                                                 this->ansatz_space(),
+                                                                 *term.factor,
+                                                                 *term.tensor,
+                                                                 over_integrate));
+        } else {
+          elliptic_product_matrix->register_affine_part(this->test_space().mapper().size(),
+                                                        this->ansatz_space().mapper().size(),
+                                                        *pattern_);
+          elliptic_products.emplace_back(new EllipticProductType(*elliptic_product_matrix->affine_part(),
+                                                                 this->test_space(),
+                                                                 this->grid_view(),
+                                                                 this->ansatz_space(),
+                                                                 *term.factor,
+                                                                 *term.tensor,
+                                                                 over_integrate));
+        }
       }
       for (auto& product : elliptic_products)
         system_assembler.add(*product);
@@ -534,36 +837,37 @@ protected:
                                                 typename ProblemType::DiffusionTensorType::NonparametricType,
                                                 TestSpaceType > PenaltyProductType;
     std::vector< std::unique_ptr< PenaltyProductType > > penalty_products;
+    std::vector< MatrixType* > penalty_matrices;
     auto penalty_product_matrix = std::make_shared< AffinelyDecomposedMatrixType >();
     if (   std::find(only_these_products.begin(), only_these_products.end(), "penalty") != only_these_products.end()
         || std::find(only_these_products.begin(), only_these_products.end(), "elliptic_penalty") != only_these_products.end()) {
-      for (DUNE_STUFF_SSIZE_T qq = 0; qq < diffusion_factor.num_components(); ++qq) {
-        const auto id = penalty_product_matrix->register_component(diffusion_factor.coefficient(qq),
-                                                                   this->test_space().mapper().size(),
-                                                                   this->ansatz_space().mapper().size(),
-                                                                   *pattern_);
-        penalty_products.emplace_back(new PenaltyProductType(*penalty_product_matrix->component(id),
-                                                             this->test_space(),
-                                                             this->grid_view(),
-                                                             this->ansatz_space(),
-                                                             *diffusion_factor.component(qq),
-                                                             *diffusion_tensor.affine_part(),
-                                                             over_integrate));
-      }
-      if (diffusion_factor.has_affine_part()) {
-        penalty_product_matrix->register_affine_part(this->test_space().mapper().size(),
-                                                     this->ansatz_space().mapper().size(),
-                                                     *pattern_);
-        penalty_products.emplace_back(new PenaltyProductType(*penalty_product_matrix->affine_part(),
-                                                             this->test_space(),
-                                                             this->grid_view(),
-                                                             this->ansatz_space(),
-                                                             *diffusion_factor.affine_part(),
-                                                             *diffusion_tensor.affine_part(),
-                                                             over_integrate));
+      for (const auto& term : affine_diffusion.terms()) {
+        if (term.coefficient) {
+          const auto id = penalty_product_matrix->register_component(term.coefficient,
+                                                                     this->test_space().mapper().size(),
+                                                                     this->ansatz_space().mapper().size(),
+                                                                     *pattern_);
+          penalty_matrices.push_back(penalty_product_matrix->component(id).get());
+        } else {
+          penalty_product_matrix->register_affine_part(this->test_space().mapper().size(),
+                                                       this->ansatz_space().mapper().size(),
+                                                       *pattern_);
+          penalty_matrices.push_back(penalty_product_matrix->affine_part().get());
+        }
+        // for a parametric diffusion tensor the SWIPDG weights are fixed, see internal::AffineDiffusion
+        if (!diffusion_tensor.parametric())
+          penalty_products.emplace_back(new PenaltyProductType(*penalty_matrices.back(),
+                                                               this->test_space(),
+                                                               this->grid_view(),
+                                                               this->ansatz_space(),
+                                                               *term.factor,
+                                                               *term.tensor,
+                                                               over_integrate));
       }
       for (auto& product : penalty_products)
         system_assembler.add(*product);
+      if (diffusion_tensor.parametric())
+        affine_diffusion.add_penalty(system_assembler, this->boundary_info(), penalty_matrices);
     }
     // walk the grid
     system_assembler.assemble();
@@ -629,6 +933,114 @@ protected:
     }
   } // assemble_product(...)
 
+  /**
+   * \brief Writes the data of a derived class to the files of save() and export_shared(), to be hidden by derived
+   *        classes with additional state (which then have to befriend this class).
+   */
+  void write_additional_data(internal::BinaryWriter& /*writer*/) const {}
+
+  /**
+   * \brief Restores the data written by write_additional_data(), called by load() and attach_shared() before anything
+   *        of this class is changed.
+   */
+  void read_additional_data(internal::MappedReader& /*reader*/) {}
+
+  void write_header(internal::BinaryWriter& writer) const
+  {
+    writer.write(serialization_magic, sizeof(serialization_magic));
+    writer.write(std::uint64_t(serialization_version));
+    writer.write(Traits::derived_type::static_id());
+    writer.write(std::uint64_t(this->test_space().mapper().size()));
+    writer.write(std::uint64_t(this->ansatz_space().mapper().size()));
+    writer.write(internal::fingerprint(this->grid_view(), this->problem()));
+  } // ... write_header(...)
+
+  /**
+   * \brief Reads the header written by write_header().
+   * \return false if the file does not exist or was written by another version.
+   */
+  bool read_header(internal::MappedReader& reader, const std::string& filename) const
+  {
+    if (!reader.valid() || reader.remaining() < sizeof(serialization_magic) + sizeof(std::uint64_t))
+      return false;
+    if (std::memcmp(reader.read(sizeof(serialization_magic)), serialization_magic, sizeof(serialization_magic)) != 0
+        || reader.read_uint() != serialization_version)
+      return false;
+    const std::string type = reader.read_string();
+    if (type != Traits::derived_type::static_id())
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                 "'" << filename << "' was written by a '" << type << "', not by a '"
+                 << Traits::derived_type::static_id() << "'!");
+    const size_t test_size = reader.read_uint();
+    const size_t ansatz_size = reader.read_uint();
+    if (test_size != this->test_space().mapper().size() || ansatz_size != this->ansatz_space().mapper().size())
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                 "The spaces do not match the ones stored in '" << filename << "'!\n"
+                 << "   test_space().mapper().size():   " << this->test_space().mapper().size() << "\n"
+                 << "   stored:                         " << test_size << "\n"
+                 << "   ansatz_space().mapper().size(): " << this->ansatz_space().mapper().size() << "\n"
+                 << "   stored:                         " << ansatz_size);
+    if (reader.read_uint() != internal::fingerprint(this->grid_view(), this->problem()))
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                 "'" << filename << "' was written for another grid view or another problem!");
+    return true;
+  } // ... read_header(...)
+
+  void assert_renumberable() const
+  {
+    assert_everything_is_ready();
+    if (!permutation_.empty())
+      DUNE_THROW(Stuff::Exceptions::you_are_using_this_wrong, "This discretization has already been renumbered!");
+    if (shared_matrix_)
+      DUNE_THROW(Stuff::Exceptions::you_are_using_this_wrong, "Do not renumber an attached discretization!");
+    if (this->test_space().mapper().size() != this->ansatz_space().mapper().size())
+      DUNE_THROW(NotImplemented, "Renumbering is only implemented for identical test and ansatz spaces!");
+  } // ... assert_renumberable(...)
+
+  /**
+   * \brief Permutes all containers, permutation[ii] being the new index of DoF ii, see renumber().
+   */
+  void apply_permutation(const std::vector< size_t >& permutation)
+  {
+    using namespace internal;
+    if (permutation.size() != pattern_->size())
+      DUNE_THROW(Stuff::Exceptions::shapes_do_not_match,
+                 "permutation.size() = " << permutation.size() << ", pattern_->size() = " << pattern_->size());
+    auto pattern = permute_pattern(*pattern_, permutation);
+    const auto permute_mat = [](const MatrixType& matrix,
+                                const PatternType& old_pattern,
+                                const PatternType& new_pattern,
+                                const std::vector< size_t >& perm) {
+      return permute_matrix(matrix, old_pattern, new_pattern, perm); };
+    const auto permute_vec = permute_vector< VectorType, PatternType >;
+    matrix_ = permute_affinely_decomposed(*matrix_, *pattern_, *pattern, permutation, permute_mat);
+    rhs_ = permute_affinely_decomposed(*rhs_, *pattern_, *pattern, permutation, permute_vec);
+    for (auto& element : products_)
+      element.second = permute_affinely_decomposed(*element.second, *pattern_, *pattern, permutation, permute_mat);
+    for (auto& element : vectors_)
+      element.second = permute_affinely_decomposed(*element.second, *pattern_, *pattern, permutation, permute_vec);
+    pattern_ = pattern;
+    permutation_ = permutation;
+    // cached solutions are given in the old numbering
+    this->cache_.clear();
+  } // ... apply_permutation(...)
+
+  void write_permutation(internal::BinaryWriter& writer) const
+  {
+    const std::vector< std::uint64_t > permutation(permutation_.begin(), permutation_.end());
+    writer.write(std::uint64_t(permutation.size()));
+    writer.write(permutation.data(), permutation.size()*sizeof(std::uint64_t));
+  }
+
+  static std::vector< size_t > read_permutation(internal::MappedReader& reader)
+  {
+    const size_t size = reader.read_uint();
+    std::vector< size_t > ret(size);
+    for (size_t ii = 0; ii < size; ++ii)
+      ret[ii] = reader.read_uint();
+    return ret;
+  }
+
   void finalize_init(const bool prune)
   {
     if (!container_based_initialized_) {
@@ -643,6 +1055,14 @@ protected:
     }
   } // ... finalize_init(...)
 
+  void assert_not_attached(const std::string caller) const
+  {
+    if (shared_matrix_)
+      DUNE_THROW(Stuff::Exceptions::you_are_using_this_wrong,
+                 "The system matrix of a discretization attached by attach_shared() is only available to solve(), "
+                 << "do not call " << caller << "()!");
+  } // ... assert_not_attached(...)
+
   void assert_everything_is_ready() const
   {
     if (!container_based_initialized_)
@@ -652,6 +1072,9 @@ protected:
                  << "The user has to call init() before calling any other method!");
   } // ... assert_everything_is_ready()
 
+  static constexpr char serialization_magic[8] = {'D', 'H', 'D', 'D', 'C', 'B', 'D', '\0'};
+  static const size_t serialization_version = 3;
+
   bool container_based_initialized_;
   bool purely_neumann_;
   std::shared_ptr< AffinelyDecomposedMatrixType > matrix_;
@@ -659,8 +1082,13 @@ protected:
   std::shared_ptr< PatternType > pattern_;
   mutable std::map< std::string, std::shared_ptr< AffinelyDecomposedMatrixType > > products_;
   mutable std::map< std::string, std::shared_ptr< AffinelyDecomposedVectorType > > vectors_;
+  std::shared_ptr< SharedMatrixType > shared_matrix_;
+  std::vector< size_t > permutation_;
 }; // class ContainerBasedDefault
 
+template< class ImpTraits >
+constexpr char ContainerBasedDefault< ImpTraits >::serialization_magic[8];
+
 
 } // namespace Discretizations
 } // namespace LinearElliptic
@@ -8,12 +8,16 @@
 
 #include <memory>
 #include <algorithm>
+#include <cassert>
 #include <vector>
 #include <map>
 #include <set>
 #include <cmath>
+#include <cstdint>
 #include <limits>
 #include <type_traits>
+#include <fstream>
+#include <string>
 
 #include <boost/numeric/conversion/cast.hpp>
 
@@ -68,6 +72,8 @@
 #include <dune/hdd/linearelliptic/problems/default.hh>
 #include <dune/hdd/linearelliptic/problems/zero-boundary.hh>
 
+#include "../vtk-collection.hh"
+#include "affine-diffusion.hh"
 #include "base.hh"
 #include "swipdg.hh"
 
@@ -142,6 +148,96 @@ protected:
 }; // class LocalDiscretizationsContainer
 
 
+/**
+ * \brief The DoFs of one subdomain within a global vector, i.e. the contiguous block [offset, offset + size).
+ *
+ *        Reads and writes go directly to the global vector, no local copy is made. The view is only valid as long as
+ *        the global vector is neither destroyed nor resized.
+ */
+template< class VectorImp >
+class SubdomainBlockView
+{
+public:
+  typedef VectorImp                                                  VectorType;
+  typedef typename std::remove_const< VectorType >::type::ScalarType ScalarType;
+
+  SubdomainBlockView(VectorType& global_vector, const size_t offset, const size_t sz)
+    : global_vector_(global_vector)
+    , offset_(offset)
+    , size_(sz)
+  {
+    assert(offset_ + size_ <= global_vector_.size());
+  }
+
+  size_t size() const
+  {
+    return size_;
+  }
+
+  size_t offset() const
+  {
+    return offset_;
+  }
+
+  ScalarType get_entry(const size_t ii) const
+  {
+    assert(ii < size_);
+    return global_vector_.get_entry(offset_ + ii);
+  }
+
+  void set_entry(const size_t ii, const ScalarType& value)
+  {
+    assert(ii < size_);
+    global_vector_.set_entry(offset_ + ii, value);
+  }
+
+  void add_to_entry(const size_t ii, const ScalarType& value)
+  {
+    assert(ii < size_);
+    global_vector_.add_to_entry(offset_ + ii, value);
+  }
+
+  template< class V >
+  void copy_to(Stuff::LA::VectorInterface< V >& local_vector) const
+  {
+    assert(local_vector.size() == size_);
+    for (size_t ii = 0; ii < size_; ++ii)
+      local_vector.set_entry(ii, global_vector_.get_entry(offset_ + ii));
+  }
+
+  template< class V >
+  void assign(const Stuff::LA::VectorInterface< V >& local_vector)
+  {
+    assert(local_vector.size() == size_);
+    for (size_t ii = 0; ii < size_; ++ii)
+      global_vector_.set_entry(offset_ + ii, local_vector.get_entry(ii));
+  }
+
+  template< class V >
+  void axpy(const ScalarType& alpha, const Stuff::LA::VectorInterface< V >& local_vector)
+  {
+    assert(local_vector.size() == size_);
+    for (size_t ii = 0; ii < size_; ++ii)
+      global_vector_.add_to_entry(offset_ + ii, alpha*local_vector.get_entry(ii));
+  }
+
+  template< class V >
+  ScalarType dot(const Stuff::LA::VectorInterface< V >& local_vector) const
+  {
+    assert(local_vector.size() == size_);
+    ScalarType ret = 0;
+    for (size_t ii = 0; ii < size_; ++ii)
+      ret += global_vector_.get_entry(offset_ + ii)*local_vector.get_entry(ii);
+    return ret;
+  }
+
+private:
+  VectorType& global_vector_;
+  const size_t offset_;
+  const size_t size_;
+}; // class SubdomainBlockView
+
+
 template< class GridImp, class RangeFieldImp, int rangeDim, int polynomialOrder, Stuff::LA::ChooseBackend la_backend >
 class BlockSWIPDGTraits
   : public ContainerBasedDefaultTraits< typename Stuff::LA::Container< RangeFieldImp, la_backend >::MatrixType,
@@ -234,18 +330,70 @@ public:
 
   void init(const bool prune = false);
 
+  /**
+   * \brief Renumbers the DoFs of each subdomain (see ContainerBasedDefault::renumber()), the blocks stay in place.
+   *
+   *        Each local discretization is renumbered by itself and the local and coupling containers are permuted
+   *        accordingly, so block_offset(), local_view(), localize_vector() and globalize_vectors() remain valid and
+   *        the localized vectors are given in the numbering of the local discretization (use its
+   *        to_space_numbering() to obtain the numbering of the local space).
+   */
+  void renumber(const std::string type = "rcm");
+
   ssize_t num_subdomains() const;
 
   std::vector< ssize_t > neighbouring_subdomains(const ssize_t ss) const;
 
+  /**
+   * \brief The first global DoF of subdomain ss, the DoFs of which are numbered contiguously.
+   */
+  size_t block_offset(const size_t ss) const;
+
+  /**
+   * \brief The DoFs of subdomain ss within the given global vector, without copying them (see
+   *        internal::SubdomainBlockView).
+   */
+  internal::SubdomainBlockView< VectorType > local_view(VectorType& global_vector, const size_t ss) const;
+
+  internal::SubdomainBlockView< const VectorType > local_view(const VectorType& global_vector, const size_t ss) const;
+
   VectorType localize_vector(const VectorType& global_vector, const size_t ss) const;
 
+  /**
+   * \brief Like localize_vector(), but writes into the given local_vector without allocating.
+   */
+  void localize_vector(const VectorType& global_vector, const size_t ss, VectorType& local_vector) const;
+
   VectorType globalize_vectors(const std::vector< VectorType >& local_vectors) const;
 
+  /**
+   * \brief Like globalize_vectors(), but writes into the given global_vector without allocating.
+   */
+  void globalize_vectors(const std::vector< VectorType >& local_vectors, VectorType& global_vector) const;
+
   VectorType* globalize_vectors_and_return_ptr(const std::vector< VectorType >& local_vectors) const;
 
   VectorType* localize_vector_and_return_ptr(const VectorType& global_vector, const ssize_t ss) const;
 
+  /**
+   * \brief Writes one piece per subdomain (filename_<ss>.vtu, each on the grid part of the local discretization,
+   *        zlib compressed if available), together with the collection filename.pvtu of all pieces.
+   * \note  The pieces are written concurrently on num_threads threads (0 meaning as many as the hardware supports),
+   *        but for the first one, see internal::write_vtu_pieces().
+   */
+  void visualize_subdomains(const VectorType& vector,
+                            const std::string filename,
+                            const std::string name,
+                            const size_t num_threads = 0) const;
+
+  /**
+   * \brief Like visualize_subdomains(), for one value per subdomain (e.g. local estimator indicators).
+   */
+  void visualize_subdomain_indicators(const std::vector< RangeFieldType >& indicators,
+                                      const std::string filename,
+                                      const std::string name,
+                                      const size_t num_threads = 0) const;
+
   ProductType get_local_product(const size_t ss, const std::string id) const;
 
   ProductType* get_local_product_and_return_ptr(const ssize_t ss, const std::string id) const;
@@ -468,6 +616,16 @@ private:
     std::vector< LocalCodim1MatrixAssemblerApplication* > localCodim1MatrixAssemblers_;
   }; // class CouplingAssembler
 
+  friend class ContainerBasedDefault< Traits >;
+
+  /**
+   * \brief Writes the local discretizations, the local and the coupling containers (see
+   *        ContainerBasedDefault::write_additional_data()).
+   */
+  void write_additional_data(internal::BinaryWriter& writer) const;
+
+  void read_additional_data(internal::MappedReader& reader);
+
   void add_local_to_global_pattern(const PatternType& local,
                                    const size_t test_subdomain,
                                    const size_t ansatz_subdomain,
@@ -495,6 +653,8 @@ private:
     }
   } // ... copy_local_to_global_matrix(...)
 
+  void check_global_vector(const VectorType& global_vector, const size_t ss) const;
+
   void copy_local_to_global_vector(const AffinelyDecomposedConstVectorType& local_vector,
                                    const size_t subdomain,
                                    AffinelyDecomposedVectorType& global_vector) const;
@@ -504,10 +664,11 @@ private:
                                    const size_t subdomain,
                                    Stuff::LA::VectorInterface< VG >& global_vector) const
   {
-    for (size_t local_ii = 0; local_ii < local_vector.size(); ++local_ii) {
-      const size_t global_ii = this->test_space().mapper().mapToGlobal(subdomain, local_ii);
-      global_vector.add_to_entry(global_ii, local_vector.get_entry(local_ii));
-    }
+    // test and ansatz spaces coincide, so the DoFs of the subdomain are the block given by block_offsets_
+    assert(local_vector.size() == block_offsets_[subdomain + 1] - block_offsets_[subdomain]);
+    internal::SubdomainBlockView< typename VG::derived_type >(global_vector.as_imp(),
+                                                              block_offsets_[subdomain],
+                                                              local_vector.size()).axpy(1, local_vector);
   } // ... copy_local_to_global_vector(...)
 
   void assemble_boundary_contributions(const size_t subdomain) const;
@@ -525,6 +686,19 @@ private:
 
   void build_global_containers();
 
+  /**
+   * \brief The containers of the given matrix in the order of affine_diffusion_.terms().
+   */
+  std::vector< MatrixType* > term_matrices(AffinelyDecomposedMatrixType& matrix) const
+  {
+    std::vector< MatrixType* > ret;
+    for (size_t qq = 0; qq < affine_diffusion_.num_components(); ++qq)
+      ret.push_back(matrix.component(qq).get());
+    if (affine_diffusion_.has_affine_part())
+      ret.push_back(matrix.affine_part().get());
+    return ret;
+  } // ... term_matrices(...)
+
   template< class AffinelyDecomposedContainerType >
   ssize_t find_component(const AffinelyDecomposedContainerType& container,
                          const Pymor::ParameterFunctional& coefficient) const
@@ -538,6 +712,7 @@ private:
   const GridProviderType& grid_provider_;
   std::shared_ptr< const MsGridType > ms_grid_;
   const std::vector< std::string > only_these_products_;
+  const internal::AffineDiffusion< ProblemType > affine_diffusion_;
   using BaseType::pattern_;
   std::vector< std::shared_ptr< AffinelyDecomposedMatrixType > > local_matrices_;
   std::vector< std::shared_ptr< AffinelyDecomposedVectorType > > local_vectors_;
@@ -545,6 +720,7 @@ private:
   std::vector< std::map< size_t, std::shared_ptr< PatternType > > > outside_inside_patterns_;
   std::vector< std::map< size_t, std::shared_ptr< AffinelyDecomposedMatrixType > > > inside_outside_matrices_;
   std::vector< std::map< size_t, std::shared_ptr< AffinelyDecomposedMatrixType > > > outside_inside_matrices_;
+  std::vector< size_t > block_offsets_;
 }; // BlockSWIPDG
 
 
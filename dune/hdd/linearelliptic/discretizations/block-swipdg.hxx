@@ -35,18 +35,33 @@ BlockSWIPDG(const typename BlockSWIPDG< G, R, r, p, la >::GridProviderType& grid
   , grid_provider_(grid_provider)
   , ms_grid_(grid_provider.ms_grid())
   , only_these_products_(only_these_products)
+  , affine_diffusion_(this->problem())
   , local_matrices_(ms_grid_->size())
   , local_vectors_(ms_grid_->size())
   , inside_outside_patterns_(ms_grid_->size())
   , outside_inside_patterns_(ms_grid_->size())
   , inside_outside_matrices_(ms_grid_->size())
   , outside_inside_matrices_(ms_grid_->size())
+  , block_offsets_(ms_grid_->size() + 1, 0)
 {
-  // in case of parametric diffusion tensor everything is too complicated
-  if (this->problem_.diffusion_tensor()->parametric())
-    DUNE_THROW(NotImplemented, "The diffusion tensor must not be parametric!");
-  if (!this->problem_.diffusion_tensor()->has_affine_part())
+  // a parametric diffusion tensor is handled by internal::AffineDiffusion
+  if (!this->problem_.diffusion_tensor()->parametric() && !this->problem_.diffusion_tensor()->has_affine_part())
     DUNE_THROW(Stuff::Exceptions::wrong_input_given, "The diffusion tensor must not be empty!");
+  // the block space numbers the DoFs subdomain by subdomain, which localize_vector(), globalize_vectors() and
+  // local_view() rely on
+  const auto& mapper = this->ansatz_space().mapper();
+  for (size_t ss = 0; ss < ms_grid_->size(); ++ss) {
+    const size_t local_size = this->local_ansatz_spaces_[ss]->mapper().size();
+    block_offsets_[ss + 1] = block_offsets_[ss] + local_size;
+    for (size_t ii = 0; ii < local_size; ++ii)
+      if (mapper.mapToGlobal(ss, ii) != block_offsets_[ss] + ii)
+        DUNE_THROW(Stuff::Exceptions::internal_error,
+                   "The DoFs of subdomain " << ss << " are not numbered contiguously!");
+  }
+  if (block_offsets_[ms_grid_->size()] != mapper.size())
+    DUNE_THROW(Stuff::Exceptions::internal_error,
+               "The subdomain blocks (" << block_offsets_[ms_grid_->size()] << " DoFs) do not cover the ansatz space ("
+               << mapper.size() << " DoFs)!");
 } // BlockSWIPDG(...)
 
 template< class G, class R, int r, int p, Stuff::LA::ChooseBackend la >
@@ -83,19 +98,21 @@ init(const bool prune)
     local_matrices_[ss] = std::make_shared< AffinelyDecomposedMatrixType >();
     //   * we take the affine part only if the diffusion has one, otherwise it contains only the dirichlet rows,
     //     thus it is empty, since the local problems are purely neumann
-    if (this->problem().diffusion_factor()->has_affine_part()) {
+    if (affine_diffusion_.has_affine_part()) {
       if (!local_operator.has_affine_part())
         DUNE_THROW(Stuff::Exceptions::internal_error, "The local operator is missing the affine part!");
       local_matrices_[ss]->register_affine_part(new MatrixType(*(local_operator.affine_part().container())));
     }
-    if (local_operator.num_components() < this->problem().diffusion_factor()->num_components())
+    //   * the local discretizations register one component per term of the diffusion, in the same order
+    const auto& diffusion_terms = affine_diffusion_.terms();
+    if (local_operator.num_components() < boost::numeric_cast< ssize_t >(affine_diffusion_.num_components()))
       DUNE_THROW(Stuff::Exceptions::requirements_not_met,
-                 "The local operator should have " << this->problem().diffusion_factor()->num_components()
+                 "The local operator should have " << affine_diffusion_.num_components()
                  << " components (but has only " << local_operator.num_components() << ")!");
-    for (ssize_t qq = 0; qq < this->problem().diffusion_factor()->num_components(); ++qq) {
+    for (size_t qq = 0; qq < affine_diffusion_.num_components(); ++qq) {
       local_matrices_[ss]->register_component(new MatrixType(
           local_operator.component(qq).container()->backend()),
-          this->problem().diffusion_factor()->coefficient(qq));
+          diffusion_terms[qq].coefficient);
     }
     // * and the vectors
     const auto local_functional = this->local_discretizations_[ss]->get_rhs();
@@ -159,23 +176,24 @@ init(const bool prune)
         // create the coupling matrices
         auto inside_outside_matrix = std::make_shared< AffinelyDecomposedMatrixType >();
         auto outside_inside_matrix = std::make_shared< AffinelyDecomposedMatrixType >();
-        if (this->problem().diffusion_factor()->has_affine_part()) {
-          inside_outside_matrix->register_affine_part(new MatrixType(inner_test_mapper.size(),
+        for (const auto& term : affine_diffusion_.terms()) {
+          if (term.coefficient) {
+            inside_outside_matrix->register_component(new MatrixType(inner_test_mapper.size(),
                                                                      outer_ansatz_mapper.size(),
-                                                                     inside_outside_pattern));
-          outside_inside_matrix->register_affine_part(new MatrixType(outer_test_mapper.size(),
+                                                                     inside_outside_pattern),
+                                                      term.coefficient);
+            outside_inside_matrix->register_component(new MatrixType(outer_test_mapper.size(),
                                                                      inner_ansatz_mapper.size(),
-                                                                     outside_inside_pattern));
-        }
-        for (ssize_t qq = 0; qq < this->problem().diffusion_factor()->num_components(); ++qq) {
-          inside_outside_matrix->register_component(new MatrixType(inner_test_mapper.size(),
-                                                                   outer_ansatz_mapper.size(),
-                                                                   inside_outside_pattern),
-                                                    this->problem().diffusion_factor()->coefficient(qq));
-          outside_inside_matrix->register_component(new MatrixType(outer_test_mapper.size(),
-                                                                   inner_ansatz_mapper.size(),
-                                                                   outside_inside_pattern),
-                                                    this->problem().diffusion_factor()->coefficient(qq));
+                                                                     outside_inside_pattern),
+                                                      term.coefficient);
+          } else {
+            inside_outside_matrix->register_affine_part(new MatrixType(inner_test_mapper.size(),
+                                                                       outer_ansatz_mapper.size(),
+                                                                       inside_outside_pattern));
+            outside_inside_matrix->register_affine_part(new MatrixType(outer_test_mapper.size(),
+                                                                       inner_ansatz_mapper.size(),
+                                                                       outside_inside_pattern));
+          }
         }
         // and assemble them
         assemble_coupling_contributions(ss, nn,
@@ -202,6 +220,141 @@ init(const bool prune)
   logger.info() << "finished!" << std::endl;
 } // ... init(...)
 
+template< class G, class R, int r, int p, Stuff::LA::ChooseBackend la >
+    void BlockSWIPDG< G, R, r, p, la >::
+write_additional_data(internal::BinaryWriter& writer) const
+{
+  using namespace internal;
+  const auto write_matrix = write_container< MatrixType, PatternType >;
+  const auto write_vec = write_vector< VectorType, PatternType >;
+  const auto write_couplings = [&](const std::map< size_t, std::shared_ptr< PatternType > >& patterns,
+                                   const std::map< size_t, std::shared_ptr< AffinelyDecomposedMatrixType > >& matrices) {
+    writer.write(std::uint64_t(patterns.size()));
+    for (const auto& element : patterns) {
+      writer.write(std::uint64_t(element.first));
+      write_pattern(writer, *element.second);
+      write_affinely_decomposed(writer, *(matrices.at(element.first)), *element.second, write_matrix);
+    }
+  };
+  writer.write(std::uint64_t(ms_grid_->size()));
+  for (size_t ss = 0; ss < ms_grid_->size(); ++ss) {
+    const auto& local_discretization = *(this->local_discretizations_[ss]);
+    writer.write(std::uint64_t(local_discretization.grid_view().indexSet().size(0)));
+    local_discretization.write_containers(writer);
+    write_affinely_decomposed(writer, *local_matrices_[ss], local_discretization.pattern(), write_matrix);
+    write_affinely_decomposed(writer, *local_vectors_[ss], local_discretization.pattern(), write_vec);
+    write_couplings(inside_outside_patterns_[ss], inside_outside_matrices_[ss]);
+    write_couplings(outside_inside_patterns_[ss], outside_inside_matrices_[ss]);
+  }
+} // ... write_additional_data(...)
+
+template< class G, class R, int r, int p, Stuff::LA::ChooseBackend la >
+    void BlockSWIPDG< G, R, r, p, la >::
+read_additional_data(internal::MappedReader& reader)
+{
+  using namespace internal;
+  const auto read_mat = read_matrix< MatrixType, PatternType >;
+  const auto read_vec = read_vector< VectorType, PatternType >;
+  const auto read_couplings = [&](std::map< size_t, std::shared_ptr< PatternType > >& patterns,
+                                  std::map< size_t, std::shared_ptr< AffinelyDecomposedMatrixType > >& matrices) {
+    const size_t num_couplings = reader.read_uint();
+    for (size_t ii = 0; ii < num_couplings; ++ii) {
+      const size_t nn = reader.read_uint();
+      if (nn >= ms_grid_->size())
+        DUNE_THROW(Stuff::Exceptions::wrong_input_given, "The stored couplings do not match the subdomains!");
+      const auto pattern = read_pattern< PatternType >(reader);
+      patterns.insert(std::make_pair(nn, pattern));
+      matrices.insert(std::make_pair(nn, read_affinely_decomposed< MatrixType >(reader, *pattern, read_mat)));
+    }
+  };
+  const size_t subdomains = ms_grid_->size();
+  if (reader.read_uint() != subdomains)
+    DUNE_THROW(Stuff::Exceptions::wrong_input_given, "The stored discretization has another number of subdomains!");
+  std::vector< std::shared_ptr< AffinelyDecomposedMatrixType > > local_matrices(subdomains);
+  std::vector< std::shared_ptr< AffinelyDecomposedVectorType > > local_vectors(subdomains);
+  std::vector< std::map< size_t, std::shared_ptr< PatternType > > > inside_outside_patterns(subdomains);
+  std::vector< std::map< size_t, std::shared_ptr< PatternType > > > outside_inside_patterns(subdomains);
+  std::vector< std::map< size_t, std::shared_ptr< AffinelyDecomposedMatrixType > > > inside_outside_matrices(subdomains);
+  std::vector< std::map< size_t, std::shared_ptr< AffinelyDecomposedMatrixType > > > outside_inside_matrices(subdomains);
+  for (size_t ss = 0; ss < subdomains; ++ss) {
+    auto& local_discretization = *(this->local_discretizations_[ss]);
+    if (reader.read_uint() != local_discretization.grid_view().indexSet().size(0))
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                 "The stored subdomain " << ss << " does not match the one of this discretization!");
+    local_discretization.read_containers(reader);
+    local_matrices[ss] = read_affinely_decomposed< MatrixType >(reader, local_discretization.pattern(), read_mat);
+    local_vectors[ss] = read_affinely_decomposed< VectorType >(reader, local_discretization.pattern(), read_vec);
+    read_couplings(inside_outside_patterns[ss], inside_outside_matrices[ss]);
+    read_couplings(outside_inside_patterns[ss], outside_inside_matrices[ss]);
+  }
+  local_matrices_ = local_matrices;
+  local_vectors_ = local_vectors;
+  inside_outside_patterns_ = inside_outside_patterns;
+  outside_inside_patterns_ = outside_inside_patterns;
+  inside_outside_matrices_ = inside_outside_matrices;
+  outside_inside_matrices_ = outside_inside_matrices;
+} // ... read_additional_data(...)
+
+template< class G, class R, int r, int p, Stuff::LA::ChooseBackend la >
+    void BlockSWIPDG< G, R, r, p, la >::
+renumber(const std::string type)
+{
+  using namespace internal;
+  this->assert_renumberable();
+  auto logger = Stuff::Common::TimedLogger().get("hdd.linearelliptic.discretizations.block-swipdg.renumber");
+  logger.info() << "renumbering " << ms_grid_->size() << " subdomains (" << type << ")... " << std::endl;
+  const size_t subdomains = ms_grid_->size();
+  // renumber each subdomain on its own, the global permutation thus keeps the blocks (and block_offsets_) in place
+  std::vector< std::shared_ptr< PatternType > > old_local_patterns(subdomains);
+  for (size_t ss = 0; ss < subdomains; ++ss) {
+    auto& local_discretization = *(this->local_discretizations_[ss]);
+    old_local_patterns[ss] = std::make_shared< PatternType >(local_discretization.pattern());
+    local_discretization.renumber(type);
+  }
+  const auto local_permutation = [&](const size_t ss) -> const std::vector< size_t >& {
+    return this->local_discretizations_[ss]->permutation();
+  };
+  std::vector< size_t > permutation(block_offsets_[subdomains]);
+  for (size_t ss = 0; ss < subdomains; ++ss)
+    for (size_t ii = 0; ii < local_permutation(ss).size(); ++ii)
+      permutation[block_offsets_[ss] + ii] = block_offsets_[ss] + local_permutation(ss)[ii];
+  // the local and coupling containers, the rows of the latter belong to ss, the columns to nn
+  const auto permute_vec = permute_vector< VectorType, PatternType >;
+  const auto permute_couplings = [&](const size_t ss,
+                                     std::map< size_t, std::shared_ptr< PatternType > >& patterns,
+                                     std::map< size_t, std::shared_ptr< AffinelyDecomposedMatrixType > >& matrices) {
+    for (auto& element : patterns) {
+      const size_t nn = element.first;
+      const auto& col_permutation = local_permutation(nn);
+      const auto pattern = permute_pattern(*element.second, local_permutation(ss), col_permutation);
+      matrices[nn] = permute_affinely_decomposed(*matrices.at(nn), *element.second, *pattern, local_permutation(ss),
+                                                 [&](const MatrixType& matrix,
+                                                     const PatternType& old_pattern,
+                                                     const PatternType& new_pattern,
+                                                     const std::vector< size_t >& row_permutation) {
+        return permute_matrix(matrix, old_pattern, new_pattern, row_permutation, col_permutation); });
+      element.second = pattern;
+    }
+  };
+  for (size_t ss = 0; ss < subdomains; ++ss) {
+    const auto& old_pattern = *old_local_patterns[ss];
+    const auto& new_pattern = this->local_discretizations_[ss]->pattern();
+    local_matrices_[ss] = permute_affinely_decomposed(*local_matrices_[ss], old_pattern, new_pattern,
+                                                      local_permutation(ss),
+                                                      [](const MatrixType& matrix,
+                                                         const PatternType& old_p,
+                                                         const PatternType& new_p,
+                                                         const std::vector< size_t >& perm) {
+      return permute_matrix(matrix, old_p, new_p, perm); });
+    local_vectors_[ss] = permute_affinely_decomposed(*local_vectors_[ss], old_pattern, new_pattern,
+                                                     local_permutation(ss), permute_vec);
+    permute_couplings(ss, inside_outside_patterns_[ss], inside_outside_matrices_[ss]);
+    permute_couplings(ss, outside_inside_patterns_[ss], outside_inside_matrices_[ss]);
+  }
+  // and the global containers
+  this->apply_permutation(permutation);
+} // ... renumber(...)
+
 template< class G, class R, int r, int p, Stuff::LA::ChooseBackend la >
     ssize_t BlockSWIPDG< G, R, r, p, la >::
 num_subdomains() const
@@ -221,43 +374,102 @@ neighbouring_subdomains(const ssize_t ss) const
 }
 
 template< class G, class R, int r, int p, Stuff::LA::ChooseBackend la >
-    typename BlockSWIPDG< G, R, r, p, la >::VectorType BlockSWIPDG< G, R, r, p, la >::
-localize_vector(const typename BlockSWIPDG< G, R, r, p, la >::VectorType& global_vector, const size_t ss) const
+    void BlockSWIPDG< G, R, r, p, la >::
+check_global_vector(const typename BlockSWIPDG< G, R, r, p, la >::VectorType& global_vector, const size_t ss) const
 {
   if ((std::make_signed< size_t >::type)(ss) >= num_subdomains())
     DUNE_THROW(Stuff::Exceptions::index_out_of_range,
                "0 <= ss < num_subdomains() = " << num_subdomains() << " is not true for ss = " << ss << "!");
   if (global_vector.size() != this->ansatz_space().mapper().size())
     DUNE_THROW(Stuff::Exceptions::index_out_of_range,
-               "The size() of global_vector (" << global_vector.dim()
+               "The size() of global_vector (" << global_vector.size()
                << ") does not match the size() of the ansatz space (" << this->ansatz_space().mapper().size() << ")!");
+} // ... check_global_vector(...)
+
+template< class G, class R, int r, int p, Stuff::LA::ChooseBackend la >
+    size_t BlockSWIPDG< G, R, r, p, la >::
+block_offset(const size_t ss) const
+{
+  if ((std::make_signed< size_t >::type)(ss) >= num_subdomains())
+    DUNE_THROW(Stuff::Exceptions::index_out_of_range,
+               "0 <= ss < num_subdomains() = " << num_subdomains() << " is not true for ss = " << ss << "!");
+  return block_offsets_[ss];
+}
+
+template< class G, class R, int r, int p, Stuff::LA::ChooseBackend la >
+    internal::SubdomainBlockView< typename BlockSWIPDG< G, R, r, p, la >::VectorType > BlockSWIPDG< G, R, r, p, la >::
+local_view(typename BlockSWIPDG< G, R, r, p, la >::VectorType& global_vector, const size_t ss) const
+{
+  check_global_vector(global_vector, ss);
+  return internal::SubdomainBlockView< VectorType >(global_vector,
+                                                    block_offsets_[ss],
+                                                    block_offsets_[ss + 1] - block_offsets_[ss]);
+}
+
+template< class G, class R, int r, int p, Stuff::LA::ChooseBackend la >
+    internal::SubdomainBlockView< const typename BlockSWIPDG< G, R, r, p, la >::VectorType >
+    BlockSWIPDG< G, R, r, p, la >::
+local_view(const typename BlockSWIPDG< G, R, r, p, la >::VectorType& global_vector, const size_t ss) const
+{
+  check_global_vector(global_vector, ss);
+  return internal::SubdomainBlockView< const VectorType >(global_vector,
+                                                          block_offsets_[ss],
+                                                          block_offsets_[ss + 1] - block_offsets_[ss]);
+}
+
+template< class G, class R, int r, int p, Stuff::LA::ChooseBackend la >
+    typename BlockSWIPDG< G, R, r, p, la >::VectorType BlockSWIPDG< G, R, r, p, la >::
+localize_vector(const typename BlockSWIPDG< G, R, r, p, la >::VectorType& global_vector, const size_t ss) const
+{
+  check_global_vector(global_vector, ss);
   assert(ss < this->local_discretizations_.size());
   VectorType local_vector = this->local_discretizations_[ss]->create_vector();
-  for (size_t ii = 0; ii < local_vector.size(); ++ii)
-    local_vector.set_entry(ii, global_vector.get_entry(this->ansatz_space().mapper().mapToGlobal(ss, ii)));
+  local_view(global_vector, ss).copy_to(local_vector);
   return local_vector;
 } // ... localize_vetor(...)
 
+template< class G, class R, int r, int p, Stuff::LA::ChooseBackend la >
+    void BlockSWIPDG< G, R, r, p, la >::
+localize_vector(const typename BlockSWIPDG< G, R, r, p, la >::VectorType& global_vector,
+                const size_t ss,
+                typename BlockSWIPDG< G, R, r, p, la >::VectorType& local_vector) const
+{
+  const auto view = local_view(global_vector, ss);
+  if (local_vector.size() != view.size())
+    DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+               "The size() of local_vector (" << local_vector.size() << ") does not match the number of DoFs of "
+               << "subdomain " << ss << " (" << view.size() << ")!");
+  view.copy_to(local_vector);
+} // ... localize_vetor(...)
+
 template< class G, class R, int r, int p, Stuff::LA::ChooseBackend la >
     typename BlockSWIPDG< G, R, r, p, la >::VectorType BlockSWIPDG< G, R, r, p, la >::
 globalize_vectors(const std::vector< typename BlockSWIPDG< G, R, r, p, la >::VectorType >& local_vectors) const
+{
+  VectorType ret(this->ansatz_space().mapper().size());
+  globalize_vectors(local_vectors, ret);
+  return ret;
+}
+
+template< class G, class R, int r, int p, Stuff::LA::ChooseBackend la >
+    void BlockSWIPDG< G, R, r, p, la >::
+globalize_vectors(const std::vector< typename BlockSWIPDG< G, R, r, p, la >::VectorType >& local_vectors,
+                  typename BlockSWIPDG< G, R, r, p, la >::VectorType& global_vector) const
 {
   if (local_vectors.size() != boost::numeric_cast< size_t >(num_subdomains()))
     DUNE_THROW(Stuff::Exceptions::wrong_input_given,
                "Given local_vectors has wrong size (is " << local_vectors.size() << ", should be "
                << num_subdomains() << ")!");
-  VectorType ret(this->ansatz_space().mapper().size());
   for (size_t ss = 0; ss < boost::numeric_cast< size_t >(num_subdomains()); ++ss) {
     const auto& local_vector = local_vectors[ss];
-    if (local_vector.size() != this->local_discretizations_[ss]->ansatz_space().mapper().size())
+    auto view = local_view(global_vector, ss);
+    if (local_vector.size() != view.size())
       DUNE_THROW(Stuff::Exceptions::wrong_input_given,
                  "Given local_vectors[" << ss << "] has wrong size (is "
-                 << local_vector.size() << ", should be "
-                 << this->local_discretizations_[ss]->ansatz_space().mapper().size() << ")!");
-    copy_local_to_global_vector(local_vector, ss, ret);
+                 << local_vector.size() << ", should be " << view.size() << ")!");
+    view.assign(local_vector);
   }
-  return ret;
-}
+} // ... globalize_vectors(...)
 
 template< class G, class R, int r, int p, Stuff::LA::ChooseBackend la >
     typename BlockSWIPDG< G, R, r, p, la >::VectorType* BlockSWIPDG< G, R, r, p, la >::
@@ -274,6 +486,62 @@ localize_vector_and_return_ptr(const typename BlockSWIPDG< G, R, r, p, la >::Vec
   return new VectorType(localize_vector(global_vector, boost::numeric_cast< size_t >(ss)));
 }
 
+template< class G, class R, int r, int p, Stuff::LA::ChooseBackend la >
+    void BlockSWIPDG< G, R, r, p, la >::
+visualize_subdomains(const typename BlockSWIPDG< G, R, r, p, la >::VectorType& vector,
+                     const std::string filename,
+                     const std::string name,
+                     const size_t num_threads) const
+{
+  if (vector.size() != this->ansatz_space().mapper().size())
+    DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+               "The size() of vector (" << vector.size() << ") does not match the size() of the ansatz space ("
+               << this->ansatz_space().mapper().size() << ")!");
+  LinearElliptic::internal::write_vtu_pieces(filename,
+                                             ms_grid_->size(),
+                                             this->grid_view().indexSet().types(0).size() == 1,
+                                             num_threads,
+                                             [&](const size_t ss, const std::string& piece) {
+    // the local spaces expect their own numbering (see renumber()), which is applied while copying out of the view
+    const auto& local_discretization = *(local_discretizations_[ss]);
+    const auto& permutation = local_discretization.permutation();
+    const auto view = local_view(vector, ss);
+    VectorType local_vector = local_discretization.create_vector();
+    for (size_t ii = 0; ii < view.size(); ++ii)
+      local_vector.set_entry(ii, view.get_entry(permutation.empty() ? ii : permutation[ii]));
+    GDT::ConstDiscreteFunction< typename LocalDiscretizationType::AnsatzSpaceType, VectorType >(
+          local_discretization.ansatz_space(), local_vector, name).visualize(piece);
+  });
+} // ... visualize_subdomains(...)
+
+template< class G, class R, int r, int p, Stuff::LA::ChooseBackend la >
+    void BlockSWIPDG< G, R, r, p, la >::
+visualize_subdomain_indicators(const std::vector< typename BlockSWIPDG< G, R, r, p, la >::RangeFieldType >& indicators,
+                               const std::string filename,
+                               const std::string name,
+                               const size_t num_threads) const
+{
+  if (indicators.size() != ms_grid_->size())
+    DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+               "Given indicators has wrong size (is " << indicators.size() << ", should be " << ms_grid_->size()
+               << ")!");
+  typedef Stuff::Functions::Constant< EntityType, DomainFieldType, dimDomain, RangeFieldType, dimRange >
+      ConstantFunctionType;
+  LinearElliptic::internal::write_vtu_pieces(filename,
+                                             ms_grid_->size(),
+                                             this->grid_view().indexSet().types(0).size() == 1,
+                                             num_threads,
+                                             [&](const size_t ss, const std::string& piece) {
+    const auto& local_discretization = *(this->local_discretizations_[ss]);
+    GDT::DiscreteFunction< typename LocalDiscretizationType::AnsatzSpaceType, VectorType >
+        local_function(local_discretization.ansatz_space(), name);
+    const GDT::Operators::Projection< typename LocalDiscretizationType::GridViewType >
+        projection_operator(local_discretization.grid_view());
+    projection_operator.apply(ConstantFunctionType(indicators[ss]), local_function);
+    local_function.visualize(piece);
+  });
+} // ... visualize_subdomain_indicators(...)
+
 template< class G, class R, int r, int p, Stuff::LA::ChooseBackend la >
     typename BlockSWIPDG< G, R, r, p, la >::ProductType BlockSWIPDG< G, R, r, p, la >::
 get_local_product(const size_t ss, const std::string id) const
@@ -640,28 +908,31 @@ assemble_boundary_contributions(const size_t subdomain) const
   typedef typename ProblemType::DiffusionFactorType::NonparametricType DiffusionFactorType;
   typedef typename ProblemType::DiffusionTensorType::NonparametricType DiffusionTensorType;
   const auto& diffusion_tensor = *(this->problem().diffusion_tensor());
-  assert(!diffusion_tensor.parametric());
-  assert(diffusion_tensor.has_affine_part());
   typedef GDT::LocalOperator::Codim1BoundaryIntegral< GDT::LocalEvaluation::SWIPDG::BoundaryLHS< DiffusionFactorType, DiffusionTensorType > >
       DirichletOperatorType;
   typedef GDT::LocalAssembler::Codim1BoundaryMatrix< DirichletOperatorType > DirichletMatrixAssemblerType;
   std::vector< std::unique_ptr< DirichletOperatorType > > dirichlet_operators;
   std::vector< std::unique_ptr< DirichletMatrixAssemblerType > > dirichlet_matrix_assemblers;
-  for (ssize_t qq = 0; qq < this->problem().diffusion_factor()->num_components(); ++qq) {
-    dirichlet_operators.emplace_back(new DirichletOperatorType(*(this->problem().diffusion_factor()->component(qq)),
-                                                               *(diffusion_tensor.affine_part())));
-    dirichlet_matrix_assemblers.emplace_back(new DirichletMatrixAssemblerType(*dirichlet_operators.back()));
-    boundary_assembler.add(*dirichlet_matrix_assemblers.back(),
-                           *(local_matrix.component(qq)),
-                           new Stuff::Grid::ApplyOn::DirichletIntersections< BoundaryGridPartType >(this->boundary_info()));
-  }
-  if (this->problem().diffusion_factor()->has_affine_part()) {
-    dirichlet_operators.emplace_back(new DirichletOperatorType(*(this->problem().diffusion_factor()->affine_part()),
-                                                               *(diffusion_tensor.affine_part())));
-    dirichlet_matrix_assemblers.emplace_back(new DirichletMatrixAssemblerType(*dirichlet_operators.back()));
-    boundary_assembler.add(*dirichlet_matrix_assemblers.back(),
-                           *(local_matrix.affine_part()),
-                           new Stuff::Grid::ApplyOn::DirichletIntersections< BoundaryGridPartType >(this->boundary_info()));
+  if (diffusion_tensor.parametric())
+    affine_diffusion_.add_dirichlet(boundary_assembler, this->boundary_info(), term_matrices(local_matrix));
+  else {
+    assert(diffusion_tensor.has_affine_part());
+    for (ssize_t qq = 0; qq < this->problem().diffusion_factor()->num_components(); ++qq) {
+      dirichlet_operators.emplace_back(new DirichletOperatorType(*(this->problem().diffusion_factor()->component(qq)),
+                                                                 *(diffusion_tensor.affine_part())));
+      dirichlet_matrix_assemblers.emplace_back(new DirichletMatrixAssemblerType(*dirichlet_operators.back()));
+      boundary_assembler.add(*dirichlet_matrix_assemblers.back(),
+                             *(local_matrix.component(qq)),
+                             new Stuff::Grid::ApplyOn::DirichletIntersections< BoundaryGridPartType >(this->boundary_info()));
+    }
+    if (this->problem().diffusion_factor()->has_affine_part()) {
+      dirichlet_operators.emplace_back(new DirichletOperatorType(*(this->problem().diffusion_factor()->affine_part()),
+                                                                 *(diffusion_tensor.affine_part())));
+      dirichlet_matrix_assemblers.emplace_back(new DirichletMatrixAssemblerType(*dirichlet_operators.back()));
+      boundary_assembler.add(*dirichlet_matrix_assemblers.back(),
+                             *(local_matrix.affine_part()),
+                             new Stuff::Grid::ApplyOn::DirichletIntersections< BoundaryGridPartType >(this->boundary_info()));
+    }
   }
 
   // rhs
@@ -697,43 +968,55 @@ assemble_boundary_contributions(const size_t subdomain) const
   std::vector< std::unique_ptr< DirichletFunctionalType > > dirichlet_functionals;
   std::vector< std::unique_ptr< DirichletVectorAssemblerType > > dirichlet_vector_assemblers;
   size_t component_index = this->problem().force()->num_components() + this->problem().neumann()->num_components();
-  if (this->problem().diffusion_factor()->has_affine_part()) {
-    for (ssize_t qq = 0; qq < this->problem().dirichlet()->num_components(); ++qq) {
-      dirichlet_functionals.emplace_back(new DirichletFunctionalType(*(this->problem().diffusion_factor()->affine_part()),
-                                                                     *(diffusion_tensor.affine_part()),
-                                                                     *(this->problem().dirichlet()->component(qq))));
-      dirichlet_vector_assemblers.emplace_back(new DirichletVectorAssemblerType(*(
-          dirichlet_functionals[dirichlet_functionals.size() - 1])));
-      boundary_assembler.add(*(dirichlet_vector_assemblers[dirichlet_vector_assemblers.size() - 1]),
-                             *(local_vector.component(component_index)),
-                             new Stuff::Grid::ApplyOn::DirichletIntersections< BoundaryGridPartType >(this->boundary_info()));
-      ++component_index;
+  if (diffusion_tensor.parametric()) {
+    // the local discretizations register one component per dirichlet term, in the same order
+    std::vector< VectorType* > dirichlet_vectors;
+    for (const auto& term : affine_diffusion_.dirichlet_terms()) {
+      if (term.coefficient)
+        dirichlet_vectors.push_back(local_vector.component(component_index++).get());
+      else
+        dirichlet_vectors.push_back(local_vector.affine_part().get());
     }
-  }
-  if (this->problem().dirichlet()->has_affine_part()) {
-    for (ssize_t qq = 0; qq < this->problem().diffusion_factor()->num_components(); ++qq) {
-      dirichlet_functionals.emplace_back(new DirichletFunctionalType(*(this->problem().diffusion_factor()->component(qq)),
-                                                                     *(diffusion_tensor.affine_part()),
-                                                                     *(this->problem().dirichlet()->affine_part())));
-      dirichlet_vector_assemblers.emplace_back(new DirichletVectorAssemblerType(*(
-          dirichlet_functionals[dirichlet_functionals.size() - 1])));
-      boundary_assembler.add(*(dirichlet_vector_assemblers[dirichlet_vector_assemblers.size() - 1]),
-                             *(local_vector.component(component_index)),
-                             new Stuff::Grid::ApplyOn::DirichletIntersections< BoundaryGridPartType >(this->boundary_info()));
-      ++component_index;
+    affine_diffusion_.add_dirichlet_rhs(boundary_assembler, this->boundary_info(), dirichlet_vectors);
+  } else {
+    if (this->problem().diffusion_factor()->has_affine_part()) {
+      for (ssize_t qq = 0; qq < this->problem().dirichlet()->num_components(); ++qq) {
+        dirichlet_functionals.emplace_back(new DirichletFunctionalType(*(this->problem().diffusion_factor()->affine_part()),
+                                                                       *(diffusion_tensor.affine_part()),
+                                                                       *(this->problem().dirichlet()->component(qq))));
+        dirichlet_vector_assemblers.emplace_back(new DirichletVectorAssemblerType(*(
+            dirichlet_functionals[dirichlet_functionals.size() - 1])));
+        boundary_assembler.add(*(dirichlet_vector_assemblers[dirichlet_vector_assemblers.size() - 1]),
+                               *(local_vector.component(component_index)),
+                               new Stuff::Grid::ApplyOn::DirichletIntersections< BoundaryGridPartType >(this->boundary_info()));
+        ++component_index;
+      }
     }
-  }
-  for (ssize_t pp = 0; pp < this->problem().diffusion_factor()->num_components(); ++ pp) {
-    for (ssize_t qq = 0; qq < this->problem().dirichlet()->num_components(); ++qq) {
-      dirichlet_functionals.emplace_back(new DirichletFunctionalType(*(this->problem().diffusion_factor()->component(pp)),
-                                                                     *(diffusion_tensor.affine_part()),
-                                                                     *(this->problem().dirichlet()->component(qq))));
-      dirichlet_vector_assemblers.emplace_back(new DirichletVectorAssemblerType(*(
-          dirichlet_functionals[dirichlet_functionals.size() - 1])));
-      boundary_assembler.add(*(dirichlet_vector_assemblers[dirichlet_vector_assemblers.size() - 1]),
-                             *(local_vector.component(component_index)),
-                             new Stuff::Grid::ApplyOn::DirichletIntersections< BoundaryGridPartType >(this->boundary_info()));
-      ++component_index;
+    if (this->problem().dirichlet()->has_affine_part()) {
+      for (ssize_t qq = 0; qq < this->problem().diffusion_factor()->num_components(); ++qq) {
+        dirichlet_functionals.emplace_back(new DirichletFunctionalType(*(this->problem().diffusion_factor()->component(qq)),
+                                                                       *(diffusion_tensor.affine_part()),
+                                                                       *(this->problem().dirichlet()->affine_part())));
+        dirichlet_vector_assemblers.emplace_back(new DirichletVectorAssemblerType(*(
+            dirichlet_functionals[dirichlet_functionals.size() - 1])));
+        boundary_assembler.add(*(dirichlet_vector_assemblers[dirichlet_vector_assemblers.size() - 1]),
+                               *(local_vector.component(component_index)),
+                               new Stuff::Grid::ApplyOn::DirichletIntersections< BoundaryGridPartType >(this->boundary_info()));
+        ++component_index;
+      }
+    }
+    for (ssize_t pp = 0; pp < this->problem().diffusion_factor()->num_components(); ++ pp) {
+      for (ssize_t qq = 0; qq < this->problem().dirichlet()->num_components(); ++qq) {
+        dirichlet_functionals.emplace_back(new DirichletFunctionalType(*(this->problem().diffusion_factor()->component(pp)),
+                                                                       *(diffusion_tensor.affine_part()),
+                                                                       *(this->problem().dirichlet()->component(qq))));
+        dirichlet_vector_assemblers.emplace_back(new DirichletVectorAssemblerType(*(
+            dirichlet_functionals[dirichlet_functionals.size() - 1])));
+        boundary_assembler.add(*(dirichlet_vector_assemblers[dirichlet_vector_assemblers.size() - 1]),
+                               *(local_vector.component(component_index)),
+                               new Stuff::Grid::ApplyOn::DirichletIntersections< BoundaryGridPartType >(this->boundary_info()));
+        ++component_index;
+      }
     }
   } // dirichlet boundary terms
 
@@ -759,6 +1042,15 @@ assemble_coupling_contributions(const size_t subdomain,
   CouplingAssembler coupling_assembler(inner_test_space, inner_ansatz_space,
                                        outer_test_space, outer_ansatz_space,
                                        ms_grid_->couplingGridPart(subdomain, neighbour));
+  if (affine_diffusion_.tensor_parametric()) {
+    affine_diffusion_.add_coupling(coupling_assembler,
+                                   term_matrices(inside_inside_matrix),
+                                   term_matrices(inside_outside_matrix),
+                                   term_matrices(outside_inside_matrix),
+                                   term_matrices(outside_outside_matrix));
+    coupling_assembler.assemble();
+    return;
+  }
 
   typedef typename ProblemType::DiffusionFactorType::NonparametricType DiffusionFactorType;
   typedef typename ProblemType::DiffusionTensorType::NonparametricType DiffusionTensorType;
@@ -0,0 +1,260 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_DISCRETIZATIONS_RENUMBERING_HH
+#define DUNE_HDD_LINEARELLIPTIC_DISCRETIZATIONS_RENUMBERING_HH
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include <dune/common/fvector.hh>
+
+#include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/common/ranges.hh>
+
+#include <dune/pymor/parameters/functional.hh>
+#include <dune/pymor/la/container/affine.hh>
+
+namespace Dune {
+namespace HDD {
+namespace LinearElliptic {
+namespace Discretizations {
+namespace internal {
+
+
+/**
+ * \brief Computes a reverse Cuthill-McKee ordering of the (symmetric) graph of the given pattern.
+ * \return the new index of each row
+ */
+template< class PatternType >
+std::vector< size_t > reverse_cuthill_mckee(const PatternType& pattern)
+{
+  const size_t size = pattern.size();
+  const auto degree = [&](const size_t ii) { return pattern.inner(ii).size(); };
+  std::vector< bool > visited(size, false);
+  std::vector< size_t > order;
+  order.reserve(size);
+  // start each connected component at an element of minimal degree
+  std::vector< size_t > candidates(size);
+  std::iota(candidates.begin(), candidates.end(), 0);
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [&](const size_t ii, const size_t jj) { return degree(ii) < degree(jj); });
+  std::vector< size_t > neighbours;
+  for (const size_t start : candidates) {
+    if (visited[start])
+      continue;
+    std::deque< size_t > queue(1, start);
+    visited[start] = true;
+    while (!queue.empty()) {
+      const size_t current = queue.front();
+      queue.pop_front();
+      order.push_back(current);
+      neighbours.clear();
+      for (const auto& jj : pattern.inner(current))
+        if (jj < size && !visited[jj]) {
+          visited[jj] = true;
+          neighbours.push_back(jj);
+        }
+      std::stable_sort(neighbours.begin(), neighbours.end(),
+                       [&](const size_t ii, const size_t jj) { return degree(ii) < degree(jj); });
+      queue.insert(queue.end(), neighbours.begin(), neighbours.end());
+    }
+  }
+  std::vector< size_t > ret(size);
+  for (size_t kk = 0; kk < size; ++kk)
+    ret[order[kk]] = size - 1 - kk;
+  return ret;
+} // ... reverse_cuthill_mckee(...)
+
+
+/**
+ * \brief Returns the index of the given point (with coordinates in [0, 2^bits)) along a Hilbert curve, following
+ *        J. Skilling, Programming the Hilbert curve, AIP Conf. Proc. 707 (2004).
+ */
+template< size_t d >
+std::uint64_t hilbert_index(std::array< std::uint32_t, d > xx, const size_t bits)
+{
+  const std::uint32_t highest = std::uint32_t(1) << (bits - 1);
+  // inverse undo
+  for (std::uint32_t qq = highest; qq > 1; qq >>= 1) {
+    const std::uint32_t pp = qq - 1;
+    for (size_t ii = 0; ii < d; ++ii) {
+      if (xx[ii] & qq)
+        xx[0] ^= pp;
+      else {
+        const std::uint32_t tt = (xx[0] ^ xx[ii]) & pp;
+        xx[0] ^= tt;
+        xx[ii] ^= tt;
+      }
+    }
+  }
+  // gray encode
+  for (size_t ii = 1; ii < d; ++ii)
+    xx[ii] ^= xx[ii - 1];
+  std::uint32_t tt = 0;
+  for (std::uint32_t qq = highest; qq > 1; qq >>= 1)
+    if (xx[d - 1] & qq)
+      tt ^= qq - 1;
+  for (size_t ii = 0; ii < d; ++ii)
+    xx[ii] ^= tt;
+  // interleave the transposed index
+  std::uint64_t ret = 0;
+  for (size_t bb = bits; bb > 0; --bb)
+    for (size_t ii = 0; ii < d; ++ii)
+      ret = (ret << 1) | ((xx[ii] >> (bb - 1)) & 1);
+  return ret;
+} // ... hilbert_index(...)
+
+
+/**
+ * \brief Numbers the DoFs of the given space element by element, the elements being ordered along a Hilbert curve
+ *        through their centers.
+ * \return the new index of each DoF
+ */
+template< class SpaceType >
+std::vector< size_t > hilbert_ordering(const SpaceType& space)
+{
+  typedef typename SpaceType::GridViewType GridViewType;
+  static const size_t d = GridViewType::dimension;
+  const size_t bits = std::min(size_t(21), size_t(64 / d));
+  const auto& grid_view = space.grid_view();
+  const auto& mapper = space.mapper();
+  // bounding box of the centers
+  FieldVector< double, d > lower_left(std::numeric_limits< double >::max());
+  FieldVector< double, d > upper_right(std::numeric_limits< double >::lowest());
+  for (const auto& entity : Stuff::Common::entityRange(grid_view)) {
+    const auto center = entity.geometry().center();
+    for (size_t dd = 0; dd < d; ++dd) {
+      lower_left[dd] = std::min(lower_left[dd], double(center[dd]));
+      upper_right[dd] = std::max(upper_right[dd], double(center[dd]));
+    }
+  }
+  const double max_coordinate = double((std::uint64_t(1) << bits) - 1);
+  std::vector< std::pair< std::uint64_t, std::vector< size_t > > > elements;
+  for (const auto& entity : Stuff::Common::entityRange(grid_view)) {
+    const auto center = entity.geometry().center();
+    std::array< std::uint32_t, d > coordinates;
+    for (size_t dd = 0; dd < d; ++dd) {
+      const double extent = upper_right[dd] - lower_left[dd];
+      coordinates[dd] = extent > 0 ? std::uint32_t((center[dd] - lower_left[dd]) / extent * max_coordinate) : 0;
+    }
+    std::vector< size_t > dofs(mapper.numDofs(entity));
+    for (size_t ii = 0; ii < dofs.size(); ++ii)
+      dofs[ii] = mapper.mapToGlobal(entity, ii);
+    elements.emplace_back(hilbert_index< d >(coordinates, bits), std::move(dofs));
+  }
+  std::stable_sort(elements.begin(), elements.end(),
+                   [](const std::pair< std::uint64_t, std::vector< size_t > >& first,
+                      const std::pair< std::uint64_t, std::vector< size_t > >& second) {
+                     return first.first < second.first; });
+  // shared DoFs (of continuous spaces) are numbered by the first element
+  const size_t size = mapper.size();
+  std::vector< size_t > ret(size, std::numeric_limits< size_t >::max());
+  size_t next = 0;
+  for (const auto& element : elements)
+    for (const size_t dof : element.second)
+      if (ret[dof] == std::numeric_limits< size_t >::max())
+        ret[dof] = next++;
+  if (next != size)
+    DUNE_THROW(Stuff::Exceptions::internal_error, "Not all DoFs are attached to an element!");
+  return ret;
+} // ... hilbert_ordering(...)
+
+
+/**
+ * \brief Permutes the rows and the columns of a (possibly rectangular) pattern independently.
+ */
+template< class PatternType >
+std::shared_ptr< PatternType > permute_pattern(const PatternType& pattern,
+                                               const std::vector< size_t >& row_permutation,
+                                               const std::vector< size_t >& col_permutation)
+{
+  auto ret = std::make_shared< PatternType >(pattern.size());
+  for (size_t ii = 0; ii < pattern.size(); ++ii) {
+    auto& inner = ret->inner(row_permutation[ii]);
+    for (const auto& jj : pattern.inner(ii))
+      inner.push_back(col_permutation[jj]);
+    std::sort(inner.begin(), inner.end());
+  }
+  return ret;
+} // ... permute_pattern(...)
+
+template< class PatternType >
+std::shared_ptr< PatternType > permute_pattern(const PatternType& pattern, const std::vector< size_t >& permutation)
+{
+  return permute_pattern(pattern, permutation, permutation);
+}
+
+template< class MatrixType, class PatternType >
+MatrixType* permute_matrix(const MatrixType& matrix,
+                           const PatternType& pattern,
+                           const PatternType& permuted_pattern,
+                           const std::vector< size_t >& row_permutation,
+                           const std::vector< size_t >& col_permutation)
+{
+  auto ret = new MatrixType(matrix.rows(), matrix.cols(), permuted_pattern);
+  for (size_t ii = 0; ii < pattern.size(); ++ii)
+    for (const auto& jj : pattern.inner(ii))
+      ret->set_entry(row_permutation[ii], col_permutation[jj], matrix.get_entry(ii, jj));
+  return ret;
+} // ... permute_matrix(...)
+
+template< class MatrixType, class PatternType >
+MatrixType* permute_matrix(const MatrixType& matrix,
+                           const PatternType& pattern,
+                           const PatternType& permuted_pattern,
+                           const std::vector< size_t >& permutation)
+{
+  return permute_matrix(matrix, pattern, permuted_pattern, permutation, permutation);
+}
+
+template< class VectorType, class PatternType >
+VectorType* permute_vector(const VectorType& vector,
+                           const PatternType& /*pattern*/,
+                           const PatternType& /*permuted_pattern*/,
+                           const std::vector< size_t >& permutation)
+{
+  auto ret = new VectorType(vector.size());
+  for (size_t ii = 0; ii < vector.size(); ++ii)
+    ret->set_entry(permutation[ii], vector.get_entry(ii));
+  return ret;
+} // ... permute_vector(...)
+
+/**
+ * \brief Permutes all components (and the affine part) of the given container using
+ *        permute(container, pattern, permuted_pattern, permutation), retaining the coefficients.
+ */
+template< class ContainerType, class PatternType, class PermuteType >
+std::shared_ptr< Pymor::LA::AffinelyDecomposedContainer< ContainerType > >
+permute_affinely_decomposed(const Pymor::LA::AffinelyDecomposedContainer< ContainerType >& container,
+                            const PatternType& pattern,
+                            const PatternType& permuted_pattern,
+                            const std::vector< size_t >& permutation,
+                            const PermuteType& permute)
+{
+  auto ret = std::make_shared< Pymor::LA::AffinelyDecomposedContainer< ContainerType > >();
+  for (DUNE_STUFF_SSIZE_T qq = 0; qq < container.num_components(); ++qq)
+    ret->register_component(permute(*container.component(qq), pattern, permuted_pattern, permutation),
+                            std::make_shared< const Pymor::ParameterFunctional >(*container.coefficient(qq)));
+  if (container.has_affine_part())
+    ret->register_affine_part(permute(*container.affine_part(), pattern, permuted_pattern, permutation));
+  return ret;
+} // ... permute_affinely_decomposed(...)
+
+
+} // namespace internal
+} // namespace Discretizations
+} // namespace LinearElliptic
+} // namespace HDD
+} // namespace Dune
+
+#endif // DUNE_HDD_LINEARELLIPTIC_DISCRETIZATIONS_RENUMBERING_HH
@@ -0,0 +1,447 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_DISCRETIZATIONS_SERIALIZATION_HH
+#define DUNE_HDD_LINEARELLIPTIC_DISCRETIZATIONS_SERIALIZATION_HH
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+
+#include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/common/string.hh>
+
+#include <dune/pymor/parameters/base.hh>
+#include <dune/pymor/parameters/functional.hh>
+#include <dune/pymor/la/container/affine.hh>
+
+namespace Dune {
+namespace HDD {
+namespace LinearElliptic {
+namespace Discretizations {
+namespace internal {
+
+
+/**
+ * \brief Writes the binary files of ContainerBasedDefault::save() (to a temporary file which is moved on commit(), so
+ *        concurrent readers never see a partially written file).
+ */
+class BinaryWriter
+{
+public:
+  BinaryWriter(const std::string& filename)
+    : filename_(filename)
+    , tmp_filename_(filename + ".tmp." + Stuff::Common::toString(getpid()))
+    , file_(tmp_filename_, std::ofstream::binary)
+  {
+    if (!file_)
+      DUNE_THROW(IOError, "Could not open '" << tmp_filename_ << "' for writing!");
+  }
+
+  void write(const void* data, const size_t bytes)
+  {
+    file_.write(static_cast< const char* >(data), bytes);
+  }
+
+  void write(const std::uint64_t value)
+  {
+    write(&value, sizeof(value));
+  }
+
+  void write(const std::string& value)
+  {
+    write(std::uint64_t(value.size()));
+    write(value.data(), value.size());
+  }
+
+  void commit()
+  {
+    file_.close();
+    if (!file_) {
+      std::remove(tmp_filename_.c_str());
+      DUNE_THROW(IOError, "Failed to write to '" << tmp_filename_ << "'!");
+    }
+    if (std::rename(tmp_filename_.c_str(), filename_.c_str()) != 0) {
+      std::remove(tmp_filename_.c_str());
+      DUNE_THROW(IOError, "Could not move '" << tmp_filename_ << "' to '" << filename_ << "'!");
+    }
+  } // ... commit(...)
+
+private:
+  const std::string filename_;
+  const std::string tmp_filename_;
+  std::ofstream file_;
+}; // class BinaryWriter
+
+
+/**
+ * \brief Reads the binary files of ContainerBasedDefault::save() from a read-only memory mapping.
+ */
+class MappedReader
+{
+public:
+  /**
+   * \brief Maps the given file, valid() is false if it does not exist or cannot be mapped.
+   */
+  MappedReader(const std::string& filename)
+    : filename_(filename)
+    , mapping_(nullptr)
+    , size_(0)
+    , position_(0)
+  {
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+      return;
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+      void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapping != MAP_FAILED) {
+        mapping_ = mapping;
+        size_ = info.st_size;
+      }
+    }
+    close(fd); // <- the mapping stays valid
+  } // MappedReader(...)
+
+  MappedReader(const MappedReader& /*other*/) = delete;
+
+  MappedReader& operator=(const MappedReader& /*other*/) = delete;
+
+  ~MappedReader()
+  {
+    if (mapping_)
+      munmap(mapping_, size_);
+  }
+
+  bool valid() const
+  {
+    return mapping_ != nullptr;
+  }
+
+  size_t remaining() const
+  {
+    return size_ - position_;
+  }
+
+  /**
+   * \brief Returns a pointer to the next bytes of the mapping and advances.
+   */
+  const char* read(const size_t bytes)
+  {
+    if (bytes > remaining())
+      DUNE_THROW(IOError, "The file '" << filename_ << "' is truncated!");
+    const char* ret = static_cast< const char* >(mapping_) + position_;
+    position_ += bytes;
+    return ret;
+  }
+
+  std::uint64_t read_uint()
+  {
+    std::uint64_t ret;
+    std::memcpy(&ret, read(sizeof(ret)), sizeof(ret));
+    return ret;
+  }
+
+  std::string read_string()
+  {
+    const size_t size = read_uint();
+    return std::string(read(size), size);
+  }
+
+private:
+  const std::string filename_;
+  void* mapping_;
+  size_t size_;
+  size_t position_;
+}; // class MappedReader
+
+
+/**
+ * \brief An FNV-1a hash of values, to recognize the grid view and the problem a file was written for.
+ */
+class Fingerprint
+{
+public:
+  Fingerprint()
+    : hash_(14695981039346656037ull)
+  {}
+
+  void add(const void* data, const size_t bytes)
+  {
+    const unsigned char* values = static_cast< const unsigned char* >(data);
+    for (size_t ii = 0; ii < bytes; ++ii) {
+      hash_ ^= values[ii];
+      hash_ *= 1099511628211ull;
+    }
+  }
+
+  void add(const std::uint64_t value)
+  {
+    add(&value, sizeof(value));
+  }
+
+  void add(const double value)
+  {
+    // -0 and 0 are the same value
+    const double normalized = value == 0.0 ? 0.0 : value;
+    add(&normalized, sizeof(normalized));
+  }
+
+  void add(const std::string& value)
+  {
+    add(std::uint64_t(value.size()));
+    add(value.data(), value.size());
+  }
+
+  template< class K, int size >
+  void add(const FieldVector< K, size >& value)
+  {
+    for (size_t ii = 0; ii < size; ++ii)
+      add(double(value[ii]));
+  }
+
+  template< class K, int rows, int cols >
+  void add(const FieldMatrix< K, rows, cols >& value)
+  {
+    for (size_t ii = 0; ii < rows; ++ii)
+      for (size_t jj = 0; jj < cols; ++jj)
+        add(double(value[ii][jj]));
+  }
+
+  std::uint64_t value() const
+  {
+    return hash_;
+  }
+
+private:
+  std::uint64_t hash_;
+}; // class Fingerprint
+
+
+/**
+ * \brief Adds the values of all components (and their coefficients) of an affinely decomposable function at the given
+ *        local point of the given entity.
+ */
+template< class FunctionType, class EntityType, class DomainType >
+void add_function(Fingerprint& fingerprint,
+                  const FunctionType& function,
+                  const EntityType& entity,
+                  const DomainType& xx)
+{
+  fingerprint.add(std::uint64_t(function.num_components()));
+  for (DUNE_STUFF_SSIZE_T qq = 0; qq < function.num_components(); ++qq) {
+    fingerprint.add(function.coefficient(qq)->expression());
+    fingerprint.add(function.component(qq)->local_function(entity)->evaluate(xx));
+  }
+  fingerprint.add(std::uint64_t(function.has_affine_part()));
+  if (function.has_affine_part())
+    fingerprint.add(function.affine_part()->local_function(entity)->evaluate(xx));
+} // ... add_function(...)
+
+
+/**
+ * \brief A fingerprint of the grid view (the corners of all elements, in the order of iteration) and of the problem
+ *        (its type and the values of all its data functions at the centers of the elements).
+ *
+ *        Two discretizations with the same number of DoFs may still differ (e.g. by the placement of the vertices or
+ *        by the data of the problem), this allows to reject a file written by another one.
+ */
+template< class GridViewType, class ProblemType >
+std::uint64_t fingerprint(const GridViewType& grid_view, const ProblemType& problem)
+{
+  Fingerprint ret;
+  ret.add(problem.type());
+  ret.add(std::uint64_t(grid_view.indexSet().size(0)));
+  for (auto it = grid_view.template begin< 0 >(); it != grid_view.template end< 0 >(); ++it) {
+    const auto& entity = *it;
+    const auto geometry = entity.geometry();
+    for (int cc = 0; cc < geometry.corners(); ++cc)
+      ret.add(geometry.corner(cc));
+    const auto xx = geometry.local(geometry.center());
+    add_function(ret, *problem.diffusion_factor(), entity, xx);
+    add_function(ret, *problem.diffusion_tensor(), entity, xx);
+    add_function(ret, *problem.force(), entity, xx);
+    add_function(ret, *problem.dirichlet(), entity, xx);
+    add_function(ret, *problem.neumann(), entity, xx);
+  }
+  return ret.value();
+} // ... fingerprint(...)
+
+
+inline void write_coefficient(BinaryWriter& writer, const Pymor::ParameterFunctional& coefficient)
+{
+  const auto& parameter_type = coefficient.parameter_type();
+  const auto keys = parameter_type.keys();
+  writer.write(std::uint64_t(keys.size()));
+  for (const auto& key : keys) {
+    writer.write(key);
+    writer.write(std::uint64_t(parameter_type.get(key)));
+  }
+  writer.write(coefficient.expression());
+} // ... write_coefficient(...)
+
+inline std::shared_ptr< const Pymor::ParameterFunctional > read_coefficient(MappedReader& reader)
+{
+  Pymor::ParameterType parameter_type;
+  const size_t num_keys = reader.read_uint();
+  for (size_t kk = 0; kk < num_keys; ++kk) {
+    const std::string key = reader.read_string();
+    parameter_type.set(key, reader.read_uint());
+  }
+  const std::string expression = reader.read_string();
+  return std::make_shared< const Pymor::ParameterFunctional >(parameter_type, expression);
+} // ... read_coefficient(...)
+
+template< class PatternType >
+void write_pattern(BinaryWriter& writer, const PatternType& pattern)
+{
+  writer.write(std::uint64_t(pattern.size()));
+  std::vector< std::uint64_t > columns;
+  for (size_t ii = 0; ii < pattern.size(); ++ii) {
+    const auto& inner = pattern.inner(ii);
+    columns.assign(inner.begin(), inner.end());
+    writer.write(std::uint64_t(columns.size()));
+    writer.write(columns.data(), columns.size()*sizeof(std::uint64_t));
+  }
+} // ... write_pattern(...)
+
+template< class PatternType >
+std::shared_ptr< PatternType > read_pattern(MappedReader& reader)
+{
+  const size_t size = reader.read_uint();
+  auto pattern = std::make_shared< PatternType >(size);
+  for (size_t ii = 0; ii < size; ++ii) {
+    const size_t num_columns = reader.read_uint();
+    const char* columns = reader.read(num_columns*sizeof(std::uint64_t));
+    auto& inner = pattern->inner(ii);
+    inner.resize(num_columns);
+    for (size_t jj = 0; jj < num_columns; ++jj) {
+      std::uint64_t column;
+      std::memcpy(&column, columns + jj*sizeof(std::uint64_t), sizeof(column));
+      inner[jj] = column;
+    }
+  }
+  return pattern;
+} // ... read_pattern(...)
+
+/**
+ * \brief Writes the entries of the given matrix within the given pattern, row by row.
+ */
+template< class MatrixType, class PatternType >
+void write_container(BinaryWriter& writer, const MatrixType& matrix, const PatternType& pattern)
+{
+  writer.write(std::uint64_t(matrix.rows()));
+  writer.write(std::uint64_t(matrix.cols()));
+  std::vector< double > values;
+  for (size_t ii = 0; ii < pattern.size(); ++ii)
+    for (const auto& jj : pattern.inner(ii))
+      values.push_back(matrix.get_entry(ii, jj));
+  writer.write(std::uint64_t(values.size()));
+  writer.write(values.data(), values.size()*sizeof(double));
+} // ... write_container(...)
+
+template< class MatrixType, class PatternType >
+MatrixType* read_matrix(MappedReader& reader, const PatternType& pattern)
+{
+  const size_t rows = reader.read_uint();
+  const size_t cols = reader.read_uint();
+  const size_t num_values = reader.read_uint();
+  const char* values = reader.read(num_values*sizeof(double));
+  auto matrix = new MatrixType(rows, cols, pattern);
+  size_t vv = 0;
+  for (size_t ii = 0; ii < pattern.size(); ++ii)
+    for (const auto& jj : pattern.inner(ii)) {
+      if (vv >= num_values) {
+        delete matrix;
+        DUNE_THROW(IOError, "The given pattern does not match the stored matrix!");
+      }
+      double value;
+      std::memcpy(&value, values + vv*sizeof(double), sizeof(value));
+      matrix->set_entry(ii, jj, value);
+      ++vv;
+    }
+  return matrix;
+} // ... read_matrix(...)
+
+template< class VectorType, class PatternType >
+void write_vector(BinaryWriter& writer, const VectorType& vector, const PatternType& /*pattern*/)
+{
+  std::vector< double > values(vector.size());
+  for (size_t ii = 0; ii < vector.size(); ++ii)
+    values[ii] = vector.get_entry(ii);
+  writer.write(std::uint64_t(values.size()));
+  writer.write(values.data(), values.size()*sizeof(double));
+} // ... write_vector(...)
+
+template< class VectorType, class PatternType >
+VectorType* read_vector(MappedReader& reader, const PatternType& /*pattern*/)
+{
+  const size_t size = reader.read_uint();
+  const char* values = reader.read(size*sizeof(double));
+  auto vector = new VectorType(size);
+  for (size_t ii = 0; ii < size; ++ii) {
+    double value;
+    std::memcpy(&value, values + ii*sizeof(double), sizeof(value));
+    vector->set_entry(ii, value);
+  }
+  return vector;
+} // ... read_vector(...)
+
+/**
+ * \brief Writes an affinely decomposed container (its components together with their coefficients, followed by the
+ *        affine part, if present), using write_element(writer, container, pattern) for the containers.
+ */
+template< class ContainerType, class PatternType, class WriteElementType >
+void write_affinely_decomposed(BinaryWriter& writer,
+                               const Pymor::LA::AffinelyDecomposedContainer< ContainerType >& container,
+                               const PatternType& pattern,
+                               const WriteElementType& write_element)
+{
+  writer.write(std::uint64_t(container.num_components()));
+  for (DUNE_STUFF_SSIZE_T qq = 0; qq < container.num_components(); ++qq) {
+    write_coefficient(writer, *container.coefficient(qq));
+    write_element(writer, *container.component(qq), pattern);
+  }
+  writer.write(std::uint64_t(container.has_affine_part()));
+  if (container.has_affine_part())
+    write_element(writer, *container.affine_part(), pattern);
+} // ... write_affinely_decomposed(...)
+
+template< class ContainerType, class PatternType, class ReadElementType >
+std::shared_ptr< Pymor::LA::AffinelyDecomposedContainer< ContainerType > >
+read_affinely_decomposed(MappedReader& reader, const PatternType& pattern, const ReadElementType& read_element)
+{
+  auto ret = std::make_shared< Pymor::LA::AffinelyDecomposedContainer< ContainerType > >();
+  const size_t num_components = reader.read_uint();
+  for (size_t qq = 0; qq < num_components; ++qq) {
+    const auto coefficient = read_coefficient(reader);
+    ret->register_component(read_element(reader, pattern), coefficient);
+  }
+  if (reader.read_uint())
+    ret->register_affine_part(read_element(reader, pattern));
+  return ret;
+} // ... read_affinely_decomposed(...)
+
+
+} // namespace internal
+} // namespace Discretizations
+} // namespace LinearElliptic
+} // namespace HDD
+} // namespace Dune
+
+#endif // DUNE_HDD_LINEARELLIPTIC_DISCRETIZATIONS_SERIALIZATION_HH
@@ -0,0 +1,241 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_DISCRETIZATIONS_SHARED_HH
+#define DUNE_HDD_LINEARELLIPTIC_DISCRETIZATIONS_SHARED_HH
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+
+#include <dune/stuff/common/exceptions.hh>
+
+#include <dune/pymor/parameters/base.hh>
+#include <dune/pymor/parameters/functional.hh>
+#include <dune/pymor/la/container/affine.hh>
+
+#include "serialization.hh"
+
+namespace Dune {
+namespace HDD {
+namespace LinearElliptic {
+namespace Discretizations {
+
+
+/**
+ * \brief An affinely decomposed matrix, the components of which are stored in compressed row format in a memory
+ *        mapped file, so that all processes of a node attaching to the same file share one copy of the data.
+ *
+ *        The mapping is read-only, which is why the pages are shared via the page cache (place the file in /dev/shm
+ *        to keep it in memory). Only the matrices returned by freeze_parameter() are private to each process. The
+ *        layout of the block written by write() is:
+ *        \code
+magic, version, rows, cols, nonzeros, num_components, has_affine_part
+row offsets (rows + 1 uint64), column indices (nonzeros uint64)
+values of each component and of the affine part (nonzeros double each)
+coefficients of the components (parameter type and expression)
+\endcode
+ *        All arrays are 8 byte aligned within the mapping and are used in place. Data following the block (see
+ *        ContainerBasedDefault::export_shared()) can be read from reader().
+ */
+template< class MatrixImp >
+class SharedAffinelyDecomposedMatrix
+{
+public:
+  typedef MatrixImp MatrixType;
+  typedef Pymor::LA::AffinelyDecomposedContainer< MatrixType > AffinelyDecomposedMatrixType;
+
+  static const size_t version = 1;
+
+  /**
+   * \brief Writes the given matrix restricted to the given pattern.
+   */
+  template< class PatternType >
+  static void write(internal::BinaryWriter& writer,
+                    const AffinelyDecomposedMatrixType& matrix,
+                    const PatternType& pattern)
+  {
+    const size_t num_components = matrix.num_components();
+    std::vector< std::uint64_t > row_offsets(1, 0);
+    std::vector< std::uint64_t > columns;
+    for (size_t ii = 0; ii < pattern.size(); ++ii) {
+      for (const auto& jj : pattern.inner(ii))
+        columns.push_back(jj);
+      row_offsets.push_back(columns.size());
+    }
+    writer.write(magic(), 8);
+    writer.write(std::uint64_t(version));
+    writer.write(std::uint64_t(pattern.size()));
+    writer.write(std::uint64_t(matrix.has_affine_part() ? matrix.affine_part()->cols()
+                                                        : (num_components > 0 ? matrix.component(0)->cols() : 0)));
+    writer.write(std::uint64_t(columns.size()));
+    writer.write(std::uint64_t(num_components));
+    writer.write(std::uint64_t(matrix.has_affine_part()));
+    writer.write(row_offsets.data(), row_offsets.size()*sizeof(std::uint64_t));
+    writer.write(columns.data(), columns.size()*sizeof(std::uint64_t));
+    std::vector< double > values(columns.size());
+    const auto write_values = [&](const MatrixType& component) {
+      size_t vv = 0;
+      for (size_t ii = 0; ii < pattern.size(); ++ii)
+        for (const auto& jj : pattern.inner(ii))
+          values[vv++] = component.get_entry(ii, jj);
+      writer.write(values.data(), values.size()*sizeof(double));
+    };
+    for (size_t qq = 0; qq < num_components; ++qq)
+      write_values(*matrix.component(qq));
+    if (matrix.has_affine_part())
+      write_values(*matrix.affine_part());
+    for (size_t qq = 0; qq < num_components; ++qq)
+      internal::write_coefficient(writer, *matrix.coefficient(qq));
+  } // ... write(...)
+
+  /**
+   * \brief Attaches to the block at the beginning of the given file.
+   * \note  Throws if the file cannot be mapped or does not contain a valid block, check exists() first.
+   */
+  explicit SharedAffinelyDecomposedMatrix(const std::string filename)
+    : reader_(new internal::MappedReader(filename))
+  {
+    if (!reader_->valid())
+      DUNE_THROW(IOError, "Could not map '" << filename << "'!");
+    if (reader_->remaining() < 8 + 7*sizeof(std::uint64_t)
+        || std::memcmp(reader_->read(8), magic(), 8) != 0
+        || reader_->read_uint() != version)
+      DUNE_THROW(IOError, "The file '" << filename << "' does not contain a shared matrix (of this version)!");
+    rows_ = reader_->read_uint();
+    cols_ = reader_->read_uint();
+    nonzeros_ = reader_->read_uint();
+    num_components_ = reader_->read_uint();
+    has_affine_part_ = reader_->read_uint();
+    row_offsets_ = reinterpret_cast< const std::uint64_t* >(reader_->read((rows_ + 1)*sizeof(std::uint64_t)));
+    columns_ = reinterpret_cast< const std::uint64_t* >(reader_->read(nonzeros_*sizeof(std::uint64_t)));
+    for (size_t qq = 0; qq < num_components_ + (has_affine_part_ ? 1 : 0); ++qq)
+      values_.push_back(reinterpret_cast< const double* >(reader_->read(nonzeros_*sizeof(double))));
+    for (size_t qq = 0; qq < num_components_; ++qq)
+      coefficients_.push_back(internal::read_coefficient(*reader_));
+  } // SharedAffinelyDecomposedMatrix(...)
+
+  static bool exists(const std::string filename)
+  {
+    internal::MappedReader reader(filename);
+    return reader.valid()
+        && reader.remaining() >= 8
+        && std::memcmp(reader.read(8), magic(), 8) == 0;
+  }
+
+  size_t rows() const
+  {
+    return rows_;
+  }
+
+  size_t cols() const
+  {
+    return cols_;
+  }
+
+  size_t num_components() const
+  {
+    return num_components_;
+  }
+
+  bool has_affine_part() const
+  {
+    return has_affine_part_;
+  }
+
+  const std::shared_ptr< const Pymor::ParameterFunctional >& coefficient(const size_t qq) const
+  {
+    assert(qq < num_components_);
+    return coefficients_[qq];
+  }
+
+  /**
+   * \brief Returns a copy of the stored pattern.
+   */
+  template< class PatternType >
+  std::shared_ptr< PatternType > pattern() const
+  {
+    auto ret = std::make_shared< PatternType >(rows_);
+    for (size_t ii = 0; ii < rows_; ++ii) {
+      auto& inner = ret->inner(ii);
+      inner.assign(columns_ + row_offsets_[ii], columns_ + row_offsets_[ii + 1]);
+    }
+    return ret;
+  } // ... pattern(...)
+
+  /**
+   * \brief Returns a placeholder for the affine decomposition (with empty components but the same coefficients),
+   *        which carries the parameter type and the coefficients without duplicating the data.
+   */
+  std::shared_ptr< AffinelyDecomposedMatrixType > placeholder() const
+  {
+    auto ret = std::make_shared< AffinelyDecomposedMatrixType >();
+    for (size_t qq = 0; qq < num_components_; ++qq)
+      ret->register_component(new MatrixType(), std::make_shared< const Pymor::ParameterFunctional >(*coefficients_[qq]));
+    if (has_affine_part_)
+      ret->register_affine_part(new MatrixType());
+    return ret;
+  } // ... placeholder(...)
+
+  /**
+   * \brief Returns the private matrix affine_part + sum_qq coefficient(qq)(mu) * component(qq).
+   */
+  template< class PatternType >
+  MatrixType freeze_parameter(const Pymor::Parameter& mu, const PatternType& pattern) const
+  {
+    std::vector< double > coefficients;
+    for (size_t qq = 0; qq < num_components_; ++qq)
+      coefficients.push_back(coefficients_[qq]->evaluate(mu));
+    if (has_affine_part_)
+      coefficients.push_back(1.0);
+    MatrixType ret(rows_, cols_, pattern);
+    for (size_t ii = 0; ii < rows_; ++ii)
+      for (size_t vv = row_offsets_[ii]; vv < row_offsets_[ii + 1]; ++vv) {
+        double value = 0.0;
+        for (size_t qq = 0; qq < coefficients.size(); ++qq)
+          value += coefficients[qq]*values_[qq][vv];
+        ret.set_entry(ii, columns_[vv], value);
+      }
+    return ret;
+  } // ... freeze_parameter(...)
+
+  /**
+   * \brief Reads the data written after the block.
+   */
+  internal::MappedReader& reader()
+  {
+    return *reader_;
+  }
+
+private:
+  static const char* magic()
+  {
+    return "DHDDSHM";
+  }
+
+  std::unique_ptr< internal::MappedReader > reader_;
+  size_t rows_;
+  size_t cols_;
+  size_t nonzeros_;
+  size_t num_components_;
+  bool has_affine_part_;
+  const std::uint64_t* row_offsets_;
+  const std::uint64_t* columns_;
+  std::vector< const double* > values_;
+  std::vector< std::shared_ptr< const Pymor::ParameterFunctional > > coefficients_;
+}; // class SharedAffinelyDecomposedMatrix
+
+
+} // namespace Discretizations
+} // namespace LinearElliptic
+} // namespace HDD
+} // namespace Dune
+
+#endif // DUNE_HDD_LINEARELLIPTIC_DISCRETIZATIONS_SHARED_HH
@@ -46,6 +46,7 @@
 #include <dune/gdt/spaces/rt/pdelab.hh>
 #include <dune/gdt/spaces/dg.hh>
 
+#include "affine-diffusion.hh"
 #include "base.hh"
 
 namespace Dune {
@@ -43,10 +43,8 @@ SWIPDG(typename SWIPDG< G, gl, R, r, p, s, la >::GridProviderType& grid_provider
   , beta_(GDT::LocalEvaluation::SIPDG::internal::default_beta(dimDomain))
   , only_these_products_(only_these_products)
 {
-  // in case of parametric diffusion tensor this discretization is not affinely decomposable any more
-  if (this->problem_.diffusion_tensor()->parametric())
-    DUNE_THROW(NotImplemented, "The diffusion tensor must not be parametric!");
-  if (!this->problem_.diffusion_tensor()->has_affine_part())
+  // a parametric diffusion tensor is handled by internal::AffineDiffusion (see init())
+  if (!this->problem_.diffusion_tensor()->parametric() && !this->problem_.diffusion_tensor()->has_affine_part())
     DUNE_THROW(Stuff::Exceptions::wrong_input_given, "The diffusion tensor must not be empty!");
 } // SWIPDG(...)
 
@@ -67,10 +65,8 @@ SWIPDG(const typename SWIPDG< G, gl, R, r, p, s, la >::MsGridProviderType& grid_
   , beta_(GDT::LocalEvaluation::SIPDG::internal::default_beta(dimDomain))
   , only_these_products_(only_these_products)
 {
-  // in case of parametric diffusion tensor this discretization is not affinely decomposable any more
-  if (this->problem_.diffusion_tensor()->parametric())
-    DUNE_THROW(NotImplemented, "The diffusion tensor must not be parametric!");
-  if (!this->problem_.diffusion_tensor()->has_affine_part())
+  // a parametric diffusion tensor is handled by internal::AffineDiffusion (see init())
+  if (!this->problem_.diffusion_tensor()->parametric() && !this->problem_.diffusion_tensor()->has_affine_part())
     DUNE_THROW(Stuff::Exceptions::wrong_input_given, "The diffusion tensor must not be empty!");
 } // SWIPDG(...)
 
@@ -103,28 +99,45 @@ init(const bool prune)
     // lhs operator
     const auto& diffusion_factor = *(this->problem_.diffusion_factor());
     const auto& diffusion_tensor = *(this->problem_.diffusion_tensor());
-    assert(!diffusion_tensor.parametric());
-    assert(diffusion_tensor.has_affine_part());
+    const internal::AffineDiffusion< ProblemType > affine_diffusion(this->problem_);
     std::vector< std::unique_ptr< EllipticOperatorType > > elliptic_operators;
-    for (size_t qq = 0; qq < boost::numeric_cast< size_t >(diffusion_factor.num_components()); ++qq) {
-      const size_t id = matrix.register_component(diffusion_factor.coefficient(qq),
-                                                  space.mapper().size(), space.mapper().size(), *pattern_);
-      elliptic_operators.emplace_back(new EllipticOperatorType(
-          *(diffusion_factor.component(qq)),
-          *(diffusion_tensor.affine_part()),
-          boundary_info,
-          *(matrix.component(id)),
-          space));
-    }
-    if (diffusion_factor.has_affine_part()) {
-      if (!matrix.has_affine_part())
-        matrix.register_affine_part(space.mapper().size(), space.mapper().size(), *pattern_);
-      elliptic_operators.emplace_back(new EllipticOperatorType(
-          *(diffusion_factor.affine_part()),
-          *(diffusion_tensor.affine_part()),
-          boundary_info,
-          *(matrix.affine_part()),
-          space));
+    std::vector< MatrixType* > diffusion_matrices;
+    if (!diffusion_tensor.parametric()) {
+      assert(diffusion_tensor.has_affine_part());
+      for (size_t qq = 0; qq < boost::numeric_cast< size_t >(diffusion_factor.num_components()); ++qq) {
+        const size_t id = matrix.register_component(diffusion_factor.coefficient(qq),
+                                                    space.mapper().size(), space.mapper().size(), *pattern_);
+        elliptic_operators.emplace_back(new EllipticOperatorType(
+            *(diffusion_factor.component(qq)),
+            *(diffusion_tensor.affine_part()),
+            boundary_info,
+            *(matrix.component(id)),
+            space));
+      }
+      if (diffusion_factor.has_affine_part()) {
+        if (!matrix.has_affine_part())
+          matrix.register_affine_part(space.mapper().size(), space.mapper().size(), *pattern_);
+        elliptic_operators.emplace_back(new EllipticOperatorType(
+            *(diffusion_factor.affine_part()),
+            *(diffusion_tensor.affine_part()),
+            boundary_info,
+            *(matrix.affine_part()),
+            space));
+      }
+    } else {
+      // one component per term of the diffusion
+      for (const auto& term : affine_diffusion.terms()) {
+        if (term.coefficient) {
+          const size_t id = matrix.register_component(term.coefficient,
+                                                      space.mapper().size(), space.mapper().size(), *pattern_);
+          diffusion_matrices.push_back(matrix.component(id).get());
+        } else {
+          if (!matrix.has_affine_part())
+            matrix.register_affine_part(space.mapper().size(), space.mapper().size(), *pattern_);
+          diffusion_matrices.push_back(matrix.affine_part().get());
+        }
+      }
+      affine_diffusion.add_operator(system_assembler, boundary_info, diffusion_matrices);
     }
     for (auto& elliptic_operator : elliptic_operators)
       system_assembler.add(*elliptic_operator);
@@ -155,59 +168,74 @@ init(const bool prune)
     typedef Functionals::DirichletBoundarySWIPDG< DiffusionFactorType, FunctionType, VectorType, TestSpaceType,
                                                   GridViewType, DiffusionTensorType > DirichletBoundaryFunctionalType;
     std::vector< std::unique_ptr< DirichletBoundaryFunctionalType > > dirichlet_boundary_functionals;
-    if (diffusion_factor.has_affine_part() && dirichlet.has_affine_part()) {
-      if (!rhs.has_affine_part())
-        rhs.register_affine_part(space.mapper().size());
-      dirichlet_boundary_functionals.emplace_back(new DirichletBoundaryFunctionalType(
-          *(diffusion_factor.affine_part()),
-          *(diffusion_tensor.affine_part()),
-          *(dirichlet.affine_part()),
-          boundary_info,
-          *(rhs.affine_part()),
-          space));
-    }
-    if (diffusion_factor.has_affine_part()) {
-      for (size_t qq = 0; qq < boost::numeric_cast< size_t >(dirichlet.num_components()); ++qq) {
-        const size_t id = rhs.register_component(dirichlet.coefficient(qq), space.mapper().size());
+    std::vector< VectorType* > dirichlet_vectors;
+    if (!diffusion_tensor.parametric()) {
+      if (diffusion_factor.has_affine_part() && dirichlet.has_affine_part()) {
+        if (!rhs.has_affine_part())
+          rhs.register_affine_part(space.mapper().size());
         dirichlet_boundary_functionals.emplace_back(new DirichletBoundaryFunctionalType(
             *(diffusion_factor.affine_part()),
             *(diffusion_tensor.affine_part()),
-            *(dirichlet.component(qq)),
-            boundary_info,
-            *(rhs.component(id)),
-            space));
-      }
-    }
-    if (dirichlet.has_affine_part()) {
-      for (size_t qq = 0; qq < boost::numeric_cast< size_t >(diffusion_factor.num_components()); ++qq) {
-        const size_t id = rhs.register_component(diffusion_factor.coefficient(qq), space.mapper().size());
-        dirichlet_boundary_functionals.emplace_back(new DirichletBoundaryFunctionalType(
-            *(diffusion_factor.component(qq)),
-            *(diffusion_tensor.affine_part()),
             *(dirichlet.affine_part()),
             boundary_info,
-            *(rhs.component(id)),
+            *(rhs.affine_part()),
             space));
       }
-    }
-    Pymor::ParameterType param;
-    for (const auto& key : diffusion_factor.parameter_type().keys())
-      param.set(key, diffusion_factor.parameter_type().get(key));
-    for (const auto& key : dirichlet.parameter_type().keys())
-      param.set(key, dirichlet.parameter_type().get(key));
-    for (size_t pp = 0; pp < boost::numeric_cast< size_t >(diffusion_factor.num_components()); ++ pp) {
-      for (size_t qq = 0; qq < boost::numeric_cast< size_t >(dirichlet.num_components()); ++qq) {
-        const std::string expression = "(" + diffusion_factor.coefficient(pp)->expression()
-                                           + ")*(" + dirichlet.coefficient(qq)->expression() + ")";
-        const size_t id = rhs.register_component(param, expression, space.mapper().size());
-        dirichlet_boundary_functionals.emplace_back(new DirichletBoundaryFunctionalType(
-            *(diffusion_factor.component(pp)),
-            *(diffusion_tensor.affine_part()),
-            *(dirichlet.component(qq)),
-            boundary_info,
-            *(rhs.component(id)),
-            space));
+      if (diffusion_factor.has_affine_part()) {
+        for (size_t qq = 0; qq < boost::numeric_cast< size_t >(dirichlet.num_components()); ++qq) {
+          const size_t id = rhs.register_component(dirichlet.coefficient(qq), space.mapper().size());
+          dirichlet_boundary_functionals.emplace_back(new DirichletBoundaryFunctionalType(
+              *(diffusion_factor.affine_part()),
+              *(diffusion_tensor.affine_part()),
+              *(dirichlet.component(qq)),
+              boundary_info,
+              *(rhs.component(id)),
+              space));
+        }
+      }
+      if (dirichlet.has_affine_part()) {
+        for (size_t qq = 0; qq < boost::numeric_cast< size_t >(diffusion_factor.num_components()); ++qq) {
+          const size_t id = rhs.register_component(diffusion_factor.coefficient(qq), space.mapper().size());
+          dirichlet_boundary_functionals.emplace_back(new DirichletBoundaryFunctionalType(
+              *(diffusion_factor.component(qq)),
+              *(diffusion_tensor.affine_part()),
+              *(dirichlet.affine_part()),
+              boundary_info,
+              *(rhs.component(id)),
+              space));
+        }
+      }
+      Pymor::ParameterType param;
+      for (const auto& key : diffusion_factor.parameter_type().keys())
+        param.set(key, diffusion_factor.parameter_type().get(key));
+      for (const auto& key : dirichlet.parameter_type().keys())
+        param.set(key, dirichlet.parameter_type().get(key));
+      for (size_t pp = 0; pp < boost::numeric_cast< size_t >(diffusion_factor.num_components()); ++ pp) {
+        for (size_t qq = 0; qq < boost::numeric_cast< size_t >(dirichlet.num_components()); ++qq) {
+          const std::string expression = "(" + diffusion_factor.coefficient(pp)->expression()
+                                             + ")*(" + dirichlet.coefficient(qq)->expression() + ")";
+          const size_t id = rhs.register_component(param, expression, space.mapper().size());
+          dirichlet_boundary_functionals.emplace_back(new DirichletBoundaryFunctionalType(
+              *(diffusion_factor.component(pp)),
+              *(diffusion_tensor.affine_part()),
+              *(dirichlet.component(qq)),
+              boundary_info,
+              *(rhs.component(id)),
+              space));
+        }
+      }
+    } else {
+      for (const auto& term : affine_diffusion.dirichlet_terms()) {
+        if (term.coefficient) {
+          const size_t id = rhs.register_component(term.coefficient, space.mapper().size());
+          dirichlet_vectors.push_back(rhs.component(id).get());
+        } else {
+          if (!rhs.has_affine_part())
+            rhs.register_affine_part(space.mapper().size());
+          dirichlet_vectors.push_back(rhs.affine_part().get());
+        }
       }
+      affine_diffusion.add_dirichlet_rhs(system_assembler, boundary_info, dirichlet_vectors);
     }
     for (auto& dirichlet_boundary_functional : dirichlet_boundary_functionals)
       system_assembler.add(*dirichlet_boundary_functional);
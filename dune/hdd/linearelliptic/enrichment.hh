@@ -0,0 +1,408 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_ENRICHMENT_HH
+#define DUNE_HDD_LINEARELLIPTIC_ENRICHMENT_HH
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <boost/numeric/conversion/cast.hpp>
+
+#include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/common/timedlogging.hh>
+#include <dune/stuff/la/container/common.hh>
+#include <dune/stuff/la/solver.hh>
+
+#include <dune/pymor/parameters/base.hh>
+
+#include "parallel.hh"
+
+namespace Dune {
+namespace HDD {
+namespace LinearElliptic {
+
+
+/**
+ * \brief Localized reduced bases for the BlockSWIPDG discretization, together with the reduced local and coupling
+ *        blocks of its operator and the reduced local functionals (see OS2015, Sect. 4).
+ *
+ *        For each subdomain, the local basis is kept orthonormal w.r.t. the given local product. The reduced blocks
+ *        are stored per affine component (ordered as the components of get_local_operator() and
+ *        get_coupling_operator(), followed by their affine part, if present). Since the images of all basis vectors
+ *        under the (high-dimensional) local and coupling matrices are kept, extend() only applies these matrices to
+ *        the new basis vectors and only computes the new rows and columns of the affected blocks, while the old
+ *        entries are kept.
+ * \note  The parameter given to reduced_operator(), reduced_functional() and solve() is handed over to the
+ *        coefficients of the local operators and functionals.
+ */
+template< class DiscretizationImp >
+class LocalizedBasis
+{
+public:
+  typedef DiscretizationImp                           DiscretizationType;
+  typedef typename DiscretizationType::MatrixType     MatrixType;
+  typedef typename DiscretizationType::VectorType     VectorType;
+  typedef typename DiscretizationType::RangeFieldType RangeFieldType;
+  typedef typename DiscretizationType::OperatorType   OperatorType;
+  typedef typename DiscretizationType::ProductType    ProductType;
+  typedef typename DiscretizationType::FunctionalType FunctionalType;
+
+  typedef Stuff::LA::CommonDenseMatrix< RangeFieldType > ReducedMatrixType;
+  typedef Stuff::LA::CommonDenseVector< RangeFieldType > ReducedVectorType;
+
+private:
+  typedef std::vector< std::vector< VectorType > > ImagesType; // <- one list of images per affine component
+
+public:
+  static std::string static_id()
+  {
+    return "hdd.linearelliptic.localizedbasis";
+  }
+
+  /**
+   * \param product    Id of the local product to orthonormalize the local bases with (see
+   *                   DiscretizationType::get_local_product()), defaults to the only available one.
+   * \param mu_product Parameter of the local product (if parametric).
+   */
+  LocalizedBasis(const DiscretizationType& discretization,
+                 const std::string product = "",
+                 const Pymor::Parameter mu_product = Pymor::Parameter(),
+                 const RangeFieldType orthonormalization_tolerance = 1e-10)
+    : discretization_(discretization)
+    , num_subdomains_(boost::numeric_cast< size_t >(discretization_.num_subdomains()))
+    , mu_product_(mu_product)
+    , tolerance_(orthonormalization_tolerance)
+    , bases_(num_subdomains_)
+    , neighbours_(num_subdomains_)
+    , operators_(num_subdomains_)
+    , images_(num_subdomains_)
+    , reduced_operators_(num_subdomains_)
+    , reduced_functionals_(num_subdomains_)
+  {
+    const std::string product_type = (product.empty() && discretization_.available_products().size() == 1)
+                                     ? discretization_.available_products()[0]
+                                     : product;
+    for (size_t ss = 0; ss < num_subdomains_; ++ss) {
+      products_.emplace_back(discretization_.get_local_product(ss, product_type));
+      functionals_.emplace_back(discretization_.get_local_functional(ss));
+      operators_[ss].insert(std::make_pair(ss, discretization_.get_local_operator(ss)));
+      for (const auto& nn : discretization_.neighbouring_subdomains(ss)) {
+        const size_t neighbour = boost::numeric_cast< size_t >(nn);
+        neighbours_[ss].push_back(neighbour);
+        operators_[ss].insert(std::make_pair(neighbour, discretization_.get_coupling_operator(ss, neighbour)));
+      }
+      for (const auto& element : operators_[ss]) {
+        images_[ss][element.first] = ImagesType(num_matrices(element.second));
+        reduced_operators_[ss][element.first] = std::vector< ReducedMatrixType >(num_matrices(element.second),
+                                                                                ReducedMatrixType(0, 0, 0.0));
+      }
+      reduced_functionals_[ss] = std::vector< ReducedVectorType >(num_matrices(functionals_[ss]),
+                                                                  ReducedVectorType(0, 0.0));
+    }
+  } // LocalizedBasis(...)
+
+  size_t num_subdomains() const
+  {
+    return num_subdomains_;
+  }
+
+  const std::vector< VectorType >& local_basis(const size_t ss) const
+  {
+    assert_subdomain(ss);
+    return bases_[ss];
+  }
+
+  size_t size() const
+  {
+    size_t ret = 0;
+    for (const auto& basis : bases_)
+      ret += basis.size();
+    return ret;
+  }
+
+  /**
+   * \brief The components of the reduced local (nn == ss) or coupling (nn a neighbour of ss) block.
+   */
+  const std::vector< ReducedMatrixType >& reduced_block(const size_t ss, const size_t nn) const
+  {
+    assert_subdomain(ss);
+    const auto result = reduced_operators_[ss].find(nn);
+    if (result == reduced_operators_[ss].end())
+      DUNE_THROW(Stuff::Exceptions::index_out_of_range,
+                 "Subdomain " << nn << " is neither " << ss << " nor one of its neighbours!");
+    return result->second;
+  } // ... reduced_block(...)
+
+  const std::vector< ReducedVectorType >& reduced_local_functional(const size_t ss) const
+  {
+    assert_subdomain(ss);
+    return reduced_functionals_[ss];
+  }
+
+  /**
+   * \brief Orthonormalizes the given local vectors w.r.t. the local bases (and each other), appends those which are
+   *        not (numerically) contained in the local bases and updates the reduced blocks accordingly.
+   *
+   *        The subdomains are processed concurrently on num_threads threads (0 meaning as many as the hardware
+   *        supports).
+   * \return The number of basis vectors added to each subdomain.
+   */
+  std::vector< size_t > extend(const std::map< size_t, std::vector< VectorType > >& local_vectors,
+                               const size_t num_threads = 0)
+  {
+    auto logger = DSC::TimedLogger().get(static_id());
+    std::vector< size_t > old_sizes(num_subdomains_);
+    for (size_t ss = 0; ss < num_subdomains_; ++ss)
+      old_sizes[ss] = bases_[ss].size();
+    std::vector< size_t > extended_subdomains;
+    for (const auto& element : local_vectors) {
+      assert_subdomain(element.first);
+      extended_subdomains.push_back(element.first);
+    }
+    // orthonormalize and compute the images of the new basis vectors, each subdomain only touches its own basis and
+    // the images of its basis under its local matrices and the coupling matrices of its neighbours
+    internal::parallel_for_each(extended_subdomains, num_threads, [&](const size_t& ss) {
+      for (const auto& vector : local_vectors.at(ss))
+        append(ss, vector);
+      apply_matrices(operators_[ss].at(ss), bases_[ss], old_sizes[ss], images_[ss].at(ss));
+      for (const auto& nn : neighbours_[ss])
+        apply_matrices(operators_[nn].at(ss), bases_[ss], old_sizes[ss], images_[nn].at(ss));
+    });
+    // update the reduced blocks, each subdomain only touches its own rows
+    std::vector< size_t > affected_subdomains;
+    for (size_t ss = 0; ss < num_subdomains_; ++ss) {
+      bool affected = bases_[ss].size() > old_sizes[ss];
+      for (const auto& nn : neighbours_[ss])
+        affected = affected || bases_[nn].size() > old_sizes[nn];
+      if (affected)
+        affected_subdomains.push_back(ss);
+    }
+    internal::parallel_for_each(affected_subdomains, num_threads, [&](const size_t& ss) {
+      for (auto& element : reduced_operators_[ss]) {
+        const size_t nn = element.first;
+        const auto& images = images_[ss].at(nn);
+        for (size_t qq = 0; qq < element.second.size(); ++qq)
+          element.second[qq] = extend_block(element.second[qq],
+                                            old_sizes[ss], bases_[ss].size(),
+                                            old_sizes[nn], bases_[nn].size(),
+                                            [&](const size_t ii, const size_t jj) {
+                                              return bases_[ss][ii].dot(images[qq][jj]);
+                                            });
+      }
+      if (bases_[ss].size() > old_sizes[ss]) {
+        const auto vectors = functional_vectors(functionals_[ss]);
+        for (size_t qq = 0; qq < vectors.size(); ++qq) {
+          ReducedVectorType extended(bases_[ss].size(), 0.0);
+          for (size_t ii = 0; ii < old_sizes[ss]; ++ii)
+            extended.set_entry(ii, reduced_functionals_[ss][qq].get_entry(ii));
+          for (size_t ii = old_sizes[ss]; ii < bases_[ss].size(); ++ii)
+            extended.set_entry(ii, vectors[qq]->dot(bases_[ss][ii]));
+          reduced_functionals_[ss][qq] = extended;
+        }
+      }
+    });
+    std::vector< size_t > ret(num_subdomains_);
+    size_t num_added = 0;
+    for (size_t ss = 0; ss < num_subdomains_; ++ss) {
+      ret[ss] = bases_[ss].size() - old_sizes[ss];
+      num_added += ret[ss];
+    }
+    logger.info() << "added " << num_added << " basis vectors on " << extended_subdomains.size()
+                  << " subdomains (total basis size: " << size() << ")" << std::endl;
+    return ret;
+  } // ... extend(...)
+
+  /**
+   * \brief The reduced system matrix for the given parameter (the local bases being ordered by subdomain).
+   */
+  ReducedMatrixType reduced_operator(const Pymor::Parameter mu = Pymor::Parameter()) const
+  {
+    const auto offsets = compute_offsets();
+    ReducedMatrixType ret(size(), size(), 0.0);
+    for (size_t ss = 0; ss < num_subdomains_; ++ss) {
+      for (const auto& element : reduced_operators_[ss]) {
+        const size_t nn = element.first;
+        const auto coefficients = compute_coefficients(operators_[ss].at(nn), mu);
+        for (size_t qq = 0; qq < coefficients.size(); ++qq)
+          for (size_t ii = 0; ii < bases_[ss].size(); ++ii)
+            for (size_t jj = 0; jj < bases_[nn].size(); ++jj)
+              ret.add_to_entry(offsets[ss] + ii,
+                               offsets[nn] + jj,
+                               coefficients[qq] * element.second[qq].get_entry(ii, jj));
+      }
+    }
+    return ret;
+  } // ... reduced_operator(...)
+
+  ReducedVectorType reduced_functional(const Pymor::Parameter mu = Pymor::Parameter()) const
+  {
+    const auto offsets = compute_offsets();
+    ReducedVectorType ret(size(), 0.0);
+    for (size_t ss = 0; ss < num_subdomains_; ++ss) {
+      const auto coefficients = compute_coefficients(functionals_[ss], mu);
+      for (size_t qq = 0; qq < coefficients.size(); ++qq)
+        for (size_t ii = 0; ii < bases_[ss].size(); ++ii)
+          ret.add_to_entry(offsets[ss] + ii, coefficients[qq] * reduced_functionals_[ss][qq].get_entry(ii));
+    }
+    return ret;
+  } // ... reduced_functional(...)
+
+  ReducedVectorType solve(const Pymor::Parameter mu = Pymor::Parameter()) const
+  {
+    ReducedVectorType ret(size(), 0.0);
+    Stuff::LA::Solver< ReducedMatrixType >(reduced_operator(mu)).apply(reduced_functional(mu), ret);
+    return ret;
+  }
+
+  VectorType reconstruct(const ReducedVectorType& coefficients) const
+  {
+    if (coefficients.size() != size())
+      DUNE_THROW(Stuff::Exceptions::shapes_do_not_match,
+                 "coefficients.size() = " << coefficients.size() << ", size() = " << size());
+    const auto offsets = compute_offsets();
+    // the local bases are added directly to the blocks of the global vector, without local copies
+    VectorType ret(discretization_.ansatz_space().mapper().size(), 0.0);
+    for (size_t ss = 0; ss < num_subdomains_; ++ss) {
+      auto view = discretization_.local_view(ret, ss);
+      for (size_t ii = 0; ii < bases_[ss].size(); ++ii)
+        view.axpy(coefficients.get_entry(offsets[ss] + ii), bases_[ss][ii]);
+    }
+    return ret;
+  } // ... reconstruct(...)
+
+private:
+  void assert_subdomain(const size_t ss) const
+  {
+    if (ss >= num_subdomains_)
+      DUNE_THROW(Stuff::Exceptions::index_out_of_range,
+                 "0 <= ss < num_subdomains() = " << num_subdomains_ << " is not true for ss = " << ss << "!");
+  }
+
+  /**
+   * \brief Modified Gram-Schmidt (applied twice for stability) against the current local basis.
+   */
+  void append(const size_t ss, const VectorType& vector)
+  {
+    const auto& product = products_[ss];
+    const RangeFieldType initial_norm = std::sqrt(std::abs(product.apply2(vector, vector, mu_product_)));
+    if (!(initial_norm > 0.0))
+      return;
+    VectorType candidate = vector;
+    for (size_t pass = 0; pass < 2; ++pass)
+      for (const auto& basis_vector : bases_[ss])
+        candidate.axpy(-1.0 * product.apply2(basis_vector, candidate, mu_product_), basis_vector);
+    const RangeFieldType norm = std::sqrt(std::abs(product.apply2(candidate, candidate, mu_product_)));
+    if (norm < tolerance_ * initial_norm)
+      return;
+    candidate.scal(1.0 / norm);
+    bases_[ss].push_back(candidate);
+  } // ... append(...)
+
+  /**
+   * \brief The number of containers (components and affine part) of an operator or functional.
+   */
+  template< class ContainerBasedType >
+  static size_t num_matrices(const ContainerBasedType& container_based)
+  {
+    return boost::numeric_cast< size_t >(container_based.num_components())
+        + (container_based.has_affine_part() ? 1 : 0);
+  }
+
+  static std::vector< std::shared_ptr< const MatrixType > > operator_matrices(const OperatorType& op)
+  {
+    std::vector< std::shared_ptr< const MatrixType > > ret;
+    for (DUNE_STUFF_SSIZE_T qq = 0; qq < op.num_components(); ++qq)
+      ret.emplace_back(op.component(qq).container());
+    if (op.has_affine_part())
+      ret.emplace_back(op.affine_part().container());
+    return ret;
+  }
+
+  static std::vector< std::shared_ptr< const VectorType > > functional_vectors(const FunctionalType& functional)
+  {
+    std::vector< std::shared_ptr< const VectorType > > ret;
+    for (DUNE_STUFF_SSIZE_T qq = 0; qq < functional.num_components(); ++qq)
+      ret.emplace_back(functional.component(qq).container());
+    if (functional.has_affine_part())
+      ret.emplace_back(functional.affine_part().container());
+    return ret;
+  }
+
+  template< class ContainerBasedType >
+  static std::vector< RangeFieldType > compute_coefficients(const ContainerBasedType& container_based,
+                                                            const Pymor::Parameter& mu)
+  {
+    std::vector< RangeFieldType > ret;
+    for (DUNE_STUFF_SSIZE_T qq = 0; qq < container_based.num_components(); ++qq)
+      ret.push_back(container_based.coefficient(qq).evaluate(mu));
+    if (container_based.has_affine_part())
+      ret.push_back(1.0);
+    return ret;
+  }
+
+  static void apply_matrices(const OperatorType& op,
+                             const std::vector< VectorType >& basis,
+                             const size_t first,
+                             ImagesType& images)
+  {
+    const auto matrices = operator_matrices(op);
+    assert(matrices.size() == images.size());
+    for (size_t qq = 0; qq < matrices.size(); ++qq)
+      for (size_t jj = first; jj < basis.size(); ++jj) {
+        VectorType image(matrices[qq]->rows(), 0.0);
+        matrices[qq]->mv(basis[jj], image);
+        images[qq].emplace_back(std::move(image));
+      }
+  } // ... apply_matrices(...)
+
+  template< class EntryFunctionType >
+  static ReducedMatrixType extend_block(const ReducedMatrixType& block,
+                                        const size_t old_rows, const size_t rows,
+                                        const size_t old_cols, const size_t cols,
+                                        const EntryFunctionType& entry)
+  {
+    if (rows == old_rows && cols == old_cols)
+      return block;
+    ReducedMatrixType ret(rows, cols, 0.0);
+    for (size_t ii = 0; ii < rows; ++ii)
+      for (size_t jj = 0; jj < cols; ++jj)
+        ret.set_entry(ii, jj, (ii < old_rows && jj < old_cols) ? block.get_entry(ii, jj) : entry(ii, jj));
+    return ret;
+  } // ... extend_block(...)
+
+  std::vector< size_t > compute_offsets() const
+  {
+    std::vector< size_t > offsets(num_subdomains_, 0);
+    for (size_t ss = 1; ss < num_subdomains_; ++ss)
+      offsets[ss] = offsets[ss - 1] + bases_[ss - 1].size();
+    return offsets;
+  }
+
+  const DiscretizationType& discretization_;
+  const size_t num_subdomains_;
+  const Pymor::Parameter mu_product_;
+  const RangeFieldType tolerance_;
+  std::vector< std::vector< VectorType > > bases_;
+  std::vector< std::vector< size_t > > neighbours_;
+  std::vector< ProductType > products_;
+  std::vector< FunctionalType > functionals_;
+  std::vector< std::map< size_t, OperatorType > > operators_;
+  std::vector< std::map< size_t, ImagesType > > images_;
+  std::vector< std::map< size_t, std::vector< ReducedMatrixType > > > reduced_operators_;
+  std::vector< std::vector< ReducedVectorType > > reduced_functionals_;
+}; // class LocalizedBasis
+
+
+} // namespace LinearElliptic
+} // namespace HDD
+} // namespace Dune
+
+#endif // DUNE_HDD_LINEARELLIPTIC_ENRICHMENT_HH
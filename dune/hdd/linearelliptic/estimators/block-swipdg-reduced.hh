@@ -0,0 +1,469 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_ESTIMATORS_BLOCK_SWIPDG_REDUCED_HH
+#define DUNE_HDD_LINEARELLIPTIC_ESTIMATORS_BLOCK_SWIPDG_REDUCED_HH
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+
+#include <dune/geometry/quadraturerules.hh>
+
+#if HAVE_ALUGRID
+# include <dune/grid/alugrid.hh>
+#endif
+
+#include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/common/memory.hh>
+#include <dune/stuff/common/ranges.hh>
+#include <dune/stuff/common/timedlogging.hh>
+#include <dune/stuff/la/container/common.hh>
+
+#include <dune/pymor/common/exceptions.hh>
+#include <dune/pymor/parameters/base.hh>
+
+#include <dune/gdt/discretefunction/default.hh>
+
+#include "block-swipdg.hh"
+#include "flux-reconstruction.hh"
+#include "oswald-interpolation.hh"
+
+namespace Dune {
+namespace HDD {
+namespace LinearElliptic {
+namespace Estimators {
+
+
+/**
+ * \brief Offline/online decomposition of the OS2014 estimator for reduced solutions.
+ *
+ *        Given a (global) reduced basis v_1, ..., v_N, a reduced solution u = \sum_i c_i v_i and an affinely
+ *        decomposable diffusion factor \kappa_\mu = \kappa_0 + \sum_q \theta_q(\mu) \kappa_q, the squared local
+ *        nonconformity and diffusive flux estimators on each subdomain are quadratic forms in c, the weights of
+ *        which are affine (resp. quadratic) in the \theta_q. We assemble the corresponding Gram matrices once
+ *        (offline) for each subdomain, so that each online evaluation only costs O(Q^2 N^2) per subdomain.
+ *        The residual estimator does not depend on the solution or the parameter (see LocalResidualOS2014) and is
+ *        thus computed once as well.
+ * \note  This relies on the diffusive flux reconstruction being linear in the diffusion factor (which it is, since
+ *        the weights of the SWIPDG discretization only depend on the diffusion tensor). Since the inverse of
+ *        \kappa_{\hat{\mu}} enters the diffusive flux estimator, \hat{\mu} has to be fixed offline: the online
+ *        evaluations throw if they are given a different 'mu_hat'.
+ * \note  The oswald interpolation and the flux reconstruction are applied to the basis vectors in the numbering of
+ *        the space. If the discretization was renumbered (see BlockSWIPDG::renumber()), convert the basis with its
+ *        to_space_numbering() first.
+ */
+template< class BlockSpaceType, class VectorType, class ProblemType, class GridType >
+class ReducedBlockSWIPDG
+{
+public:
+  static const bool available = false;
+};
+
+#if HAVE_ALUGRID
+
+template< class BlockSpaceType, class VectorType, class ProblemType >
+class ReducedBlockSWIPDG< BlockSpaceType, VectorType, ProblemType, ALUGrid< 2, 2, simplex, conforming > >
+{
+  typedef ALUGrid< 2, 2, simplex, conforming > GridType;
+public:
+  static const bool available = true;
+
+  typedef std::map< std::string, Pymor::Parameter > ParametersMapType;
+
+  typedef typename ProblemType::RangeFieldType RangeFieldType;
+  typedef Stuff::LA::CommonDenseVector< RangeFieldType > CoefficientsType;
+  typedef Stuff::LA::CommonDenseMatrix< RangeFieldType > GramMatrixType;
+
+  static const unsigned int dimDomain = BlockSpaceType::dimDomain;
+
+private:
+  typedef typename ProblemType::DomainFieldType                                        DomainFieldType;
+  typedef FieldVector< RangeFieldType, dimDomain >                                     DomainType;
+  typedef FieldMatrix< RangeFieldType, dimDomain, dimDomain >                          TensorType;
+  typedef GDT::ConstDiscreteFunction< BlockSpaceType, VectorType >                     ConstDiscreteFunctionType;
+  typedef DiffusiveFluxReconstructionOperator< BlockSpaceType, VectorType, ProblemType > FluxReconstructionType;
+  typedef typename FluxReconstructionType::RTN0SpaceType                               RTN0SpaceType;
+  typedef GDT::ConstDiscreteFunction< RTN0SpaceType, VectorType >                      ConstRTN0DiscreteFunctionType;
+  typedef typename ProblemType::DiffusionFactorType::NonparametricType                 DiffusionFactorType;
+  typedef internal::BlockSWIPDG::LocalResidualOS2014
+      < BlockSpaceType, VectorType, ProblemType, GridType >                            LocalResidualOS2014Type;
+
+  static const ProblemType& assert_problem(const ProblemType& problem)
+  {
+    if (problem.diffusion_tensor()->parametric())
+      DUNE_THROW(Stuff::Exceptions::requirements_not_met, "Not implemented for parametric diffusion_tensor!");
+    if (problem.force()->parametric())
+      DUNE_THROW(Stuff::Exceptions::requirements_not_met, "Not implemented for parametric force!");
+    if (problem.dirichlet()->parametric())
+      DUNE_THROW(Stuff::Exceptions::requirements_not_met, "Not implemented for parametric dirichlet!");
+    if (problem.neumann()->parametric())
+      DUNE_THROW(Stuff::Exceptions::requirements_not_met, "Not implemented for parametric neumann!");
+    return problem;
+  } // ... assert_problem(...)
+
+  static Pymor::Parameter get_parameter(const ProblemType& problem,
+                                        const ParametersMapType& parameters,
+                                        const std::string key)
+  {
+    if (!problem.parametric())
+      return Pymor::Parameter();
+    if (parameters.find(key) == parameters.end())
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given, "Given parameters are missing '" << key << "'!");
+    const auto& mu = parameters.at(key);
+    if (mu.type() != problem.parameter_type())
+      DUNE_THROW(Pymor::Exceptions::wrong_parameter_type,
+                 "Given " << key << " is of type " << mu.type() << " and should be of type "
+                 << problem.parameter_type() << "!");
+    return mu;
+  } // ... get_parameter(...)
+
+public:
+  /**
+   * \param parameters has to contain 'mu_hat', 'parameter_range_min' and 'parameter_range_max' (if the problem is
+   *        parametric).
+   */
+  ReducedBlockSWIPDG(const BlockSpaceType& space,
+                     const ProblemType& problem,
+                     const std::vector< VectorType >& basis,
+                     const ParametersMapType parameters = ParametersMapType())
+    : space_(space)
+    , problem_(assert_problem(problem))
+    , mu_hat_(get_parameter(problem_, parameters, "mu_hat"))
+    , num_basis_(basis.size())
+    , num_components_(problem_.diffusion_factor()->num_components()
+                      + (problem_.diffusion_factor()->has_affine_part() ? 1 : 0))
+    , eta_r_squared_locally_(LocalResidualOS2014Type::estimate_locally(
+                               space_,
+                               problem_,
+                               get_parameter(problem_, parameters, "parameter_range_min"),
+                               get_parameter(problem_, parameters, "parameter_range_max")))
+  {
+    auto logger = DSC::TimedLogger().get("hdd.linearelliptic.estimators.reducedblockswipdg");
+    logger.info() << "assembling gram matrices for " << num_basis_ << " basis functions, " << num_components_
+                  << " affine components and " << space_.ms_grid()->size() << " subdomains..." << std::endl;
+    const auto& diffusion_factor = *problem_.diffusion_factor();
+    const auto& diffusion_tensor = *problem_.diffusion_tensor()->affine_part();
+    std::vector< std::shared_ptr< const DiffusionFactorType > > diffusion_factor_components;
+    for (DUNE_STUFF_SSIZE_T qq = 0; qq < diffusion_factor.num_components(); ++qq)
+      diffusion_factor_components.emplace_back(diffusion_factor.component(qq));
+    if (diffusion_factor.has_affine_part())
+      diffusion_factor_components.emplace_back(diffusion_factor.affine_part());
+    assert(diffusion_factor_components.size() == num_components_);
+    const auto problem_mu_hat = problem_.with_mu(mu_hat_);
+    const auto& diffusion_factor_mu_hat = *problem_mu_hat->diffusion_factor()->affine_part();
+    // compute the oswald interpolations and flux reconstructions of the basis
+    const std::vector< VectorType > oswald_interpolation_vectors
+        = OswaldInterpolationOperator< BlockSpaceType >(space_).apply(basis);
+    const auto flux_reconstruction = FluxReconstructionType::get(space_, problem_);
+    assert(flux_reconstruction->num_components() == num_components_);
+    std::vector< std::vector< VectorType > > diffusive_flux_vectors;
+    for (size_t qq = 0; qq < num_components_; ++qq)
+      diffusive_flux_vectors.emplace_back(flux_reconstruction->apply(qq, basis));
+    std::vector< std::unique_ptr< ConstDiscreteFunctionType > > basis_functions;
+    std::vector< std::unique_ptr< ConstDiscreteFunctionType > > oswald_interpolations;
+    std::vector< std::vector< std::unique_ptr< ConstRTN0DiscreteFunctionType > > > diffusive_fluxes(num_components_);
+    for (size_t ii = 0; ii < num_basis_; ++ii) {
+      basis_functions.emplace_back(DSC::make_unique< ConstDiscreteFunctionType >(space_, basis[ii]));
+      oswald_interpolations.emplace_back(DSC::make_unique< ConstDiscreteFunctionType >(space_,
+                                                                                        oswald_interpolation_vectors[ii]));
+      for (size_t qq = 0; qq < num_components_; ++qq)
+        diffusive_fluxes[qq].emplace_back(DSC::make_unique< ConstRTN0DiscreteFunctionType >(
+                                            flux_reconstruction->range_space(), diffusive_flux_vectors[qq][ii]));
+    }
+    // walk the subdomains
+    std::vector< std::vector< DomainType > > basis_gradients(num_basis_);
+    std::vector< std::vector< DomainType > > difference_gradients(num_basis_);
+    std::vector< std::vector< std::vector< DomainType > > > flux_values(num_components_,
+                                                                         std::vector< std::vector< DomainType > >(num_basis_));
+    std::vector< RangeFieldType > diffusion_factor_values(num_components_);
+    DomainType tmp_vector(0);
+    for (size_t ss = 0; ss < space_.ms_grid()->size(); ++ss) {
+      nonconformity_.emplace_back(num_components_, GramMatrixType(num_basis_, num_basis_, 0.0));
+      diffusive_flux_affine_.emplace_back(num_basis_, num_basis_, 0.0);
+      diffusive_flux_linear_.emplace_back(num_components_, GramMatrixType(num_basis_, num_basis_, 0.0));
+      diffusive_flux_quadratic_.emplace_back(num_components_ * num_components_,
+                                             GramMatrixType(num_basis_, num_basis_, 0.0));
+      auto& nonconformity = nonconformity_.back();
+      auto& diffusive_flux_affine = diffusive_flux_affine_.back();
+      auto& diffusive_flux_linear = diffusive_flux_linear_.back();
+      auto& diffusive_flux_quadratic = diffusive_flux_quadratic_.back();
+      // walk the local grid
+      const auto local_grid_view = space_.local_spaces()[ss]->grid_view();
+      for (const auto& entity : Stuff::Common::entityRange(local_grid_view)) {
+        const auto local_diffusion_tensor = diffusion_tensor.local_function(entity);
+        const auto local_diffusion_factor_mu_hat = diffusion_factor_mu_hat.local_function(entity);
+        size_t diffusion_factor_order = local_diffusion_factor_mu_hat->order();
+        std::vector< std::unique_ptr< typename DiffusionFactorType::LocalfunctionType > > local_diffusion_factors;
+        for (size_t qq = 0; qq < num_components_; ++qq) {
+          local_diffusion_factors.emplace_back(diffusion_factor_components[qq]->local_function(entity));
+          diffusion_factor_order = std::max(diffusion_factor_order, local_diffusion_factors[qq]->order());
+        }
+        const size_t integrand_order = diffusion_factor_order + local_diffusion_tensor->order()
+                                       + 2*BlockSpaceType::polOrder + internal::SWIPDG::over_integrate;
+        const auto& quadrature = QuadratureRules< DomainFieldType, dimDomain >::rule(entity.type(),
+                                                                                     int(integrand_order));
+        const size_t num_quadrature_points = quadrature.size();
+        // evaluate the basis related functions at all quadrature points
+        for (size_t ii = 0; ii < num_basis_; ++ii) {
+          const auto local_basis_function = basis_functions[ii]->local_function(entity);
+          const auto local_oswald_interpolation = oswald_interpolations[ii]->local_function(entity);
+          basis_gradients[ii].resize(num_quadrature_points);
+          difference_gradients[ii].resize(num_quadrature_points);
+          for (size_t pp = 0; pp < num_quadrature_points; ++pp) {
+            const auto xx = quadrature[pp].position();
+            basis_gradients[ii][pp] = local_basis_function->jacobian(xx)[0];
+            difference_gradients[ii][pp] = basis_gradients[ii][pp];
+            difference_gradients[ii][pp] -= local_oswald_interpolation->jacobian(xx)[0];
+          }
+          for (size_t qq = 0; qq < num_components_; ++qq) {
+            const auto local_diffusive_flux = diffusive_fluxes[qq][ii]->local_function(entity);
+            flux_values[qq][ii].resize(num_quadrature_points);
+            for (size_t pp = 0; pp < num_quadrature_points; ++pp)
+              flux_values[qq][ii][pp] = local_diffusive_flux->evaluate(quadrature[pp].position());
+          }
+        }
+        // integrate
+        for (size_t pp = 0; pp < num_quadrature_points; ++pp) {
+          const auto xx = quadrature[pp].position();
+          const RangeFieldType integration_factor = entity.geometry().integrationElement(xx) * quadrature[pp].weight();
+          const TensorType tensor = local_diffusion_tensor->evaluate(xx);
+          const RangeFieldType diffusion_factor_mu_hat_value = local_diffusion_factor_mu_hat->evaluate(xx);
+          assert(diffusion_factor_mu_hat_value > 0.0);
+          TensorType inverse_diffusion_mu_hat = tensor;
+          inverse_diffusion_mu_hat.invert();
+          inverse_diffusion_mu_hat /= diffusion_factor_mu_hat_value;
+          for (size_t qq = 0; qq < num_components_; ++qq)
+            diffusion_factor_values[qq] = local_diffusion_factors[qq]->evaluate(xx);
+          for (size_t ii = 0; ii < num_basis_; ++ii) {
+            for (size_t jj = 0; jj < num_basis_; ++jj) {
+              // nonconformity: \kappa_q A \nabla (v_i - I v_i) \cdot \nabla (v_j - I v_j)
+              tensor.mv(difference_gradients[jj][pp], tmp_vector);
+              const RangeFieldType nonconformity_value = integration_factor * (tmp_vector * difference_gradients[ii][pp]);
+              for (size_t qq = 0; qq < num_components_; ++qq)
+                nonconformity[qq].add_to_entry(ii, jj, diffusion_factor_values[qq] * nonconformity_value);
+              // diffusive flux, affine part: \kappa_{\hat{\mu}} A \nabla v_i \cdot \nabla v_j
+              tensor.mv(basis_gradients[jj][pp], tmp_vector);
+              diffusive_flux_affine.add_to_entry(ii,
+                                                 jj,
+                                                 integration_factor * diffusion_factor_mu_hat_value
+                                                 * (tmp_vector * basis_gradients[ii][pp]));
+              for (size_t qq = 0; qq < num_components_; ++qq) {
+                // diffusive flux, linear part: \nabla v_i \cdot t_q(v_j) + t_q(v_i) \cdot \nabla v_j
+                diffusive_flux_linear[qq].add_to_entry(ii,
+                                                       jj,
+                                                       integration_factor
+                                                       * (  basis_gradients[ii][pp] * flux_values[qq][jj][pp]
+                                                          + flux_values[qq][ii][pp] * basis_gradients[jj][pp]));
+                // diffusive flux, quadratic part: (\kappa_{\hat{\mu}} A)^{-1} t_q(v_i) \cdot t_r(v_j)
+                for (size_t rr = 0; rr < num_components_; ++rr) {
+                  inverse_diffusion_mu_hat.mv(flux_values[rr][jj][pp], tmp_vector);
+                  diffusive_flux_quadratic[qq*num_components_ + rr].add_to_entry(
+                        ii, jj, integration_factor * (tmp_vector * flux_values[qq][ii][pp]));
+                }
+              }
+            }
+          }
+        }
+      } // walk the local grid
+    } // walk the subdomains
+    logger.info() << "done" << std::endl;
+  } // ReducedBlockSWIPDG(...)
+
+  size_t num_basis() const
+  {
+    return num_basis_;
+  }
+
+  /**
+   * \brief Returns the squared local nonconformity estimator of each subdomain (see LocalNonconformityOS2014).
+   */
+  std::vector< RangeFieldType > estimate_nonconformity_locally(const CoefficientsType& coefficients,
+                                                               const Pymor::Parameter mu_bar = Pymor::Parameter())
+                                                               const
+  {
+    const auto thetas = coefficients_of(mu_bar);
+    CoefficientsType tmp(num_basis_, 0.0);
+    std::vector< RangeFieldType > ret(nonconformity_.size(), 0.0);
+    for (size_t ss = 0; ss < nonconformity_.size(); ++ss)
+      for (size_t qq = 0; qq < num_components_; ++qq)
+        ret[ss] += thetas[qq] * quadratic_form(nonconformity_[ss][qq], coefficients, tmp);
+    return ret;
+  } // ... estimate_nonconformity_locally(...)
+
+  /**
+   * \brief Returns the squared local diffusive flux estimator of each subdomain (see LocalDiffusiveFluxOS2014), for
+   *        the mu_hat given on construction.
+   */
+  std::vector< RangeFieldType > estimate_diffusive_flux_locally(const CoefficientsType& coefficients,
+                                                                const Pymor::Parameter mu = Pymor::Parameter()) const
+  {
+    const auto thetas = coefficients_of(mu);
+    CoefficientsType tmp(num_basis_, 0.0);
+    std::vector< RangeFieldType > ret(diffusive_flux_affine_.size(), 0.0);
+    for (size_t ss = 0; ss < diffusive_flux_affine_.size(); ++ss) {
+      ret[ss] = quadratic_form(diffusive_flux_affine_[ss], coefficients, tmp);
+      for (size_t qq = 0; qq < num_components_; ++qq) {
+        ret[ss] += thetas[qq] * quadratic_form(diffusive_flux_linear_[ss][qq], coefficients, tmp);
+        for (size_t rr = 0; rr < num_components_; ++rr)
+          ret[ss] += thetas[qq] * thetas[rr]
+                     * quadratic_form(diffusive_flux_quadratic_[ss][qq*num_components_ + rr], coefficients, tmp);
+      }
+      // may be slightly negative due to cancellation
+      ret[ss] = std::max(ret[ss], RangeFieldType(0));
+    }
+    return ret;
+  } // ... estimate_diffusive_flux_locally(...)
+
+  /**
+   * \brief Computes the same value as OS2014::estimate() for the reduced solution given by coefficients, but without
+   *        touching the grid.
+   * \param parameters has to contain 'mu' and 'mu_bar' (if the problem is parametric), the mu_hat given on
+   *        construction is used. If parameters contains 'mu_hat' as well, it has to coincide with that one.
+   */
+  RangeFieldType estimate(const CoefficientsType& coefficients,
+                          const ParametersMapType parameters = ParametersMapType()) const
+  {
+    RangeFieldType eta_nc_squared = 0.0;
+    RangeFieldType eta_r_squared = 0.0;
+    RangeFieldType eta_df_squared = 0.0;
+    const auto factors = compute_factors(parameters);
+    const auto eta_nc_locally = estimate_nonconformity_locally(coefficients, factors.mu_bar);
+    const auto eta_df_locally = estimate_diffusive_flux_locally(coefficients, factors.mu);
+    for (size_t ss = 0; ss < eta_nc_locally.size(); ++ss) {
+      eta_nc_squared += eta_nc_locally[ss];
+      eta_r_squared  += (*eta_r_squared_locally_)[ss];
+      eta_df_squared += eta_df_locally[ss];
+    }
+    return (1.0/std::sqrt(factors.alpha_mu_mu_bar)) * (  std::sqrt(factors.gamma_mu_mu_bar) * std::sqrt(eta_nc_squared)
+                                                       +                                      std::sqrt(eta_r_squared)
+                                                       + factors.sqrt_gamma_tilde           * std::sqrt(eta_df_squared));
+  } // ... estimate(...)
+
+  /**
+   * \brief Computes the same values as OS2014::estimate_local(), see estimate().
+   */
+  Stuff::LA::CommonDenseVector< RangeFieldType > estimate_local(const CoefficientsType& coefficients,
+                                                                const ParametersMapType parameters
+                                                                  = ParametersMapType()) const
+  {
+    const auto factors = compute_factors(parameters);
+    const auto eta_nc_locally = estimate_nonconformity_locally(coefficients, factors.mu_bar);
+    const auto eta_df_locally = estimate_diffusive_flux_locally(coefficients, factors.mu);
+    Stuff::LA::CommonDenseVector< RangeFieldType > indicators(eta_nc_locally.size(), 0.0);
+    RangeFieldType eta_nc_squared = 0.0;
+    RangeFieldType eta_r_squared = 0.0;
+    RangeFieldType eta_df_squared = 0.0;
+    for (size_t ss = 0; ss < eta_nc_locally.size(); ++ss) {
+      const RangeFieldType eta_r_T_squared = (*eta_r_squared_locally_)[ss];
+      indicators[ss] = 3.0/std::sqrt(factors.alpha_mu_mu_bar) * (std::sqrt(factors.gamma_mu_mu_bar)*eta_nc_locally[ss]
+                                                                 + eta_r_T_squared
+                                                                 + factors.sqrt_gamma_tilde*eta_df_locally[ss]);
+      eta_nc_squared += eta_nc_locally[ss];
+      eta_r_squared  += eta_r_T_squared;
+      eta_df_squared += eta_df_locally[ss];
+    }
+    const RangeFieldType eta_squared
+        = std::pow(1.0/std::sqrt(factors.alpha_mu_mu_bar) * (std::sqrt(factors.gamma_mu_mu_bar)*std::sqrt(eta_nc_squared)
+                                                             + std::sqrt(eta_r_squared)
+                                                             + factors.sqrt_gamma_tilde*std::sqrt(eta_df_squared)),
+                   2);
+    for (auto& element : indicators)
+      element /= eta_squared;
+    return indicators;
+  } // ... estimate_local(...)
+
+private:
+  struct Factors
+  {
+    Pymor::Parameter mu;
+    Pymor::Parameter mu_bar;
+    double alpha_mu_mu_bar;
+    double gamma_mu_mu_bar;
+    double sqrt_gamma_tilde;
+  }; // struct Factors
+
+  Factors compute_factors(const ParametersMapType& parameters) const
+  {
+    if (problem_.parametric() && parameters.find("mu_hat") != parameters.end()
+        && !equal(get_parameter(problem_, parameters, "mu_hat"), mu_hat_))
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                 "Given mu_hat " << parameters.at("mu_hat") << " differs from the one given on construction (" << mu_hat_
+                 << "), the gram matrices of the diffusive flux estimator depend on it!");
+    Factors factors;
+    factors.mu     = get_parameter(problem_, parameters, "mu");
+    factors.mu_bar = get_parameter(problem_, parameters, "mu_bar");
+    factors.alpha_mu_mu_bar = problem_.diffusion_factor()->alpha(factors.mu, factors.mu_bar);
+    factors.gamma_mu_mu_bar = problem_.diffusion_factor()->gamma(factors.mu, factors.mu_bar);
+    const double alpha_mu_mu_hat = problem_.diffusion_factor()->alpha(factors.mu, mu_hat_);
+    const double gamma_mu_mu_hat = problem_.diffusion_factor()->gamma(factors.mu, mu_hat_);
+    assert(factors.alpha_mu_mu_bar > 0.0);
+    assert(factors.gamma_mu_mu_bar > 0.0);
+    assert(alpha_mu_mu_hat > 0.0);
+    assert(gamma_mu_mu_hat > 0.0);
+    factors.sqrt_gamma_tilde = std::max(std::sqrt(gamma_mu_mu_hat), 1.0/std::sqrt(alpha_mu_mu_hat));
+    return factors;
+  } // ... compute_factors(...)
+
+  static bool equal(const Pymor::Parameter& first, const Pymor::Parameter& second)
+  {
+    if (first.type() != second.type())
+      return false;
+    for (const auto& key : first.type().keys())
+      if (first.get(key) != second.get(key))
+        return false;
+    return true;
+  }
+
+  std::vector< RangeFieldType > coefficients_of(const Pymor::Parameter& mu) const
+  {
+    const auto& diffusion_factor = *problem_.diffusion_factor();
+    std::vector< RangeFieldType > thetas;
+    for (DUNE_STUFF_SSIZE_T qq = 0; qq < diffusion_factor.num_components(); ++qq)
+      thetas.push_back(diffusion_factor.coefficient(qq)->evaluate(mu));
+    if (diffusion_factor.has_affine_part())
+      thetas.push_back(1.0);
+    assert(thetas.size() == num_components_);
+    return thetas;
+  } // ... coefficients_of(...)
+
+  RangeFieldType quadratic_form(const GramMatrixType& matrix,
+                                const CoefficientsType& coefficients,
+                                CoefficientsType& tmp) const
+  {
+    if (coefficients.size() != num_basis_)
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                 "Given coefficients are of size " << coefficients.size() << " and should be of size " << num_basis_
+                 << "!");
+    matrix.mv(coefficients, tmp);
+    return coefficients.dot(tmp);
+  } // ... quadratic_form(...)
+
+  const BlockSpaceType& space_;
+  const ProblemType& problem_;
+  const Pymor::Parameter mu_hat_;
+  const size_t num_basis_;
+  const size_t num_components_;
+  const std::shared_ptr< const std::vector< RangeFieldType > > eta_r_squared_locally_;
+  std::vector< std::vector< GramMatrixType > > nonconformity_;
+  std::vector< GramMatrixType > diffusive_flux_affine_;
+  std::vector< std::vector< GramMatrixType > > diffusive_flux_linear_;
+  std::vector< std::vector< GramMatrixType > > diffusive_flux_quadratic_;
+}; // class ReducedBlockSWIPDG< ..., ALUGrid< 2, 2, simplex, conforming > >
+
+#endif // HAVE_ALUGRID
+
+
+} // namespace Estimators
+} // namespace LinearElliptic
+} // namespace HDD
+} // namespace Dune
+
+#endif // DUNE_HDD_LINEARELLIPTIC_ESTIMATORS_BLOCK_SWIPDG_REDUCED_HH
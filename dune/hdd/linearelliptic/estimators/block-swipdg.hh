@@ -6,13 +6,11 @@
 #ifndef DUNE_HDD_LINEARELLIPTIC_ESTIMATORS_BLOCK_SWIPDG_HH
 #define DUNE_HDD_LINEARELLIPTIC_ESTIMATORS_BLOCK_SWIPDG_HH
 
-#include <dune/stuff/common/disable_warnings.hh>
-# if HAVE_EIGEN
-#   include <Eigen/Eigenvalues>
-# endif
-#include <dune/stuff/common/reenable_warnings.hh>
-
-#include <dune/geometry/quadraturerules.hh>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
 
 #if HAVE_ALUGRID
 # include <dune/grid/alugrid.hh>
@@ -24,6 +22,10 @@
 #include <dune/gdt/playground/localevaluation/OS2014.hh>
 
 #include "swipdg.hh"
+#include "diffusion-bounds.hh"
+#include "subdomain-metrics.hh"
+#include "data-terms-cache.hh"
+#include "flux-reconstruction.hh"
 
 namespace Dune {
 namespace HDD {
@@ -32,147 +34,6 @@ namespace Estimators {
 namespace internal {
 
 
-template< class FunctionType, class EntityType, int dimRange, int dimRangeCols >
-class MinMax
-{
-  static_assert(AlwaysFalse< FunctionType >::value, "Not implemented for these dimensions!");
-};
-
-/**
- * We try to find the minimum of a polynomial of given order by evaluating it at the points of a quadrature that
- * would integrate this polynomial exactly.
- * \todo These are just some heuristics and should be replaced by something proper.
- */
-template< class FunctionType, class EntityType >
-class MinMax< FunctionType, EntityType, 1, 1 >
-{
-  typedef typename FunctionType::RangeFieldType RangeFieldType;
-
-public:
-  static RangeFieldType compute_min(const FunctionType& function, const EntityType& entity)
-  {
-    typename FunctionType::RangeType tmp_value(0);
-    RangeFieldType ret = std::numeric_limits< RangeFieldType >::max();
-    const auto local_function = function.local_function(entity);
-    const size_t ord = local_function->order();
-    assert(ord < std::numeric_limits< int >::max());
-    const auto& quadrature = QuadratureRules< typename FunctionType::DomainFieldType
-                                            , FunctionType::dimDomain >::rule(entity.type(), int(ord));
-    const auto quad_point_it_end = quadrature.end();
-    for (auto quad_point_it = quadrature.begin(); quad_point_it != quad_point_it_end; ++quad_point_it) {
-      local_function->evaluate(quad_point_it->position(), tmp_value);
-      ret = std::min(ret, tmp_value[0]);
-    }
-    return ret;
-  } // ... compute_min(...)
-
-  static RangeFieldType compute_max(const FunctionType& function, const EntityType& entity)
-  {
-    typename FunctionType::RangeType tmp_value(0);
-    RangeFieldType ret = std::numeric_limits< RangeFieldType >::min();
-    const auto local_function = function.local_function(entity);
-    const size_t ord = local_function->order();
-    assert(ord < std::numeric_limits< int >::max());
-    const auto& quadrature = QuadratureRules< typename FunctionType::DomainFieldType
-                                            , FunctionType::dimDomain >::rule(entity.type(), int(ord));
-    const auto quad_point_it_end = quadrature.end();
-    for (auto quad_point_it = quadrature.begin(); quad_point_it != quad_point_it_end; ++quad_point_it) {
-      local_function->evaluate(quad_point_it->position(), tmp_value);
-      ret = std::max(ret, tmp_value[0]);
-    }
-    return ret;
-  } // ... compute_max(...)
-}; // class MinMax< ..., 1, 1 >
-
-#if HAVE_EIGEN
-
-/**
- * we basically assume that the function is constant, since we only evaluate it in the center
- */
-template< class FunctionType, class EntityType, int dimDomain >
-class MinMax< FunctionType, EntityType, dimDomain, dimDomain >
-{
-  typedef typename FunctionType::RangeFieldType RangeFieldType;
-
-public:
-  static RangeFieldType compute_min(const FunctionType& function, const EntityType& entity)
-  {
-    const auto local_function = function.local_function(entity);
-    assert(local_function->order() == 0);
-    const auto& reference_element = ReferenceElements< typename FunctionType::DomainFieldType
-                                                     , FunctionType::dimDomain >::general(entity.type());
-    const Stuff::LA::EigenDenseMatrix< RangeFieldType >
-        tensor = local_function->evaluate(reference_element.position(0, 0));
-    ::Eigen::EigenSolver< typename Stuff::LA::EigenDenseMatrix< RangeFieldType >::BackendType >
-        eigen_solver(tensor.backend());
-    assert(eigen_solver.info() == ::Eigen::Success);
-    const auto eigenvalues = eigen_solver.eigenvalues(); // <- this should be an Eigen vector of std::complex
-    RangeFieldType min_ev = std::numeric_limits< RangeFieldType >::max();
-    for (size_t ii = 0; ii < boost::numeric_cast< size_t >(eigenvalues.size()); ++ii) {
-      // assert this is real
-      assert(std::abs(eigenvalues[ii].imag()) < 1e-15);
-      // assert that this eigenvalue is positive
-      const RangeFieldType eigenvalue = eigenvalues[ii].real();
-      assert(eigenvalue > 1e-15);
-      min_ev = std::min(min_ev, eigenvalue);
-    }
-    return min_ev;
-  } // ... compute_min(...)
-
-  static RangeFieldType compute_max(const FunctionType& function, const EntityType& entity)
-  {
-    const auto local_function = function.local_function(entity);
-    assert(local_function->order() == 0);
-    const auto& reference_element = ReferenceElements< typename FunctionType::DomainFieldType
-                                                     , FunctionType::dimDomain >::general(entity.type());
-    const Stuff::LA::EigenDenseMatrix< RangeFieldType >
-        tensor = local_function->evaluate(reference_element.position(0, 0));
-    ::Eigen::EigenSolver< typename Stuff::LA::EigenDenseMatrix< RangeFieldType >::BackendType >
-        eigen_solver(tensor.backend());
-    assert(eigen_solver.info() == ::Eigen::Success);
-    const auto eigenvalues = eigen_solver.eigenvalues(); // <- this should be an Eigen vector of std::complex
-    RangeFieldType max_ev = std::numeric_limits< RangeFieldType >::min();
-    for (size_t ii = 0; ii < boost::numeric_cast< size_t >(eigenvalues.size()); ++ii) {
-      // assert this is real
-      assert(std::abs(eigenvalues[ii].imag()) < 1e-15);
-      // assert that this eigenvalue is positive
-      const RangeFieldType eigenvalue = eigenvalues[ii].real();
-      assert(eigenvalue > 1e-15);
-      max_ev = std::max(max_ev, eigenvalue);
-    }
-    return max_ev;
-  } // ... compute_max(...)
-}; // class MinMax< ..., dimDomain, dimDomain >
-
-#else // HAVE_EIGEN
-
-template< class FunctionType, class EntityType, int dimDomain >
-class MinMax< FunctionType, EntityType, dimDomain, dimDomain >
-{
-  static_assert(AlwaysFalse< FunctionType >::value, "You are missing eigen!");
-};
-
-#endif // HAVE_EIGEN
-
-
-template< class FunctionType, class EntityType >
-static typename FunctionType::RangeFieldType compute_minimum(const FunctionType& function, const EntityType& entity)
-{
-  static const int dimRange = FunctionType::dimRange;
-  static const int dimRangeCols = FunctionType::dimRangeCols;
-  return MinMax< FunctionType, EntityType, dimRange, dimRangeCols >::compute_min(function, entity);
-} // ... compute_minimum(...)
-
-
-template< class FunctionType, class EntityType >
-static typename FunctionType::RangeFieldType compute_maximum(const FunctionType& function, const EntityType& entity)
-{
-  static const int dimRange = FunctionType::dimRange;
-  static const int dimRangeCols = FunctionType::dimRangeCols;
-  return MinMax< FunctionType, EntityType, dimRange, dimRangeCols >::compute_max(function, entity);
-} // ... compute_maximum(...)
-
-
 namespace BlockSWIPDG {
 
 
@@ -197,6 +58,8 @@ class LocalResidualOS2014Base
 {
 public:
   static std::string id() { return "eta_R_OS2014"; }
+  static const bool depends_on_solution = false;
+  static const bool depends_on_parameter = false;
 };
 
 
@@ -228,10 +91,13 @@ public:
 
   typedef std::map< std::string, Pymor::Parameter > ParametersMapType;
 
+  typedef DiffusionBounds< typename BlockSpaceType::GridViewType, ProblemType > DiffusionBoundsType;
+
 private:
   static const unsigned int dimDomain = GridViewType::dimension;
 
   typedef typename BlockSpaceType::LocalSpaceType LocalSpaceType;
+  typedef SubdomainMetrics< BlockSpaceType > SubdomainMetricsType;
 
   typedef GDT::Spaces::FV::Default< GridViewType, RangeFieldType, 1, 1 > P0SpaceType;
   typedef GDT::DiscreteFunction< P0SpaceType, VectorType > DiscreteFunctionType;
@@ -278,34 +144,71 @@ public:
       DUNE_THROW(Stuff::Exceptions::wrong_input_given, "Given parameters are missing 'parameter_range_max'!");
     const Pymor::Parameter mu_min = problem.parametric() ? parameters.at("parameter_range_min") : Pymor::Parameter();
     const Pymor::Parameter mu_max = problem.parametric() ? parameters.at("parameter_range_max") : Pymor::Parameter();
-    // walk the subdomains
     double eta_r_squared = 0.0;
-    for (size_t subdomain = 0; subdomain < space.ms_grid()->size(); ++subdomain) {
-      const auto local_space = space.local_spaces()[subdomain];
-      ThisType eta_r_T(*local_space, problem, mu_min, mu_max);
-      Stuff::Grid::Walker< GridViewType > grid_walker(local_space->grid_view());
-      grid_walker.add(eta_r_T);
-      grid_walker.walk();
-      eta_r_squared += eta_r_T.result_;
-    } // walk the subdomains
+    for (const auto& eta_r_T_squared : *estimate_locally(space, problem, mu_min, mu_max))
+      eta_r_squared += eta_r_T_squared;
     return std::sqrt(eta_r_squared);
   } // ... estimate(...)
 
+  /**
+   * \brief Returns the squared local estimator of each subdomain.
+   *
+   *        Since this estimator depends neither on the solution nor on the parameter, the result is only computed once
+   *        for each multiscale grid, problem and parameter range, and then reused.
+   */
+  static std::shared_ptr< const std::vector< RangeFieldType > > estimate_locally(const BlockSpaceType& space,
+                                                                                 const ProblemType& problem,
+                                                                                 const Pymor::Parameter& mu_min,
+                                                                                 const Pymor::Parameter& mu_max)
+  {
+    static_assert(!ThisType::depends_on_solution && !ThisType::depends_on_parameter,
+                  "This estimator must not be cached!");
+    return internal::DataTermsCache< ThisType, RangeFieldType >::get(
+          {space.ms_grid(), problem.diffusion_factor(), problem.diffusion_tensor(), problem.force()},
+          {mu_min, mu_max},
+          [&]() {
+            const auto subdomain_metrics = SubdomainMetricsType::get(space);
+            const auto diffusion_bounds = DiffusionBoundsType::get(space.grid_view(), problem, space.ms_grid());
+            std::vector< RangeFieldType > eta_r_T_squared(space.ms_grid()->size(), 0.0);
+            // walk the subdomains
+            for (size_t subdomain = 0; subdomain < space.ms_grid()->size(); ++subdomain) {
+              const auto local_space = space.local_spaces()[subdomain];
+              ThisType eta_r_T(*local_space,
+                               *subdomain_metrics,
+                               subdomain,
+                               *diffusion_bounds,
+                               problem,
+                               mu_min,
+                               mu_max);
+              Stuff::Grid::Walker< GridViewType > grid_walker(local_space->grid_view());
+              grid_walker.add(eta_r_T);
+              grid_walker.walk();
+              eta_r_T_squared[subdomain] = eta_r_T.result_;
+            } // walk the subdomains
+            return eta_r_T_squared;
+          });
+  } // ... estimate_locally(...)
+
   LocalResidualOS2014(const LocalSpaceType& local_space,
+                      const SubdomainMetricsType& subdomain_metrics,
+                      const size_t subdomain,
+                      const DiffusionBoundsType& diffusion_bounds,
                       const ProblemType& problem,
                       const Pymor::Parameter mu_min = Pymor::Parameter(),
                       const Pymor::Parameter mu_max = Pymor::Parameter())
     : local_space_(local_space)
     , problem_(assert_problem(problem, mu_min, mu_max))
-    , problem_mu_min_(problem_.with_mu(mu_min))
-    , problem_mu_max_(problem_.with_mu(mu_max))
+    , diffusion_bounds_(diffusion_bounds)
+    , thetas_mu_min_(diffusion_bounds_.coefficients(problem_.map_parameter(mu_min, "diffusion_factor")))
+    , thetas_mu_max_(diffusion_bounds_.coefficients(problem_.map_parameter(mu_max, "diffusion_factor")))
     , p0_space_(local_space_.grid_view())
     , p0_force_(p0_space_)
     , difference_(Stuff::Common::make_unique< DifferenceType >(*problem_.force()->affine_part() - p0_force_))
     , constant_one_(1)
     , local_operator_(SWIPDG::over_integrate, constant_one_)
     , tmp_local_matrices_({1, local_operator_.numTmpObjectsRequired()}, 1, 1)
-    , vertices_()
+    , diameter_(subdomain_metrics.diameter(subdomain))
+    , poincare_constant_(subdomain_metrics.poincare_constant(subdomain))
     , min_diffusion_value_(std::numeric_limits< RangeFieldType >::max())
     , prepared_(false)
     , finalized_(false)
@@ -325,15 +228,12 @@ public:
 
   virtual void apply_local(const EntityType &entity)
   {
-    // collect all vertices
-    for (int cc = 0; cc < entity.template count< dimDomain >(); ++cc)
-      vertices_.push_back(entity.template subEntity< dimDomain >(cc)->geometry().center());
     // compute minimum diffusion
     // this assumes that the minimum of the diffusion factor is reached for the min or max mu
+    const size_t index = diffusion_bounds_.index(entity);
     const RangeFieldType min_diffusion_value_entity
-        =   std::min(internal::compute_minimum(*problem_mu_min_->diffusion_factor()->affine_part(), entity),
-                     internal::compute_minimum(*problem_mu_max_->diffusion_factor()->affine_part(), entity))
-          * internal::compute_minimum(*problem_.diffusion_tensor()->affine_part(), entity);
+        = std::min(diffusion_bounds_.ev_lower_bound(index, thetas_mu_min_),
+                   diffusion_bounds_.ev_lower_bound(index, thetas_mu_max_));
     min_diffusion_value_ = std::min(min_diffusion_value_, min_diffusion_value_entity);
     // compute the local product
     const auto local_difference = difference_->local_function(entity);
@@ -351,36 +251,27 @@ public:
     if (!prepared_)
       DUNE_THROW(Stuff::Exceptions::you_are_using_this_wrong, "Do not call finalize() before calling prepare()!");
     if (!finalized_) {
-      // compute diameter
-      DomainFieldType diameter(0);
-      DomainType tmp_diff;
-      for (size_t cc = 0; cc < vertices_.size(); ++cc) {
-        const auto& vertex = vertices_[cc];
-        for (size_t dd = cc + 1; dd < vertices_.size(); ++dd) {
-          const auto& other_vertex = vertices_[dd];
-          tmp_diff = vertex - other_vertex;
-          diameter = std::max(diameter, tmp_diff.two_norm());
-        }
-      }
       // compute local estimator
-      const RangeFieldType poincare_constant = 1.0 / (M_PIl * M_PIl);
       assert(min_diffusion_value_ > 0.0);
-      result_ *= ((poincare_constant * diameter * diameter) / min_diffusion_value_);
+      result_ *= ((poincare_constant_ * diameter_ * diameter_) / min_diffusion_value_);
+      finalized_ = true;
     }
   } // ... finalize(...)
 
 private:
   const LocalSpaceType& local_space_;
   const ProblemType& problem_;
-  const std::shared_ptr< const typename ProblemType::NonparametricType > problem_mu_min_;
-  const std::shared_ptr< const typename ProblemType::NonparametricType > problem_mu_max_;
+  const DiffusionBoundsType& diffusion_bounds_;
+  const std::vector< RangeFieldType > thetas_mu_min_;
+  const std::vector< RangeFieldType > thetas_mu_max_;
   const P0SpaceType p0_space_;
   DiscreteFunctionType p0_force_;
   std::unique_ptr< const DifferenceType > difference_;
   const ConstantFunctionType constant_one_;
   const LocalOperatorType local_operator_;
   TmpStorageProviderType tmp_local_matrices_;
-  std::vector< DomainType > vertices_;
+  const DomainFieldType diameter_;
+  const RangeFieldType poincare_constant_;
   RangeFieldType min_diffusion_value_;
   bool prepared_;
   bool finalized_;
@@ -426,12 +317,14 @@ public:
 
   typedef std::map< std::string, Pymor::Parameter > ParametersMapType;
 
+  typedef DiffusionBounds< typename BlockSpaceType::GridViewType, ProblemType > DiffusionBoundsType;
+
 private:
   static const unsigned int dimDomain = GridViewType::dimension;
 
   typedef typename BlockSpaceType::LocalSpaceType LocalSpaceType;
+  typedef SubdomainMetrics< BlockSpaceType > SubdomainMetricsType;
 
-  typedef GDT::ConstDiscreteFunction< BlockSpaceType, VectorType > ConstDiscreteFunctionType;
   typedef typename BlockSpaceType::GridViewType GlobalGridViewType;
   typedef GDT::Spaces::RT::PdelabBased< GlobalGridViewType, 0, RangeFieldType, dimDomain > RTN0SpaceType;
   typedef GDT::DiscreteFunction< RTN0SpaceType, VectorType > RTN0DiscreteFunctionType;
@@ -483,21 +376,24 @@ public:
     const Pymor::Parameter mu_min = problem.parametric() ? parameters.at("parameter_range_min") : Pymor::Parameter();
     const Pymor::Parameter mu_max = problem.parametric() ? parameters.at("parameter_range_max") : Pymor::Parameter();
     // compute the diffusive flux reconstruction
-    const ConstDiscreteFunctionType discrete_solution(space, vector);
     const RTN0SpaceType rtn0_space(space.grid_view());
     RTN0DiscreteFunctionType diffusive_flux(rtn0_space);
-    const auto problem_mu = problem.with_mu(mu);
-    const GDT::Operators::DiffusiveFluxReconstruction< GlobalGridViewType, DiffusionFactorType, DiffusionTensorType >
-      diffusive_flux_reconstruction(space.grid_view(),
-                                    *problem_mu->diffusion_factor()->affine_part(),
-                                    *problem.diffusion_tensor()->affine_part(),
-                                    SWIPDG::over_integrate);
-    diffusive_flux_reconstruction.apply(discrete_solution, diffusive_flux);
+    DiffusiveFluxReconstructionOperator< BlockSpaceType, VectorType, ProblemType >::get(space, problem)
+        ->apply(vector, diffusive_flux.vector(), mu);
+    const auto subdomain_metrics = SubdomainMetricsType::get(space);
+    const auto diffusion_bounds = DiffusionBoundsType::get(space.grid_view(), problem, space.ms_grid());
     // walk the subdomains
     double eta_r_squared = 0.0;
     for (size_t subdomain = 0; subdomain < space.ms_grid()->size(); ++subdomain) {
       const auto local_space = space.local_spaces()[subdomain];
-      ThisType eta_r_T(*local_space, diffusive_flux, problem, mu_min, mu_max);
+      ThisType eta_r_T(*local_space,
+                       *subdomain_metrics,
+                       subdomain,
+                       *diffusion_bounds,
+                       diffusive_flux,
+                       problem,
+                       mu_min,
+                       mu_max);
       Stuff::Grid::Walker< GridViewType > grid_walker(local_space->grid_view());
       grid_walker.add(eta_r_T);
       grid_walker.walk();
@@ -507,6 +403,9 @@ public:
   } // ... estimate(...)
 
   LocalResidualOS2014Star(const LocalSpaceType& local_space,
+                          const SubdomainMetricsType& subdomain_metrics,
+                          const size_t subdomain,
+                          const DiffusionBoundsType& diffusion_bounds,
                           const RTN0DiscreteFunctionType& diffusive_flux,
                           const ProblemType& problem,
                           const Pymor::Parameter mu_min = Pymor::Parameter(),
@@ -514,14 +413,16 @@ public:
     : local_space_(local_space)
     , diffusive_flux_(diffusive_flux)
     , problem_(assert_problem(problem, mu_min, mu_max))
-    , problem_mu_min_(problem_.with_mu(mu_min))
-    , problem_mu_max_(problem_.with_mu(mu_max))
+    , diffusion_bounds_(diffusion_bounds)
+    , thetas_mu_min_(diffusion_bounds_.coefficients(problem_.map_parameter(mu_min, "diffusion_factor")))
+    , thetas_mu_max_(diffusion_bounds_.coefficients(problem_.map_parameter(mu_max, "diffusion_factor")))
     , divergence_(diffusive_flux_.divergence())
     , difference_(*problem_.force()->affine_part() - divergence_)
     , constant_one_(1)
     , local_operator_(SWIPDG::over_integrate, constant_one_)
     , tmp_local_matrices_({1, local_operator_.numTmpObjectsRequired()}, 1, 1)
-    , vertices_()
+    , diameter_(subdomain_metrics.diameter(subdomain))
+    , poincare_constant_(subdomain_metrics.poincare_constant(subdomain))
     , min_diffusion_value_(std::numeric_limits< RangeFieldType >::max())
     , prepared_(false)
     , finalized_(false)
@@ -538,15 +439,12 @@ public:
 
   virtual void apply_local(const EntityType &entity)
   {
-    // collect all vertices
-    for (int cc = 0; cc < entity.template count< dimDomain >(); ++cc)
-      vertices_.push_back(entity.template subEntity< dimDomain >(cc)->geometry().center());
     // compute minimum diffusion
     // this assumes that the minimum of the diffusion factor is reached for the min or max mu
+    const size_t index = diffusion_bounds_.index(entity);
     const RangeFieldType min_diffusion_value_entity
-        =   std::min(internal::compute_minimum(*problem_mu_min_->diffusion_factor()->affine_part(), entity),
-                     internal::compute_minimum(*problem_mu_max_->diffusion_factor()->affine_part(), entity))
-          * internal::compute_minimum(*problem_.diffusion_tensor()->affine_part(), entity);
+        = std::min(diffusion_bounds_.ev_lower_bound(index, thetas_mu_min_),
+                   diffusion_bounds_.ev_lower_bound(index, thetas_mu_max_));
     min_diffusion_value_ = std::min(min_diffusion_value_, min_diffusion_value_entity);
     // compute the local product
     const auto local_difference = difference_.local_function(entity);
@@ -564,21 +462,10 @@ public:
     if (!prepared_)
       DUNE_THROW(Stuff::Exceptions::you_are_using_this_wrong, "Do not call finalize() before calling prepare()!");
     if (!finalized_) {
-      // compute diameter
-      DomainFieldType diameter(0);
-      DomainType tmp_diff;
-      for (size_t cc = 0; cc < vertices_.size(); ++cc) {
-        const auto& vertex = vertices_[cc];
-        for (size_t dd = cc + 1; dd < vertices_.size(); ++dd) {
-          const auto& other_vertex = vertices_[dd];
-          tmp_diff = vertex - other_vertex;
-          diameter = std::max(diameter, tmp_diff.two_norm());
-        }
-      }
       // compute local estimator
-      const RangeFieldType poincare_constant = 1.0 / (M_PIl * M_PIl);
       assert(min_diffusion_value_ > 0.0);
-      result_ *= ((poincare_constant * diameter * diameter) / min_diffusion_value_);
+      result_ *= ((poincare_constant_ * diameter_ * diameter_) / min_diffusion_value_);
+      finalized_ = true;
     }
   } // ... finalize(...)
 
@@ -586,14 +473,16 @@ private:
   const LocalSpaceType& local_space_;
   const RTN0DiscreteFunctionType& diffusive_flux_;
   const ProblemType& problem_;
-  const std::shared_ptr< typename ProblemType::NonparametricType > problem_mu_min_;
-  const std::shared_ptr< typename ProblemType::NonparametricType > problem_mu_max_;
+  const DiffusionBoundsType& diffusion_bounds_;
+  const std::vector< RangeFieldType > thetas_mu_min_;
+  const std::vector< RangeFieldType > thetas_mu_max_;
   const DivergenceType divergence_;
   const DifferenceType difference_;
   const ConstantFunctionType constant_one_;
   const LocalOperatorType local_operator_;
   TmpStorageProviderType tmp_local_matrices_;
-  std::vector< DomainType > vertices_;
+  const DomainFieldType diameter_;
+  const RangeFieldType poincare_constant_;
   RangeFieldType min_diffusion_value_;
   bool prepared_;
   bool finalized_;
@@ -659,11 +548,12 @@ public:
 
   static const unsigned int dimDomain = BlockSpaceType::dimDomain;
 
-private:
-  typedef GDT::ConstDiscreteFunction< BlockSpaceType, VectorType > ConstDiscreteFunctionType;
   typedef GDT::Spaces::RT::PdelabBased< GridViewType, 0, RangeFieldType, dimDomain > RTN0SpaceType;
   typedef GDT::DiscreteFunction< RTN0SpaceType, VectorType > RTN0DiscreteFunctionType;
 
+private:
+  typedef GDT::ConstDiscreteFunction< BlockSpaceType, VectorType > ConstDiscreteFunctionType;
+
   typedef typename ProblemType::DiffusionFactorType::NonparametricType DiffusionFactorType;
   typedef typename ProblemType::DiffusionTensorType::NonparametricType DiffusionTensorType;
 
@@ -719,11 +609,42 @@ public:
     : space_(space)
     , vector_(vector)
     , problem_(assert_problem(problem, mu, mu_hat))
+    , mu_(mu)
+    , problem_mu_(problem_.with_mu(mu))
+    , problem_mu_hat_(problem.with_mu(mu_hat))
+    , discrete_solution_(space_, vector_)
+    , rtn0_space_(space.grid_view())
+    , reconstructed_flux_(Stuff::Common::make_unique< RTN0DiscreteFunctionType >(rtn0_space_))
+    , diffusive_flux_(*reconstructed_flux_)
+    , local_operator_(SWIPDG::over_integrate,
+                      *problem_mu_->diffusion_factor()->affine_part(),
+                      *problem_mu_hat_->diffusion_factor()->affine_part(),
+                      *problem_.diffusion_tensor()->affine_part(),
+                      diffusive_flux_)
+    , tmp_local_matrices_({1, local_operator_.numTmpObjectsRequired()}, 1, 1)
+    , prepared_(false)
+    , result_(0.0)
+  {}
+
+  /**
+   * \brief Uses the given reconstruction of the diffusive flux of vector (w.r.t. mu) instead of computing it.
+   */
+  LocalDiffusiveFluxOS2014Star(const BlockSpaceType& space,
+                               const VectorType& vector,
+                               const ProblemType& problem,
+                               const RTN0DiscreteFunctionType& diffusive_flux,
+                               const Pymor::Parameter mu = Pymor::Parameter(),
+                               const Pymor::Parameter mu_hat = Pymor::Parameter())
+    : space_(space)
+    , vector_(vector)
+    , problem_(assert_problem(problem, mu, mu_hat))
+    , mu_(mu)
     , problem_mu_(problem_.with_mu(mu))
     , problem_mu_hat_(problem.with_mu(mu_hat))
     , discrete_solution_(space_, vector_)
     , rtn0_space_(space.grid_view())
-    , diffusive_flux_(rtn0_space_)
+    , reconstructed_flux_(nullptr)
+    , diffusive_flux_(diffusive_flux)
     , local_operator_(SWIPDG::over_integrate,
                       *problem_mu_->diffusion_factor()->affine_part(),
                       *problem_mu_hat_->diffusion_factor()->affine_part(),
@@ -737,12 +658,9 @@ public:
   virtual void prepare()
   {
     if (!prepared_) {
-      const GDT::Operators::DiffusiveFluxReconstruction< GridViewType, DiffusionFactorType, DiffusionTensorType >
-        diffusive_flux_reconstruction(space_.grid_view(),
-                                      *problem_mu_->diffusion_factor()->affine_part(),
-                                      *problem_.diffusion_tensor()->affine_part(),
-                                      SWIPDG::over_integrate);
-      diffusive_flux_reconstruction.apply(discrete_solution_, diffusive_flux_);
+      if (reconstructed_flux_)
+        DiffusiveFluxReconstructionOperator< BlockSpaceType, VectorType, ProblemType >::get(space_, problem_)
+            ->apply(vector_, reconstructed_flux_->vector(), mu_);
       result_ = 0.0;
       prepared_ = true;
     }
@@ -764,11 +682,13 @@ private:
   const BlockSpaceType& space_;
   const VectorType& vector_;
   const ProblemType& problem_;
+  const Pymor::Parameter mu_;
   const std::shared_ptr< const typename ProblemType::NonparametricType > problem_mu_;
   const std::shared_ptr< const typename ProblemType::NonparametricType > problem_mu_hat_;
   const ConstDiscreteFunctionType discrete_solution_;
   const RTN0SpaceType rtn0_space_;
-  RTN0DiscreteFunctionType diffusive_flux_;
+  std::unique_ptr< RTN0DiscreteFunctionType > reconstructed_flux_;
+  const RTN0DiscreteFunctionType& diffusive_flux_;
   const LocalOperatorType local_operator_;
   TmpStorageProviderType tmp_local_matrices_;
   bool prepared_;
@@ -912,23 +832,22 @@ public:
     RangeFieldType eta_df_squared = 0.0;
     Stuff::LA::CommonDenseVector< RangeFieldType > indicators(space.ms_grid()->size(), 0.0);
 
+    // the residual does not depend on the solution, so we use the cached local contributions
+    const auto eta_r_squared_locally = LocalResidualOS2014Type::estimate_locally(space, problem, mu_min, mu_max);
+
     // walk the subdomains
     for (size_t subdomain = 0; subdomain < space.ms_grid()->size(); ++subdomain) {
       const auto local_space = space.local_spaces()[subdomain];
-      LocalResidualOS2014Type eta_r_T(*local_space, problem, mu_min, mu_max);
-      eta_r_T.prepare();
       eta_nc.result_ = 0.0;
       eta_df.result_ = 0.0;
       // walk the local grid
       const auto local_grid_view = local_space->grid_view();
       for (const auto& entity : Stuff::Common::entityRange(local_grid_view)) {
         eta_nc.apply_local(entity);
-        eta_r_T.apply_local(entity);
         eta_df.apply_local(entity);
       } // walk the local grid
-      eta_r_T.finalize();
       const RangeFieldType eta_nc_T_squared = eta_nc.result_;
-      const RangeFieldType eta_r_T_squared  = eta_r_T.result_;
+      const RangeFieldType eta_r_T_squared  = (*eta_r_squared_locally)[subdomain];
       const RangeFieldType eta_df_T_squared = eta_df.result_;
       // compute indicators
       indicators[subdomain] = 3.0/std::sqrt(alpha_mu_mu_bar) * (std::sqrt(gamma_mu_mu_bar)*eta_nc_T_squared
@@ -1068,23 +987,12 @@ public:
     assert(alpha_mu_mu_hat > 0.0);
     assert(gamma_mu_mu_bar > 0.0);
     // compute the diffusive flux reconstruction
-    typedef GDT::ConstDiscreteFunction< BlockSpaceType, VectorType > ConstDiscreteFunctionType;
-    typedef typename BlockSpaceType::GridViewType                    GlobalGridViewType;
-    typedef GDT::Spaces::RT::PdelabBased
-        < GlobalGridViewType, 0, RangeFieldType, dimDomain >         RTN0SpaceType;
-    typedef GDT::DiscreteFunction< RTN0SpaceType, VectorType >       RTN0DiscreteFunctionType;
-    const ConstDiscreteFunctionType discrete_solution(space, vector);
-    const RTN0SpaceType rtn0_space(space.grid_view());
-    RTN0DiscreteFunctionType diffusive_flux(rtn0_space);
-    const auto problem_mu = problem.with_mu(mu);
-    typedef typename ProblemType::DiffusionFactorType::NonparametricType DiffusionFactorType;
-    typedef typename ProblemType::DiffusionTensorType::NonparametricType DiffusionTensorType;
-    const GDT::Operators::DiffusiveFluxReconstruction< GlobalGridViewType, DiffusionFactorType, DiffusionTensorType >
-      diffusive_flux_reconstruction(space.grid_view(),
-                                    *problem_mu->diffusion_factor()->affine_part(),
-                                    *problem.diffusion_tensor()->affine_part(),
-                                    SWIPDG::over_integrate);
-    diffusive_flux_reconstruction.apply(discrete_solution, diffusive_flux);
+    typedef DiffusiveFluxReconstructionOperator< BlockSpaceType, VectorType, ProblemType > FluxReconstructionType;
+    typedef GDT::DiscreteFunction< typename FluxReconstructionType::RTN0SpaceType, VectorType >
+        RTN0DiscreteFunctionType;
+    const auto flux_reconstruction = FluxReconstructionType::get(space, problem);
+    RTN0DiscreteFunctionType diffusive_flux(flux_reconstruction->range_space());
+    flux_reconstruction->apply(vector, diffusive_flux.vector(), mu);
 
     typedef LocalNonconformityOS2014
         < BlockSpaceType, VectorType, ProblemType, GridType > LocalNonconformityOS2014Type;
@@ -1100,10 +1008,22 @@ public:
     eta_df.prepare();
     Stuff::LA::CommonDenseVector< RangeFieldType > indicators(space.ms_grid()->size(), 0.0);
 
+    const auto subdomain_metrics = SubdomainMetrics< BlockSpaceType >::get(space);
+    const auto diffusion_bounds = LocalResidualOS2014Type::DiffusionBoundsType::get(space.grid_view(),
+                                                                                    problem,
+                                                                                    space.ms_grid());
+
     // walk the subdomains
     for (size_t subdomain = 0; subdomain < space.ms_grid()->size(); ++subdomain) {
       const auto local_space = space.local_spaces()[subdomain];
-      LocalResidualOS2014Type eta_r_T(*local_space, diffusive_flux, problem, mu_min, mu_max);
+      LocalResidualOS2014Type eta_r_T(*local_space,
+                                      *subdomain_metrics,
+                                      subdomain,
+                                      *diffusion_bounds,
+                                      diffusive_flux,
+                                      problem,
+                                      mu_min,
+                                      mu_max);
       eta_r_T.prepare();
       eta_nc.result_ = 0.0;
       eta_df.result_ = 0.0;
@@ -1130,16 +1050,396 @@ public:
 #endif // HAVE_ALUGRID
 
 
+template< class BlockSpaceType, class VectorType, class ProblemType, class GridType >
+class Session
+{
+public:
+  static const bool available = false;
+
+  static bool handles(const ProblemType& /*problem*/)
+  {
+    return false;
+  }
+
+  static std::vector< std::string > available_types()
+  {
+    return std::vector< std::string >();
+  }
+
+  static std::vector< std::string > available_local_types()
+  {
+    return std::vector< std::string >();
+  }
+};
+
+#if HAVE_ALUGRID
+
+/**
+ * \brief Computes all estimators of OS2014 for one given vector and set of parameters, sharing all intermediate
+ *        quantities.
+ *
+ *        Each local component (and the diffusive flux reconstruction they depend on) is computed on first request and
+ *        then kept, so that any sequence of estimate() and estimate_local() calls costs at most one walk over the
+ *        grid per component and one flux reconstruction.
+ * \note  The session holds a copy of the vector and the parameters, use matches() to check if it can be reused.
+ */
+template< class BlockSpaceType, class VectorType, class ProblemType >
+class Session< BlockSpaceType, VectorType, ProblemType, ALUGrid< 2, 2, simplex, conforming > >
+{
+  typedef ALUGrid< 2, 2, simplex, conforming > GridType;
+  typedef LocalNonconformityOS2014< BlockSpaceType, VectorType, ProblemType, GridType > LocalNonconformityType;
+  typedef LocalResidualOS2014< BlockSpaceType, VectorType, ProblemType, GridType >      LocalResidualType;
+  typedef LocalResidualOS2014Star< BlockSpaceType, VectorType, ProblemType, GridType >  LocalResidualStarType;
+  typedef SWIPDG::LocalDiffusiveFluxESV2007
+      < BlockSpaceType, VectorType, ProblemType, GridType >                             LocalDiffusiveFluxType;
+  typedef LocalDiffusiveFluxOS2014Star
+      < BlockSpaceType, VectorType, ProblemType, GridType >                             LocalDiffusiveFluxStarType;
+  typedef DiffusiveFluxReconstructionOperator< BlockSpaceType, VectorType, ProblemType > FluxReconstructionType;
+  typedef typename LocalDiffusiveFluxStarType::RTN0DiscreteFunctionType                RTN0DiscreteFunctionType;
+
+  static const ProblemType& assert_problem(const ProblemType& problem)
+  {
+    if (!handles(problem))
+      DUNE_THROW(Stuff::Exceptions::requirements_not_met,
+                 "Not implemented for parametric diffusion_tensor, force, dirichlet or neumann!");
+    return problem;
+  } // ... assert_problem(...)
+
+  static std::string to_string(const std::map< std::string, Pymor::Parameter >& parameters)
+  {
+    std::ostringstream ss;
+    ss.precision(std::numeric_limits< double >::digits10 + 2);
+    for (const auto& element : parameters)
+      ss << element.first << ": " << element.second << ";";
+    return ss.str();
+  }
+
+public:
+  static const bool available = true;
+
+  typedef typename ProblemType::RangeFieldType RangeFieldType;
+  typedef std::map< std::string, Pymor::Parameter > ParametersMapType;
+  typedef std::vector< RangeFieldType > LocalValuesType;
+
+  /**
+   * \brief Whether a session can be created for the given problem, use the estimators directly otherwise.
+   */
+  static bool handles(const ProblemType& problem)
+  {
+    return !problem.diffusion_tensor()->parametric()
+        && !problem.force()->parametric()
+        && !problem.dirichlet()->parametric()
+        && !problem.neumann()->parametric();
+  } // ... handles(...)
+
+  /**
+   * \brief The types supported by estimate().
+   */
+  static std::vector< std::string > available_types()
+  {
+    return { LocalNonconformityType::id(),
+             LocalResidualOS2014Base::id(),
+             LocalResidualOS2014StarBase::id(),
+             LocalDiffusiveFluxOS2014< BlockSpaceType, VectorType, ProblemType, GridType >::id(),
+             LocalDiffusiveFluxOS2014StarBase::id(),
+             OS2014Base::id(),
+             OS2014StarBase::id() };
+  } // ... available_types(...)
+
+  /**
+   * \brief The types supported by estimate_local().
+   */
+  static std::vector< std::string > available_local_types()
+  {
+    return { OS2014Base::id(), OS2014StarBase::id() };
+  }
+
+  /**
+   * \param parameters has to contain 'mu', 'mu_hat', 'mu_bar', 'parameter_range_min' and 'parameter_range_max' (if
+   *        the problem is parametric and the respective estimators are requested).
+   */
+  Session(const BlockSpaceType& space,
+          const VectorType& vector,
+          const ProblemType& problem,
+          const ParametersMapType parameters = ParametersMapType())
+    : space_(space)
+    , vector_(vector)
+    , problem_(assert_problem(problem))
+    , parameters_(parameters)
+    , parameters_string_(to_string(parameters_))
+  {}
+
+  const VectorType& vector() const
+  {
+    return vector_;
+  }
+
+  const ParametersMapType& parameters() const
+  {
+    return parameters_;
+  }
+
+  bool matches(const VectorType& vector, const ParametersMapType& parameters) const
+  {
+    if (to_string(parameters) != parameters_string_)
+      return false;
+    if (vector.size() != vector_.size())
+      return false;
+    for (size_t ii = 0; ii < vector_.size(); ++ii)
+      if (vector.get_entry(ii) != vector_.get_entry(ii))
+        return false;
+    return true;
+  } // ... matches(...)
+
+  RangeFieldType estimate(const std::string& type)
+  {
+    if (type == LocalNonconformityType::id())
+      return std::sqrt(sum(nonconformity_locally()));
+    else if (type == LocalResidualOS2014Base::id())
+      return std::sqrt(sum(residual_locally()));
+    else if (type == LocalResidualOS2014StarBase::id())
+      return std::sqrt(sum(residual_star_locally()));
+    else if (type == LocalDiffusiveFluxOS2014< BlockSpaceType, VectorType, ProblemType, GridType >::id())
+      return std::sqrt(sum(diffusive_flux_locally()));
+    else if (type == LocalDiffusiveFluxOS2014StarBase::id())
+      return std::sqrt(sum(diffusive_flux_star_locally()));
+    else if (type == OS2014Base::id()) {
+      const auto factors = compute_factors();
+      return (1.0/std::sqrt(factors.alpha_mu_mu_bar))
+          * (  std::sqrt(factors.gamma_mu_mu_bar) * std::sqrt(sum(nonconformity_locally()))
+             +                                      std::sqrt(sum(residual_locally()))
+             + factors.sqrt_gamma_tilde           * std::sqrt(sum(diffusive_flux_locally())));
+    } else if (type == OS2014StarBase::id()) {
+      const auto factors = compute_factors();
+      return (1.0/std::sqrt(factors.alpha_mu_mu_bar))
+          * (  std::sqrt(factors.gamma_mu_mu_bar)     * std::sqrt(sum(nonconformity_locally()))
+             +                                          std::sqrt(sum(residual_star_locally()))
+             + (1.0/std::sqrt(factors.alpha_mu_mu_hat)) * std::sqrt(sum(diffusive_flux_star_locally())));
+    } else
+      DUNE_THROW(Stuff::Exceptions::you_are_using_this_wrong, "Requested type '" << type << "' is not available!");
+  } // ... estimate(...)
+
+  Stuff::LA::CommonDenseVector< RangeFieldType > estimate_local(const std::string& type)
+  {
+    Stuff::LA::CommonDenseVector< RangeFieldType > indicators(space_.ms_grid()->size(), 0.0);
+    const auto factors = compute_factors();
+    if (type == OS2014Base::id()) {
+      const auto& eta_nc_T_squared = nonconformity_locally();
+      const auto& eta_r_T_squared  = residual_locally();
+      const auto& eta_df_T_squared = diffusive_flux_locally();
+      for (size_t subdomain = 0; subdomain < indicators.size(); ++subdomain)
+        indicators[subdomain] = 3.0/std::sqrt(factors.alpha_mu_mu_bar)
+                                * (std::sqrt(factors.gamma_mu_mu_bar)*eta_nc_T_squared[subdomain]
+                                   + eta_r_T_squared[subdomain]
+                                   + factors.sqrt_gamma_tilde*eta_df_T_squared[subdomain]);
+      const RangeFieldType eta_squared
+          = std::pow(1.0/std::sqrt(factors.alpha_mu_mu_bar)
+                       * (std::sqrt(factors.gamma_mu_mu_bar)*std::sqrt(sum(eta_nc_T_squared))
+                          + std::sqrt(sum(eta_r_T_squared))
+                          + factors.sqrt_gamma_tilde*std::sqrt(sum(eta_df_T_squared))),
+                     2);
+      for (auto& element : indicators)
+        element /= eta_squared;
+    } else if (type == OS2014StarBase::id()) {
+      const auto& eta_nc_T_squared = nonconformity_locally();
+      const auto& eta_r_T_squared  = residual_star_locally();
+      const auto& eta_df_T_squared = diffusive_flux_star_locally();
+      for (size_t subdomain = 0; subdomain < indicators.size(); ++subdomain)
+        indicators[subdomain] = std::sqrt(3.0/std::sqrt(factors.alpha_mu_mu_bar)
+                                          * (std::sqrt(factors.gamma_mu_mu_bar)*eta_nc_T_squared[subdomain]
+                                             + eta_r_T_squared[subdomain]
+                                             + std::sqrt(factors.alpha_mu_mu_hat)*eta_df_T_squared[subdomain]));
+    } else
+      DUNE_THROW(Stuff::Exceptions::you_are_using_this_wrong, "Requested type '" << type << "' is not available!");
+    return indicators;
+  } // ... estimate_local(...)
+
+  /**
+   * \brief The reconstruction of the diffusive flux of the vector w.r.t. 'mu'.
+   */
+  const RTN0DiscreteFunctionType& diffusive_flux()
+  {
+    if (!diffusive_flux_) {
+      const auto flux_reconstruction = FluxReconstructionType::get(space_, problem_);
+      diffusive_flux_ = Stuff::Common::make_unique< RTN0DiscreteFunctionType >(flux_reconstruction->range_space());
+      flux_reconstruction->apply(vector_, diffusive_flux_->vector(), get_parameter("mu"));
+    }
+    return *diffusive_flux_;
+  } // ... diffusive_flux(...)
+
+  // the following return the squared local contributions of each subdomain
+  const LocalValuesType& nonconformity_locally()
+  {
+    if (!nonconformity_) {
+      LocalNonconformityType estimator(space_, vector_, problem_, get_parameter("mu_bar"));
+      nonconformity_ = walk_subdomains(estimator);
+    }
+    return *nonconformity_;
+  } // ... nonconformity_locally(...)
+
+  const LocalValuesType& residual_locally()
+  {
+    if (!residual_)
+      residual_ = LocalResidualType::estimate_locally(space_,
+                                                      problem_,
+                                                      get_parameter("parameter_range_min"),
+                                                      get_parameter("parameter_range_max"));
+    return *residual_;
+  } // ... residual_locally(...)
+
+  const LocalValuesType& residual_star_locally()
+  {
+    if (!residual_star_) {
+      const auto subdomain_metrics = SubdomainMetrics< BlockSpaceType >::get(space_);
+      const auto diffusion_bounds = LocalResidualStarType::DiffusionBoundsType::get(space_.grid_view(),
+                                                                                    problem_,
+                                                                                    space_.ms_grid());
+      const auto mu_min = get_parameter("parameter_range_min");
+      const auto mu_max = get_parameter("parameter_range_max");
+      LocalValuesType values(space_.ms_grid()->size(), 0.0);
+      for (size_t subdomain = 0; subdomain < space_.ms_grid()->size(); ++subdomain) {
+        const auto local_space = space_.local_spaces()[subdomain];
+        LocalResidualStarType eta_r_T(*local_space,
+                                      *subdomain_metrics,
+                                      subdomain,
+                                      *diffusion_bounds,
+                                      diffusive_flux(),
+                                      problem_,
+                                      mu_min,
+                                      mu_max);
+        eta_r_T.prepare();
+        for (const auto& entity : Stuff::Common::entityRange(local_space->grid_view()))
+          eta_r_T.apply_local(entity);
+        eta_r_T.finalize();
+        values[subdomain] = eta_r_T.result_;
+      }
+      residual_star_ = std::make_shared< const LocalValuesType >(std::move(values));
+    }
+    return *residual_star_;
+  } // ... residual_star_locally(...)
+
+  const LocalValuesType& diffusive_flux_locally()
+  {
+    if (!diffusive_flux_estimate_) {
+      LocalDiffusiveFluxType estimator(space_,
+                                       vector_,
+                                       problem_,
+                                       diffusive_flux(),
+                                       get_parameter("mu"),
+                                       get_parameter("mu_hat"));
+      diffusive_flux_estimate_ = walk_subdomains(estimator);
+    }
+    return *diffusive_flux_estimate_;
+  } // ... diffusive_flux_locally(...)
+
+  const LocalValuesType& diffusive_flux_star_locally()
+  {
+    if (!diffusive_flux_star_) {
+      LocalDiffusiveFluxStarType estimator(space_,
+                                           vector_,
+                                           problem_,
+                                           diffusive_flux(),
+                                           get_parameter("mu"),
+                                           get_parameter("mu_hat"));
+      diffusive_flux_star_ = walk_subdomains(estimator);
+    }
+    return *diffusive_flux_star_;
+  } // ... diffusive_flux_star_locally(...)
+
+private:
+  struct Factors
+  {
+    double alpha_mu_mu_bar;
+    double alpha_mu_mu_hat;
+    double gamma_mu_mu_bar;
+    double sqrt_gamma_tilde;
+  }; // struct Factors
+
+  Factors compute_factors() const
+  {
+    const auto mu     = get_parameter("mu");
+    const auto mu_hat = get_parameter("mu_hat");
+    const auto mu_bar = get_parameter("mu_bar");
+    Factors factors;
+    factors.alpha_mu_mu_bar = problem_.diffusion_factor()->alpha(mu, mu_bar);
+    factors.alpha_mu_mu_hat = problem_.diffusion_factor()->alpha(mu, mu_hat);
+    factors.gamma_mu_mu_bar = problem_.diffusion_factor()->gamma(mu, mu_bar);
+    const double gamma_mu_mu_hat = problem_.diffusion_factor()->gamma(mu, mu_hat);
+    assert(factors.alpha_mu_mu_bar > 0.0);
+    assert(factors.alpha_mu_mu_hat > 0.0);
+    assert(factors.gamma_mu_mu_bar > 0.0);
+    assert(gamma_mu_mu_hat > 0.0);
+    factors.sqrt_gamma_tilde = std::max(std::sqrt(gamma_mu_mu_hat), 1.0/std::sqrt(factors.alpha_mu_mu_hat));
+    return factors;
+  } // ... compute_factors(...)
+
+  Pymor::Parameter get_parameter(const std::string& key) const
+  {
+    if (!problem_.parametric())
+      return Pymor::Parameter();
+    const auto result = parameters_.find(key);
+    if (result == parameters_.end())
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given, "Given parameters are missing '" << key << "'!");
+    return result->second;
+  } // ... get_parameter(...)
+
+  /**
+   * \note Works for all local estimators, which sum up their local contributions in result_.
+   */
+  template< class LocalEstimatorType >
+  std::shared_ptr< const LocalValuesType > walk_subdomains(LocalEstimatorType& estimator) const
+  {
+    estimator.prepare();
+    LocalValuesType values(space_.ms_grid()->size(), 0.0);
+    for (size_t subdomain = 0; subdomain < space_.ms_grid()->size(); ++subdomain) {
+      estimator.result_ = 0.0;
+      for (const auto& entity : Stuff::Common::entityRange(space_.local_spaces()[subdomain]->grid_view()))
+        estimator.apply_local(entity);
+      values[subdomain] = estimator.result_;
+    }
+    return std::make_shared< const LocalValuesType >(std::move(values));
+  } // ... walk_subdomains(...)
+
+  static RangeFieldType sum(const LocalValuesType& values)
+  {
+    return std::accumulate(values.begin(), values.end(), RangeFieldType(0));
+  }
+
+  const BlockSpaceType& space_;
+  const VectorType vector_;
+  const ProblemType& problem_;
+  const ParametersMapType parameters_;
+  const std::string parameters_string_;
+  std::unique_ptr< RTN0DiscreteFunctionType > diffusive_flux_;
+  std::shared_ptr< const LocalValuesType > nonconformity_;
+  std::shared_ptr< const LocalValuesType > residual_;
+  std::shared_ptr< const LocalValuesType > residual_star_;
+  std::shared_ptr< const LocalValuesType > diffusive_flux_estimate_;
+  std::shared_ptr< const LocalValuesType > diffusive_flux_star_;
+}; // class Session< ..., ALUGrid< 2, 2, simplex, conforming > >
+
+#endif // HAVE_ALUGRID
+
+
 } // namespace BlockSWIPDG
 } // namespace internal
 
 
+/**
+ * \note The vectors have to be given in the numbering of the space, convert the vectors of a renumbered
+ *       discretization by its to_space_numbering() first.
+ */
 template< class BlockSpaceType, class VectorType, class ProblemType, class GridType >
 class BlockSWIPDG
 {
 public:
   typedef typename ProblemType::RangeFieldType RangeFieldType;
   typedef std::map< std::string, Pymor::Parameter > ParametersMapType;
+  /**
+   * \brief Use a session instead of estimate() and estimate_local() to evaluate several estimators for the same
+   *        vector and parameters (available if SessionType::available is true).
+   */
+  typedef internal::BlockSWIPDG::Session< BlockSpaceType, VectorType, ProblemType, GridType > SessionType;
 
 private:
   template< class IndividualEstimator, bool available = false >
@@ -0,0 +1,159 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_ESTIMATORS_COMPRESSED_ROW_MATRIX_HH
+#define DUNE_HDD_LINEARELLIPTIC_ESTIMATORS_COMPRESSED_ROW_MATRIX_HH
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/la/container/interfaces.hh>
+#include <dune/stuff/la/container/pattern.hh>
+
+namespace Dune {
+namespace HDD {
+namespace LinearElliptic {
+namespace Estimators {
+namespace internal {
+
+
+/**
+ * \brief Minimal sparse matrix in compressed row storage, used for the assembled operators of the estimators.
+ *
+ *        Can be applied to any vector of the Stuff::LA containers, use to_matrix() to obtain a matrix of a specific
+ *        backend.
+ */
+template< class RangeFieldType >
+class CompressedRowMatrix
+{
+public:
+  CompressedRowMatrix(const std::vector< std::map< size_t, RangeFieldType > >& rows, const size_t cols)
+    : rows_(rows.size())
+    , cols_(cols)
+    , row_offsets_(rows_ + 1, 0)
+  {
+    for (size_t ii = 0; ii < rows_; ++ii) {
+      row_offsets_[ii + 1] = row_offsets_[ii] + rows[ii].size();
+      for (const auto& element : rows[ii]) {
+        assert(element.first < cols_);
+        column_indices_.push_back(element.first);
+        values_.push_back(element.second);
+      }
+    }
+  } // CompressedRowMatrix(...)
+
+  size_t rows() const
+  {
+    return rows_;
+  }
+
+  size_t cols() const
+  {
+    return cols_;
+  }
+
+  size_t non_zeros() const
+  {
+    return values_.size();
+  }
+
+  /**
+   * \brief Computes range = alpha * (*this) * source + beta * range.
+   * \note  source and range must not be the same vector.
+   */
+  template< class S, class R >
+  void apply(const Stuff::LA::VectorInterface< S >& source,
+             Stuff::LA::VectorInterface< R >& range,
+             const RangeFieldType alpha = 1.0,
+             const RangeFieldType beta = 0.0) const
+  {
+    if (source.size() != cols_)
+      DUNE_THROW(Stuff::Exceptions::shapes_do_not_match,
+                 "source.size() = " << source.size() << ", cols() = " << cols_);
+    if (range.size() != rows_)
+      DUNE_THROW(Stuff::Exceptions::shapes_do_not_match,
+                 "range.size() = " << range.size() << ", rows() = " << rows_);
+    if (static_cast< const void* >(&source) == static_cast< const void* >(&range))
+      DUNE_THROW(Stuff::Exceptions::you_are_using_this_wrong, "source and range must not be the same vector!");
+    for (size_t ii = 0; ii < rows_; ++ii) {
+      RangeFieldType value = 0.0;
+      for (size_t kk = row_offsets_[ii]; kk < row_offsets_[ii + 1]; ++kk)
+        value += values_[kk] * source.get_entry(column_indices_[kk]);
+      range.set_entry(ii, alpha * value + (beta == 0.0 ? 0.0 : beta * range.get_entry(ii)));
+    }
+  } // ... apply(...)
+
+  /**
+   * \brief Computes ranges[vv] = (*this) * sources[vv] for all vv with one pass over the matrix (which pays off for
+   *        many vectors, e.g. a reduced basis, as the matrix is only read once).
+   * \note  None of the sources may be one of the ranges.
+   */
+  template< class S, class R >
+  void apply(const std::vector< S >& sources, std::vector< R >& ranges) const
+  {
+    if (ranges.size() != sources.size())
+      DUNE_THROW(Stuff::Exceptions::shapes_do_not_match,
+                 "ranges.size() = " << ranges.size() << ", sources.size() = " << sources.size());
+    const size_t num_vectors = sources.size();
+    for (size_t vv = 0; vv < num_vectors; ++vv) {
+      if (sources[vv].size() != cols_)
+        DUNE_THROW(Stuff::Exceptions::shapes_do_not_match,
+                   "sources[" << vv << "].size() = " << sources[vv].size() << ", cols() = " << cols_);
+      if (ranges[vv].size() != rows_)
+        DUNE_THROW(Stuff::Exceptions::shapes_do_not_match,
+                   "ranges[" << vv << "].size() = " << ranges[vv].size() << ", rows() = " << rows_);
+      for (size_t ww = 0; ww < num_vectors; ++ww)
+        if (static_cast< const void* >(&sources[ww]) == static_cast< const void* >(&ranges[vv]))
+          DUNE_THROW(Stuff::Exceptions::you_are_using_this_wrong, "sources and ranges must not overlap!");
+    }
+    std::vector< RangeFieldType > values(num_vectors);
+    for (size_t ii = 0; ii < rows_; ++ii) {
+      std::fill(values.begin(), values.end(), RangeFieldType(0));
+      for (size_t kk = row_offsets_[ii]; kk < row_offsets_[ii + 1]; ++kk)
+        for (size_t vv = 0; vv < num_vectors; ++vv)
+          values[vv] += values_[kk] * sources[vv].get_entry(column_indices_[kk]);
+      for (size_t vv = 0; vv < num_vectors; ++vv)
+        ranges[vv].set_entry(ii, values[vv]);
+    }
+  } // ... apply(...)
+
+  Stuff::LA::SparsityPatternDefault pattern() const
+  {
+    Stuff::LA::SparsityPatternDefault ret(rows_);
+    for (size_t ii = 0; ii < rows_; ++ii)
+      for (size_t kk = row_offsets_[ii]; kk < row_offsets_[ii + 1]; ++kk)
+        ret.insert(ii, column_indices_[kk]);
+    ret.sort();
+    return ret;
+  } // ... pattern(...)
+
+  template< class MatrixType >
+  MatrixType to_matrix() const
+  {
+    MatrixType ret(rows_, cols_, pattern());
+    for (size_t ii = 0; ii < rows_; ++ii)
+      for (size_t kk = row_offsets_[ii]; kk < row_offsets_[ii + 1]; ++kk)
+        ret.set_entry(ii, column_indices_[kk], values_[kk]);
+    return ret;
+  } // ... to_matrix(...)
+
+private:
+  size_t rows_;
+  size_t cols_;
+  std::vector< size_t > row_offsets_;
+  std::vector< size_t > column_indices_;
+  std::vector< RangeFieldType > values_;
+}; // class CompressedRowMatrix
+
+
+} // namespace internal
+} // namespace Estimators
+} // namespace LinearElliptic
+} // namespace HDD
+} // namespace Dune
+
+#endif // DUNE_HDD_LINEARELLIPTIC_ESTIMATORS_COMPRESSED_ROW_MATRIX_HH
@@ -0,0 +1,113 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_ESTIMATORS_DATA_TERMS_CACHE_HH
+#define DUNE_HDD_LINEARELLIPTIC_ESTIMATORS_DATA_TERMS_CACHE_HH
+
+#include <functional>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dune/stuff/common/ranges.hh>
+
+#include <dune/pymor/parameters/base.hh>
+
+#include <dune/hdd/linearelliptic/cache.hh>
+
+namespace Dune {
+namespace HDD {
+namespace LinearElliptic {
+namespace Estimators {
+namespace internal {
+
+
+/**
+ * \brief Identifies the elements of a grid view which is not held by a shared_ptr (and can thus not be a dependency of
+ *        DataTermsCache): the address and the size of the grid and a hash of all element centers.
+ * \note  This walks the whole grid view: compute it once per estimator (or session) and hand it on to all lookups.
+ */
+template< class GridViewType >
+std::string grid_view_fingerprint(const GridViewType& grid_view)
+{
+  std::size_t hash = 0;
+  for (const auto& entity : Stuff::Common::entityRange(grid_view)) {
+    const auto center = entity.geometry().center();
+    for (size_t dd = 0; dd < center.size(); ++dd)
+      hash ^= std::hash< double >()(center[dd]) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  }
+  std::ostringstream ss;
+  ss << &grid_view.grid() << ";" << grid_view.indexSet().size(0) << ";" << std::hex << hash;
+  return ss.str();
+} // ... grid_view_fingerprint(...)
+
+
+/**
+ * \brief Stores local contributions of estimator components which depend neither on the solution nor on the
+ *        parameter (see depends_on_solution and depends_on_parameter of the individual estimators).
+ *
+ *        An entry is identified by the objects it was computed from (e.g. the multiscale grid and the data functions
+ *        of the problem, given as shared_ptrs), a list of parameters (e.g. the parameter range) and an optional key
+ *        (e.g. a grid_view_fingerprint()), see LinearElliptic::internal::DependentCache. At most max_entries entries
+ *        are kept.
+ */
+template< class EstimatorType, class RangeFieldType >
+class DataTermsCache
+{
+  typedef std::vector< RangeFieldType >                          ValuesType;
+  typedef LinearElliptic::internal::DependentCache< ValuesType > CacheType;
+
+  static std::string to_string(const std::vector< Pymor::Parameter >& parameters, const std::string& key)
+  {
+    std::ostringstream ss;
+    ss.precision(std::numeric_limits< RangeFieldType >::digits10 + 2);
+    for (const auto& parameter : parameters)
+      ss << parameter << ";";
+    ss << key;
+    return ss.str();
+  }
+
+  static CacheType& cache()
+  {
+    static CacheType cache_(max_entries);
+    return cache_;
+  }
+
+public:
+  static const size_t max_entries = 16;
+
+  static std::shared_ptr< const ValuesType > get(const std::vector< std::shared_ptr< const void > >& dependencies,
+                                                 const std::vector< Pymor::Parameter >& parameters,
+                                                 const std::function< ValuesType() >& compute,
+                                                 const std::string& key = "")
+  {
+    return cache().get(dependencies, to_string(parameters, key), [&]() {
+      return std::make_shared< const ValuesType >(compute());
+    });
+  }
+
+  static size_t size()
+  {
+    return cache().size();
+  }
+
+  static void clear()
+  {
+    cache().clear();
+  }
+}; // class DataTermsCache
+
+template< class EstimatorType, class RangeFieldType >
+const size_t DataTermsCache< EstimatorType, RangeFieldType >::max_entries;
+
+} // namespace internal
+} // namespace Estimators
+} // namespace LinearElliptic
+} // namespace HDD
+} // namespace Dune
+
+#endif // DUNE_HDD_LINEARELLIPTIC_ESTIMATORS_DATA_TERMS_CACHE_HH
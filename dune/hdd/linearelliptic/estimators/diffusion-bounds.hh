@@ -0,0 +1,406 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_ESTIMATORS_DIFFUSION_BOUNDS_HH
+#define DUNE_HDD_LINEARELLIPTIC_ESTIMATORS_DIFFUSION_BOUNDS_HH
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <dune/common/typetraits.hh>
+
+#include <dune/geometry/quadraturerules.hh>
+#include <dune/geometry/referenceelements.hh>
+
+#include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/common/ranges.hh>
+
+#include <dune/pymor/parameters/base.hh>
+
+#include <dune/hdd/linearelliptic/cache.hh>
+
+#include "eigenvalues.hh"
+
+namespace Dune {
+namespace HDD {
+namespace LinearElliptic {
+namespace Estimators {
+namespace internal {
+
+
+template< class FunctionType, class EntityType, int dimRange, int dimRangeCols >
+class MinMax
+{
+  static_assert(AlwaysFalse< FunctionType >::value, "Not implemented for these dimensions!");
+};
+
+/**
+ * We try to find the minimum of a polynomial of given order by evaluating it at the points of a quadrature that
+ * would integrate this polynomial exactly.
+ * \todo These are just some heuristics and should be replaced by something proper.
+ */
+template< class FunctionType, class EntityType >
+class MinMax< FunctionType, EntityType, 1, 1 >
+{
+  typedef typename FunctionType::RangeFieldType RangeFieldType;
+
+public:
+  static RangeFieldType compute_min(const FunctionType& function, const EntityType& entity)
+  {
+    typename FunctionType::RangeType tmp_value(0);
+    RangeFieldType ret = std::numeric_limits< RangeFieldType >::max();
+    const auto local_function = function.local_function(entity);
+    const size_t ord = local_function->order();
+    assert(ord < std::numeric_limits< int >::max());
+    const auto& quadrature = QuadratureRules< typename FunctionType::DomainFieldType
+                                            , FunctionType::dimDomain >::rule(entity.type(), int(ord));
+    const auto quad_point_it_end = quadrature.end();
+    for (auto quad_point_it = quadrature.begin(); quad_point_it != quad_point_it_end; ++quad_point_it) {
+      local_function->evaluate(quad_point_it->position(), tmp_value);
+      ret = std::min(ret, tmp_value[0]);
+    }
+    return ret;
+  } // ... compute_min(...)
+
+  static RangeFieldType compute_max(const FunctionType& function, const EntityType& entity)
+  {
+    typename FunctionType::RangeType tmp_value(0);
+    RangeFieldType ret = std::numeric_limits< RangeFieldType >::lowest();
+    const auto local_function = function.local_function(entity);
+    const size_t ord = local_function->order();
+    assert(ord < std::numeric_limits< int >::max());
+    const auto& quadrature = QuadratureRules< typename FunctionType::DomainFieldType
+                                            , FunctionType::dimDomain >::rule(entity.type(), int(ord));
+    const auto quad_point_it_end = quadrature.end();
+    for (auto quad_point_it = quadrature.begin(); quad_point_it != quad_point_it_end; ++quad_point_it) {
+      local_function->evaluate(quad_point_it->position(), tmp_value);
+      ret = std::max(ret, tmp_value[0]);
+    }
+    return ret;
+  } // ... compute_max(...)
+}; // class MinMax< ..., 1, 1 >
+
+/**
+ * we basically assume that the function is constant, since we only evaluate it in the center
+ */
+template< class FunctionType, class EntityType, int dimDomain >
+class MinMax< FunctionType, EntityType, dimDomain, dimDomain >
+{
+  typedef typename FunctionType::RangeFieldType RangeFieldType;
+
+  static FieldVector< RangeFieldType, dimDomain > compute_eigenvalues(const FunctionType& function,
+                                                                      const EntityType& entity)
+  {
+    const auto local_function = function.local_function(entity);
+    assert(local_function->order() == 0);
+    const auto& reference_element = ReferenceElements< typename FunctionType::DomainFieldType
+                                                     , FunctionType::dimDomain >::general(entity.type());
+    const FieldMatrix< RangeFieldType, dimDomain, dimDomain >
+        tensor = local_function->evaluate(reference_element.position(0, 0));
+    const auto eigenvalues = symmetric_eigenvalues(tensor);
+    // assert that the eigenvalues are positive
+    assert(eigenvalues[0] > 1e-15);
+    return eigenvalues;
+  } // ... compute_eigenvalues(...)
+
+public:
+  static RangeFieldType compute_min(const FunctionType& function, const EntityType& entity)
+  {
+    return compute_eigenvalues(function, entity)[0];
+  }
+
+  static RangeFieldType compute_max(const FunctionType& function, const EntityType& entity)
+  {
+    return compute_eigenvalues(function, entity)[dimDomain - 1];
+  }
+}; // class MinMax< ..., dimDomain, dimDomain >
+
+
+template< class FunctionType, class EntityType >
+static typename FunctionType::RangeFieldType compute_minimum(const FunctionType& function, const EntityType& entity)
+{
+  static const int dimRange = FunctionType::dimRange;
+  static const int dimRangeCols = FunctionType::dimRangeCols;
+  return MinMax< FunctionType, EntityType, dimRange, dimRangeCols >::compute_min(function, entity);
+} // ... compute_minimum(...)
+
+
+template< class FunctionType, class EntityType >
+static typename FunctionType::RangeFieldType compute_maximum(const FunctionType& function, const EntityType& entity)
+{
+  static const int dimRange = FunctionType::dimRange;
+  static const int dimRangeCols = FunctionType::dimRangeCols;
+  return MinMax< FunctionType, EntityType, dimRange, dimRangeCols >::compute_max(function, entity);
+} // ... compute_maximum(...)
+
+
+} // namespace internal
+
+
+/**
+ * \brief Bounds of the diffusion on each entity, computed once for each affine component of the diffusion factor.
+ *
+ *        For \kappa_\mu = \sum_q \theta_q(\mu) \kappa_q (the affine part, if present, being the last component
+ *        with \theta = 1) and a nonparametric diffusion tensor A, we store the values of each \kappa_q at the points
+ *        at which internal::compute_minimum() and internal::compute_maximum() would evaluate \kappa_\mu (the points
+ *        of a quadrature of the highest order of all components) and at the center of each entity, as well as the
+ *        minimal and maximal eigenvalue of A on each entity. Bounds for any parameter are then given by
+ *        \sum_q \theta_q(\mu) \kappa_q evaluated at these points, which only costs O(#points * #components) and
+ *        requires neither a grid walk nor any evaluation of the data functions, while the results coincide with the
+ *        ones obtained from \kappa_\mu directly (up to rounding).
+ * \note  The parameters given to the methods of this class are the parameters of the diffusion factor (use
+ *        map_parameter() of the problem, if required).
+ * \note  Use get() to obtain the bounds for a given grid and problem: these are computed once per grid and diffusion
+ *        and then shared by all estimators.
+ */
+template< class GridViewType, class ProblemType >
+class DiffusionBounds
+{
+  typedef DiffusionBounds< GridViewType, ProblemType > ThisType;
+public:
+  typedef typename ProblemType::RangeFieldType               RangeFieldType;
+  typedef typename GridViewType::template Codim< 0 >::Entity EntityType;
+
+private:
+  typedef typename ProblemType::DiffusionFactorType                    ParametricDiffusionFactorType;
+  typedef typename ProblemType::DiffusionFactorType::NonparametricType DiffusionFactorType;
+  typedef typename DiffusionFactorType::DomainFieldType                DomainFieldType;
+  static const unsigned int                                            dimDomain = DiffusionFactorType::dimDomain;
+
+  static const ProblemType& assert_problem(const ProblemType& problem)
+  {
+    if (problem.diffusion_tensor()->parametric())
+      DUNE_THROW(Stuff::Exceptions::requirements_not_met, "Not implemented for parametric diffusion_tensor!");
+    return problem;
+  }
+
+public:
+  /**
+   * \param grid The object owning the grid of grid_view (e.g. the multiscale grid), used to identify the bounds.
+   */
+  static std::shared_ptr< const ThisType > get(const GridViewType& grid_view,
+                                               const ProblemType& problem,
+                                               const std::shared_ptr< const void >& grid)
+  {
+    static LinearElliptic::internal::DependentCache< ThisType > cache;
+    return cache.get({grid, problem.diffusion_factor(), problem.diffusion_tensor()},
+                     [&]() { return std::make_shared< const ThisType >(grid_view, problem); });
+  } // ... get(...)
+
+  DiffusionBounds(const GridViewType& grid_view, const ProblemType& problem)
+    : grid_view_(grid_view)
+    , diffusion_factor_(assert_problem(problem).diffusion_factor())
+  {
+    const auto& diffusion_factor = *diffusion_factor_;
+    const auto& diffusion_tensor = *problem.diffusion_tensor()->affine_part();
+    std::vector< std::shared_ptr< const DiffusionFactorType > > components;
+    for (DUNE_STUFF_SSIZE_T qq = 0; qq < diffusion_factor.num_components(); ++qq)
+      components.emplace_back(diffusion_factor.component(qq));
+    if (diffusion_factor.has_affine_part())
+      components.emplace_back(diffusion_factor.affine_part());
+    num_components_ = components.size();
+    const size_t num_entities = grid_view_.indexSet().size(0);
+    point_offsets_ = std::vector< size_t >(num_entities + 1, 0);
+    center_values_ = std::vector< RangeFieldType >(num_entities * num_components_, 0.0);
+    tensor_min_ev_ = std::vector< RangeFieldType >(num_entities, 0.0);
+    tensor_max_ev_ = std::vector< RangeFieldType >(num_entities, 0.0);
+    std::vector< std::vector< RangeFieldType > > values_of_entity(num_entities);
+    typename DiffusionFactorType::RangeType tmp_value(0);
+    for (const auto& entity : Stuff::Common::entityRange(grid_view_)) {
+      const size_t index = this->index(entity);
+      std::vector< std::unique_ptr< typename DiffusionFactorType::LocalfunctionType > > local_components;
+      size_t order = 0;
+      for (const auto& component : components) {
+        local_components.emplace_back(component->local_function(entity));
+        order = std::max(order, local_components.back()->order());
+      }
+      assert(order < std::numeric_limits< int >::max());
+      const auto& quadrature = QuadratureRules< DomainFieldType, dimDomain >::rule(entity.type(), int(order));
+      auto& values = values_of_entity[index];
+      for (const auto& quadrature_point : quadrature)
+        for (const auto& local_component : local_components) {
+          local_component->evaluate(quadrature_point.position(), tmp_value);
+          values.push_back(tmp_value[0]);
+        }
+      const auto& reference_element = ReferenceElements< DomainFieldType, dimDomain >::general(entity.type());
+      for (size_t qq = 0; qq < num_components_; ++qq) {
+        local_components[qq]->evaluate(reference_element.position(0, 0), tmp_value);
+        center_values_[index * num_components_ + qq] = tmp_value[0];
+      }
+      tensor_min_ev_[index] = internal::compute_minimum(diffusion_tensor, entity);
+      tensor_max_ev_[index] = internal::compute_maximum(diffusion_tensor, entity);
+    }
+    for (size_t ii = 0; ii < num_entities; ++ii)
+      point_offsets_[ii + 1] = point_offsets_[ii] + values_of_entity[ii].size();
+    point_values_.reserve(point_offsets_.back());
+    for (const auto& values : values_of_entity)
+      point_values_.insert(point_values_.end(), values.begin(), values.end());
+  } // DiffusionBounds(...)
+
+  size_t size() const
+  {
+    return tensor_min_ev_.size();
+  }
+
+  size_t index(const EntityType& entity) const
+  {
+    return grid_view_.indexSet().index(entity);
+  }
+
+  /**
+   * \brief The number of affine components, including the affine part.
+   */
+  size_t num_components() const
+  {
+    return num_components_;
+  }
+
+  const std::vector< RangeFieldType >& tensor_min_ev() const
+  {
+    return tensor_min_ev_;
+  }
+
+  const std::vector< RangeFieldType >& tensor_max_ev() const
+  {
+    return tensor_max_ev_;
+  }
+
+  /**
+   * \brief The coefficients \theta_q(\mu) of all components (the last one being 1 for the affine part, if present).
+   */
+  std::vector< RangeFieldType > coefficients(const Pymor::Parameter& mu) const
+  {
+    const auto& diffusion_factor = *diffusion_factor_;
+    std::vector< RangeFieldType > thetas;
+    for (DUNE_STUFF_SSIZE_T qq = 0; qq < diffusion_factor.num_components(); ++qq)
+      thetas.push_back(diffusion_factor.coefficient(qq)->evaluate(mu));
+    if (diffusion_factor.has_affine_part())
+      thetas.push_back(1.0);
+    assert(thetas.size() == num_components());
+    return thetas;
+  } // ... coefficients(...)
+
+  /**
+   * \brief The minimum of the diffusion factor on the entity with the given index, given the coefficients (as
+   *        computed by internal::compute_minimum()).
+   */
+  RangeFieldType factor_min(const size_t index, const std::vector< RangeFieldType >& thetas) const
+  {
+    if (num_components_ == 0)
+      return 0.0;
+    RangeFieldType ret = std::numeric_limits< RangeFieldType >::max();
+    for (size_t kk = point_offsets_[index]; kk < point_offsets_[index + 1]; kk += num_components_)
+      ret = std::min(ret, combine(&point_values_[kk], thetas));
+    return ret;
+  } // ... factor_min(...)
+
+  /**
+   * \brief The maximum of the diffusion factor on the entity with the given index, given the coefficients (as
+   *        computed by internal::compute_maximum()).
+   */
+  RangeFieldType factor_max(const size_t index, const std::vector< RangeFieldType >& thetas) const
+  {
+    if (num_components_ == 0)
+      return 0.0;
+    RangeFieldType ret = std::numeric_limits< RangeFieldType >::lowest();
+    for (size_t kk = point_offsets_[index]; kk < point_offsets_[index + 1]; kk += num_components_)
+      ret = std::max(ret, combine(&point_values_[kk], thetas));
+    return ret;
+  } // ... factor_max(...)
+
+  /**
+   * \brief A lower bound of the eigenvalues of the diffusion on the entity with the given index, given the
+   *        coefficients: the lower bound of the product of [factor_min(), factor_max()] and the interval of the
+   *        eigenvalues of the diffusion tensor (which is factor_min() * tensor_min_ev() for a positive factor).
+   */
+  RangeFieldType ev_lower_bound(const size_t index, const std::vector< RangeFieldType >& thetas) const
+  {
+    const RangeFieldType lower = factor_min(index, thetas);
+    const RangeFieldType upper = factor_max(index, thetas);
+    return std::min(std::min(lower * tensor_min_ev_[index], lower * tensor_max_ev_[index]),
+                    std::min(upper * tensor_min_ev_[index], upper * tensor_max_ev_[index]));
+  } // ... ev_lower_bound(...)
+
+  /**
+   * \brief The minimal eigenvalue of the diffusion on each entity, evaluated at the center of the entity (as computed
+   *        by internal::compute_minimum() for the product of the diffusion factor and tensor) and minimized over all
+   *        given parameters.
+   */
+  std::vector< RangeFieldType > min_ev(const std::vector< Pymor::Parameter >& mus) const
+  {
+    std::vector< RangeFieldType > ret(size(), std::numeric_limits< RangeFieldType >::max());
+    for (const auto& mu : mus) {
+      const auto thetas = coefficients(mu);
+      for (size_t ii = 0; ii < ret.size(); ++ii) {
+        const RangeFieldType factor = combine(&center_values_[ii * num_components_], thetas);
+        ret[ii] = std::min(ret[ii], factor * (factor < 0.0 ? tensor_max_ev_[ii] : tensor_min_ev_[ii]));
+      }
+    }
+    return ret;
+  } // ... min_ev(...)
+
+  std::vector< RangeFieldType > min_ev(const Pymor::Parameter& mu) const
+  {
+    return min_ev(std::vector< Pymor::Parameter >({mu}));
+  }
+
+  /**
+   * \brief The maximal eigenvalue of the diffusion on each entity, evaluated at the center of the entity (see
+   *        min_ev()).
+   */
+  std::vector< RangeFieldType > max_ev(const Pymor::Parameter& mu) const
+  {
+    const auto thetas = coefficients(mu);
+    std::vector< RangeFieldType > ret(size(), 0.0);
+    for (size_t ii = 0; ii < ret.size(); ++ii) {
+      const RangeFieldType factor = combine(&center_values_[ii * num_components_], thetas);
+      ret[ii] = factor * (factor < 0.0 ? tensor_min_ev_[ii] : tensor_max_ev_[ii]);
+    }
+    return ret;
+  } // ... max_ev(...)
+
+  RangeFieldType min_diffusion_ev(const Pymor::Parameter& mu) const
+  {
+    const auto values = min_ev(mu);
+    return values.empty() ? std::numeric_limits< RangeFieldType >::max()
+                          : *std::min_element(values.begin(), values.end());
+  }
+
+  RangeFieldType max_diffusion_ev(const Pymor::Parameter& mu) const
+  {
+    const auto values = max_ev(mu);
+    return values.empty() ? std::numeric_limits< RangeFieldType >::min()
+                          : *std::max_element(values.begin(), values.end());
+  }
+
+private:
+  RangeFieldType combine(const RangeFieldType* values, const std::vector< RangeFieldType >& thetas) const
+  {
+    assert(thetas.size() == num_components_);
+    RangeFieldType ret = 0.0;
+    for (size_t qq = 0; qq < num_components_; ++qq)
+      ret += thetas[qq] * values[qq];
+    return ret;
+  } // ... combine(...)
+
+  const GridViewType grid_view_;
+  const std::shared_ptr< const ParametricDiffusionFactorType > diffusion_factor_;
+  size_t num_components_;
+  std::vector< size_t > point_offsets_;
+  std::vector< RangeFieldType > point_values_;
+  std::vector< RangeFieldType > center_values_;
+  std::vector< RangeFieldType > tensor_min_ev_;
+  std::vector< RangeFieldType > tensor_max_ev_;
+}; // class DiffusionBounds
+
+
+} // namespace Estimators
+} // namespace LinearElliptic
+} // namespace HDD
+} // namespace Dune
+
+#endif // DUNE_HDD_LINEARELLIPTIC_ESTIMATORS_DIFFUSION_BOUNDS_HH
@@ -0,0 +1,248 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_ESTIMATORS_EIGENVALUES_HH
+#define DUNE_HDD_LINEARELLIPTIC_ESTIMATORS_EIGENVALUES_HH
+
+#include <algorithm>
+#include <cmath>
+
+#include <dune/stuff/common/disable_warnings.hh>
+# if HAVE_EIGEN
+#   include <Eigen/Eigenvalues>
+# endif
+#include <dune/stuff/common/reenable_warnings.hh>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/math.hh>
+
+#include <dune/stuff/common/exceptions.hh>
+
+namespace Dune {
+namespace HDD {
+namespace LinearElliptic {
+namespace Estimators {
+namespace internal {
+
+
+template< class FieldType, int dim >
+bool is_symmetric(const FieldMatrix< FieldType, dim, dim >& matrix)
+{
+  FieldType scale = 0.0;
+  for (int ii = 0; ii < dim; ++ii)
+    for (int jj = 0; jj < dim; ++jj)
+      scale = std::max(scale, std::abs(matrix[ii][jj]));
+  for (int ii = 0; ii < dim; ++ii)
+    for (int jj = ii + 1; jj < dim; ++jj)
+      if (std::abs(matrix[ii][jj] - matrix[jj][ii]) > 1e-14 * scale)
+        return false;
+  return true;
+} // ... is_symmetric(...)
+
+
+/**
+ * \brief Computes the eigenvalues of a matrix with real spectrum (in ascending order) using a general solver.
+ */
+template< class FieldType, int dim >
+FieldVector< FieldType, dim > general_eigenvalues(const FieldMatrix< FieldType, dim, dim >& matrix)
+{
+#if HAVE_EIGEN
+  ::Eigen::Matrix< FieldType, dim, dim > tensor;
+  for (int ii = 0; ii < dim; ++ii)
+    for (int jj = 0; jj < dim; ++jj)
+      tensor(ii, jj) = matrix[ii][jj];
+  FieldVector< FieldType, dim > ret;
+  if (is_symmetric(matrix)) {
+    ::Eigen::SelfAdjointEigenSolver< ::Eigen::Matrix< FieldType, dim, dim > >
+        eigen_solver(tensor, ::Eigen::EigenvaluesOnly);
+    assert(eigen_solver.info() == ::Eigen::Success);
+    for (int ii = 0; ii < dim; ++ii)
+      ret[ii] = eigen_solver.eigenvalues()[ii];
+  } else {
+    ::Eigen::EigenSolver< ::Eigen::Matrix< FieldType, dim, dim > > eigen_solver(tensor, false);
+    assert(eigen_solver.info() == ::Eigen::Success);
+    const auto eigenvalues = eigen_solver.eigenvalues(); // <- this should be an Eigen vector of std::complex
+    for (int ii = 0; ii < dim; ++ii) {
+      // assert this is real
+      assert(std::abs(eigenvalues[ii].imag()) < 1e-15);
+      ret[ii] = eigenvalues[ii].real();
+    }
+  }
+  std::sort(ret.begin(), ret.end());
+  return ret;
+#else // HAVE_EIGEN
+  DUNE_THROW(NotImplemented,
+             "You are missing eigen (only symmetric matrices up to dimension 3 are supported without it)!");
+  return FieldVector< FieldType, dim >(0.0);
+#endif // HAVE_EIGEN
+} // ... general_eigenvalues(...)
+
+
+/**
+ * \brief Computes the eigenvalues (in ascending order) of small symmetric matrices in closed form.
+ *
+ *        Non-symmetric matrices (and symmetric ones of dimension larger than 3) are handed over to
+ *        general_eigenvalues().
+ */
+template< class FieldType, int dim >
+class SymmetricEigenvalues
+{
+public:
+  static FieldVector< FieldType, dim > compute(const FieldMatrix< FieldType, dim, dim >& matrix)
+  {
+    return general_eigenvalues(matrix);
+  }
+}; // class SymmetricEigenvalues
+
+
+template< class FieldType >
+class SymmetricEigenvalues< FieldType, 1 >
+{
+public:
+  static FieldVector< FieldType, 1 > compute(const FieldMatrix< FieldType, 1, 1 >& matrix)
+  {
+    return FieldVector< FieldType, 1 >(matrix[0][0]);
+  }
+}; // class SymmetricEigenvalues< ..., 1 >
+
+
+/**
+ * Uses the quadratic formula, written such that no cancellation occurs in the discriminant.
+ */
+template< class FieldType >
+class SymmetricEigenvalues< FieldType, 2 >
+{
+public:
+  static FieldVector< FieldType, 2 > compute(const FieldMatrix< FieldType, 2, 2 >& matrix)
+  {
+    if (!is_symmetric(matrix))
+      return general_eigenvalues(matrix);
+    const FieldType mean = 0.5 * (matrix[0][0] + matrix[1][1]);
+    const FieldType radius = std::hypot(0.5 * (matrix[0][0] - matrix[1][1]), matrix[0][1]);
+    FieldVector< FieldType, 2 > ret;
+    ret[0] = mean - radius;
+    ret[1] = mean + radius;
+    return ret;
+  } // ... compute(...)
+}; // class SymmetricEigenvalues< ..., 2 >
+
+
+/**
+ * Uses the trigonometric solution of the characteristic polynomial, see for instance O. K. Smith, Eigenvalues of a
+ * symmetric 3 x 3 matrix, Communications of the ACM 4(4), 1961. Since this solution is only accurate to about the
+ * square root of the machine precision for (nearly) multiple eigenvalues, we only use it for the eigenvalue which is
+ * well separated from the others and obtain the other two from the restriction of the matrix to the orthogonal
+ * complement of its eigenvector, see D. Eberly, A robust eigensolver for 3 x 3 symmetric matrices, 2014.
+ */
+template< class FieldType >
+class SymmetricEigenvalues< FieldType, 3 >
+{
+  typedef FieldVector< FieldType, 3 > VectorType;
+
+  static VectorType cross(const VectorType& left, const VectorType& right)
+  {
+    VectorType ret;
+    ret[0] = left[1]*right[2] - left[2]*right[1];
+    ret[1] = left[2]*right[0] - left[0]*right[2];
+    ret[2] = left[0]*right[1] - left[1]*right[0];
+    return ret;
+  }
+
+  static VectorType apply(const FieldMatrix< FieldType, 3, 3 >& matrix, const VectorType& vector)
+  {
+    VectorType ret(0.0);
+    for (int ii = 0; ii < 3; ++ii)
+      for (int jj = 0; jj < 3; ++jj)
+        ret[ii] += matrix[ii][jj] * vector[jj];
+    return ret;
+  }
+
+public:
+  static FieldVector< FieldType, 3 > compute(const FieldMatrix< FieldType, 3, 3 >& matrix)
+  {
+    if (!is_symmetric(matrix))
+      return general_eigenvalues(matrix);
+    FieldVector< FieldType, 3 > ret;
+    const FieldType off_diagonal = matrix[0][1]*matrix[0][1] + matrix[0][2]*matrix[0][2] + matrix[1][2]*matrix[1][2];
+    if (off_diagonal == 0.0) {
+      for (int ii = 0; ii < 3; ++ii)
+        ret[ii] = matrix[ii][ii];
+      std::sort(ret.begin(), ret.end());
+      return ret;
+    }
+    const FieldType mean = (matrix[0][0] + matrix[1][1] + matrix[2][2]) / 3.0;
+    FieldType deviation = 2.0 * off_diagonal;
+    for (int ii = 0; ii < 3; ++ii)
+      deviation += (matrix[ii][ii] - mean) * (matrix[ii][ii] - mean);
+    const FieldType scale = std::sqrt(deviation / 6.0);
+    // B = (A - mean * I) / scale has eigenvalues 2 cos(phi + 2 k pi / 3), where cos(3 phi) = det(B) / 2
+    FieldMatrix< FieldType, 3, 3 > shifted = matrix;
+    for (int ii = 0; ii < 3; ++ii)
+      shifted[ii][ii] -= mean;
+    shifted /= scale;
+    const FieldType half_determinant = std::min(FieldType(1), std::max(FieldType(-1), 0.5 * shifted.determinant()));
+    const FieldType phi = std::acos(half_determinant) / 3.0;
+    // the largest eigenvalue is well separated if det(B) >= 0, the smallest one otherwise
+    const FieldType separated = (half_determinant >= 0.0)
+                                ? mean + 2.0 * scale * std::cos(phi)
+                                : mean + 2.0 * scale * std::cos(phi + 2.0 * MathematicalConstants< FieldType >::pi()
+                                                                               / 3.0);
+    // its eigenvector is orthogonal to the rows of A - separated * I, take the most accurate cross product
+    FieldMatrix< FieldType, 3, 3 > rows = matrix;
+    for (int ii = 0; ii < 3; ++ii)
+      rows[ii][ii] -= separated;
+    const VectorType candidates[3] = {cross(rows[0], rows[1]), cross(rows[0], rows[2]), cross(rows[1], rows[2])};
+    VectorType eigenvector = candidates[0];
+    for (int ii = 1; ii < 3; ++ii)
+      if (candidates[ii].two_norm2() > eigenvector.two_norm2())
+        eigenvector = candidates[ii];
+    if (!(eigenvector.two_norm2() > 0.0)) {
+      // A - separated * I vanishes (up to rounding), i.e., we have a triple eigenvalue
+      ret = VectorType(separated);
+      return ret;
+    }
+    eigenvector *= 1.0 / eigenvector.two_norm();
+    // orthonormal basis of the complement
+    VectorType first(0.0);
+    if (std::abs(eigenvector[0]) > std::abs(eigenvector[1])) {
+      first[0] = -eigenvector[2];
+      first[2] = eigenvector[0];
+    } else {
+      first[1] = eigenvector[2];
+      first[2] = -eigenvector[1];
+    }
+    first *= 1.0 / first.two_norm();
+    const VectorType second = cross(eigenvector, first);
+    FieldMatrix< FieldType, 2, 2 > restricted;
+    const VectorType matrix_first = apply(matrix, first);
+    const VectorType matrix_second = apply(matrix, second);
+    restricted[0][0] = first * matrix_first;
+    restricted[0][1] = restricted[1][0] = 0.5 * (second * matrix_first + first * matrix_second);
+    restricted[1][1] = second * matrix_second;
+    const auto others = SymmetricEigenvalues< FieldType, 2 >::compute(restricted);
+    ret[0] = separated;
+    ret[1] = others[0];
+    ret[2] = others[1];
+    std::sort(ret.begin(), ret.end());
+    return ret;
+  } // ... compute(...)
+}; // class SymmetricEigenvalues< ..., 3 >
+
+
+template< class FieldType, int dim >
+FieldVector< FieldType, dim > symmetric_eigenvalues(const FieldMatrix< FieldType, dim, dim >& matrix)
+{
+  return SymmetricEigenvalues< FieldType, dim >::compute(matrix);
+}
+
+
+} // namespace internal
+} // namespace Estimators
+} // namespace LinearElliptic
+} // namespace HDD
+} // namespace Dune
+
+#endif // DUNE_HDD_LINEARELLIPTIC_ESTIMATORS_EIGENVALUES_HH
@@ -0,0 +1,267 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_ESTIMATORS_FLUX_RECONSTRUCTION_HH
+#define DUNE_HDD_LINEARELLIPTIC_ESTIMATORS_FLUX_RECONSTRUCTION_HH
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/common/ranges.hh>
+#include <dune/stuff/common/timedlogging.hh>
+
+#include <dune/pymor/parameters/base.hh>
+
+#include <dune/gdt/discretefunction/default.hh>
+#include <dune/gdt/playground/operators/fluxreconstruction.hh>
+#include <dune/gdt/spaces/rt/pdelab.hh>
+
+#include <dune/hdd/linearelliptic/cache.hh>
+
+#include "compressed-row-matrix.hh"
+#include "swipdg.hh"
+
+namespace Dune {
+namespace HDD {
+namespace LinearElliptic {
+namespace Estimators {
+
+
+/**
+ * \brief The diffusive flux reconstruction (see GDT::Operators::DiffusiveFluxReconstruction), assembled once for
+ *        each affine component of the diffusion factor as a sparse matrix mapping DG coefficients to RTN0
+ *        coefficients.
+ *
+ *        Since the reconstruction is linear in the discrete function and in the diffusion factor (the weights of the
+ *        SWIPDG discretization only depend on the diffusion tensor), the reconstruction for \kappa_\mu = \kappa_0 +
+ *        \sum_q \theta_q(\mu) \kappa_q is given by \sum_q \theta_q(\mu) R_q u, i.e., by one sparse matrix-vector
+ *        product per component, without any grid walk or quadrature.
+ *
+ *        To assemble R_q, we color the grid such that no two neighboring entities share a color and apply the
+ *        reconstruction to the sum of the ii-th local basis function of all entities of one color at a time: since
+ *        the reconstruction on a face only depends on the two adjacent entities, the value of each RTN0 DoF can then
+ *        be attributed to exactly one DG DoF. This costs (number of colors) * (local DG DoFs) reconstructions per
+ *        component (about 12 for piecewise linears on triangles) instead of one per DG DoF.
+ * \note  Use get() to obtain the operator for a given block space and problem: these are assembled once per
+ *        multiscale grid and diffusion and then shared by all estimators.
+ */
+template< class SpaceType, class VectorType, class ProblemType >
+class DiffusiveFluxReconstructionOperator
+{
+  typedef DiffusiveFluxReconstructionOperator< SpaceType, VectorType, ProblemType > ThisType;
+public:
+  typedef typename SpaceType::GridViewType     GridViewType;
+  typedef typename ProblemType::RangeFieldType RangeFieldType;
+  static const unsigned int dimDomain = SpaceType::dimDomain;
+
+  typedef GDT::Spaces::RT::PdelabBased< GridViewType, 0, RangeFieldType, dimDomain > RTN0SpaceType;
+  typedef GDT::DiscreteFunction< RTN0SpaceType, VectorType >                     RTN0DiscreteFunctionType;
+  typedef internal::CompressedRowMatrix< RangeFieldType >                        MatrixType;
+
+private:
+  typedef GDT::ConstDiscreteFunction< SpaceType, VectorType >          ConstDiscreteFunctionType;
+  typedef typename ProblemType::DiffusionFactorType                    ParametricDiffusionFactorType;
+  typedef typename ProblemType::DiffusionFactorType::NonparametricType DiffusionFactorType;
+  typedef typename ProblemType::DiffusionTensorType::NonparametricType DiffusionTensorType;
+  typedef GDT::Operators::DiffusiveFluxReconstruction< GridViewType, DiffusionFactorType, DiffusionTensorType >
+      ReconstructionType;
+
+  static const ProblemType& assert_problem(const ProblemType& problem)
+  {
+    // the reconstruction uses the SWIPDG weights of the tensor, while those are fixed for a parametric tensor (see
+    // Discretizations::internal::AffineDiffusion), so the reconstructed flux would not be conservative
+    if (problem.diffusion_tensor()->parametric())
+      DUNE_THROW(Stuff::Exceptions::requirements_not_met, "Not implemented for parametric diffusion_tensor!");
+    return problem;
+  }
+
+public:
+  static std::shared_ptr< const ThisType > get(const SpaceType& space, const ProblemType& problem)
+  {
+    static LinearElliptic::internal::DependentCache< ThisType > cache;
+    return cache.get({space.ms_grid(), problem.diffusion_factor(), problem.diffusion_tensor()},
+                     [&]() { return std::make_shared< const ThisType >(space, problem); });
+  } // ... get(...)
+
+  DiffusiveFluxReconstructionOperator(const SpaceType& space, const ProblemType& problem)
+    : diffusion_factor_(assert_problem(problem).diffusion_factor())
+    , rtn0_space_(space.grid_view())
+  {
+    auto logger = DSC::TimedLogger().get("hdd.linearelliptic.estimators.diffusivefluxreconstructionoperator");
+    const auto& diffusion_factor = *diffusion_factor_;
+    const auto& diffusion_tensor = *problem.diffusion_tensor()->affine_part();
+    std::vector< std::shared_ptr< const DiffusionFactorType > > diffusion_factor_components;
+    for (DUNE_STUFF_SSIZE_T qq = 0; qq < diffusion_factor.num_components(); ++qq)
+      diffusion_factor_components.emplace_back(diffusion_factor.component(qq));
+    if (diffusion_factor.has_affine_part())
+      diffusion_factor_components.emplace_back(diffusion_factor.affine_part());
+    const auto colors = color_entities(space);
+    const size_t num_colors = colors.empty() ? 0 : *std::max_element(colors.begin(), colors.end()) + 1;
+    size_t max_local_size = 0;
+    for (const auto& entity : Stuff::Common::entityRange(space.grid_view()))
+      max_local_size = std::max(max_local_size, space.base_function_set(entity).size());
+    logger.info() << "assembling " << diffusion_factor_components.size() << " components using " << num_colors
+                  << " colors..." << std::endl;
+    const auto& index_set = space.grid_view().indexSet();
+    const auto& rtn0_mapper = rtn0_space_.mapper();
+    const size_t dg_size = space.mapper().size();
+    const size_t rtn0_size = rtn0_mapper.size();
+    for (const auto& diffusion_factor_component : diffusion_factor_components) {
+      const ReconstructionType reconstruction(space.grid_view(),
+                                              *diffusion_factor_component,
+                                              diffusion_tensor,
+                                              internal::SWIPDG::over_integrate);
+      std::vector< std::map< size_t, RangeFieldType > > rows(rtn0_size);
+      for (size_t color = 0; color < num_colors; ++color) {
+        for (size_t ii = 0; ii < max_local_size; ++ii) {
+          // probe
+          VectorType probe(dg_size, 0.0);
+          for (const auto& entity : Stuff::Common::entityRange(space.grid_view()))
+            if (colors[index_set.index(entity)] == color && ii < space.base_function_set(entity).size())
+              probe.set_entry(space.mapper().mapToGlobal(entity, ii), 1.0);
+          const ConstDiscreteFunctionType probe_function(space, probe);
+          RTN0DiscreteFunctionType response(rtn0_space_);
+          reconstruction.apply(probe_function, response);
+          // attribute the response to the probed DoFs
+          const auto& response_vector = response.vector();
+          std::vector< bool > attributed(rtn0_size, false);
+          for (const auto& entity : Stuff::Common::entityRange(space.grid_view())) {
+            if (colors[index_set.index(entity)] != color || ii >= space.base_function_set(entity).size())
+              continue;
+            const size_t column = space.mapper().mapToGlobal(entity, ii);
+            for (size_t ff = 0; ff < rtn0_mapper.numDofs(entity); ++ff) {
+              const size_t row = rtn0_mapper.mapToGlobal(entity, ff);
+              attributed[row] = true;
+              const RangeFieldType value = response_vector.get_entry(row);
+              if (value != 0.0)
+                rows[row][column] = value;
+            }
+          }
+          // the attribution is only valid if the reconstruction is local
+          RangeFieldType max_attributed = 0.0;
+          RangeFieldType max_unattributed = 0.0;
+          for (size_t row = 0; row < rtn0_size; ++row) {
+            const RangeFieldType value = std::abs(response_vector.get_entry(row));
+            if (attributed[row])
+              max_attributed = std::max(max_attributed, value);
+            else
+              max_unattributed = std::max(max_unattributed, value);
+          }
+          if (max_unattributed > 1e-12 * std::max(max_attributed, RangeFieldType(1)))
+            DUNE_THROW(Stuff::Exceptions::internal_error,
+                       "The diffusive flux reconstruction is not local (max_unattributed = " << max_unattributed
+                       << ")!");
+        }
+      }
+      matrices_.emplace_back(rows, dg_size);
+    }
+    logger.info() << "done (" << (matrices_.empty() ? 0 : matrices_.front().non_zeros()) << " non-zeros per component)"
+                  << std::endl;
+  } // DiffusiveFluxReconstructionOperator(...)
+
+  const RTN0SpaceType& range_space() const
+  {
+    return rtn0_space_;
+  }
+
+  /**
+   * \brief The number of affine components, the affine part of the diffusion factor (if present) is the last one.
+   */
+  size_t num_components() const
+  {
+    return matrices_.size();
+  }
+
+  const MatrixType& component(const size_t qq) const
+  {
+    if (qq >= num_components())
+      DUNE_THROW(Stuff::Exceptions::index_out_of_range,
+                 "Given qq " << qq << " is not smaller than num_components() = " << num_components() << "!");
+    return matrices_[qq];
+  }
+
+  /**
+   * \brief Computes the reconstruction of the given DG coefficients for the given parameter, range has to be a vector
+   *        of range_space().
+   */
+  void apply(const VectorType& source, VectorType& range, const Pymor::Parameter mu = Pymor::Parameter()) const
+  {
+    const auto& diffusion_factor = *diffusion_factor_;
+    if (matrices_.empty()) {
+      range.scal(0.0);
+      return;
+    }
+    for (size_t qq = 0; qq < matrices_.size(); ++qq) {
+      const RangeFieldType theta = (DUNE_STUFF_SSIZE_T(qq) < diffusion_factor.num_components())
+                                   ? RangeFieldType(diffusion_factor.coefficient(qq)->evaluate(mu))
+                                   : RangeFieldType(1);
+      matrices_[qq].apply(source, range, theta, (qq == 0) ? 0.0 : 1.0);
+    }
+  } // ... apply(...)
+
+  VectorType apply(const VectorType& source, const Pymor::Parameter mu = Pymor::Parameter()) const
+  {
+    VectorType range(rtn0_space_.mapper().size(), 0.0);
+    apply(source, range, mu);
+    return range;
+  }
+
+  /**
+   * \brief Computes the reconstructions with respect to the qq-th component of the given DG coefficients.
+   */
+  std::vector< VectorType > apply(const size_t qq, const std::vector< VectorType >& sources) const
+  {
+    std::vector< VectorType > ranges(sources.size(), VectorType(rtn0_space_.mapper().size(), 0.0));
+    component(qq).apply(sources, ranges);
+    return ranges;
+  } // ... apply(...)
+
+private:
+  /**
+   * \brief Greedy coloring of the entities, such that entities sharing a face have different colors.
+   */
+  static std::vector< size_t > color_entities(const SpaceType& space)
+  {
+    const auto& grid_view = space.grid_view();
+    const auto& index_set = grid_view.indexSet();
+    std::vector< std::vector< size_t > > entities_of_face(index_set.size(1));
+    for (const auto& entity : Stuff::Common::entityRange(grid_view))
+      for (int ff = 0; ff < entity.template count< 1 >(); ++ff)
+        entities_of_face[index_set.subIndex(entity, ff, 1)].push_back(index_set.index(entity));
+    const size_t unset = std::numeric_limits< size_t >::max();
+    std::vector< size_t > colors(index_set.size(0), unset);
+    std::vector< bool > taken;
+    for (const auto& entity : Stuff::Common::entityRange(grid_view)) {
+      const size_t index = index_set.index(entity);
+      taken.assign(taken.size(), false);
+      for (int ff = 0; ff < entity.template count< 1 >(); ++ff)
+        for (const size_t neighbor : entities_of_face[index_set.subIndex(entity, ff, 1)])
+          if (neighbor != index && colors[neighbor] != unset) {
+            if (colors[neighbor] >= taken.size())
+              taken.resize(colors[neighbor] + 1, false);
+            taken[colors[neighbor]] = true;
+          }
+      colors[index] = std::find(taken.begin(), taken.end(), false) - taken.begin();
+    }
+    return colors;
+  } // ... color_entities(...)
+
+  const std::shared_ptr< const ParametricDiffusionFactorType > diffusion_factor_;
+  const RTN0SpaceType rtn0_space_;
+  std::vector< MatrixType > matrices_;
+}; // class DiffusiveFluxReconstructionOperator
+
+
+} // namespace Estimators
+} // namespace LinearElliptic
+} // namespace HDD
+} // namespace Dune
+
+#endif // DUNE_HDD_LINEARELLIPTIC_ESTIMATORS_FLUX_RECONSTRUCTION_HH
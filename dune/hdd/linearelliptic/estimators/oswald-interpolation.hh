@@ -0,0 +1,200 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_ESTIMATORS_OSWALD_INTERPOLATION_HH
+#define DUNE_HDD_LINEARELLIPTIC_ESTIMATORS_OSWALD_INTERPOLATION_HH
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <dune/common/dynmatrix.hh>
+
+#include <dune/geometry/referenceelements.hh>
+
+#include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/common/ranges.hh>
+#include <dune/stuff/la/container/interfaces.hh>
+
+#include <dune/hdd/linearelliptic/cache.hh>
+
+#include "compressed-row-matrix.hh"
+#include "data-terms-cache.hh"
+
+namespace Dune {
+namespace HDD {
+namespace LinearElliptic {
+namespace Estimators {
+
+
+/**
+ * \brief The oswald interpolation (averaging of the nodal values of a discontinuous piecewise linear function at each
+ *        vertex), assembled once as a sparse matrix.
+ *
+ *        This is the same linear map as GDT::Operators::OswaldInterpolation, but since it only depends on the space,
+ *        repeated interpolations (e.g. of all reduced basis functions) are reduced to one sparse matrix-vector product
+ *        each. Use matrix().to_matrix() to obtain a matrix of a specific backend (for instance to use it in
+ *        matrix-matrix products).
+ * \note  Only implemented for linear discontinuous spaces on simplices. If zero_boundary is set, the values at the
+ *        vertices on the domain boundary are set to zero (as in ESV2007).
+ */
+template< class SpaceType >
+class OswaldInterpolationOperator
+{
+  typedef OswaldInterpolationOperator< SpaceType > ThisType;
+  static const size_t max_cached_operators = 4;
+public:
+  typedef typename SpaceType::RangeFieldType RangeFieldType;
+  static const unsigned int dimDomain = SpaceType::dimDomain;
+
+private:
+  typedef typename SpaceType::DomainFieldType DomainFieldType;
+  typedef typename SpaceType::GridViewType    GridViewType;
+
+public:
+  explicit OswaldInterpolationOperator(const SpaceType& space, const bool zero_boundary = true)
+    : matrix_(assemble(space, zero_boundary))
+  {}
+
+  size_t size() const
+  {
+    return matrix_.rows();
+  }
+
+  const internal::CompressedRowMatrix< RangeFieldType >& matrix() const
+  {
+    return matrix_;
+  }
+
+  template< class S, class R >
+  void apply(const Stuff::LA::VectorInterface< S >& source, Stuff::LA::VectorInterface< R >& range) const
+  {
+    matrix_.apply(source, range);
+  }
+
+  template< class VectorType >
+  VectorType apply(const VectorType& source) const
+  {
+    VectorType range(size(), 0.0);
+    apply(source, range);
+    return range;
+  }
+
+  template< class VectorType >
+  std::vector< VectorType > apply(const std::vector< VectorType >& sources) const
+  {
+    std::vector< VectorType > ranges(sources.size(), VectorType(size(), 0.0));
+    matrix_.apply(sources, ranges);
+    return ranges;
+  }
+
+  /**
+   * \brief Returns the operator for the given space, which is only assembled once for each grid view.
+   *
+   *        The grid view is identified by grid_view_key, which is computed by internal::grid_view_fingerprint() if
+   *        empty. Callers interpolating repeatedly should compute it once and pass it on.
+   */
+  static std::shared_ptr< const ThisType > get(const SpaceType& space,
+                                               const bool zero_boundary = true,
+                                               const std::string& grid_view_key = "")
+  {
+    static LinearElliptic::internal::DependentCache< ThisType > cache(max_cached_operators);
+    return cache.get({},
+                     (grid_view_key.empty() ? internal::grid_view_fingerprint(space.grid_view()) : grid_view_key)
+                     + (zero_boundary ? ";zero" : ""),
+                     [&]() { return std::make_shared< const ThisType >(space, zero_boundary); });
+  } // ... get(...)
+
+private:
+  static internal::CompressedRowMatrix< RangeFieldType > assemble(const SpaceType& space, const bool zero_boundary)
+  {
+    const size_t size = space.mapper().size();
+    const GridViewType& grid_view = space.grid_view();
+    const auto& index_set = grid_view.indexSet();
+    const size_t num_vertices = index_set.size(dimDomain);
+    // count the entities adjacent to each vertex and find the boundary vertices
+    std::vector< size_t > num_adjacent_entities(num_vertices, 0);
+    std::vector< bool > boundary_vertices(num_vertices, false);
+    for (const auto& entity : Stuff::Common::entityRange(grid_view)) {
+      if (!entity.type().isSimplex())
+        DUNE_THROW(NotImplemented, "Only implemented for simplices!");
+      const auto& reference_element = ReferenceElements< DomainFieldType, dimDomain >::general(entity.type());
+      for (int cc = 0; cc < entity.template count< dimDomain >(); ++cc)
+        ++num_adjacent_entities[index_set.subIndex(entity, cc, dimDomain)];
+      if (zero_boundary) {
+        const auto intersection_it_end = grid_view.iend(entity);
+        for (auto intersection_it = grid_view.ibegin(entity); intersection_it != intersection_it_end; ++intersection_it) {
+          const auto& intersection = *intersection_it;
+          if (intersection.boundary() && !intersection.neighbor()) {
+            const int face = intersection.indexInInside();
+            for (int ii = 0; ii < reference_element.size(face, 1, dimDomain); ++ii)
+              boundary_vertices[index_set.subIndex(entity,
+                                                   reference_element.subEntity(face, 1, ii, dimDomain),
+                                                   dimDomain)] = true;
+          }
+        }
+      }
+    }
+    // collect the contributions of the source DoFs to the averaged value at each vertex
+    std::vector< std::map< size_t, RangeFieldType > > vertex_values(num_vertices);
+    std::vector< typename SpaceType::BaseFunctionSetType::RangeType > basis_values;
+    for (const auto& entity : Stuff::Common::entityRange(grid_view)) {
+      const auto& reference_element = ReferenceElements< DomainFieldType, dimDomain >::general(entity.type());
+      const auto basis = space.base_function_set(entity);
+      basis_values.resize(basis.size());
+      for (int cc = 0; cc < entity.template count< dimDomain >(); ++cc) {
+        const size_t vertex = index_set.subIndex(entity, cc, dimDomain);
+        if (zero_boundary && boundary_vertices[vertex])
+          continue;
+        basis.evaluate(reference_element.position(cc, dimDomain), basis_values);
+        for (size_t ii = 0; ii < basis.size(); ++ii)
+          if (basis_values[ii][0] != 0.0)
+            vertex_values[vertex][space.mapper().mapToGlobal(entity, ii)]
+                += basis_values[ii][0] / num_adjacent_entities[vertex];
+      }
+    }
+    // for each target DoF, combine the vertex values
+    // (since the basis need not be nodal, we invert the local nodal interpolation matrix)
+    std::vector< std::map< size_t, RangeFieldType > > rows(size);
+    for (const auto& entity : Stuff::Common::entityRange(grid_view)) {
+      const auto& reference_element = ReferenceElements< DomainFieldType, dimDomain >::general(entity.type());
+      const auto basis = space.base_function_set(entity);
+      const int num_corners = entity.template count< dimDomain >();
+      if (basis.size() != size_t(num_corners))
+        DUNE_THROW(NotImplemented, "Only implemented for linear discontinuous spaces!");
+      basis_values.resize(basis.size());
+      DynamicMatrix< RangeFieldType > nodal_values(num_corners, num_corners, 0.0);
+      for (int cc = 0; cc < num_corners; ++cc) {
+        basis.evaluate(reference_element.position(cc, dimDomain), basis_values);
+        for (int ii = 0; ii < num_corners; ++ii)
+          nodal_values[cc][ii] = basis_values[ii][0];
+      }
+      nodal_values.invert();
+      for (int ii = 0; ii < num_corners; ++ii) {
+        auto& row = rows[space.mapper().mapToGlobal(entity, ii)];
+        for (int cc = 0; cc < num_corners; ++cc) {
+          const RangeFieldType factor = nodal_values[ii][cc];
+          if (factor == 0.0)
+            continue;
+          for (const auto& element : vertex_values[index_set.subIndex(entity, cc, dimDomain)])
+            row[element.first] += factor * element.second;
+        }
+      }
+    }
+    return internal::CompressedRowMatrix< RangeFieldType >(rows, size);
+  } // ... assemble(...)
+
+  const internal::CompressedRowMatrix< RangeFieldType > matrix_;
+}; // class OswaldInterpolationOperator
+
+
+} // namespace Estimators
+} // namespace LinearElliptic
+} // namespace HDD
+} // namespace Dune
+
+#endif // DUNE_HDD_LINEARELLIPTIC_ESTIMATORS_OSWALD_INTERPOLATION_HH
@@ -0,0 +1,216 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_ESTIMATORS_SUBDOMAIN_METRICS_HH
+#define DUNE_HDD_LINEARELLIPTIC_ESTIMATORS_SUBDOMAIN_METRICS_HH
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <dune/common/fvector.hh>
+
+#include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/common/ranges.hh>
+
+#include <dune/hdd/linearelliptic/cache.hh>
+
+namespace Dune {
+namespace HDD {
+namespace LinearElliptic {
+namespace Estimators {
+namespace internal {
+
+
+/**
+ * \brief Computes the exact diameter of a point set, i.e. the largest distance between any two of its points.
+ *
+ *        This generic variant (used for 3d grids) compares all pairs of distinct points and is thus O(V^2) in the
+ *        number V of distinct vertices, see the specializations below for 1d and 2d.
+ */
+template< class DomainFieldType, int dimDomain >
+class Diameter
+{
+public:
+  typedef FieldVector< DomainFieldType, dimDomain > PointType;
+
+  static DomainFieldType compute(std::vector< PointType >& points)
+  {
+    if (points.size() < 2)
+      return DomainFieldType(0);
+    // the vertices of a subdomain are shared by several elements, compare each one only once
+    std::sort(points.begin(), points.end(), [](const PointType& a, const PointType& b) {
+      return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+    });
+    points.erase(std::unique(points.begin(), points.end()), points.end());
+    DomainFieldType diameter(0);
+    for (size_t ii = 0; ii < points.size(); ++ii)
+      for (size_t jj = ii + 1; jj < points.size(); ++jj)
+        diameter = std::max(diameter, (points[ii] - points[jj]).two_norm());
+    return diameter;
+  } // ... compute(...)
+}; // class Diameter
+
+
+/**
+ * \brief Computes the exact diameter of a point set on the line in O(V).
+ */
+template< class DomainFieldType >
+class Diameter< DomainFieldType, 1 >
+{
+public:
+  typedef FieldVector< DomainFieldType, 1 > PointType;
+
+  static DomainFieldType compute(std::vector< PointType >& points)
+  {
+    if (points.size() < 2)
+      return DomainFieldType(0);
+    const auto minmax = std::minmax_element(points.begin(), points.end(), [](const PointType& a, const PointType& b) {
+      return a[0] < b[0];
+    });
+    return (*minmax.second)[0] - (*minmax.first)[0];
+  }
+}; // class Diameter< ..., 1 >
+
+
+/**
+ * \brief Computes the exact diameter of a planar point set by only comparing the vertices of its convex hull.
+ *
+ *        The hull is obtained by Andrew's monotone chain algorithm in O(V log V), its H vertices are then compared
+ *        pairwise in O(H^2). For the vertices of a subdomain H is of the order of sqrt(V), which is where this pays
+ *        off compared to the generic variant.
+ */
+template< class DomainFieldType >
+class Diameter< DomainFieldType, 2 >
+{
+public:
+  typedef FieldVector< DomainFieldType, 2 > PointType;
+
+  static DomainFieldType compute(std::vector< PointType >& points)
+  {
+    if (points.size() < 2)
+      return DomainFieldType(0);
+    std::sort(points.begin(), points.end(), [](const PointType& a, const PointType& b) {
+      return a[0] < b[0] || (a[0] == b[0] && a[1] < b[1]);
+    });
+    points.erase(std::unique(points.begin(), points.end()), points.end());
+    const size_t num_points = points.size();
+    if (num_points < 3)
+      return (points.front() - points.back()).two_norm();
+    std::vector< PointType > hull(2*num_points);
+    size_t kk = 0;
+    for (size_t ii = 0; ii < num_points; ++ii) {  // lower hull
+      while (kk >= 2 && cross(hull[kk - 2], hull[kk - 1], points[ii]) <= 0)
+        --kk;
+      hull[kk++] = points[ii];
+    }
+    for (size_t ii = num_points - 1, tt = kk + 1; ii > 0; --ii) { // upper hull
+      while (kk >= tt && cross(hull[kk - 2], hull[kk - 1], points[ii - 1]) <= 0)
+        --kk;
+      hull[kk++] = points[ii - 1];
+    }
+    hull.resize(kk - 1);
+    DomainFieldType diameter(0);
+    for (size_t ii = 0; ii < hull.size(); ++ii)
+      for (size_t jj = ii + 1; jj < hull.size(); ++jj)
+        diameter = std::max(diameter, (hull[ii] - hull[jj]).two_norm());
+    return diameter;
+  } // ... compute(...)
+
+private:
+  static DomainFieldType cross(const PointType& oo, const PointType& aa, const PointType& bb)
+  {
+    return (aa[0] - oo[0])*(bb[1] - oo[1]) - (aa[1] - oo[1])*(bb[0] - oo[0]);
+  }
+}; // class Diameter< ..., 2 >
+
+
+} // namespace internal
+
+
+/**
+ * \brief Geometric data of each subdomain of a multiscale grid, as required by the localized estimators.
+ *
+ *        Use get() to obtain the metrics of a given block space: these are computed once per multiscale grid and
+ *        then shared by all estimators (and all evaluations of those) on spaces built upon the same multiscale grid.
+ * \note  The poincare constant is the one for convex subdomains, 1/pi^2.
+ */
+template< class BlockSpaceType >
+class SubdomainMetrics
+{
+  typedef SubdomainMetrics< BlockSpaceType > ThisType;
+public:
+  typedef typename BlockSpaceType::DomainFieldType DomainFieldType;
+  static const unsigned int dimDomain = BlockSpaceType::dimDomain;
+  typedef FieldVector< DomainFieldType, dimDomain > DomainType;
+
+  static std::shared_ptr< const ThisType > get(const BlockSpaceType& space)
+  {
+    static LinearElliptic::internal::DependentCache< ThisType > cache;
+    return cache.get({space.ms_grid()}, [&]() { return std::make_shared< const ThisType >(space); });
+  }
+
+  explicit SubdomainMetrics(const BlockSpaceType& space)
+    : diameters_(space.ms_grid()->size(), DomainFieldType(0))
+    , volumes_(space.ms_grid()->size(), DomainFieldType(0))
+  {
+    std::vector< DomainType > vertices;
+    for (size_t ss = 0; ss < space.ms_grid()->size(); ++ss) {
+      vertices.clear();
+      const auto local_grid_view = space.local_spaces()[ss]->grid_view();
+      for (const auto& entity : Stuff::Common::entityRange(local_grid_view)) {
+        const auto geometry = entity.geometry();
+        for (int cc = 0; cc < geometry.corners(); ++cc)
+          vertices.push_back(geometry.corner(cc));
+        volumes_[ss] += geometry.volume();
+      }
+      diameters_[ss] = internal::Diameter< DomainFieldType, dimDomain >::compute(vertices);
+    }
+  } // SubdomainMetrics(...)
+
+  size_t size() const
+  {
+    return diameters_.size();
+  }
+
+  DomainFieldType diameter(const size_t subdomain) const
+  {
+    assert_subdomain(subdomain);
+    return diameters_[subdomain];
+  }
+
+  DomainFieldType volume(const size_t subdomain) const
+  {
+    assert_subdomain(subdomain);
+    return volumes_[subdomain];
+  }
+
+  DomainFieldType poincare_constant(const size_t subdomain) const
+  {
+    assert_subdomain(subdomain);
+    return 1.0 / (M_PIl * M_PIl);
+  }
+
+private:
+  void assert_subdomain(const size_t subdomain) const
+  {
+    if (subdomain >= size())
+      DUNE_THROW(Stuff::Exceptions::index_out_of_range,
+                 "Given subdomain " << subdomain << " is not smaller than size() = " << size() << "!");
+  }
+
+  std::vector< DomainFieldType > diameters_;
+  std::vector< DomainFieldType > volumes_;
+}; // class SubdomainMetrics
+
+
+} // namespace Estimators
+} // namespace LinearElliptic
+} // namespace HDD
+} // namespace Dune
+
+#endif // DUNE_HDD_LINEARELLIPTIC_ESTIMATORS_SUBDOMAIN_METRICS_HH
@@ -6,8 +6,10 @@
 #ifndef DUNE_HDD_LINEARELLIPTIC_ESTIMATORS_SWIPDG_HH
 #define DUNE_HDD_LINEARELLIPTIC_ESTIMATORS_SWIPDG_HH
 
+#include <cmath>
 #include <map>
 #include <memory>
+#include <numeric>
 #include <string>
 #include <vector>
 
@@ -18,9 +20,11 @@
 #endif
 
 #include <dune/stuff/common/memory.hh>
+#include <dune/stuff/common/ranges.hh>
 #include <dune/stuff/common/tmp-storage.hh>
 #include <dune/stuff/grid/walker.hh>
 #include <dune/stuff/grid/walker/functors.hh>
+#include <dune/stuff/la/container/common.hh>
 #include <dune/stuff/playground/functions/ESV2007.hh>
 
 #include <dune/pymor/common/exceptions.hh>
@@ -30,13 +34,15 @@
 #include <dune/gdt/localevaluation/elliptic.hh>
 #include <dune/gdt/localevaluation/product.hh>
 #include <dune/gdt/localoperator/codim0.hh>
-#include <dune/gdt/operators/oswaldinterpolation.hh>
 #include <dune/gdt/operators/projections.hh>
 #include <dune/gdt/playground/localevaluation/ESV2007.hh>
 #include <dune/gdt/playground/operators/fluxreconstruction.hh>
 #include <dune/gdt/spaces/fv/default.hh>
 #include <dune/gdt/spaces/rt/pdelab.hh>
 
+#include "data-terms-cache.hh"
+#include "oswald-interpolation.hh"
+
 namespace Dune {
 namespace HDD {
 namespace LinearElliptic {
@@ -104,8 +110,6 @@ private:
       DUNE_THROW(Pymor::Exceptions::wrong_parameter_type,
                  "Given mu_bar is of type " << mu_bar.type() << " and should be of type " << problem.parameter_type()
                  << "!");
-    if (problem.diffusion_tensor()->parametric())
-      DUNE_THROW(NotImplemented, "Not implemented for parametric diffusion_tensor!");
     return problem;
   } // ... assert_problem(...)
 
@@ -115,7 +119,8 @@ public:
                                  const ProblemType& problem,
                                  const ParametersMapType parameters = ParametersMapType())
   {
-    if (problem.diffusion_factor()->parametric() && parameters.find("mu_bar") == parameters.end())
+    if ((problem.diffusion_factor()->parametric() || problem.diffusion_tensor()->parametric())
+        && parameters.find("mu_bar") == parameters.end())
       DUNE_THROW(Stuff::Exceptions::wrong_input_given, "Given parameters are missing 'mu_bar'!");
     const Pymor::Parameter mu_bar = problem.parametric() ? parameters.at("mu_bar") : Pymor::Parameter();
     ThisType estimator(space, vector, problem, mu_bar);
@@ -125,20 +130,25 @@ public:
     return std::sqrt(estimator.result_);
   } // ... estimate(...)
 
+  /**
+   * \param grid_view_key identifies the grid view of space (see grid_view_fingerprint()), computed if empty
+   */
   LocalNonconformityESV2007(const SpaceType& space,
                             const VectorType& vector,
                             const ProblemType& problem,
-                            const Pymor::Parameter mu_bar = Pymor::Parameter())
+                            const Pymor::Parameter mu_bar = Pymor::Parameter(),
+                            const std::string grid_view_key = "")
     : space_(space)
     , vector_(vector)
     , problem_(assert_problem(problem, mu_bar))
+    , grid_view_key_(grid_view_key)
     , problem_mu_bar_(problem_.with_mu(mu_bar))
     , discrete_solution_(space_, vector_)
     , oswald_interpolation_(space_)
     , difference_(Stuff::Common::make_unique< DifferenceType >(discrete_solution_ - oswald_interpolation_))
     , local_operator_(over_integrate,
                       *problem_mu_bar_->diffusion_factor()->affine_part(),
-                      *problem_.diffusion_tensor()->affine_part())
+                      *problem_mu_bar_->diffusion_tensor()->affine_part())
     , tmp_local_matrices_({1, local_operator_.numTmpObjectsRequired()}, 1, 1)
     , prepared_(false)
     , result_(0.0)
@@ -147,8 +157,8 @@ public:
   virtual void prepare()
   {
     if (!prepared_) {
-      const GDT::Operators::OswaldInterpolation< GridViewType > oswald_interpolation_operator(space_.grid_view());
-      oswald_interpolation_operator.apply(discrete_solution_, oswald_interpolation_);
+      OswaldInterpolationOperator< SpaceType >::get(space_, true, grid_view_key_)->apply(vector_,
+                                                                                        oswald_interpolation_.vector());
       result_ = 0.0;
       prepared_ = true;
     }
@@ -175,6 +185,7 @@ private:
   const SpaceType& space_;
   const VectorType& vector_;
   const ProblemType& problem_;
+  const std::string grid_view_key_;
   const std::shared_ptr< const typename ProblemType::NonparametricType > problem_mu_bar_;
   const ConstDiscreteFunctionType discrete_solution_;
   DiscreteFunctionType oswald_interpolation_;
@@ -193,6 +204,8 @@ class LocalResidualESV2007Base
 {
 public:
   static std::string id() { return "eta_R_ESV2007"; }
+  static const bool depends_on_solution = false;
+  static const bool depends_on_parameter = false;
 };
 
 
@@ -250,13 +263,40 @@ private:
 public:
   static RangeFieldType estimate(const SpaceType& space, const VectorType& /*vector*/, const ProblemType& problem)
   {
-    ThisType estimator(space, problem);
-    Stuff::Grid::Walker< GridViewType > grid_walker(space.grid_view());
-    grid_walker.add(estimator);
-    grid_walker.walk();
-    return std::sqrt(estimator.result_);
+    const auto eta_r_t_squared = estimate_locally(space, problem);
+    return std::sqrt(std::accumulate(eta_r_t_squared->begin(), eta_r_t_squared->end(), RangeFieldType(0)));
   } // ... estimate(...)
 
+  /**
+   * \brief Returns the squared local estimator of each entity (in the order of the index set).
+   *
+   *        Since this estimator depends neither on the solution nor on the parameter, the result is only computed once
+   *        for each grid view and problem, and then reused. The grid view is identified by grid_view_key (see
+   *        grid_view_fingerprint()), which is computed if empty.
+   */
+  static std::shared_ptr< const std::vector< RangeFieldType > > estimate_locally(const SpaceType& space,
+                                                                                 const ProblemType& problem,
+                                                                                 const std::string& grid_view_key = "")
+  {
+    static_assert(!ThisType::depends_on_solution && !ThisType::depends_on_parameter,
+                  "This estimator must not be cached!");
+    assert_problem(problem);
+    const auto& grid_view = space.grid_view();
+    return DataTermsCache< ThisType, RangeFieldType >::get(
+          {problem.diffusion_factor(), problem.diffusion_tensor(), problem.force()},
+          {},
+          [&]() {
+            ThisType estimator(space, problem);
+            estimator.prepare();
+            std::vector< RangeFieldType > eta_r_t_squared(boost::numeric_cast< size_t >(grid_view.indexSet().size(0)),
+                                                          0.0);
+            for (const auto& entity : Stuff::Common::entityRange(grid_view))
+              eta_r_t_squared[grid_view.indexSet().index(entity)] = estimator.compute_locally(entity);
+            return eta_r_t_squared;
+          },
+          grid_view_key.empty() ? grid_view_fingerprint(grid_view) : grid_view_key);
+  } // ... estimate_locally(...)
+
   LocalResidualESV2007(const SpaceType& space, const ProblemType& problem)
     : space_(space)
     , problem_(assert_problem(problem))
@@ -355,10 +395,11 @@ public:
 
   static const unsigned int dimDomain = SpaceType::dimDomain;
 
-private:
-  typedef GDT::ConstDiscreteFunction< SpaceType, VectorType > ConstDiscreteFunctionType;
   typedef GDT::Spaces::RT::PdelabBased< GridViewType, 0, RangeFieldType, dimDomain > RTN0SpaceType;
   typedef GDT::DiscreteFunction< RTN0SpaceType, VectorType > RTN0DiscreteFunctionType;
+
+private:
+  typedef GDT::ConstDiscreteFunction< SpaceType, VectorType > ConstDiscreteFunctionType;
   typedef typename RTN0DiscreteFunctionType::DivergenceType DivergenceType;
   typedef typename DivergenceType::DifferenceType DifferenceType;
 
@@ -408,7 +449,34 @@ public:
     , problem_mu_(problem_.with_mu(mu))
     , discrete_solution_(space_, vector_)
     , rtn0_space_(space_.grid_view())
-    , diffusive_flux_(rtn0_space_)
+    , reconstructed_flux_(Stuff::Common::make_unique< RTN0DiscreteFunctionType >(rtn0_space_))
+    , diffusive_flux_(*reconstructed_flux_)
+    , divergence_(diffusive_flux_.divergence())
+    , difference_(*problem_.force()->affine_part() - divergence_)
+    , cutoff_function_(*problem_.diffusion_factor()->affine_part(),
+                       *problem_.diffusion_tensor()->affine_part())
+    , local_operator_(over_integrate, cutoff_function_)
+    , tmp_local_matrices_({1, local_operator_.numTmpObjectsRequired()}, 1, 1)
+    , prepared_(false)
+    , result_(0.0)
+  {}
+
+  /**
+   * \brief Uses the given reconstruction of the diffusive flux of vector (w.r.t. mu) instead of computing it.
+   */
+  LocalResidualESV2007Star(const SpaceType& space,
+                           const VectorType& vector,
+                           const ProblemType& problem,
+                           const RTN0DiscreteFunctionType& diffusive_flux,
+                           const Pymor::Parameter mu = Pymor::Parameter())
+    : space_(space)
+    , vector_(vector)
+    , problem_(assert_problem(problem, mu))
+    , problem_mu_(problem_.with_mu(mu))
+    , discrete_solution_(space_, vector_)
+    , rtn0_space_(space_.grid_view())
+    , reconstructed_flux_(nullptr)
+    , diffusive_flux_(diffusive_flux)
     , divergence_(diffusive_flux_.divergence())
     , difference_(*problem_.force()->affine_part() - divergence_)
     , cutoff_function_(*problem_.diffusion_factor()->affine_part(),
@@ -424,12 +492,14 @@ public:
   virtual void prepare()
   {
     if (!prepared_) {
-      const GDT::Operators::DiffusiveFluxReconstruction< GridViewType, DiffusionFactorType, DiffusionTensorType >
-        diffusive_flux_reconstruction(space_.grid_view(),
-                                      *problem_mu_->diffusion_factor()->affine_part(),
-                                      *problem_.diffusion_tensor()->affine_part(),
-                                      over_integrate);
-      diffusive_flux_reconstruction.apply(discrete_solution_, diffusive_flux_);
+      if (reconstructed_flux_) {
+        const GDT::Operators::DiffusiveFluxReconstruction< GridViewType, DiffusionFactorType, DiffusionTensorType >
+          diffusive_flux_reconstruction(space_.grid_view(),
+                                        *problem_mu_->diffusion_factor()->affine_part(),
+                                        *problem_.diffusion_tensor()->affine_part(),
+                                        over_integrate);
+        diffusive_flux_reconstruction.apply(discrete_solution_, *reconstructed_flux_);
+      }
       result_ = 0.0;
       prepared_ = true;
     }
@@ -456,10 +526,11 @@ private:
   const SpaceType& space_;
   const VectorType& vector_;
   const ProblemType& problem_;
-  const std::shared_ptr< typename ProblemType::NonparametricType > problem_mu_;
+  const std::shared_ptr< const typename ProblemType::NonparametricType > problem_mu_;
   const ConstDiscreteFunctionType discrete_solution_;
   const RTN0SpaceType rtn0_space_;
-  RTN0DiscreteFunctionType diffusive_flux_;
+  std::unique_ptr< RTN0DiscreteFunctionType > reconstructed_flux_;
+  const RTN0DiscreteFunctionType& diffusive_flux_;
   const DivergenceType divergence_;
   const DifferenceType difference_;
   const CutoffFunctionType cutoff_function_;
@@ -513,11 +584,12 @@ public:
 
   static const unsigned int dimDomain = SpaceType::dimDomain;
 
-private:
-  typedef GDT::ConstDiscreteFunction< SpaceType, VectorType > ConstDiscreteFunctionType;
   typedef GDT::Spaces::RT::PdelabBased< GridViewType, 0, RangeFieldType, dimDomain > RTN0SpaceType;
   typedef GDT::DiscreteFunction< RTN0SpaceType, VectorType > RTN0DiscreteFunctionType;
 
+private:
+  typedef GDT::ConstDiscreteFunction< SpaceType, VectorType > ConstDiscreteFunctionType;
+
   typedef typename ProblemType::DiffusionFactorType::NonparametricType DiffusionFactorType;
   typedef typename ProblemType::DiffusionTensorType::NonparametricType DiffusionTensorType;
 
@@ -575,7 +647,35 @@ public:
     , problem_mu_hat_(problem.with_mu(mu_hat))
     , discrete_solution_(space_, vector_)
     , rtn0_space_(space.grid_view())
-    , diffusive_flux_(rtn0_space_)
+    , reconstructed_flux_(Stuff::Common::make_unique< RTN0DiscreteFunctionType >(rtn0_space_))
+    , diffusive_flux_(*reconstructed_flux_)
+    , local_operator_(over_integrate,
+                      *problem_mu_hat_->diffusion_factor()->affine_part(),
+                      *problem_.diffusion_tensor()->affine_part(),
+                      diffusive_flux_)
+    , tmp_local_matrices_({1, local_operator_.numTmpObjectsRequired()}, 1, 1)
+    , prepared_(false)
+    , result_(0.0)
+  {}
+
+  /**
+   * \brief Uses the given reconstruction of the diffusive flux of vector (w.r.t. mu) instead of computing it.
+   */
+  LocalDiffusiveFluxESV2007(const SpaceType& space,
+                            const VectorType& vector,
+                            const ProblemType& problem,
+                            const RTN0DiscreteFunctionType& diffusive_flux,
+                            const Pymor::Parameter mu = Pymor::Parameter(),
+                            const Pymor::Parameter mu_hat = Pymor::Parameter())
+    : space_(space)
+    , vector_(vector)
+    , problem_(assert_problem(problem, mu, mu_hat))
+    , problem_mu_(problem_.with_mu(mu))
+    , problem_mu_hat_(problem.with_mu(mu_hat))
+    , discrete_solution_(space_, vector_)
+    , rtn0_space_(space.grid_view())
+    , reconstructed_flux_(nullptr)
+    , diffusive_flux_(diffusive_flux)
     , local_operator_(over_integrate,
                       *problem_mu_hat_->diffusion_factor()->affine_part(),
                       *problem_.diffusion_tensor()->affine_part(),
@@ -588,12 +688,14 @@ public:
   virtual void prepare()
   {
     if (!prepared_) {
-      const GDT::Operators::DiffusiveFluxReconstruction< GridViewType, DiffusionFactorType, DiffusionTensorType >
-        diffusive_flux_reconstruction(space_.grid_view(),
-                                      *problem_mu_->diffusion_factor()->affine_part(),
-                                      *problem_.diffusion_tensor()->affine_part(),
-                                      over_integrate);
-      diffusive_flux_reconstruction.apply(discrete_solution_, diffusive_flux_);
+      if (reconstructed_flux_) {
+        const GDT::Operators::DiffusiveFluxReconstruction< GridViewType, DiffusionFactorType, DiffusionTensorType >
+          diffusive_flux_reconstruction(space_.grid_view(),
+                                        *problem_mu_->diffusion_factor()->affine_part(),
+                                        *problem_.diffusion_tensor()->affine_part(),
+                                        over_integrate);
+        diffusive_flux_reconstruction.apply(discrete_solution_, *reconstructed_flux_);
+      }
       result_ = 0.0;
       prepared_ = true;
     }
@@ -624,7 +726,8 @@ private:
   const std::shared_ptr< const typename ProblemType::NonparametricType > problem_mu_hat_;
   const ConstDiscreteFunctionType discrete_solution_;
   const RTN0SpaceType rtn0_space_;
-  RTN0DiscreteFunctionType diffusive_flux_;
+  std::unique_ptr< RTN0DiscreteFunctionType > reconstructed_flux_;
+  const RTN0DiscreteFunctionType& diffusive_flux_;
   const LocalOperatorType local_operator_;
   TmpStorageProviderType tmp_local_matrices_;
   bool prepared_;
@@ -668,11 +771,15 @@ public:
 
   static RangeFieldType estimate(const SpaceType& space, const VectorType& vector, const ProblemType& problem)
   {
-    LocalNonconformityESV2007< SpaceType, VectorType, ProblemType, GridType > eta_nc(space, vector, problem);
-    LocalResidualESV2007< SpaceType, VectorType, ProblemType, GridType >      eta_r(space, problem);
+    const auto grid_view_key = grid_view_fingerprint(space.grid_view());
+    LocalNonconformityESV2007< SpaceType, VectorType, ProblemType, GridType >
+        eta_nc(space, vector, problem, Pymor::Parameter(), grid_view_key);
     LocalDiffusiveFluxESV2007< SpaceType, VectorType, ProblemType, GridType > eta_df(space, vector, problem);
+    const auto eta_r_t_squared_cached
+        = LocalResidualESV2007< SpaceType, VectorType, ProblemType, GridType >::estimate_locally(space,
+                                                                                               problem,
+                                                                                               grid_view_key);
     eta_nc.prepare();
-    eta_r.prepare();
     eta_df.prepare();
 
     RangeFieldType eta_squared(0.0);
@@ -681,8 +788,9 @@ public:
     const auto entity_it_end = grid_view.template end< 0 >();
     for (auto entity_it = grid_view.template begin< 0 >(); entity_it != entity_it_end; ++entity_it) {
       const auto& entity = *entity_it;
+      const RangeFieldType eta_r_t_squared = (*eta_r_t_squared_cached)[grid_view.indexSet().index(entity)];
       eta_squared += eta_nc.compute_locally(entity)
-                   + std::pow(std::sqrt(eta_r.compute_locally(entity)) + std::sqrt(eta_df.compute_locally(entity)), 2);
+                   + std::pow(std::sqrt(eta_r_t_squared) + std::sqrt(eta_df.compute_locally(entity)), 2);
     }
     return std::sqrt(eta_squared);
   } // ... estimate(...)
@@ -691,11 +799,15 @@ public:
                                                                        const VectorType& vector,
                                                                        const ProblemType& problem)
   {
-    LocalNonconformityESV2007< SpaceType, VectorType, ProblemType, GridType > eta_nc(space, vector, problem);
-    LocalResidualESV2007< SpaceType, VectorType, ProblemType, GridType >      eta_r(space, problem);
+    const auto grid_view_key = grid_view_fingerprint(space.grid_view());
+    LocalNonconformityESV2007< SpaceType, VectorType, ProblemType, GridType >
+        eta_nc(space, vector, problem, Pymor::Parameter(), grid_view_key);
     LocalDiffusiveFluxESV2007< SpaceType, VectorType, ProblemType, GridType > eta_df(space, vector, problem);
+    const auto eta_r_t_squared_cached
+        = LocalResidualESV2007< SpaceType, VectorType, ProblemType, GridType >::estimate_locally(space,
+                                                                                               problem,
+                                                                                               grid_view_key);
     eta_nc.prepare();
-    eta_r.prepare();
     eta_df.prepare();
 
     const auto& grid_view = space.grid_view();
@@ -709,7 +821,7 @@ public:
       const auto index = grid_view.indexSet().index(entity);
       const RangeFieldType eta_t_squared
           = eta_nc.compute_locally(entity)
-            + std::pow(std::sqrt(eta_r.compute_locally(entity)) + std::sqrt(eta_df.compute_locally(entity)), 2);
+            + std::pow(std::sqrt((*eta_r_t_squared_cached)[index]) + std::sqrt(eta_df.compute_locally(entity)), 2);
       local_indicators[index] = eta_t_squared;
       eta_squared += eta_t_squared;
     }
@@ -755,11 +867,15 @@ public:
 
   static RangeFieldType estimate(const SpaceType& space, const VectorType& vector, const ProblemType& problem)
   {
-    LocalNonconformityESV2007< SpaceType, VectorType, ProblemType, GridType > eta_nc(space, vector, problem);
-    LocalResidualESV2007< SpaceType, VectorType, ProblemType, GridType >      eta_r(space, problem);
+    const auto grid_view_key = grid_view_fingerprint(space.grid_view());
+    LocalNonconformityESV2007< SpaceType, VectorType, ProblemType, GridType >
+        eta_nc(space, vector, problem, Pymor::Parameter(), grid_view_key);
     LocalDiffusiveFluxESV2007< SpaceType, VectorType, ProblemType, GridType > eta_df(space, vector, problem);
+    const auto eta_r_t_squared_cached
+        = LocalResidualESV2007< SpaceType, VectorType, ProblemType, GridType >::estimate_locally(space,
+                                                                                               problem,
+                                                                                               grid_view_key);
     eta_nc.prepare();
-    eta_r.prepare();
     eta_df.prepare();
 
     RangeFieldType eta_nc_squared(0.0);
@@ -771,7 +887,7 @@ public:
     for (auto entity_it = grid_view.template begin< 0 >(); entity_it != entity_it_end; ++entity_it) {
       const auto& entity = *entity_it;
       eta_nc_squared += eta_nc.compute_locally(entity);
-      eta_r_squared += eta_r.compute_locally(entity);
+      eta_r_squared += (*eta_r_t_squared_cached)[grid_view.indexSet().index(entity)];
       eta_df_squared += eta_df.compute_locally(entity);
     }
     return std::sqrt(eta_nc_squared) + std::sqrt(eta_r_squared) + std::sqrt(eta_df_squared);
@@ -781,11 +897,15 @@ public:
                                                                        const VectorType& vector,
                                                                        const ProblemType& problem)
   {
-    LocalNonconformityESV2007< SpaceType, VectorType, ProblemType, GridType > eta_nc(space, vector, problem);
-    LocalResidualESV2007< SpaceType, VectorType, ProblemType, GridType >      eta_r(space, problem);
+    const auto grid_view_key = grid_view_fingerprint(space.grid_view());
+    LocalNonconformityESV2007< SpaceType, VectorType, ProblemType, GridType >
+        eta_nc(space, vector, problem, Pymor::Parameter(), grid_view_key);
     LocalDiffusiveFluxESV2007< SpaceType, VectorType, ProblemType, GridType > eta_df(space, vector, problem);
+    const auto eta_r_t_squared_cached
+        = LocalResidualESV2007< SpaceType, VectorType, ProblemType, GridType >::estimate_locally(space,
+                                                                                               problem,
+                                                                                               grid_view_key);
     eta_nc.prepare();
-    eta_r.prepare();
     eta_df.prepare();
 
     const auto grid_view = space.grid_view();
@@ -800,7 +920,7 @@ public:
       const auto& entity = *entity_it;
       const auto index = grid_view.indexSet().index(entity);
       const RangeFieldType eta_nc_t_squared = eta_nc.compute_locally(entity);
-      const RangeFieldType eta_r_t_squared = eta_r.compute_locally(entity);
+      const RangeFieldType eta_r_t_squared = (*eta_r_t_squared_cached)[index];
       const RangeFieldType eta_df_t_squared = eta_df.compute_locally(entity);
       eta_nc_squared += eta_nc_t_squared;
       eta_r_squared += eta_r_t_squared;
@@ -818,15 +938,238 @@ public:
 #endif // HAVE_ALUGRID
 
 
+template< class SpaceType, class VectorType, class ProblemType, class GridType >
+class Session
+{
+public:
+  static const bool available = false;
+};
+
+
+#if HAVE_ALUGRID
+
+/**
+ * \brief Computes all estimators of ESV2007 for one given vector, sharing all intermediate quantities.
+ *
+ *        Each local component (and the diffusive flux reconstruction it depends on) is computed on first request and
+ *        then kept, so that any sequence of estimate() and estimate_local() calls costs at most one grid walk per
+ *        component and one flux reconstruction.
+ * \note  The session holds a copy of the vector, use matches() to check if it can be reused for a given vector.
+ */
+template< class SpaceType, class VectorType, class ProblemType >
+class Session< SpaceType, VectorType, ProblemType, ALUGrid< 2, 2, simplex, conforming > >
+{
+  typedef ALUGrid< 2, 2, simplex, conforming > GridType;
+  typedef LocalNonconformityESV2007< SpaceType, VectorType, ProblemType, GridType > LocalNonconformityType;
+  typedef LocalResidualESV2007< SpaceType, VectorType, ProblemType, GridType >      LocalResidualType;
+  typedef LocalResidualESV2007Star< SpaceType, VectorType, ProblemType, GridType >  LocalResidualStarType;
+  typedef LocalDiffusiveFluxESV2007< SpaceType, VectorType, ProblemType, GridType > LocalDiffusiveFluxType;
+  typedef typename LocalDiffusiveFluxType::GridViewType                            GridViewType;
+  typedef typename LocalDiffusiveFluxType::RTN0SpaceType                           RTN0SpaceType;
+  typedef typename LocalDiffusiveFluxType::RTN0DiscreteFunctionType                RTN0DiscreteFunctionType;
+  typedef GDT::ConstDiscreteFunction< SpaceType, VectorType >                      ConstDiscreteFunctionType;
+  typedef typename ProblemType::DiffusionFactorType::NonparametricType             DiffusionFactorType;
+  typedef typename ProblemType::DiffusionTensorType::NonparametricType             DiffusionTensorType;
+
+  static const ProblemType& assert_problem(const ProblemType& problem)
+  {
+    if (problem.parametric())
+      DUNE_THROW(NotImplemented, "Not implemented yet for parametric problems!");
+    return problem;
+  }
+
+public:
+  static const bool available = true;
+
+  typedef typename ProblemType::RangeFieldType RangeFieldType;
+  typedef std::vector< RangeFieldType >        LocalValuesType;
+
+  Session(const SpaceType& space, const VectorType& vector, const ProblemType& problem)
+    : space_(space)
+    , vector_(vector)
+    , problem_(assert_problem(problem))
+    , grid_view_key_(grid_view_fingerprint(space_.grid_view()))
+  {}
+
+  const VectorType& vector() const
+  {
+    return vector_;
+  }
+
+  bool matches(const VectorType& vector) const
+  {
+    if (vector.size() != vector_.size())
+      return false;
+    for (size_t ii = 0; ii < vector_.size(); ++ii)
+      if (vector.get_entry(ii) != vector_.get_entry(ii))
+        return false;
+    return true;
+  } // ... matches(...)
+
+  RangeFieldType estimate(const std::string& type)
+  {
+    if (type == LocalNonconformityESV2007Base::id())
+      return std::sqrt(sum(nonconformity_locally()));
+    else if (type == LocalResidualESV2007Base::id())
+      return std::sqrt(sum(residual_locally()));
+    else if (type == LocalResidualESV2007StarBase::id())
+      return std::sqrt(sum(residual_star_locally()));
+    else if (type == LocalDiffusiveFluxESV2007Base::id())
+      return std::sqrt(sum(diffusive_flux_locally()));
+    else if (type == ESV2007Base::id())
+      return std::sqrt(sum(esv2007_locally()));
+    else if (type == ESV2007AlternativeSummationBase::id())
+      return std::sqrt(sum(nonconformity_locally()))
+           + std::sqrt(sum(residual_locally()))
+           + std::sqrt(sum(diffusive_flux_locally()));
+    else
+      DUNE_THROW(Stuff::Exceptions::you_are_using_this_wrong, "Requested type '" << type << "' is not available!");
+  } // ... estimate(...)
+
+  Stuff::LA::CommonDenseVector< RangeFieldType > estimate_local(const std::string& type)
+  {
+    Stuff::LA::CommonDenseVector< RangeFieldType >
+        local_indicators(boost::numeric_cast< size_t >(space_.grid_view().indexSet().size(0)), 0.0);
+    RangeFieldType eta_squared = 0.0;
+    if (type == ESV2007Base::id()) {
+      const auto& eta_t_squared = esv2007_locally();
+      for (size_t ii = 0; ii < eta_t_squared.size(); ++ii)
+        local_indicators[ii] = eta_t_squared[ii];
+      eta_squared = sum(eta_t_squared);
+    } else if (type == ESV2007AlternativeSummationBase::id()) {
+      const auto& eta_nc_t_squared = nonconformity_locally();
+      const auto& eta_r_t_squared = residual_locally();
+      const auto& eta_df_t_squared = diffusive_flux_locally();
+      for (size_t ii = 0; ii < eta_nc_t_squared.size(); ++ii)
+        local_indicators[ii] = 3.0*(eta_nc_t_squared[ii] + eta_r_t_squared[ii] + eta_df_t_squared[ii]);
+      eta_squared = std::pow(std::sqrt(sum(eta_nc_t_squared))
+                             + std::sqrt(sum(eta_r_t_squared))
+                             + std::sqrt(sum(eta_df_t_squared)),
+                             2);
+    } else
+      DUNE_THROW(Stuff::Exceptions::you_are_using_this_wrong, "Requested type '" << type << "' is not available!");
+    for (auto& element : local_indicators)
+      element /= eta_squared;
+    return local_indicators;
+  } // ... estimate_local(...)
+
+  const RTN0DiscreteFunctionType& diffusive_flux()
+  {
+    if (!diffusive_flux_) {
+      rtn0_space_ = Stuff::Common::make_unique< RTN0SpaceType >(space_.grid_view());
+      diffusive_flux_ = Stuff::Common::make_unique< RTN0DiscreteFunctionType >(*rtn0_space_);
+      const ConstDiscreteFunctionType discrete_solution(space_, vector_);
+      const GDT::Operators::DiffusiveFluxReconstruction< GridViewType, DiffusionFactorType, DiffusionTensorType >
+        diffusive_flux_reconstruction(space_.grid_view(),
+                                      *problem_.diffusion_factor()->affine_part(),
+                                      *problem_.diffusion_tensor()->affine_part(),
+                                      over_integrate);
+      diffusive_flux_reconstruction.apply(discrete_solution, *diffusive_flux_);
+    }
+    return *diffusive_flux_;
+  } // ... diffusive_flux(...)
+
+  // the following return the squared local contributions of each entity (in the order of the index set)
+  const LocalValuesType& nonconformity_locally()
+  {
+    if (!nonconformity_) {
+      LocalNonconformityType estimator(space_, vector_, problem_, Pymor::Parameter(), grid_view_key_);
+      nonconformity_ = walk(estimator);
+    }
+    return *nonconformity_;
+  } // ... nonconformity_locally(...)
+
+  const LocalValuesType& residual_locally()
+  {
+    if (!residual_)
+      residual_ = LocalResidualType::estimate_locally(space_, problem_, grid_view_key_);
+    return *residual_;
+  } // ... residual_locally(...)
+
+  const LocalValuesType& residual_star_locally()
+  {
+    if (!residual_star_) {
+      LocalResidualStarType estimator(space_, vector_, problem_, diffusive_flux());
+      residual_star_ = walk(estimator);
+    }
+    return *residual_star_;
+  } // ... residual_star_locally(...)
+
+  const LocalValuesType& diffusive_flux_locally()
+  {
+    if (!diffusive_flux_estimate_) {
+      LocalDiffusiveFluxType estimator(space_, vector_, problem_, diffusive_flux());
+      diffusive_flux_estimate_ = walk(estimator);
+    }
+    return *diffusive_flux_estimate_;
+  } // ... diffusive_flux_locally(...)
+
+private:
+  const LocalValuesType& esv2007_locally()
+  {
+    if (!esv2007_) {
+      const auto& eta_nc_t_squared = nonconformity_locally();
+      const auto& eta_r_t_squared = residual_locally();
+      const auto& eta_df_t_squared = diffusive_flux_locally();
+      LocalValuesType eta_t_squared(eta_nc_t_squared.size(), 0.0);
+      for (size_t ii = 0; ii < eta_t_squared.size(); ++ii)
+        eta_t_squared[ii] = eta_nc_t_squared[ii]
+                            + std::pow(std::sqrt(eta_r_t_squared[ii]) + std::sqrt(eta_df_t_squared[ii]), 2);
+      esv2007_ = Stuff::Common::make_unique< const LocalValuesType >(std::move(eta_t_squared));
+    }
+    return *esv2007_;
+  } // ... esv2007_locally(...)
+
+  template< class LocalEstimatorType >
+  std::unique_ptr< const LocalValuesType > walk(LocalEstimatorType& estimator) const
+  {
+    estimator.prepare();
+    const auto& grid_view = space_.grid_view();
+    LocalValuesType values(boost::numeric_cast< size_t >(grid_view.indexSet().size(0)), 0.0);
+    for (const auto& entity : Stuff::Common::entityRange(grid_view))
+      values[grid_view.indexSet().index(entity)] = estimator.compute_locally(entity);
+    return Stuff::Common::make_unique< const LocalValuesType >(std::move(values));
+  } // ... walk(...)
+
+  static RangeFieldType sum(const LocalValuesType& values)
+  {
+    return std::accumulate(values.begin(), values.end(), RangeFieldType(0));
+  }
+
+  const SpaceType& space_;
+  const VectorType vector_;
+  const ProblemType& problem_;
+  const std::string grid_view_key_;
+  std::unique_ptr< const RTN0SpaceType > rtn0_space_;
+  std::unique_ptr< RTN0DiscreteFunctionType > diffusive_flux_;
+  std::unique_ptr< const LocalValuesType > nonconformity_;
+  std::shared_ptr< const LocalValuesType > residual_;
+  std::unique_ptr< const LocalValuesType > residual_star_;
+  std::unique_ptr< const LocalValuesType > diffusive_flux_estimate_;
+  std::unique_ptr< const LocalValuesType > esv2007_;
+}; // class Session< ..., ALUGrid< 2, 2, simplex, conforming > >
+
+#endif // HAVE_ALUGRID
+
+
 } // namespace SWIPDG
 } // namespace internal
 
 
+/**
+ * \note The vectors have to be given in the numbering of the space, convert the vectors of a renumbered
+ *       discretization by its to_space_numbering() first.
+ */
 template< class SpaceType, class VectorType, class ProblemType, class GridType >
 class SWIPDG
 {
 public:
   typedef typename ProblemType::RangeFieldType RangeFieldType;
+  /**
+   * \brief Use a session instead of estimate() and estimate_local() to evaluate several estimators for the same
+   *        vector (available if SessionType::available is true).
+   */
+  typedef internal::SWIPDG::Session< SpaceType, VectorType, ProblemType, GridType > SessionType;
 
 private:
   template< class IndividualEstimator, bool available = false >
@@ -0,0 +1,72 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_PARALLEL_HH
+#define DUNE_HDD_LINEARELLIPTIC_PARALLEL_HH
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Dune {
+namespace HDD {
+namespace LinearElliptic {
+namespace internal {
+
+
+/**
+ * \brief Calls functor(item) for each item on num_threads threads (0 meaning as many as the hardware supports).
+ *
+ *        The items are handed out one at a time, so items of different cost are balanced automatically. The first
+ *        exception thrown by any call is rethrown once all threads have been joined, the remaining items are skipped.
+ */
+template< class ItemType, class FunctorType >
+void parallel_for_each(const std::vector< ItemType >& items, size_t num_threads, const FunctorType& functor)
+{
+  if (num_threads == 0)
+    num_threads = std::max(size_t(1), size_t(std::thread::hardware_concurrency()));
+  num_threads = std::min(num_threads, items.size());
+  if (num_threads <= 1) {
+    for (const auto& item : items)
+      functor(item);
+    return;
+  }
+  std::atomic< size_t > next(0);
+  std::atomic< bool > failed(false);
+  std::mutex exception_mutex;
+  std::exception_ptr exception;
+  const auto work = [&]() {
+    for (size_t ii = next++; ii < items.size() && !failed; ii = next++) {
+      try {
+        functor(items[ii]);
+      } catch (...) {
+        std::lock_guard< std::mutex > lock(exception_mutex);
+        if (!exception)
+          exception = std::current_exception();
+        failed = true;
+      }
+    }
+  };
+  std::vector< std::thread > threads;
+  threads.reserve(num_threads - 1);
+  for (size_t tt = 1; tt < num_threads; ++tt)
+    threads.emplace_back(work);
+  work();
+  for (auto& thread : threads)
+    thread.join();
+  if (exception)
+    std::rethrow_exception(exception);
+} // ... parallel_for_each(...)
+
+
+} // namespace internal
+} // namespace LinearElliptic
+} // namespace HDD
+} // namespace Dune
+
+#endif // DUNE_HDD_LINEARELLIPTIC_PARALLEL_HH
@@ -0,0 +1,392 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_PARTITIONING_HH
+#define DUNE_HDD_LINEARELLIPTIC_PARTITIONING_HH
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/numeric/conversion/cast.hpp>
+
+#ifndef DUNE_HDD_HAVE_METIS
+# define DUNE_HDD_HAVE_METIS 0
+#endif
+
+#if DUNE_HDD_HAVE_METIS
+# include <metis.h>
+#endif
+
+#include <dune/stuff/common/configuration.hh>
+#include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/common/memory.hh>
+#include <dune/stuff/common/ranges.hh>
+#include <dune/stuff/common/timedlogging.hh>
+#include <dune/stuff/grid/provider/cube.hh>
+
+#if HAVE_DUNE_GRID_MULTISCALE
+# include <dune/grid/multiscale/default.hh>
+# include <dune/grid/multiscale/factory/default.hh>
+# include <dune/grid/multiscale/provider/interface.hh>
+#endif
+
+namespace Dune {
+namespace HDD {
+namespace LinearElliptic {
+
+
+/**
+ * \brief Partitions the elements of a grid view into subdomains along the dual graph of the grid view (the elements
+ *        being the vertices, the inner faces being the edges).
+ *
+ *        The partitions balance the sum of the weights of their elements (e.g. the number of DoFs per element) while
+ *        minimizing the number of faces between subdomains. If dune-hdd was configured with METIS
+ *        (DUNE_HDD_HAVE_METIS), METIS_PartGraphKway is used by default, otherwise a recursive bisection of the dual
+ *        graph along breadth first orderings. Since METIS may leave parts empty (e.g. for few elements per part), its
+ *        partitions are checked and the bisection is used instead if a part is empty.
+ */
+template< class GridViewImp >
+class GraphPartitioner
+{
+public:
+  typedef GridViewImp                                      GridViewType;
+  typedef typename GridViewType::template Codim< 0 >::Entity EntityType;
+  typedef std::function< size_t(const EntityType&) >      WeightType;
+
+  GraphPartitioner(const GridViewType& grid_view, const WeightType weight = nullptr)
+    : num_elements_(grid_view.indexSet().size(0))
+    , offsets_(num_elements_ + 1, 0)
+    , weights_(num_elements_, 1)
+  {
+    const auto& index_set = grid_view.indexSet();
+    std::vector< std::vector< size_t > > neighbours(num_elements_);
+    for (const auto& entity : Stuff::Common::entityRange(grid_view)) {
+      const size_t index = index_set.index(entity);
+      if (weight)
+        weights_[index] = std::max(size_t(1), weight(entity));
+      const auto intersection_it_end = grid_view.iend(entity);
+      for (auto intersection_it = grid_view.ibegin(entity); intersection_it != intersection_it_end; ++intersection_it) {
+        const auto& intersection = *intersection_it;
+        if (intersection.neighbor() && !intersection.boundary()) {
+          const auto neighbour_ptr = intersection.outside();
+          neighbours[index].push_back(index_set.index(*neighbour_ptr));
+        }
+      }
+    }
+    for (size_t ii = 0; ii < num_elements_; ++ii) {
+      offsets_[ii + 1] = offsets_[ii] + neighbours[ii].size();
+      adjacency_.insert(adjacency_.end(), neighbours[ii].begin(), neighbours[ii].end());
+    }
+  } // GraphPartitioner(...)
+
+  /**
+   * \brief The default backend, one of "metis" or "bisection".
+   */
+  static std::string backend()
+  {
+#if DUNE_HDD_HAVE_METIS
+    return "metis";
+#else
+    return "bisection";
+#endif
+  }
+
+  /**
+   * \brief Returns the subdomain of each element (by its index in the index set of the grid view), each subdomain
+   *        contains at least one element.
+   * \param type one of "metis" (only if DUNE_HDD_HAVE_METIS) or "bisection"
+   */
+  std::vector< size_t > partition(const size_t num_subdomains, const std::string type = backend()) const
+  {
+    if (num_subdomains == 0)
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given, "num_subdomains has to be positive!");
+    if (num_subdomains > num_elements_)
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                 "Cannot partition " << num_elements_ << " elements into " << num_subdomains << " subdomains!");
+    if (type != "bisection" && !(type == "metis" && DUNE_HDD_HAVE_METIS))
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given, "Unknown or unavailable partitioner '" << type << "'!");
+    auto logger = Stuff::Common::TimedLogger().get("hdd.linearelliptic.graphpartitioner");
+    logger.info() << "partitioning " << num_elements_ << " elements into " << num_subdomains << " subdomains ("
+                  << type << ")... " << std::endl;
+    std::vector< size_t > ret(num_elements_, 0);
+    if (num_subdomains > 1) {
+#if DUNE_HDD_HAVE_METIS
+      if (type == "metis") {
+        if (!partition_metis(num_subdomains, ret) || num_nonempty(ret, num_subdomains) < num_subdomains) {
+          logger.warn() << "METIS failed or left subdomains empty, using the bisection instead" << std::endl;
+          bisection(num_subdomains, ret);
+        }
+      } else
+#endif // DUNE_HDD_HAVE_METIS
+        bisection(num_subdomains, ret);
+    }
+    logger.info() << "  done (" << interface_faces(ret) << " interface faces)" << std::endl;
+    return ret;
+  } // ... partition(...)
+
+  /**
+   * \brief Returns the number of faces between different subdomains of the given partition.
+   */
+  size_t interface_faces(const std::vector< size_t >& partition) const
+  {
+    size_t ret = 0;
+    for (size_t ii = 0; ii < num_elements_; ++ii)
+      for (size_t kk = offsets_[ii]; kk < offsets_[ii + 1]; ++kk)
+        if (partition[ii] != partition[adjacency_[kk]])
+          ++ret;
+    return ret / 2;
+  } // ... interface_faces(...)
+
+  /**
+   * \brief Returns the sum of the weights of the elements of each subdomain of the given partition.
+   */
+  std::vector< size_t > subdomain_weights(const std::vector< size_t >& partition, const size_t num_subdomains) const
+  {
+    std::vector< size_t > ret(num_subdomains, 0);
+    for (size_t ii = 0; ii < num_elements_; ++ii) {
+      if (partition[ii] >= num_subdomains)
+        DUNE_THROW(Stuff::Exceptions::index_out_of_range,
+                   "Element " << ii << " belongs to subdomain " << partition[ii] << ", there are only "
+                   << num_subdomains << "!");
+      ret[partition[ii]] += weights_[ii];
+    }
+    return ret;
+  } // ... subdomain_weights(...)
+
+private:
+  size_t num_nonempty(const std::vector< size_t >& partition, const size_t num_subdomains) const
+  {
+    const auto weights = subdomain_weights(partition, num_subdomains);
+    return num_subdomains - std::count(weights.begin(), weights.end(), size_t(0));
+  }
+
+#if DUNE_HDD_HAVE_METIS
+  /**
+   * \return false if METIS failed
+   */
+  bool partition_metis(const size_t num_subdomains, std::vector< size_t >& ret) const
+  {
+    idx_t num_vertices = boost::numeric_cast< idx_t >(num_elements_);
+    idx_t num_constraints = 1;
+    idx_t num_parts = boost::numeric_cast< idx_t >(num_subdomains);
+    std::vector< idx_t > offsets(offsets_.begin(), offsets_.end());
+    std::vector< idx_t > adjacency(adjacency_.begin(), adjacency_.end());
+    std::vector< idx_t > weights(weights_.begin(), weights_.end());
+    idx_t options[METIS_NOPTIONS];
+    METIS_SetDefaultOptions(options);
+    options[METIS_OPTION_OBJTYPE] = METIS_OBJTYPE_CUT;
+    options[METIS_OPTION_CONTIG] = 1;
+    idx_t edge_cut = 0;
+    std::vector< idx_t > parts(num_elements_);
+    const int result = METIS_PartGraphKway(&num_vertices, &num_constraints, offsets.data(), adjacency.data(),
+                                           weights.data(), nullptr, nullptr, &num_parts, nullptr, nullptr, options,
+                                           &edge_cut, parts.data());
+    if (result != METIS_OK)
+      return false;
+    for (size_t ii = 0; ii < num_elements_; ++ii)
+      ret[ii] = parts[ii];
+    return true;
+  } // ... partition_metis(...)
+#endif // DUNE_HDD_HAVE_METIS
+
+  void bisection(const size_t num_subdomains, std::vector< size_t >& ret) const
+  {
+    std::vector< size_t > elements(num_elements_);
+    for (size_t ii = 0; ii < num_elements_; ++ii)
+      elements[ii] = ii;
+    bisect(elements, 0, num_subdomains, ret);
+  }
+
+  /**
+   * \brief Orders the given elements breadth first (within the subgraph they induce), starting from a pseudo
+   *        peripheral element, which keeps both halves of a split connected and their interface small.
+   */
+  std::vector< size_t > breadth_first(const std::vector< size_t >& elements, const std::vector< bool >& member) const
+  {
+    std::vector< size_t > order;
+    std::vector< bool > visited(num_elements_, false);
+    const auto search = [&](const size_t start) {
+      order.clear();
+      std::fill(visited.begin(), visited.end(), false);
+      for (size_t ss = 0; ss <= elements.size(); ++ss) {
+        // also visit components which are not connected to the start
+        const size_t root = ss == 0 ? start : elements[ss - 1];
+        if (visited[root])
+          continue;
+        std::deque< size_t > queue(1, root);
+        visited[root] = true;
+        while (!queue.empty()) {
+          const size_t current = queue.front();
+          queue.pop_front();
+          order.push_back(current);
+          for (size_t kk = offsets_[current]; kk < offsets_[current + 1]; ++kk) {
+            const size_t neighbour = adjacency_[kk];
+            if (member[neighbour] && !visited[neighbour]) {
+              visited[neighbour] = true;
+              queue.push_back(neighbour);
+            }
+          }
+        }
+      }
+    };
+    // the last element of a search is far from its start, a few restarts find a pseudo peripheral one
+    search(elements[0]);
+    for (size_t restart = 0; restart < 2; ++restart)
+      search(order.back());
+    return order;
+  } // ... breadth_first(...)
+
+  void bisect(const std::vector< size_t >& elements,
+              const size_t first_subdomain,
+              const size_t num_subdomains,
+              std::vector< size_t >& ret) const
+  {
+    if (num_subdomains == 1) {
+      for (const size_t element : elements)
+        ret[element] = first_subdomain;
+      return;
+    }
+    std::vector< bool > member(num_elements_, false);
+    size_t total_weight = 0;
+    for (const size_t element : elements) {
+      member[element] = true;
+      total_weight += weights_[element];
+    }
+    const size_t first_half = num_subdomains / 2;
+    const double target = double(total_weight) * first_half / num_subdomains;
+    const auto order = breadth_first(elements, member);
+    std::vector< size_t > first;
+    std::vector< size_t > second;
+    size_t weight = 0;
+    for (const size_t element : order) {
+      // keep at least one element per subdomain on either side
+      if ((weight < target && order.size() - first.size() > num_subdomains - first_half)
+          || first.size() < first_half) {
+        first.push_back(element);
+        weight += weights_[element];
+      } else
+        second.push_back(element);
+    }
+    bisect(first, first_subdomain, first_half, ret);
+    bisect(second, first_subdomain + first_half, num_subdomains - first_half, ret);
+  } // ... bisect(...)
+
+  const size_t num_elements_;
+  std::vector< size_t > offsets_;
+  std::vector< size_t > adjacency_;
+  std::vector< size_t > weights_;
+}; // class GraphPartitioner
+
+
+#if HAVE_DUNE_GRID_MULTISCALE
+
+
+/**
+ * \brief A multiscale grid provider, the subdomains of which are obtained from the dual graph of the leaf view by a
+ *        GraphPartitioner, for unstructured or strongly graded grids where grid::Multiscale::Providers::Cube gives
+ *        unbalanced subdomains with large interfaces.
+ *
+ *        When created from a configuration (see default_config()), the grid is a Stuff::Grid::Providers::Cube.
+ */
+template< class GridImp >
+class GraphPartitionedMsGridProvider
+  : public grid::Multiscale::ProviderInterface< GridImp >
+{
+  typedef grid::Multiscale::ProviderInterface< GridImp > BaseType;
+  typedef GraphPartitionedMsGridProvider< GridImp >      ThisType;
+public:
+  using typename BaseType::GridType;
+  using typename BaseType::MsGridType;
+  typedef typename GridType::LeafGridView                        GridViewType;
+  typedef GraphPartitioner< GridViewType >                       PartitionerType;
+  typedef typename PartitionerType::WeightType                   WeightType;
+  typedef grid::Multiscale::Factory::Default< GridType >         MsGridFactoryType;
+
+  static std::string static_id()
+  {
+    return BaseType::static_id() + ".graphpartitioned";
+  }
+
+  static Stuff::Common::Configuration default_config(const std::string sub_name = "")
+  {
+    Stuff::Common::Configuration config = Stuff::Grid::Providers::Cube< GridType >::default_config();
+    config["type"] = static_id();
+    config["num_subdomains"] = "4";
+    config["oversampling_layers"] = "0";
+    config["partitioner"] = PartitionerType::backend();
+    if (sub_name.empty())
+      return config;
+    else {
+      Stuff::Common::Configuration tmp;
+      tmp.add(config, sub_name);
+      return tmp;
+    }
+  } // ... default_config(...)
+
+  static std::unique_ptr< ThisType > create(const Stuff::Common::Configuration config = default_config(),
+                                            const std::string sub_name = static_id())
+  {
+    const Stuff::Common::Configuration cfg = config.has_sub(sub_name) ? config.sub(sub_name) : config;
+    const Stuff::Common::Configuration def_cfg = default_config();
+    return Stuff::Common::make_unique< ThisType >(
+          Stuff::Grid::Providers::Cube< GridType >::create(cfg)->grid_ptr(),
+          cfg.get("num_subdomains",      def_cfg.get< size_t >("num_subdomains")),
+          cfg.get("oversampling_layers", def_cfg.get< size_t >("oversampling_layers")),
+          nullptr,
+          cfg.get("partitioner",         def_cfg.get< std::string >("partitioner")));
+  } // ... create(...)
+
+  GraphPartitionedMsGridProvider(const std::shared_ptr< GridType >& grid_ptr,
+                                 const size_t num_subdomains,
+                                 const size_t num_oversampling_layers = 0,
+                                 const WeightType weight = nullptr,
+                                 const std::string partitioner = PartitionerType::backend())
+    : grid_(grid_ptr)
+  {
+    const auto grid_view = grid_->leafGridView();
+    const auto partition = PartitionerType(grid_view, weight).partition(num_subdomains, partitioner);
+    const auto& index_set = grid_view.indexSet();
+    const auto global_grid_part = std::make_shared< const typename MsGridType::GlobalGridPartType >(*grid_);
+    MsGridFactoryType factory(grid_, global_grid_part);
+    factory.prepare();
+    for (const auto& entity : Stuff::Common::entityRange(grid_view))
+      factory.add(entity, partition[index_set.index(entity)]);
+    factory.finalize(num_oversampling_layers);
+    ms_grid_ = factory.createMsGrid();
+  } // GraphPartitionedMsGridProvider(...)
+
+  virtual GridType& grid() override
+  {
+    return *grid_;
+  }
+
+  virtual const GridType& grid() const override
+  {
+    return *grid_;
+  }
+
+  virtual const std::shared_ptr< const MsGridType >& ms_grid() const override
+  {
+    return ms_grid_;
+  }
+
+private:
+  std::shared_ptr< GridType > grid_;
+  std::shared_ptr< const MsGridType > ms_grid_;
+}; // class GraphPartitionedMsGridProvider
+
+
+#endif // HAVE_DUNE_GRID_MULTISCALE
+
+
+} // namespace LinearElliptic
+} // namespace HDD
+} // namespace Dune
+
+#endif // DUNE_HDD_LINEARELLIPTIC_PARTITIONING_HH
@@ -15,6 +15,7 @@
 
 #include "problems/interfaces.hh"
 #include "problems/default.hh"
+#include "problems/cached.hh"
 #include "problems/ORS2016.hh"
 #include "problems/ESV2007.hh"
 #include "problems/mixed-boundaries.hh"
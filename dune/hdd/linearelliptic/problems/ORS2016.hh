@@ -7,16 +7,18 @@
 #define DUNE_HDD_LINEARELLIPTIC_PROBLEMS_ORS2016_HH
 
 #include <iostream>
+#include <memory>
+#include <string>
 #include <vector>
 
-#include <boost/numeric/conversion/cast.hpp>
+#include <dune/common/fmatrix.hh>
 
-#include <dune/stuff/functions/checkerboard.hh>
-#include <dune/stuff/playground/functions/indicator.hh>
+#include <dune/stuff/common/string.hh>
 
 #include <dune/pymor/functions/default.hh>
 
 #include "default.hh"
+#include "voxel-geometry.hh"
 
 namespace Dune {
 namespace HDD {
@@ -32,6 +34,7 @@ class BatteryGeometry
   typedef typename ProblemType::DomainType                     DomainType;
   typedef Stuff::LocalizableFunctionInterface< E, D, 3, R, 1 > NonparametricFunctionType;
   typedef typename ProblemType::DiffusionFactorType            DiffusionFactorType;
+  typedef MaterialFunction< E, D, 3, R >                       MaterialFunctionType;
 
 public:
   BatteryGeometry(const std::string& filename,
@@ -39,7 +42,10 @@ public:
                   const DomainType& upper_right,
                   const Stuff::Common::FieldVector< size_t, 3 >& num_elements,
                   const std::string& separator_domain,
-                  const std::string& name)
+                  const std::string& name,
+                  const R& force_value,
+                  const bool binary_cache,
+                  const std::string& binary_cache_filename)
   {
     // Interpretation of the data as int:
     //    enum Subdomain
@@ -50,85 +56,54 @@ public:
     //      CC_CATHODE, // 3
     //      ELECTROLYTE // 4
     //    };
-    static_assert(sizeof(int) == 4, "This is not the correct architecture, sizeof(int) should be 4!");
-
     size_t num_entries = 1;
     for (size_t ii = 0; ii < 3; ++ii)
       num_entries *= num_elements[ii];
-    std::vector< int > raw_data(num_entries);
-
-    std::ifstream file(filename, std::ifstream::binary);
-    if (!file)
-      DUNE_THROW(IOError, "Could not open '" << filename << "'!");
-    // check for the amount of data present in the file
-    file.seekg(0, file.end);
-    const auto length = file.tellg();
-    if (length != boost::numeric_cast< decltype(length) >(raw_data.size()*sizeof(int)))
-      DUNE_THROW(IOError,
-                 "Given file '" << filename << "' has wrong size (should be " << raw_data.size()*sizeof(int) << ", is "
-                 << length << ")!");
-    // read the actual data
-    file.seekg(0, file.beg);
-    file.read((char *)(raw_data.data()), length);
-    // check for the amount of read data
-    const auto read_data = file.gcount();
-    if (read_data != boost::numeric_cast< decltype(read_data) >(raw_data.size()*sizeof(int)))
-      DUNE_THROW(IOError,
-                 "Could not read the correct amount from given file '" << filename << "' (we would like to read "
-                 << raw_data.size()*sizeof(int) << " and the file reported this many entries, but we could only read "
-                 << read_data << "data)!");
-    if (!file)
-      DUNE_THROW(IOError, "Failed to read from file '" << filename << "'!");
-    file.close();
-
-    // create all but separator
-    typedef Stuff::Functions::Checkerboard< E, D, 3, R, 1, 1 > PiecewiseConstantFunctionType;
-    std::vector< typename PiecewiseConstantFunctionType::RangeType > data(num_entries);
-    for (size_t ii = 0; ii < num_entries; ++ii)
-      data[ii] = raw_data[ii];
-    auto battery_function = std::make_shared< PiecewiseConstantFunctionType >(lower_left, upper_right, num_elements, data, name);
-
-    // create separator
-    separator_ = std::shared_ptr< Stuff::Functions::DomainIndicator< E, D, 3, R, 1 > >(
-          Stuff::Functions::DomainIndicator< E, D, 3, R, 1 >::create(DSC::Configuration({"0.domain",        "0.value", "name"},
-                                                                                        {separator_domain,  "1",       "SEPARATOR"})));
-    // create one component per battery part
-    typedef Stuff::Functions::Constant< E, D, 3, R, 1, 1 >    ConstantFunctionType;
-    typedef Stuff::Functions::LevelIndicator< E, D, 3, R, 1 > LevelIndicator;
-    anode_      = std::make_shared< LevelIndicator >(battery_function, 0., 0., 1., "ANODE");
-    cathode_    = std::make_shared< LevelIndicator >(battery_function, 1., 1., 1., "CATHODE");
-    cc_anode_   = std::make_shared< LevelIndicator >(battery_function, 2., 2., 1., "CC_ANODE");
-    cc_cathode_ = std::make_shared< LevelIndicator >(battery_function, 3., 3., 1., "CC_CATHODE");
+    // the raw data (one int per voxel) is converted to one byte per voxel, the binary cache avoids this each time (see
+    // VoxelCache), it is written next to the data file unless binary_cache_filename is given
+    const auto voxels = binary_cache
+                        ? VoxelCache::get(filename,
+                                          num_entries,
+                                          binary_cache_filename.empty() ? VoxelCache::default_cache_filename(filename)
+                                                                        : binary_cache_filename)
+                        : std::make_shared< const VoxelData >(VoxelCache::read_raw(filename, num_entries));
+    // the separator is given by a region, which alters the material of all voxels within
+    const auto separator = Stuff::Common::fromString< FieldMatrix< D, 3, 2 > >(separator_domain);
+    DomainType separator_lower_left;
+    DomainType separator_upper_right;
+    for (size_t dd = 0; dd < 3; ++dd) {
+      separator_lower_left[dd] = separator[dd][0];
+      separator_upper_right[dd] = separator[dd][1];
+    }
+    materials_ = std::make_shared< MaterialFunctionType >(
+          voxels, lower_left, upper_right, num_elements,
+          std::vector< typename MaterialFunctionType::RegionType >(1, {separator_lower_left, separator_upper_right}));
+    // one table per coefficient (outside and inside of the separator), instead of chains of indicator functions
     //   for the electrolyte, substract the seperator
-    electrolyte_ = std::make_shared< LevelIndicator >(
-                     Stuff::Functions::make_difference(battery_function,
-                                                       Stuff::Functions::make_product(std::make_shared< ConstantFunctionType >(4.),
-                                                                                      separator_)),
-                     4., 4., 1., "ELECTROLYTE");
+    const size_t electrolyte = materials_->register_component({{0., 0., 0., 0., 1.},
+                                                                {0., 0., 0., 0., 0.}},
+                                                               "ELECTROLYTE");
+    const size_t non_electrolyte = materials_->register_component({{1.04,          1.58,          238.,
+                                                                    398.,          0.},
+                                                                   {1.04 + 0.3344, 1.58 + 0.3344, 238. + 0.3344,
+                                                                    398. + 0.3344, 0.3344}},
+                                                                  "NON_ELECTROLYTE");
+    const size_t electrodes = materials_->register_component({{1., 1., 0., 0., 0.}}, "ANODE_AND_CATHODE");
+    // the force only acts on the electrodes, given by a single lookup instead of the product of a constant and an
+    // indicator function
+    std::vector< R > force_coefficients(materials_->num_components(), R(0));
+    force_coefficients[electrodes] = force_value;
+    force_ = materials_->combination(force_coefficients, "force");
     // create parametric diffusion factor
-    battery_geometry_ = std::make_shared< Pymor::Functions::AffinelyDecomposableDefault< E, D, 3, R, 1 > >();
-//    battery_geometry_->register_component(anode_,       new Pymor::ParameterFunctional("ANODE",       1, "ANODE[0]"));
-//    battery_geometry_->register_component(cathode_,     new Pymor::ParameterFunctional("CATHODE",     1, "CATHODE[0]"));
-//    battery_geometry_->register_component(cc_anode_,    new Pymor::ParameterFunctional("CC_ANODE",    1, "CC_ANODE[0]"));
-//    battery_geometry_->register_component(cc_cathode_,  new Pymor::ParameterFunctional("CC_CATHODE",  1, "CC_CATHODE[0]"));
-    battery_geometry_->register_component(electrolyte_, new Pymor::ParameterFunctional("ELECTROLYTE", 1, "ELECTROLYTE[0]"));
-//    battery_geometry_->register_component(separator_,   new Pymor::ParameterFunctional("SEPARATOR",   1, "SEPARATOR[0]"));
-    battery_geometry_->register_affine_part(
-          Stuff::Functions::make_sum(Stuff::Functions::make_product(std::make_shared< ConstantFunctionType >(1.04),   anode_),
-          Stuff::Functions::make_sum(Stuff::Functions::make_product(std::make_shared< ConstantFunctionType >(1.58),   cathode_),
-          Stuff::Functions::make_sum(Stuff::Functions::make_product(std::make_shared< ConstantFunctionType >(238.),   cc_anode_),
-          Stuff::Functions::make_sum(Stuff::Functions::make_product(std::make_shared< ConstantFunctionType >(398.),   cc_cathode_),
-                                     Stuff::Functions::make_product(std::make_shared< ConstantFunctionType >(0.3344), separator_)))),
-                                     "NON_ELECTROLYTE"));
+    battery_geometry_ = std::make_shared< Pymor::Functions::AffinelyDecomposableDefault< E, D, 3, R, 1 > >(name);
+    battery_geometry_->register_component(materials_->component(electrolyte),
+                                          new Pymor::ParameterFunctional("ELECTROLYTE", 1, "ELECTROLYTE[0]"));
+    battery_geometry_->register_affine_part(materials_->component(non_electrolyte));
   } // BatteryGeometry(...)
 
 protected:
-  std::shared_ptr< NonparametricFunctionType > anode_;
-  std::shared_ptr< NonparametricFunctionType > cathode_;
-  std::shared_ptr< NonparametricFunctionType > cc_anode_;
-  std::shared_ptr< NonparametricFunctionType > cc_cathode_;
-  std::shared_ptr< NonparametricFunctionType > electrolyte_;
-  std::shared_ptr< NonparametricFunctionType > separator_;
+  std::shared_ptr< MaterialFunctionType > materials_;
+  std::shared_ptr< const NonparametricFunctionType > force_;
   std::shared_ptr< Pymor::Functions::AffinelyDecomposableDefault< E, D, 3, R, 1 > > battery_geometry_;
 }; // class BatteryGeometry
 
@@ -183,6 +158,8 @@ public:
     config["diffusion_factor.name"] = "battery_geometry";
     config["diffusion_factor.separator"] = "[0.0084 0.01; 0 0.008; 0 0.008]";
     config["force.value"] = "1";
+    config["binary_cache"] = "false";
+    config["binary_cache_filename"] = "";
     if (sub_name.empty())
       return config;
     else {
@@ -212,7 +189,10 @@ public:
                                                 def_cfg.get<RangeFieldType>("force.value")),
                                         BaseType::create_matrix_function("diffusion_tensor", cfg),
                                         BaseType::create_vector_function("dirichlet", cfg),
-                                        BaseType::create_vector_function("neumann", cfg));
+                                        BaseType::create_vector_function("neumann", cfg),
+                                        cfg.get("binary_cache", def_cfg.get< bool >("binary_cache")),
+                                        cfg.get("binary_cache_filename",
+                                                def_cfg.get< std::string >("binary_cache_filename")));
   } // ... create(...)
 
   ORS2016(const std::string& filename,
@@ -224,14 +204,14 @@ public:
           const RangeFieldType& force_value,
           const std::shared_ptr< const DiffusionTensorType >& diff_ten,
           const std::shared_ptr< const FunctionType >& dir,
-          const std::shared_ptr< const FunctionType >& neum)
-    : DataType(filename, lower_left, upper_right, num_elements, separator, name)
+          const std::shared_ptr< const FunctionType >& neum,
+          const bool binary_cache = default_config().template get< bool >("binary_cache"),
+          const std::string binary_cache_filename = default_config().template get< std::string >("binary_cache_filename"))
+    : DataType(filename, lower_left, upper_right, num_elements, separator, name, force_value, binary_cache,
+               binary_cache_filename)
     , BaseType(DataType::battery_geometry_,
                diff_ten,
-               std::make_shared< Pymor::Functions::AffinelyDecomposableDefault< E, D, 3, R, 1 > >(
-                  Stuff::Functions::make_product(std::make_shared< Stuff::Functions::Constant< E, D, 3, R, 1 > >(force_value),
-                                                 Stuff::Functions::make_sum(DataType::anode_, DataType::cathode_),
-                                                 "force")),
+               std::make_shared< Pymor::Functions::AffinelyDecomposableDefault< E, D, 3, R, 1 > >(DataType::force_),
                dir,
                neum)
   {}
@@ -23,11 +23,12 @@
 #include <dune/stuff/functions/global.hh>
 #include <dune/stuff/functions/expression.hh>
 #include <dune/stuff/functions/ESV2007.hh>
-#include <dune/stuff/playground/functions/indicator.hh>
 
 #include <dune/pymor/functions/default.hh>
 
 #include "default.hh"
+#include "box-indicator.hh"
+#include "spe10-cache.hh"
 
 namespace Dune {
 namespace HDD {
@@ -153,8 +154,10 @@ class Spe10Model1< E, D, 2, R, 1 >
 
   typedef Stuff::Functions::Constant< E, D, 2, R, 1 >         ConstantFunctionType;
   typedef Stuff::Functions::FlatTop< E, D, 2, R, 1 >          FlatTopFunctionType;
-  typedef Stuff::Functions::DomainIndicator< E, D, 2, R, 1 >  IndicatorFunctionType;
+  typedef BoxIndicator< E, D, 2, R, 1 >                       IndicatorFunctionType;
   typedef Stuff::Functions::Spe10::Model1< E, D, 2, R, 2, 2 > Spe10FunctionType;
+  typedef Spe10::MappedModel1< E, D, R >                      MappedSpe10FunctionType;
+  typedef Stuff::LocalizableFunctionInterface< E, D, 2, R, 2, 2 > TensorFunctionType;
 
 public:
   typedef typename BaseType::EntityType      EntityType;
@@ -186,6 +189,8 @@ public:
     config["lower_left"]  = "[0.0 0.0]";
     config["upper_right"] = "[5.0 1.0]";
     config["parametric_channel"] = "false";
+    config["binary_cache"] = "false";
+    config["binary_cache_filename"] = "";
     config.set("channel_boundary_layer", FlatTopFunctionType::default_config().template get< std::string >("boundary_layer"));
     if (sub_name.empty())
       return config;
@@ -208,7 +213,9 @@ public:
           get_values(cfg, "channel"),
           get_values(cfg, "forces"),
           cfg.get("channel_boundary_layer", def_cfg.get< DomainType >("channel_boundary_layer")),
-          cfg.get("parametric_channel", def_cfg.get< bool >("parametric_channel")));
+          cfg.get("parametric_channel", def_cfg.get< bool >("parametric_channel")),
+          cfg.get("binary_cache", def_cfg.get< bool >("binary_cache")),
+          cfg.get("binary_cache_filename", def_cfg.get< std::string >("binary_cache_filename")));
   } // ... create(...)
 
   Spe10Model1(const std::string filename,
@@ -217,14 +224,18 @@ public:
               const std::vector< std::tuple< DomainType, DomainType, typename IndicatorFunctionType::RangeType > >& channel_values,
               const std::vector< std::tuple< DomainType, DomainType, typename IndicatorFunctionType::RangeType > >& force_values,
               const DomainType& channel_boundary_layer = default_config().template get< DomainType >("channel_boundary_layer"),
-              const bool parametric_channel = default_config().template get< bool >("parametric_channel"))
+              const bool parametric_channel = default_config().template get< bool >("parametric_channel"),
+              const bool binary_cache = default_config().template get< bool >("binary_cache"),
+              const std::string binary_cache_filename = default_config().template get< std::string >("binary_cache_filename"))
     : BaseType(create_base(filename,
                            lower_left,
                            upper_right,
                            channel_values,
                            force_values,
                            channel_boundary_layer,
-                           parametric_channel))
+                           parametric_channel,
+                           binary_cache,
+                           binary_cache_filename))
   {}
 
 private:
@@ -237,26 +248,43 @@ private:
                               const Values& channel_values,
                               const Values& force_values,
                               const DomainType& channel_boundary_layer,
-                              const bool parametric_channel)
+                              const bool parametric_channel,
+                              const bool binary_cache,
+                              const std::string& binary_cache_filename)
   {
-    // build the channel as a sum of flattop functions
+    // build the channel as a sum of flattop functions (or of indicators, given as one indicator with all boxes)
     std::shared_ptr< FlatTopIndicatorType > channel(nullptr);
     if (channel_values.empty())
       channel = std::make_shared< ConstantFunctionType >(0, "zero");
-    else
+    else if (Stuff::Common::FloatCmp::eq(channel_boundary_layer, DomainType(0)))
+      channel = std::make_shared< IndicatorFunctionType >(channel_values, "channel", true);
+    else {
       channel = create_indicator(channel_values[0], channel_boundary_layer);
-    for (size_t ii = 1; ii < channel_values.size(); ++ii)
-      channel = Stuff::Functions::make_sum(channel,
-                                           create_indicator(channel_values[ii], channel_boundary_layer),
-                                           "channel");
+      for (size_t ii = 1; ii < channel_values.size(); ++ii)
+        channel = Stuff::Functions::make_sum(channel,
+                                             create_indicator(channel_values[ii], channel_boundary_layer),
+                                             "channel");
+    }
     // build the rest
     auto one = std::make_shared< ConstantFunctionType >(1, "one");
-    auto diffusion_tensor = std::make_shared< Spe10FunctionType >(filename,
-                                                                  lower_left,
-                                                                  upper_right,
-                                                                  Stuff::Functions::Spe10::internal::model1_min_value,
-                                                                  Stuff::Functions::Spe10::internal::model1_max_value,
-                                                                  "diffusion_tensor");
+    // the binary cache avoids parsing the data file each time (see Spe10::BinaryCache), it is written next to the data
+    // file unless binary_cache_filename is given
+    std::shared_ptr< TensorFunctionType > diffusion_tensor(nullptr);
+    if (binary_cache)
+      diffusion_tensor = std::make_shared< MappedSpe10FunctionType >(filename,
+                                                                     lower_left,
+                                                                     upper_right,
+                                                                     Stuff::Functions::Spe10::internal::model1_min_value,
+                                                                     Stuff::Functions::Spe10::internal::model1_max_value,
+                                                                     "diffusion_tensor",
+                                                                     binary_cache_filename);
+    else
+      diffusion_tensor = std::make_shared< Spe10FunctionType >(filename,
+                                                               lower_left,
+                                                               upper_right,
+                                                               Stuff::Functions::Spe10::internal::model1_min_value,
+                                                               Stuff::Functions::Spe10::internal::model1_max_value,
+                                                               "diffusion_tensor");
     auto force = std::make_shared< IndicatorFunctionType >(force_values, "force");
     auto dirichlet = std::make_shared< ConstantFunctionType >(0, "dirichlet");
     auto neumann = std::make_shared< ConstantFunctionType >(0, "neumann");
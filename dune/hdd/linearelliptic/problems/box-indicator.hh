@@ -0,0 +1,237 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_PROBLEMS_BOX_INDICATOR_HH
+#define DUNE_HDD_LINEARELLIPTIC_PROBLEMS_BOX_INDICATOR_HH
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/common/float_cmp.hh>
+#include <dune/stuff/functions/interfaces.hh>
+
+namespace Dune {
+namespace HDD {
+namespace LinearElliptic {
+namespace Problems {
+
+
+/**
+ * \brief A piecewise constant function given by a list of axis-aligned boxes and their values, a drop-in replacement
+ *        for Stuff::Functions::DomainIndicator.
+ *
+ *        The value on an entity is the value of the first box containing its center (lower_left <= center <
+ *        upper_right), or the sum of the values of all boxes containing it if sum_overlapping is set (which is the
+ *        same as a sum of indicators with one box each), and 0 elsewhere. Instead of testing every box, the boxes are
+ *        sorted into a uniform grid of bins upon construction, so that only the few boxes overlapping the bin of the
+ *        center have to be tested.
+ */
+template< class E, class D, int d, class R, int r, int rC = 1 >
+class BoxIndicator
+  : public Stuff::LocalizableFunctionInterface< E, D, d, R, r, rC >
+{
+  typedef Stuff::LocalizableFunctionInterface< E, D, d, R, r, rC > BaseType;
+  typedef BoxIndicator< E, D, d, R, r, rC >                         ThisType;
+public:
+  using typename BaseType::EntityType;
+  using typename BaseType::DomainType;
+  using typename BaseType::RangeType;
+  using typename BaseType::LocalfunctionType;
+
+  typedef std::vector< std::tuple< DomainType, DomainType, RangeType > >        ValuesType;
+  typedef std::vector< std::pair< std::pair< DomainType, DomainType >, RangeType > > DomainValuesType;
+
+  static const size_t max_bins_per_dim = 64;
+
+private:
+  class Localfunction
+    : public LocalfunctionType
+  {
+    typedef LocalfunctionType BaseType;
+  public:
+    typedef typename BaseType::DomainType        DomainType;
+    typedef typename BaseType::RangeType         RangeType;
+    typedef typename BaseType::JacobianRangeType JacobianRangeType;
+
+    Localfunction(const EntityType& ent, const RangeType& value)
+      : BaseType(ent)
+      , value_(value)
+    {}
+
+    virtual size_t order() const override final
+    {
+      return 0;
+    }
+
+    virtual void evaluate(const DomainType& /*xx*/, RangeType& ret) const override final
+    {
+      ret = value_;
+    }
+
+    virtual void jacobian(const DomainType& /*xx*/, JacobianRangeType& ret) const override final
+    {
+      ret *= 0.0;
+    }
+
+    using BaseType::evaluate;
+    using BaseType::jacobian;
+
+  private:
+    const RangeType value_;
+  }; // class Localfunction
+
+public:
+  static std::string static_id()
+  {
+    return "hdd.linearelliptic.problems.boxindicator";
+  }
+
+  BoxIndicator(const ValuesType& values, const std::string nm = static_id(), const bool sum_overlapping = false)
+    : values_(values)
+    , name_(nm)
+    , sum_overlapping_(sum_overlapping)
+  {
+    build_bins();
+  }
+
+  BoxIndicator(const DomainValuesType& values, const std::string nm = static_id(), const bool sum_overlapping = false)
+    : name_(nm)
+    , sum_overlapping_(sum_overlapping)
+  {
+    for (const auto& element : values)
+      values_.emplace_back(element.first.first, element.first.second, element.second);
+    build_bins();
+  }
+
+  virtual std::string type() const override
+  {
+    return static_id();
+  }
+
+  virtual std::string name() const override
+  {
+    return name_;
+  }
+
+  virtual std::unique_ptr< LocalfunctionType > local_function(const EntityType& entity) const override
+  {
+    return std::unique_ptr< LocalfunctionType >(new Localfunction(entity, value(entity.geometry().center())));
+  }
+
+  RangeType value(const DomainType& xx) const
+  {
+    RangeType ret(0.0);
+    if (values_.empty())
+      return ret;
+    for (const size_t ii : bins_[bin(xx)]) {
+      const auto& element = values_[ii];
+      if (Stuff::Common::FloatCmp::le(std::get< 0 >(element), xx)
+          && Stuff::Common::FloatCmp::lt(xx, std::get< 1 >(element))) {
+        if (!sum_overlapping_)
+          return std::get< 2 >(element);
+        ret += std::get< 2 >(element);
+      }
+    }
+    return ret;
+  } // ... value(...)
+
+private:
+  size_t bin_index(const D& coordinate, const size_t dd) const
+  {
+    if (num_bins_[dd] == 1)
+      return 0;
+    const auto relative = (coordinate - lower_left_[dd]) / (upper_right_[dd] - lower_left_[dd]);
+    return std::min(num_bins_[dd] - 1, size_t(std::max(0.0, std::floor(relative * num_bins_[dd]))));
+  }
+
+  size_t bin(const DomainType& xx) const
+  {
+    size_t index = 0;
+    size_t stride = 1;
+    for (size_t dd = 0; dd < d; ++dd) {
+      index += bin_index(xx[dd], dd)*stride;
+      stride *= num_bins_[dd];
+    }
+    return index;
+  } // ... bin(...)
+
+  void build_bins()
+  {
+    if (values_.empty())
+      return;
+    lower_left_ = std::get< 0 >(values_[0]);
+    upper_right_ = std::get< 1 >(values_[0]);
+    for (const auto& element : values_)
+      for (size_t dd = 0; dd < d; ++dd) {
+        lower_left_[dd] = std::min(lower_left_[dd], std::get< 0 >(element)[dd]);
+        upper_right_[dd] = std::max(upper_right_[dd], std::get< 1 >(element)[dd]);
+      }
+    // about two bins per box and dimension, so that most bins overlap only few boxes
+    const size_t bins_per_dim = std::min(max_bins_per_dim,
+                                         size_t(2*std::ceil(std::pow(double(values_.size()), 1.0/d))));
+    size_t num_bins = 1;
+    for (size_t dd = 0; dd < d; ++dd) {
+      num_bins_[dd] = upper_right_[dd] > lower_left_[dd] ? bins_per_dim : 1;
+      num_bins *= num_bins_[dd];
+    }
+    bins_ = std::vector< std::vector< size_t > >(num_bins);
+    // each box is added to all bins it overlaps, in order, which retains the first-match semantics, padded by (well
+    // above) the tolerance of the comparisons in value(), so that points on or near its boundary find it as well
+    static const D padding = 1e-10;
+    std::vector< size_t > first(d);
+    std::vector< size_t > last(d);
+    for (size_t ii = 0; ii < values_.size(); ++ii) {
+      for (size_t dd = 0; dd < d; ++dd) {
+        const D lower = std::get< 0 >(values_[ii])[dd];
+        const D upper = std::get< 1 >(values_[ii])[dd];
+        const D extent = upper_right_[dd] - lower_left_[dd];
+        first[dd] = bin_index(lower - padding*(std::abs(lower) + extent + 1.), dd);
+        last[dd] = bin_index(upper + padding*(std::abs(upper) + extent + 1.), dd);
+      }
+      std::vector< size_t > current(first);
+      bool done = false;
+      while (!done) {
+        size_t index = 0;
+        size_t stride = 1;
+        for (size_t dd = 0; dd < d; ++dd) {
+          index += current[dd]*stride;
+          stride *= num_bins_[dd];
+        }
+        bins_[index].push_back(ii);
+        done = true;
+        for (size_t dd = 0; dd < d; ++dd) {
+          if (current[dd] < last[dd]) {
+            ++current[dd];
+            done = false;
+            break;
+          }
+          current[dd] = first[dd];
+        }
+      }
+    }
+  } // ... build_bins(...)
+
+  ValuesType values_;
+  const std::string name_;
+  const bool sum_overlapping_;
+  DomainType lower_left_;
+  DomainType upper_right_;
+  size_t num_bins_[d];
+  std::vector< std::vector< size_t > > bins_;
+}; // class BoxIndicator
+
+
+} // namespace Problems
+} // namespace LinearElliptic
+} // namespace HDD
+} // namespace Dune
+
+#endif // DUNE_HDD_LINEARELLIPTIC_PROBLEMS_BOX_INDICATOR_HH
@@ -0,0 +1,246 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_PROBLEMS_CACHED_HH
+#define DUNE_HDD_LINEARELLIPTIC_PROBLEMS_CACHED_HH
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <dune/stuff/common/exceptions.hh>
+
+#include <dune/pymor/parameters/functional.hh>
+#include <dune/pymor/functions/default.hh>
+
+#include "interfaces.hh"
+#include "default.hh"
+
+namespace Dune {
+namespace HDD {
+namespace LinearElliptic {
+namespace Problems {
+namespace internal {
+
+
+/**
+ * \brief Wraps a localizable function and caches its values at the points it is evaluated at, per entity.
+ *
+ *        The local operators of the assemblers (and the estimators) all use the same quadrature rules, which is why
+ *        the same function is evaluated at the same (entity local) points several times: once by the system
+ *        operator, once by each product and once more by each estimator. Since the local coordinates of the
+ *        quadrature points are identical, they are looked up exactly. This also covers evaluations on intersections,
+ *        which are mapped to the inside entity before evaluating the local function.
+ *
+ *        Entities not contained in the given index set are forwarded to the wrapped function, as are jacobians. At
+ *        most max_points values are stored per entity, further points are forwarded as well. The cache is thread
+ *        safe.
+ * \note  The index set has to outlive this function.
+ */
+template< class IndexSetImp, class FunctionImp >
+class CachedFunction
+  : public FunctionImp
+{
+  typedef FunctionImp                                BaseType;
+  typedef CachedFunction< IndexSetImp, FunctionImp > ThisType;
+public:
+  typedef IndexSetImp IndexSetType;
+  typedef FunctionImp FunctionType;
+
+  using typename BaseType::EntityType;
+  using typename BaseType::LocalfunctionType;
+
+private:
+  typedef typename LocalfunctionType::DomainType                 PointType;
+  typedef typename LocalfunctionType::RangeType                  ValueType;
+  typedef std::vector< std::pair< PointType, ValueType > >       EntryType;
+
+  static const size_t num_mutexes = 64;
+
+  class Localfunction
+    : public LocalfunctionType
+  {
+    typedef LocalfunctionType BaseType;
+  public:
+    typedef typename BaseType::DomainType        DomainType;
+    typedef typename BaseType::RangeType         RangeType;
+    typedef typename BaseType::JacobianRangeType JacobianRangeType;
+
+    Localfunction(const EntityType& ent, const ThisType& cached, const size_t index)
+      : BaseType(ent)
+      , cached_(cached)
+      , index_(index)
+      , local_function_(cached_.function_->local_function(ent))
+    {}
+
+    virtual size_t order() const override final
+    {
+      return local_function_->order();
+    }
+
+    virtual void evaluate(const DomainType& xx, RangeType& ret) const override final
+    {
+      auto& entry = cached_.entries_[index_];
+      auto& mutex = cached_.mutexes_[index_ % num_mutexes];
+      {
+        std::lock_guard< std::mutex > lock(mutex);
+        for (const auto& point_and_value : entry) {
+          if (point_and_value.first == xx) {
+            ret = point_and_value.second;
+            return;
+          }
+        }
+      }
+      local_function_->evaluate(xx, ret);
+      std::lock_guard< std::mutex > lock(mutex);
+      if (entry.size() < cached_.max_points_)
+        entry.emplace_back(xx, ret);
+    } // ... evaluate(...)
+
+    virtual void jacobian(const DomainType& xx, JacobianRangeType& ret) const override final
+    {
+      local_function_->jacobian(xx, ret);
+    }
+
+    using BaseType::evaluate;
+    using BaseType::jacobian;
+
+  private:
+    const ThisType& cached_;
+    const size_t index_;
+    const std::unique_ptr< const LocalfunctionType > local_function_;
+  }; // class Localfunction
+
+public:
+  CachedFunction(const std::shared_ptr< const FunctionType >& function,
+                 const IndexSetType& index_set,
+                 const size_t max_points = 64)
+    : function_(function)
+    , index_set_(index_set)
+    , max_points_(max_points)
+    , entries_(index_set_.size(0))
+  {
+    if (max_points_ == 0)
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given, "max_points has to be positive!");
+  }
+
+  CachedFunction(const ThisType& other) = delete;
+
+  ThisType& operator=(const ThisType& other) = delete;
+
+  virtual std::string type() const override
+  {
+    return function_->type();
+  }
+
+  virtual std::string name() const override
+  {
+    return function_->name();
+  }
+
+  virtual std::unique_ptr< LocalfunctionType > local_function(const EntityType& entity) const override
+  {
+    if (!index_set_.contains(entity))
+      return function_->local_function(entity);
+    const size_t index = index_set_.index(entity);
+    if (index >= entries_.size())
+      return function_->local_function(entity);
+    return std::unique_ptr< LocalfunctionType >(new Localfunction(entity, *this, index));
+  }
+
+  /**
+   * \brief Drops all cached values.
+   * \note  The entries are cleared in place (the local functions hold references to them), which is why this does
+   *        not account for a changed size of the index set. Create a new function after adapting the grid instead.
+   */
+  void clear() const
+  {
+    for (size_t ii = 0; ii < entries_.size(); ++ii) {
+      std::lock_guard< std::mutex > lock(mutexes_[ii % num_mutexes]);
+      entries_[ii].clear();
+    }
+  } // ... clear(...)
+
+private:
+  const std::shared_ptr< const FunctionType > function_;
+  const IndexSetType& index_set_;
+  const size_t max_points_;
+  mutable std::vector< EntryType > entries_; // <- never resized, see clear()
+  mutable std::array< std::mutex, num_mutexes > mutexes_;
+}; // class CachedFunction
+
+
+} // namespace internal
+
+
+/**
+ * \brief A problem, all functions of which cache their values at the quadrature points of each entity of a grid
+ *        view, see internal::CachedFunction.
+ *
+ *        Use this as the problem of a discretization (instead of the original problem) to share the coefficient
+ *        values between all assemblers and estimators on this grid view, which pays off for expensive (e.g.
+ *        expression or data based) functions. The affine decompositions of all functions are retained, each
+ *        component is cached separately.
+ * \note  The grid view (and its index set) has to outlive this problem.
+ */
+template< class GridViewImp, class E, class D, int d, class R, int r = 1 >
+class Cached
+  : public Default< E, D, d, R, r >
+{
+  typedef Default< E, D, d, R, r > BaseType;
+  typedef Cached< GridViewImp, E, D, d, R, r > ThisType;
+public:
+  typedef GridViewImp                           GridViewType;
+  typedef typename GridViewType::IndexSet       IndexSetType;
+  typedef ProblemInterface< E, D, d, R, r >     ProblemType;
+
+  using typename BaseType::DiffusionFactorType;
+  using typename BaseType::DiffusionTensorType;
+  using typename BaseType::FunctionType;
+
+  static std::string static_id()
+  {
+    return ProblemType::static_id() + ".cached";
+  }
+
+  Cached(const ProblemType& problem, const GridViewType& grid_view, const size_t max_points = 64)
+    : BaseType(wrap(*problem.diffusion_factor(), grid_view.indexSet(), max_points),
+               wrap(*problem.diffusion_tensor(), grid_view.indexSet(), max_points),
+               wrap(*problem.force(), grid_view.indexSet(), max_points),
+               wrap(*problem.dirichlet(), grid_view.indexSet(), max_points),
+               wrap(*problem.neumann(), grid_view.indexSet(), max_points))
+  {}
+
+  virtual std::string type() const override
+  {
+    return static_id();
+  }
+
+private:
+  template< class F >
+  static std::shared_ptr< const F > wrap(const F& function, const IndexSetType& index_set, const size_t max_points)
+  {
+    typedef internal::CachedFunction< IndexSetType, typename F::NonparametricType > CachedType;
+    auto ret = std::make_shared< Pymor::Functions::AffinelyDecomposableDefault
+        < E, D, d, R, F::dimRange, F::dimRangeCols > >(function.name());
+    if (function.has_affine_part())
+      ret->register_affine_part(std::make_shared< CachedType >(function.affine_part(), index_set, max_points));
+    for (DUNE_STUFF_SSIZE_T qq = 0; qq < function.num_components(); ++qq)
+      ret->register_component(std::make_shared< CachedType >(function.component(qq), index_set, max_points),
+                              new Pymor::ParameterFunctional(*function.coefficient(qq)));
+    return ret;
+  } // ... wrap(...)
+}; // class Cached
+
+
+} // namespace Problems
+} // namespace LinearElliptic
+} // namespace HDD
+} // namespace Dune
+
+#endif // DUNE_HDD_LINEARELLIPTIC_PROBLEMS_CACHED_HH
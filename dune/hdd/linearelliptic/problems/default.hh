@@ -161,6 +161,7 @@ public:
     , neumann_(other.neumann_)
   {
     update_parameter_dependency();
+    this->copy_diffusion_tensor_reference(other);
   }
 
   ThisType& operator=(const ThisType& other) = delete;
@@ -6,6 +6,11 @@
 #ifndef DUNE_HDD_LINEARELLIPTIC_PROBLEMS_INTERFACES_HH
 #define DUNE_HDD_LINEARELLIPTIC_PROBLEMS_INTERFACES_HH
 
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <utility>
 #include <vector>
 #include <ostream>
 
@@ -23,6 +28,7 @@
 #include <dune/stuff/functions/default.hh>
 
 #include <dune/pymor/parameters/base.hh>
+#include <dune/pymor/parameters/functional.hh>
 #include <dune/pymor/functions/interfaces.hh>
 
 namespace Dune {
@@ -36,6 +42,183 @@ template< class EntityImp, class DomainFieldImp, int domainDim, class RangeField
 class Default;
 
 
+namespace internal {
+
+
+/**
+ * \brief The affinely decomposable function F for a fixed parameter, given by its components and the evaluated
+ *        coefficients.
+ *
+ *        In contrast to F::with_mu(), no new (expression or linear combination) functions are built, the coefficients
+ *        are evaluated once upon construction and evaluations are forwarded to the components of F.
+ */
+template< class F >
+class FrozenFunction
+  : public F::NonparametricType
+{
+  typedef typename F::NonparametricType BaseType;
+public:
+  using typename BaseType::EntityType;
+  using typename BaseType::LocalfunctionType;
+
+private:
+  class Localfunction
+    : public LocalfunctionType
+  {
+    typedef LocalfunctionType BaseType;
+  public:
+    typedef typename BaseType::DomainType        DomainType;
+    typedef typename BaseType::RangeType         RangeType;
+    typedef typename BaseType::JacobianRangeType JacobianRangeType;
+
+    Localfunction(const EntityType& ent, const F& function, const std::vector< double >& coefficients)
+      : BaseType(ent)
+      , coefficients_(coefficients)
+    {
+      for (DUNE_STUFF_SSIZE_T qq = 0; qq < function.num_components(); ++qq)
+        components_.emplace_back(function.component(qq)->local_function(ent));
+      if (function.has_affine_part())
+        affine_part_ = function.affine_part()->local_function(ent);
+    }
+
+    virtual size_t order() const override final
+    {
+      size_t ret = affine_part_ ? affine_part_->order() : 0;
+      for (const auto& component : components_)
+        ret = std::max(ret, component->order());
+      return ret;
+    }
+
+    virtual void evaluate(const DomainType& xx, RangeType& ret) const override final
+    {
+      if (affine_part_)
+        affine_part_->evaluate(xx, ret);
+      else
+        ret *= 0.0;
+      for (size_t qq = 0; qq < components_.size(); ++qq) {
+        components_[qq]->evaluate(xx, tmp_value_);
+        tmp_value_ *= coefficients_[qq];
+        ret += tmp_value_;
+      }
+    } // ... evaluate(...)
+
+    virtual void jacobian(const DomainType& xx, JacobianRangeType& ret) const override final
+    {
+      if (affine_part_)
+        affine_part_->jacobian(xx, ret);
+      else
+        ret *= 0.0;
+      for (size_t qq = 0; qq < components_.size(); ++qq) {
+        components_[qq]->jacobian(xx, tmp_jacobian_);
+        tmp_jacobian_ *= coefficients_[qq];
+        ret += tmp_jacobian_;
+      }
+    } // ... jacobian(...)
+
+    using BaseType::evaluate;
+    using BaseType::jacobian;
+
+  private:
+    const std::vector< double >& coefficients_;
+    std::vector< std::unique_ptr< const LocalfunctionType > > components_;
+    std::unique_ptr< const LocalfunctionType > affine_part_;
+    mutable RangeType tmp_value_;
+    mutable JacobianRangeType tmp_jacobian_;
+  }; // class Localfunction
+
+public:
+  /**
+   * \brief Returns the affine part of function, if function is not parametric, a FrozenFunction otherwise.
+   */
+  static std::shared_ptr< const BaseType > create(const std::shared_ptr< const F >& function,
+                                                  const Pymor::Parameter& mu)
+  {
+    if (!function->parametric() && function->has_affine_part())
+      return function->affine_part();
+    return std::make_shared< FrozenFunction< F > >(function, mu);
+  }
+
+  FrozenFunction(const std::shared_ptr< const F >& function, const Pymor::Parameter& mu)
+    : function_(function)
+  {
+    for (DUNE_STUFF_SSIZE_T qq = 0; qq < function_->num_components(); ++qq)
+      coefficients_.push_back(function_->coefficient(qq)->evaluate(mu));
+  }
+
+  virtual std::string type() const override
+  {
+    return function_->type();
+  }
+
+  virtual std::string name() const override
+  {
+    return function_->name();
+  }
+
+  virtual std::unique_ptr< LocalfunctionType > local_function(const EntityType& entity) const override
+  {
+    return std::unique_ptr< LocalfunctionType >(new Localfunction(entity, *function_, coefficients_));
+  }
+
+private:
+  const std::shared_ptr< const F > function_;
+  std::vector< double > coefficients_;
+}; // class FrozenFunction
+
+
+/**
+ * \brief Remembers the last few frozen problems of ProblemInterface::with_mu(), thread safe.
+ * \note  Copies start empty (the frozen problems belong to the functions of the problem they were created for).
+ */
+template< class P >
+class FrozenProblems
+{
+public:
+  static const size_t max_size = 8;
+
+  FrozenProblems() = default;
+
+  FrozenProblems(const FrozenProblems< P >& /*other*/)
+  {}
+
+  FrozenProblems< P >& operator=(const FrozenProblems< P >& /*other*/)
+  {
+    return *this;
+  }
+
+  template< class Creator >
+  std::shared_ptr< const P > get(const Pymor::Parameter& mu, const Creator& create)
+  {
+    std::lock_guard< std::mutex > lock(mutex_);
+    for (auto it = problems_.begin(); it != problems_.end(); ++it) {
+      if (equal(it->first, mu)) {
+        problems_.splice(problems_.begin(), problems_, it);
+        return problems_.front().second;
+      }
+    }
+    problems_.emplace_front(mu, create());
+    if (problems_.size() > max_size)
+      problems_.pop_back();
+    return problems_.front().second;
+  } // ... get(...)
+
+private:
+  static bool equal(const Pymor::Parameter& first, const Pymor::Parameter& second)
+  {
+    if (first.type() != second.type())
+      return false;
+    for (const auto& key : first.type().keys())
+      if (first.get(key) != second.get(key))
+        return false;
+    return true;
+  }
+
+  std::mutex mutex_;
+  std::list< std::pair< Pymor::Parameter, std::shared_ptr< const P > > > problems_;
+}; // class FrozenProblems
+
+
+} // namespace internal
 } // namespace Problems
 
 
@@ -129,20 +312,72 @@ public:
     neumann()->report(out, prefix + "    ");
   } // ... report(...)
 
-  std::shared_ptr< NonparametricType > with_mu(const Pymor::Parameter mu = Pymor::Parameter()) const
+  /**
+   * \brief Returns the problem for the given parameter.
+   * \note  The frozen functions forward to the components of the functions of this problem (evaluating the
+   *        coefficients only once) and the last few frozen problems are remembered, so repeated calls with the same
+   *        mu are cheap (and return the same problem, which is why it is const). This is thread safe.
+   */
+  std::shared_ptr< const NonparametricType > with_mu(const Pymor::Parameter mu = Pymor::Parameter()) const
   {
     if (mu.type() != this->parameter_type())
       DUNE_THROW(Pymor::Exceptions::wrong_parameter_type,
                  "mu is " << mu.type() << ", should be " << this->parameter_type() << "!");
-    return std::make_shared< NonparametricType >(diffusion_factor()->with_mu(this->map_parameter(mu,
-                                                                                                 "diffusion_factor")),
-                                                 diffusion_tensor()->with_mu(this->map_parameter(mu,
-                                                                                                 "diffusion_tensor")),
-                                                 force()->with_mu(this->map_parameter(mu, "force")),
-                                                 dirichlet()->with_mu(this->map_parameter(mu, "dirichlet")),
-                                                 neumann()->with_mu(this->map_parameter(mu, "neumann")));
+    return frozen_problems_.get(mu, [&]() {
+      return std::make_shared< NonparametricType >(
+            Problems::internal::FrozenFunction< DiffusionFactorType >::create(
+              diffusion_factor(), this->map_parameter(mu, "diffusion_factor")),
+            Problems::internal::FrozenFunction< DiffusionTensorType >::create(
+              diffusion_tensor(), this->map_parameter(mu, "diffusion_tensor")),
+            Problems::internal::FrozenFunction< FunctionType >::create(force(), this->map_parameter(mu, "force")),
+            Problems::internal::FrozenFunction< FunctionType >::create(dirichlet(),
+                                                                       this->map_parameter(mu, "dirichlet")),
+            Problems::internal::FrozenFunction< FunctionType >::create(neumann(), this->map_parameter(mu, "neumann")));
+    });
   } // ... with_mu(...)
 
+  /**
+   * \brief Sets the parameter at which the SWIPDG weights of a parametric diffusion tensor are computed (see
+   *        Discretizations::internal::AffineDiffusion), the diffusion tensor has to be positive definite for this mu.
+   * \note  Only affects discretizations created afterwards.
+   */
+  void set_diffusion_tensor_reference(const Pymor::Parameter& mu)
+  {
+    if (!diffusion_tensor()->parametric())
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given, "The diffusion tensor is not parametric!");
+    if (mu.type() != this->parameter_type())
+      DUNE_THROW(Pymor::Exceptions::wrong_parameter_type,
+                 "mu is " << mu.type() << ", should be " << this->parameter_type() << "!");
+    diffusion_tensor_reference_ = std::make_shared< const Pymor::Parameter >(this->map_parameter(mu,
+                                                                                                  "diffusion_tensor"));
+  } // ... set_diffusion_tensor_reference(...)
+
+  bool has_diffusion_tensor_reference() const
+  {
+    return bool(diffusion_tensor_reference_);
+  }
+
+  /**
+   * \brief The parameter set by set_diffusion_tensor_reference(), already mapped to the parameter of the diffusion
+   *        tensor.
+   */
+  const Pymor::Parameter& diffusion_tensor_reference() const
+  {
+    if (!diffusion_tensor_reference_)
+      DUNE_THROW(Stuff::Exceptions::requirements_not_met,
+                 "No reference parameter for the diffusion tensor was set, call set_diffusion_tensor_reference()!");
+    return *diffusion_tensor_reference_;
+  }
+
+protected:
+  /**
+   * \brief For problems sharing the diffusion tensor of other (copies, ZeroBoundary, ...).
+   */
+  void copy_diffusion_tensor_reference(const ThisType& other)
+  {
+    diffusion_tensor_reference_ = other.diffusion_tensor_reference_;
+  }
+
 private:
   template< class GridViewType, class VTKWriterType >
   void add_visualizations_(const GridViewType& grid_view, VTKWriterType& vtk_writer) const
@@ -167,6 +402,9 @@ private:
 private:
   template< class T >
   friend std::ostream& operator<<(std::ostream& /*out*/, const ThisType& /*problem*/);
+
+  mutable Problems::internal::FrozenProblems< NonparametricType > frozen_problems_;
+  std::shared_ptr< const Pymor::Parameter > diffusion_tensor_reference_;
 }; // ProblemInterface
 
 
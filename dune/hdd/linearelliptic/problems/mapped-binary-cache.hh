@@ -0,0 +1,314 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_PROBLEMS_MAPPED_BINARY_CACHE_HH
+#define DUNE_HDD_LINEARELLIPTIC_PROBLEMS_MAPPED_BINARY_CACHE_HH
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <dune/common/exceptions.hh>
+
+#include <dune/stuff/common/string.hh>
+
+namespace Dune {
+namespace HDD {
+namespace LinearElliptic {
+namespace Problems {
+namespace internal {
+
+
+/**
+ * \brief Values read from a data file, either memory mapped from a binary cache file or held in memory.
+ */
+template< class T >
+class MappedData
+{
+public:
+  /**
+   * \brief Takes the given (read-only) mapping, which is unmapped on destruction.
+   */
+  MappedData(void* mapping, const size_t mapping_size, const T* values, const size_t size)
+    : mapping_(mapping)
+    , mapping_size_(mapping_size)
+    , values_(values)
+    , size_(size)
+  {}
+
+  explicit MappedData(std::vector< T >&& values)
+    : mapping_(nullptr)
+    , mapping_size_(0)
+    , owned_values_(std::move(values))
+    , values_(owned_values_.data())
+    , size_(owned_values_.size())
+  {}
+
+  MappedData(const MappedData& /*other*/) = delete;
+
+  MappedData& operator=(const MappedData& /*other*/) = delete;
+
+  ~MappedData()
+  {
+    if (mapping_)
+      munmap(mapping_, mapping_size_);
+  }
+
+  bool mapped() const
+  {
+    return mapping_ != nullptr;
+  }
+
+  const T* data() const
+  {
+    return values_;
+  }
+
+  size_t size() const
+  {
+    return size_;
+  }
+
+  T operator[](const size_t ii) const
+  {
+    assert(ii < size_);
+    return values_[ii];
+  }
+
+private:
+  void* mapping_;
+  const size_t mapping_size_;
+  const std::vector< T > owned_values_;
+  const T* values_;
+  const size_t size_;
+}; // class MappedData
+
+
+/**
+ * \brief Converts a data file once to a binary file (given by a read function) and memory maps the latter.
+ *
+ *        The binary file consists of a Header followed by the values. The header contains a magic string identifying
+ *        the kind of data, a checksum of the values (FNV-1a) and the size, modification time and inode of the file it
+ *        was created from (see Source); a cache file which does not match (or is truncated) is recreated. Thus a
+ *        source file which is modified in place or replaced by another one invalidates the cache, even if its size
+ *        does not change. Since the files are mapped read-only, all processes
+ *        on one node share the same pages. Within one process the mapping of each file is shared by all users which
+ *        are alive at the same time.
+ */
+template< class T >
+class MappedBinaryCache
+{
+  static_assert(std::is_pod< T >::value, "T has to be a POD type!");
+public:
+  typedef MappedData< T >                         DataType;
+  typedef std::function< std::vector< T >() >     ReadType;
+
+  /**
+   * \brief Identifies the state of a source file, all members are zero if it does not exist.
+   */
+  struct Source
+  {
+    std::uint64_t size;
+    std::uint64_t mtime_sec;
+    std::uint64_t mtime_nsec;
+    std::uint64_t inode;
+
+    bool operator==(const Source& other) const
+    {
+      return size == other.size && mtime_sec == other.mtime_sec && mtime_nsec == other.mtime_nsec
+          && inode == other.inode;
+    }
+
+    bool operator!=(const Source& other) const
+    {
+      return !(*this == other);
+    }
+  }; // struct Source
+
+  struct Header
+  {
+    char magic[8];
+    std::uint64_t version;
+    Source source;
+    std::uint64_t num_values;
+    std::uint64_t checksum;
+  }; // struct Header
+
+  static const std::uint64_t version = 2;
+
+  static Source source(const std::string& filename)
+  {
+    Source ret = {0, 0, 0, 0};
+    struct stat info;
+    if (stat(filename.c_str(), &info) != 0)
+      return ret;
+    ret.size = info.st_size;
+    ret.mtime_sec = info.st_mtim.tv_sec;
+    ret.mtime_nsec = info.st_mtim.tv_nsec;
+    ret.inode = info.st_ino;
+    return ret;
+  } // ... source(...)
+
+  static std::uint64_t checksum(const T* values, const size_t size)
+  {
+    std::uint64_t hash = 14695981039346656037ull;
+    const unsigned char* bytes = reinterpret_cast< const unsigned char* >(values);
+    for (size_t ii = 0; ii < size*sizeof(T); ++ii) {
+      hash ^= bytes[ii];
+      hash *= 1099511628211ull;
+    }
+    return hash;
+  } // ... checksum(...)
+
+  /**
+   * \brief Writes the binary cache file (to a temporary file which is then moved, so concurrent readers never see a
+   *        partially written file).
+   */
+  static void write(const std::vector< T >& values,
+                    const std::string& magic,
+                    const Source& source,
+                    const std::string& cache_filename)
+  {
+    Header header;
+    fill_magic(header, magic);
+    header.version = version;
+    header.source = source;
+    header.num_values = values.size();
+    header.checksum = checksum(values.data(), values.size());
+    const std::string tmp_filename = cache_filename + ".tmp." + Stuff::Common::toString(getpid());
+    {
+      std::ofstream file(tmp_filename, std::ofstream::binary);
+      if (!file)
+        DUNE_THROW(IOError, "Could not open '" << tmp_filename << "' for writing!");
+      file.write(reinterpret_cast< const char* >(&header), sizeof(header));
+      file.write(reinterpret_cast< const char* >(values.data()), values.size()*sizeof(T));
+      if (!file)
+        DUNE_THROW(IOError, "Failed to write to '" << tmp_filename << "'!");
+    }
+    if (std::rename(tmp_filename.c_str(), cache_filename.c_str()) != 0) {
+      std::remove(tmp_filename.c_str());
+      DUNE_THROW(IOError, "Could not move '" << tmp_filename << "' to '" << cache_filename << "'!");
+    }
+  } // ... write(...)
+
+  /**
+   * \brief Maps the given cache file, returns nullptr if it does not exist, is corrupt or does not match (the
+   *        source is only checked if given and num_values only if nonzero).
+   */
+  static std::shared_ptr< const DataType > map(const std::string& cache_filename,
+                                               const std::string& magic,
+                                               const Source* source = nullptr,
+                                               const size_t num_values = 0)
+  {
+    const int fd = open(cache_filename.c_str(), O_RDONLY);
+    if (fd < 0)
+      return nullptr;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(Header)) {
+      close(fd);
+      return nullptr;
+    }
+    const size_t mapping_size = info.st_size;
+    void* mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // <- the mapping stays valid
+    if (mapping == MAP_FAILED)
+      return nullptr;
+    const Header* header = static_cast< const Header* >(mapping);
+    const T* values = reinterpret_cast< const T* >(static_cast< const char* >(mapping) + sizeof(Header));
+    Header expected;
+    fill_magic(expected, magic);
+    if (std::memcmp(header->magic, expected.magic, sizeof(header->magic)) != 0
+        || header->version != version
+        || (source && header->source != *source)
+        || (num_values > 0 && header->num_values != num_values)
+        || mapping_size != sizeof(Header) + header->num_values*sizeof(T)
+        || header->checksum != checksum(values, header->num_values)) {
+      munmap(mapping, mapping_size);
+      return nullptr;
+    }
+    return std::make_shared< const DataType >(mapping, mapping_size, values, header->num_values);
+  } // ... map(...)
+
+  /**
+   * \brief Returns the values of the given file, using (and creating from read(), if required) the given cache file.
+   * \note  If the cache file cannot be written (e.g. in a read-only data directory), the result of read() is held in
+   *        memory.
+   */
+  static std::shared_ptr< const DataType > get(const std::string& filename,
+                                               const std::string& cache_filename,
+                                               const std::string& magic,
+                                               const ReadType& read,
+                                               const size_t num_values = 0)
+  {
+    static std::mutex mutex;
+    static std::list< Mapping > mappings;
+    std::lock_guard< std::mutex > lock(mutex);
+    mappings.remove_if([](const Mapping& entry) {
+      return entry.data.expired();
+    });
+    const Source current_source = source(filename);
+    for (const auto& entry : mappings)
+      if (entry.cache_filename == cache_filename && entry.source == current_source)
+        if (auto data = entry.data.lock())
+          if (num_values == 0 || data->size() == num_values)
+            return data;
+    auto data = map(cache_filename, magic, &current_source, num_values);
+    if (!data) {
+      auto values = read();
+      try {
+        write(values, magic, current_source, cache_filename);
+        data = map(cache_filename, magic, &current_source, num_values);
+      } catch (IOError&) {}
+      if (!data)
+        return std::make_shared< const DataType >(std::move(values));
+    }
+    mappings.push_back({cache_filename, current_source, data});
+    return data;
+  } // ... get(...)
+
+  static std::uint64_t file_size(const std::string& filename)
+  {
+    return source(filename).size;
+  }
+
+private:
+  struct Mapping
+  {
+    std::string cache_filename;
+    Source source;
+    std::weak_ptr< const DataType > data;
+  }; // struct Mapping
+
+  static void fill_magic(Header& header, const std::string& magic)
+  {
+    std::memset(header.magic, 0, sizeof(header.magic));
+    std::memcpy(header.magic, magic.data(), std::min(magic.size(), sizeof(header.magic)));
+  }
+}; // class MappedBinaryCache
+
+
+} // namespace internal
+} // namespace Problems
+} // namespace LinearElliptic
+} // namespace HDD
+} // namespace Dune
+
+#endif // DUNE_HDD_LINEARELLIPTIC_PROBLEMS_MAPPED_BINARY_CACHE_HH
@@ -0,0 +1,347 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_PROBLEMS_SPE10_CACHE_HH
+#define DUNE_HDD_LINEARELLIPTIC_PROBLEMS_SPE10_CACHE_HH
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fmatrix.hh>
+
+#include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/common/fvector.hh>
+#include <dune/stuff/functions/interfaces.hh>
+#include <dune/stuff/functions/spe10.hh>
+
+#include "mapped-binary-cache.hh"
+
+namespace Dune {
+namespace HDD {
+namespace LinearElliptic {
+namespace Problems {
+namespace Spe10 {
+
+
+/**
+ * \brief The values of an SPE10 data file, either memory mapped from a binary cache file or held in memory.
+ */
+typedef Problems::internal::MappedData< double > Data;
+
+
+/**
+ * \brief Converts the ASCII SPE10 data files to a binary layout once and memory maps the latter, see
+ *        Problems::internal::MappedBinaryCache.
+ */
+class BinaryCache
+{
+  typedef Problems::internal::MappedBinaryCache< double > CacheType;
+public:
+  static std::string default_cache_filename(const std::string& filename)
+  {
+    return filename + ".bin";
+  }
+
+  static std::vector< double > read_ascii(const std::string& filename)
+  {
+    std::ifstream file(filename);
+    if (!file)
+      DUNE_THROW(IOError, "Could not open '" << filename << "'!");
+    std::vector< double > values;
+    double value = 0;
+    while (file >> value)
+      values.push_back(value);
+    if (!file.eof())
+      DUNE_THROW(IOError, "Failed to read from file '" << filename << "' (after " << values.size() << " values)!");
+    return values;
+  } // ... read_ascii(...)
+
+  /**
+   * \brief Returns the values of the given ASCII file, using (and creating, if required) the given cache file.
+   * \note  If the cache file cannot be written (e.g. in a read-only data directory), the ASCII file is parsed into
+   *        memory.
+   */
+  static std::shared_ptr< const Data > get(const std::string& filename, const std::string& cache_filename)
+  {
+    return CacheType::get(filename, cache_filename, "HDDSPE10", [&]() { return read_ascii(filename); });
+  }
+}; // class BinaryCache
+
+
+namespace internal {
+
+
+/**
+ * \brief A function which is constant on each cell of a regular grid, the values of which are given by Data.
+ *
+ *        If at_center is true, each entity gets the value of the cell containing its center (as
+ *        Stuff::Functions::Checkerboard does), otherwise the function is evaluated pointwise (as
+ *        Stuff::Functions::Spe10::Model2 does), which makes a difference for entities which are not aligned with the
+ *        cells of the data.
+ */
+template< class E, class D, int d, class R, class ValueProvider >
+class MappedPiecewiseConstant
+  : public Stuff::LocalizableFunctionInterface< E, D, d, R, d, d >
+{
+  typedef Stuff::LocalizableFunctionInterface< E, D, d, R, d, d > BaseType;
+  typedef MappedPiecewiseConstant< E, D, d, R, ValueProvider >    ThisType;
+
+  class Localfunction
+    : public BaseType::LocalfunctionType
+  {
+    typedef typename BaseType::LocalfunctionType LocalfunctionBaseType;
+  public:
+    typedef typename LocalfunctionBaseType::EntityType        EntityType;
+    typedef typename LocalfunctionBaseType::DomainType        DomainType;
+    typedef typename LocalfunctionBaseType::RangeType         RangeType;
+    typedef typename LocalfunctionBaseType::JacobianRangeType JacobianRangeType;
+
+    Localfunction(const EntityType& ent, const ThisType& function)
+      : LocalfunctionBaseType(ent)
+      , function_(function)
+      , value_(function_.at_center_ ? function_.value(ent.geometry().center()) : RangeType(0.0))
+    {}
+
+    virtual size_t order() const override final
+    {
+      return 0;
+    }
+
+    virtual void evaluate(const DomainType& xx, RangeType& ret) const override final
+    {
+      if (function_.at_center_)
+        ret = value_;
+      else
+        ret = function_.value(this->entity().geometry().global(xx));
+    }
+
+    virtual void jacobian(const DomainType& /*xx*/, JacobianRangeType& ret) const override final
+    {
+      ret *= 0.0;
+    }
+
+    using LocalfunctionBaseType::evaluate;
+    using LocalfunctionBaseType::jacobian;
+
+  private:
+    const ThisType& function_;
+    const RangeType value_;
+  }; // class Localfunction
+
+public:
+  typedef typename BaseType::EntityType        EntityType;
+  typedef typename BaseType::DomainType        DomainType;
+  typedef typename BaseType::RangeType         RangeType;
+  typedef typename BaseType::LocalfunctionType LocalfunctionType;
+
+  MappedPiecewiseConstant(std::shared_ptr< const Data > data,
+                          const DomainType& lower_left,
+                          const DomainType& upper_right,
+                          const Stuff::Common::FieldVector< size_t, d >& num_elements,
+                          const ValueProvider& value_provider,
+                          const bool at_center,
+                          const std::string nm)
+    : data_(data)
+    , lower_left_(lower_left)
+    , upper_right_(upper_right)
+    , num_elements_(num_elements)
+    , num_cells_(1)
+    , value_provider_(value_provider)
+    , at_center_(at_center)
+    , name_(nm)
+  {
+    for (size_t dd = 0; dd < d; ++dd) {
+      if (!(upper_right_[dd] > lower_left_[dd]))
+        DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                   "upper_right has to be greater than lower_left (in all dimensions)!");
+      num_cells_ *= num_elements_[dd];
+    }
+    if (data_->size() < value_provider_.required_size(num_cells_))
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                 "The given data contains only " << data_->size() << " values, but "
+                 << value_provider_.required_size(num_cells_) << " are required!");
+  } // MappedPiecewiseConstant(...)
+
+  virtual std::string type() const override
+  {
+    return "hdd.linearelliptic.problems.spe10.mapped";
+  }
+
+  virtual std::string name() const override
+  {
+    return name_;
+  }
+
+  virtual std::unique_ptr< LocalfunctionType > local_function(const EntityType& entity) const override
+  {
+    return std::unique_ptr< LocalfunctionType >(new Localfunction(entity, *this));
+  }
+
+private:
+  RangeType value(const DomainType& xx) const
+  {
+    size_t index = 0;
+    size_t stride = 1;
+    for (size_t dd = 0; dd < d; ++dd) {
+      const auto relative = (xx[dd] - lower_left_[dd]) / (upper_right_[dd] - lower_left_[dd]);
+      const auto ii = std::min(num_elements_[dd] - 1,
+                               size_t(std::max(0.0, std::floor(relative * num_elements_[dd]))));
+      index += ii*stride;
+      stride *= num_elements_[dd];
+    }
+    return value_provider_.value(*data_, index, num_cells_);
+  } // ... value(...)
+
+  const std::shared_ptr< const Data > data_;
+  const DomainType lower_left_;
+  const DomainType upper_right_;
+  const Stuff::Common::FieldVector< size_t, d > num_elements_;
+  size_t num_cells_;
+  const ValueProvider value_provider_;
+  const bool at_center_;
+  const std::string name_;
+}; // class MappedPiecewiseConstant
+
+
+/**
+ * \brief Isotropic values (the first block of the data), linearly scaled as in Stuff::Functions::Spe10::Model1.
+ */
+template< class R, int d >
+class ScaledIsotropicValues
+{
+public:
+  ScaledIsotropicValues(const R& min, const R& max)
+    : min_(min)
+    , scale_((max - min) / (Stuff::Functions::Spe10::internal::model1_max_value
+                            - Stuff::Functions::Spe10::internal::model1_min_value))
+  {
+    if (!(max > min))
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given, "max (" << max << ") has to be larger than min (" << min << ")!");
+  }
+
+  size_t required_size(const size_t num_cells) const
+  {
+    return num_cells;
+  }
+
+  FieldMatrix< R, d, d > value(const Data& data, const size_t index, const size_t /*num_cells*/) const
+  {
+    FieldMatrix< R, d, d > ret(0.0);
+    for (size_t dd = 0; dd < d; ++dd)
+      ret[dd][dd] = data[index]*scale_ + min_;
+    return ret;
+  }
+
+private:
+  const R min_;
+  const R scale_;
+}; // class ScaledIsotropicValues
+
+
+/**
+ * \brief Diagonal values, one block of the data per dimension.
+ */
+template< class R, int d >
+class DiagonalValues
+{
+public:
+  size_t required_size(const size_t num_cells) const
+  {
+    return d*num_cells;
+  }
+
+  FieldMatrix< R, d, d > value(const Data& data, const size_t index, const size_t num_cells) const
+  {
+    FieldMatrix< R, d, d > ret(0.0);
+    for (size_t dd = 0; dd < d; ++dd)
+      ret[dd][dd] = data[dd*num_cells + index];
+    return ret;
+  }
+}; // class DiagonalValues
+
+
+} // namespace internal
+
+
+/**
+ * \brief Drop-in for Stuff::Functions::Spe10::Model1 (in 2d, matrix valued), based on the binary cache.
+ * \note  The cache file defaults to <filename>.bin, next to the data file.
+ */
+template< class E, class D, class R >
+class MappedModel1
+  : public internal::MappedPiecewiseConstant< E, D, 2, R, internal::ScaledIsotropicValues< R, 2 > >
+{
+  typedef internal::MappedPiecewiseConstant< E, D, 2, R, internal::ScaledIsotropicValues< R, 2 > > BaseType;
+public:
+  using typename BaseType::DomainType;
+
+  MappedModel1(const std::string& filename,
+               const DomainType& lower_left,
+               const DomainType& upper_right,
+               const R min,
+               const R max,
+               const std::string nm,
+               const std::string cache_filename = "")
+    : BaseType(BinaryCache::get(filename,
+                                cache_filename.empty() ? BinaryCache::default_cache_filename(filename)
+                                                       : cache_filename),
+               lower_left,
+               upper_right,
+               {Stuff::Functions::Spe10::internal::model1_x_elements,
+                Stuff::Functions::Spe10::internal::model1_z_elements},
+               internal::ScaledIsotropicValues< R, 2 >(min, max),
+               /*at_center=*/true,
+               nm)
+  {}
+}; // class MappedModel1
+
+
+/**
+ * \brief Drop-in for Stuff::Functions::Spe10::Model2, based on the binary cache.
+ * \note  The cache file defaults to <filename>.bin, next to the data file.
+ */
+template< class E, class D, class R >
+class MappedModel2
+  : public internal::MappedPiecewiseConstant< E, D, 3, R, internal::DiagonalValues< R, 3 > >
+{
+  typedef internal::MappedPiecewiseConstant< E, D, 3, R, internal::DiagonalValues< R, 3 > > BaseType;
+public:
+  using typename BaseType::DomainType;
+
+  static Stuff::Common::FieldVector< size_t, 3 > num_elements()
+  {
+    return {60, 220, 85};
+  }
+
+  MappedModel2(const std::string& filename,
+               const std::string nm,
+               const DomainType& lower_left,
+               const DomainType& upper_right,
+               const std::string cache_filename = "")
+    : BaseType(BinaryCache::get(filename,
+                                cache_filename.empty() ? BinaryCache::default_cache_filename(filename)
+                                                       : cache_filename),
+               lower_left,
+               upper_right,
+               num_elements(),
+               internal::DiagonalValues< R, 3 >(),
+               /*at_center=*/false,
+               nm)
+  {}
+}; // class MappedModel2
+
+
+} // namespace Spe10
+} // namespace Problems
+} // namespace LinearElliptic
+} // namespace HDD
+} // namespace Dune
+
+#endif // DUNE_HDD_LINEARELLIPTIC_PROBLEMS_SPE10_CACHE_HH
@@ -13,12 +13,13 @@
 
 #include <dune/stuff/functions/constant.hh>
 #include <dune/stuff/functions/combined.hh>
-#include <dune/stuff/playground/functions/indicator.hh>
 #include <dune/stuff/functions/spe10model2.hh>
 
 #include <dune/pymor/functions/default.hh>
 
 #include "default.hh"
+#include "box-indicator.hh"
+#include "spe10-cache.hh"
 
 namespace Dune {
 namespace HDD {
@@ -42,9 +43,11 @@ class Model2< EntityImp, DomainFieldImp, 3, RangeFieldImp, 1 >
   typedef Default< EntityImp, DomainFieldImp, 3, RangeFieldImp, 1 > BaseType;
   typedef Model2< EntityImp, DomainFieldImp, 3, RangeFieldImp, 1 > ThisType;
   typedef Stuff::Functions::Constant< EntityImp, DomainFieldImp, 3, RangeFieldImp, 1 >  ScalarConstantFunctionType;
-  typedef Stuff::Functions::DomainIndicator< EntityImp, DomainFieldImp, 3, RangeFieldImp, 1 > ScalarIndicatorFunctionType;
+  typedef BoxIndicator< EntityImp, DomainFieldImp, 3, RangeFieldImp, 1 > ScalarIndicatorFunctionType;
   typedef typename ScalarConstantFunctionType::DomainType DomainType;
   typedef Stuff::Functions::Spe10::Model2< EntityImp, DomainFieldImp, 3, RangeFieldImp, 3, 3 > Spe10FunctionType;
+  typedef MappedModel2< EntityImp, DomainFieldImp, RangeFieldImp >                            MappedSpe10FunctionType;
+  typedef Stuff::LocalizableFunctionInterface< EntityImp, DomainFieldImp, 3, RangeFieldImp, 3, 3 > TensorFunctionType;
   using typename BaseType::DiffusionFactorWrapperType;
   using typename BaseType::DiffusionTensorWrapperType;
   using typename BaseType::FunctionWrapperType;
@@ -65,6 +68,8 @@ public:
     config["filename"] = Spe10FunctionType::default_config().template get< std::string >("filename");
     config["upper_right"] = Spe10FunctionType::default_config().template get< std::string >("upper_right");
     config["channel_width"] = "0";
+    config["binary_cache"] = "false";
+    config["binary_cache_filename"] = "";
     if (sub_name.empty())
       return config;
     else {
@@ -81,16 +86,26 @@ public:
     return Stuff::Common::make_unique< ThisType >(
           cfg.get("filename", default_config().template get< std::string >("filename")),
           cfg.get("upper_right", default_config().template get< DomainType >("upper_right")),
-          cfg.get("channel_width", default_config().template get< DomainFieldType >("channel_width")));
+          cfg.get("channel_width", default_config().template get< DomainFieldType >("channel_width")),
+          cfg.get("binary_cache", default_config().template get< bool >("binary_cache")),
+          cfg.get("binary_cache_filename", default_config().template get< std::string >("binary_cache_filename")));
   } // ... create(...)
 
-  Model2(const std::string& filename, const DomainType& upper_right, const DomainFieldType& channel_width)
+  Model2(const std::string& filename,
+         const DomainType& upper_right,
+         const DomainFieldType& channel_width,
+         const bool binary_cache = default_config().template get< bool >("binary_cache"),
+         const std::string binary_cache_filename = default_config().template get< std::string >("binary_cache_filename"))
     : BaseType(std::make_shared<DiffusionFactorWrapperType>(std::make_shared< ScalarConstantFunctionType >(1, "diffusion_factor")),
-               make_diffusion_tensor(filename, upper_right, channel_width),
+               make_diffusion_tensor(filename, upper_right, channel_width, binary_cache, binary_cache_filename),
                std::make_shared<FunctionWrapperType>(std::make_shared< ScalarConstantFunctionType >(0, "force")),
                std::make_shared<FunctionWrapperType>(std::make_shared< ScalarConstantFunctionType >(0, "dirichlet")),
                std::make_shared<FunctionWrapperType>(make_neumann(upper_right)))
-  {}
+  {
+    // the SWIPDG weights of the parametric discretization are those of the permeability without channels
+    if (channel_width > 0)
+      this->set_diffusion_tensor_reference(Pymor::Parameter("channel", {0., 0.}));
+  }
 
   virtual std::string type() const override
   {
@@ -100,16 +115,28 @@ public:
 private:
   static std::shared_ptr< DiffusionTensorType > make_diffusion_tensor(const std::string& filename,
                                                                       const DomainType& upper_right,
-                                                                      const DomainFieldType& channel_width)
+                                                                      const DomainFieldType& channel_width,
+                                                                      const bool binary_cache,
+                                                                      const std::string& binary_cache_filename)
   {
     typedef Pymor::Functions::AffinelyDecomposableDefault< EntityImp, DomainFieldType, 3, RangeFieldImp, 3, 3 >
         ParametricTensorType;
     auto diffusion_tensor = std::make_shared<ParametricTensorType>("diffusion_tensor");
-    auto spe10 = std::shared_ptr<Spe10FunctionType>(new Spe10FunctionType(
-                                                      filename, "spe10", {0., 0., 0.}, upper_right));
+    // the binary cache avoids parsing the data file each time (see BinaryCache), it is written next to the data file
+    // unless binary_cache_filename is given
+    std::shared_ptr< TensorFunctionType > spe10(nullptr);
+    if (binary_cache)
+      spe10 = std::make_shared< MappedSpe10FunctionType >(filename,
+                                                          "spe10",
+                                                          DomainType(0.),
+                                                          upper_right,
+                                                          binary_cache_filename);
+    else
+      spe10 = std::shared_ptr<Spe10FunctionType>(new Spe10FunctionType(
+                                                   filename, "spe10", {0., 0., 0.}, upper_right));
     diffusion_tensor->register_affine_part(spe10);
     if (channel_width > 0) {
-      typedef Stuff::Functions::DomainIndicator< EntityImp, DomainFieldImp, 3, RangeFieldImp, 3, 3 > TensorIndicatorFunctionType;
+      typedef BoxIndicator< EntityImp, DomainFieldImp, 3, RangeFieldImp, 3, 3 > TensorIndicatorFunctionType;
       auto one = std::make_shared<ScalarConstantFunctionType>(1, "one");
 
       auto channel_x = std::shared_ptr<ScalarIndicatorFunctionType>(new ScalarIndicatorFunctionType(
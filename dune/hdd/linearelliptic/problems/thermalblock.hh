@@ -22,7 +22,6 @@
 #include <dune/stuff/common/string.hh>
 #include <dune/stuff/functions/constant.hh>
 #include <dune/stuff/functions/expression.hh>
-#include <dune/stuff/playground/functions/indicator.hh>
 #include <dune/stuff/grid/provider/cube.hh>
 #include <dune/stuff/grid/boundaryinfo.hh>
 
@@ -30,6 +29,7 @@
 #include <dune/pymor/functions/checkerboard.hh>
 
 #include "default.hh"
+#include "box-indicator.hh"
 
 namespace Dune {
 namespace HDD {
@@ -207,7 +207,7 @@ public:
 private:
   static std::shared_ptr< AffinelyDecomposableDefaultFunctionType > create_diffusion_factor()
   {
-    typedef Stuff::Functions::DomainIndicator< EntityImp, DomainFieldImp, domainDim, RangeFieldImp, 1 > IndicatorFunctionType;
+    typedef BoxIndicator< EntityImp, DomainFieldImp, domainDim, RangeFieldImp, 1 > IndicatorFunctionType;
     const Pymor::ParameterType mu("diffusion", 3);
 
     auto ret = std::make_shared< AffinelyDecomposableDefaultFunctionType >("diffusion_factor");
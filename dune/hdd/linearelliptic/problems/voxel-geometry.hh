@@ -0,0 +1,334 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_PROBLEMS_VOXEL_GEOMETRY_HH
+#define DUNE_HDD_LINEARELLIPTIC_PROBLEMS_VOXEL_GEOMETRY_HH
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+
+#include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/common/float_cmp.hh>
+#include <dune/stuff/common/fvector.hh>
+#include <dune/stuff/functions/interfaces.hh>
+
+#include "mapped-binary-cache.hh"
+
+namespace Dune {
+namespace HDD {
+namespace LinearElliptic {
+namespace Problems {
+namespace internal {
+
+
+/**
+ * \brief A voxel grid of material classes (one byte per voxel), either memory mapped or held in memory.
+ */
+typedef MappedData< std::uint8_t > VoxelData;
+
+
+/**
+ * \brief Converts raw voxel files (one int per voxel) once to a compact binary file (one byte per voxel) and memory
+ *        maps the latter, see MappedBinaryCache.
+ */
+class VoxelCache
+{
+  typedef MappedBinaryCache< std::uint8_t > CacheType;
+public:
+  static std::string default_cache_filename(const std::string& filename)
+  {
+    return filename + ".u8";
+  }
+
+  static std::vector< std::uint8_t > read_raw(const std::string& filename, const size_t num_voxels)
+  {
+    static_assert(sizeof(int) == 4, "This is not the correct architecture, sizeof(int) should be 4!");
+    std::ifstream file(filename, std::ifstream::binary);
+    if (!file)
+      DUNE_THROW(IOError, "Could not open '" << filename << "'!");
+    if (CacheType::file_size(filename) != num_voxels*sizeof(int))
+      DUNE_THROW(IOError,
+                 "Given file '" << filename << "' has wrong size (should be " << num_voxels*sizeof(int) << ", is "
+                 << CacheType::file_size(filename) << ")!");
+    // convert in chunks, to never hold the int data as a whole
+    std::vector< std::uint8_t > voxels(num_voxels);
+    std::vector< int > chunk(1 << 16);
+    for (size_t offset = 0; offset < num_voxels; offset += chunk.size()) {
+      const size_t count = std::min(chunk.size(), num_voxels - offset);
+      file.read(reinterpret_cast< char* >(chunk.data()), count*sizeof(int));
+      if (!file)
+        DUNE_THROW(IOError, "Failed to read from file '" << filename << "'!");
+      for (size_t ii = 0; ii < count; ++ii) {
+        if (chunk[ii] < 0 || chunk[ii] > 255)
+          DUNE_THROW(IOError,
+                     "Given file '" << filename << "' contains the material class " << chunk[ii] << " (at voxel "
+                     << offset + ii << "), only 0 to 255 are supported!");
+        voxels[offset + ii] = std::uint8_t(chunk[ii]);
+      }
+    }
+    return voxels;
+  } // ... read_raw(...)
+
+  /**
+   * \brief Returns the voxels of the given raw file, using (and creating, if required) the given cache file.
+   * \note  If the cache file cannot be written, the raw file is converted in memory.
+   */
+  static std::shared_ptr< const VoxelData > get(const std::string& filename,
+                                                const size_t num_voxels,
+                                                const std::string& cache_filename)
+  {
+    return CacheType::get(filename,
+                          cache_filename,
+                          "HDDVOXU8",
+                          [&]() { return read_raw(filename, num_voxels); },
+                          num_voxels);
+  }
+}; // class VoxelCache
+
+
+/**
+ * \brief Coefficient functions which are constant on each voxel, given by lookup tables for the material of the
+ *        voxel.
+ *
+ *        The material of an entity is the material class of the voxel containing its center, shifted by
+ *        num_classes*(rr + 1) if the center lies within the (first matching) region rr, where regions are half-open
+ *        boxes [lower_left, upper_right) (such as the separator of a battery) which alter the material independently
+ *        of the voxels. Each registered component is a table mapping materials to values, so that each component
+ *        (e.g. of the affine decomposition of a diffusion factor) is given by a lookup of the material and of its
+ *        table, instead of chained indicator, sum and product functions. Use component() for a
+ *        LocalizableFunctionInterface of a single one, combination() for one of a linear combination of several and
+ *        values() to obtain all of them at once; the latter two only look up the material once per entity.
+ */
+template< class E, class D, int d, class R >
+class MaterialFunction
+  : public std::enable_shared_from_this< MaterialFunction< E, D, d, R > >
+{
+  typedef MaterialFunction< E, D, d, R > ThisType;
+public:
+  typedef Stuff::LocalizableFunctionInterface< E, D, d, R, 1 > ComponentType;
+  typedef typename ComponentType::EntityType                   EntityType;
+  typedef typename ComponentType::DomainType                   DomainType;
+  typedef std::pair< DomainType, DomainType >                  RegionType;
+
+  static const size_t num_classes = 256;
+
+private:
+  class Component
+    : public ComponentType
+  {
+    class Localfunction
+      : public ComponentType::LocalfunctionType
+    {
+      typedef typename ComponentType::LocalfunctionType BaseType;
+    public:
+      typedef typename BaseType::DomainType        DomainType;
+      typedef typename BaseType::RangeType         RangeType;
+      typedef typename BaseType::JacobianRangeType JacobianRangeType;
+
+      Localfunction(const EntityType& ent, const R& value)
+        : BaseType(ent)
+        , value_(value)
+      {}
+
+      virtual size_t order() const override final
+      {
+        return 0;
+      }
+
+      virtual void evaluate(const DomainType& /*xx*/, RangeType& ret) const override final
+      {
+        ret[0] = value_;
+      }
+
+      virtual void jacobian(const DomainType& /*xx*/, JacobianRangeType& ret) const override final
+      {
+        ret *= 0.0;
+      }
+
+      using BaseType::evaluate;
+      using BaseType::jacobian;
+
+    private:
+      const R value_;
+    }; // class Localfunction
+
+  public:
+    Component(std::shared_ptr< const ThisType > materials, const size_t index)
+      : materials_(materials)
+      , index_(index)
+      , name_(materials_->names_[index_])
+    {}
+
+    Component(std::shared_ptr< const ThisType > materials, const std::vector< R >& coefficients, const std::string nm)
+      : materials_(materials)
+      , index_(0)
+      , coefficients_(coefficients)
+      , name_(nm)
+    {}
+
+    virtual std::string type() const override
+    {
+      return "hdd.linearelliptic.problems.material";
+    }
+
+    virtual std::string name() const override
+    {
+      return name_;
+    }
+
+    virtual std::unique_ptr< typename ComponentType::LocalfunctionType >
+    local_function(const EntityType& entity) const override
+    {
+      const size_t mm = materials_->material(entity);
+      R value(0);
+      if (coefficients_.empty())
+        value = materials_->tables_[index_][mm];
+      else
+        for (size_t ii = 0; ii < coefficients_.size(); ++ii)
+          value += coefficients_[ii]*materials_->tables_[ii][mm];
+      return std::unique_ptr< typename ComponentType::LocalfunctionType >(new Localfunction(entity, value));
+    } // ... local_function(...)
+
+  private:
+    const std::shared_ptr< const ThisType > materials_;
+    const size_t index_;
+    const std::vector< R > coefficients_;
+    const std::string name_;
+  }; // class Component
+
+public:
+  MaterialFunction(std::shared_ptr< const VoxelData > voxels,
+                   const DomainType& lower_left,
+                   const DomainType& upper_right,
+                   const Stuff::Common::FieldVector< size_t, d >& num_elements,
+                   const std::vector< RegionType >& regions = std::vector< RegionType >())
+    : voxels_(voxels)
+    , lower_left_(lower_left)
+    , upper_right_(upper_right)
+    , num_elements_(num_elements)
+    , regions_(regions)
+  {
+    size_t num_voxels = 1;
+    for (size_t dd = 0; dd < d; ++dd) {
+      if (!(upper_right_[dd] > lower_left_[dd]))
+        DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                   "upper_right has to be greater than lower_left (in all dimensions)!");
+      num_voxels *= num_elements_[dd];
+    }
+    if (voxels_->size() != num_voxels)
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                 "The given voxels (" << voxels_->size() << ") do not match num_elements (" << num_voxels << ")!");
+  } // MaterialFunction(...)
+
+  /**
+   * \brief Registers a component, where tables[0] gives the value for each material class outside of all regions and
+   *        tables[rr + 1] the one within region rr (defaults to tables[0]). Classes beyond a table are mapped to 0.
+   * \note  Register all components before using any of them.
+   */
+  size_t register_component(const std::vector< std::vector< R > >& tables, const std::string nm)
+  {
+    if (tables.empty() || tables.size() > regions_.size() + 1)
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                 "Given tables (" << tables.size() << ") do not match the number of regions (" << regions_.size()
+                 << ")!");
+    std::vector< R > table(num_classes*(regions_.size() + 1), R(0));
+    for (size_t rr = 0; rr <= regions_.size(); ++rr) {
+      const auto& region_table = rr < tables.size() ? tables[rr] : tables[0];
+      if (region_table.size() > num_classes)
+        DUNE_THROW(Stuff::Exceptions::wrong_input_given, "There are at most " << num_classes << " material classes!");
+      std::copy(region_table.begin(), region_table.end(), table.begin() + rr*num_classes);
+    }
+    tables_.emplace_back(std::move(table));
+    names_.push_back(nm);
+    return tables_.size() - 1;
+  } // ... register_component(...)
+
+  size_t num_components() const
+  {
+    return tables_.size();
+  }
+
+  std::shared_ptr< const ComponentType > component(const size_t ii) const
+  {
+    assert(ii < tables_.size());
+    return std::make_shared< const Component >(this->shared_from_this(), ii);
+  }
+
+  /**
+   * \brief The linear combination \sum_ii coefficients[ii] * component(ii).
+   */
+  std::shared_ptr< const ComponentType > combination(const std::vector< R >& coefficients, const std::string nm) const
+  {
+    if (coefficients.empty() || coefficients.size() > tables_.size())
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                 "Given coefficients (" << coefficients.size() << ") do not match the number of components ("
+                 << tables_.size() << ")!");
+    return std::make_shared< const Component >(this->shared_from_this(), coefficients, nm);
+  } // ... combination(...)
+
+  size_t voxel(const DomainType& xx) const
+  {
+    size_t index = 0;
+    size_t stride = 1;
+    for (size_t dd = 0; dd < d; ++dd) {
+      const auto relative = (xx[dd] - lower_left_[dd]) / (upper_right_[dd] - lower_left_[dd]);
+      const auto ii = std::min(num_elements_[dd] - 1,
+                               size_t(std::max(0.0, std::floor(relative * num_elements_[dd]))));
+      index += ii*stride;
+      stride *= num_elements_[dd];
+    }
+    return index;
+  } // ... voxel(...)
+
+  size_t material(const EntityType& entity) const
+  {
+    const DomainType center = entity.geometry().center();
+    size_t ret = (*voxels_)[voxel(center)];
+    // regions are half-open, as the boxes of BoxIndicator
+    for (size_t rr = 0; rr < regions_.size(); ++rr)
+      if (Stuff::Common::FloatCmp::le(regions_[rr].first, center)
+          && Stuff::Common::FloatCmp::lt(center, regions_[rr].second))
+        return ret + num_classes*(rr + 1);
+    return ret;
+  } // ... material(...)
+
+  /**
+   * \brief The values of all components on the given entity (with a single lookup of its material).
+   */
+  void values(const EntityType& entity, std::vector< R >& ret) const
+  {
+    const size_t mm = material(entity);
+    ret.resize(tables_.size());
+    for (size_t ii = 0; ii < tables_.size(); ++ii)
+      ret[ii] = tables_[ii][mm];
+  }
+
+private:
+  const std::shared_ptr< const VoxelData > voxels_;
+  const DomainType lower_left_;
+  const DomainType upper_right_;
+  const Stuff::Common::FieldVector< size_t, d > num_elements_;
+  const std::vector< RegionType > regions_;
+  std::vector< std::vector< R > > tables_;
+  std::vector< std::string > names_;
+}; // class MaterialFunction
+
+
+} // namespace internal
+} // namespace Problems
+} // namespace LinearElliptic
+} // namespace HDD
+} // namespace Dune
+
+#endif // DUNE_HDD_LINEARELLIPTIC_PROBLEMS_VOXEL_GEOMETRY_HH
@@ -57,7 +57,9 @@ public:
                problem.force(),
                std::make_shared< NonparametricFunctionType >(new ConstantFunctionType(0)),
                std::make_shared< NonparametricFunctionType >(new ConstantFunctionType(0)))
-  {}
+  {
+    this->copy_diffusion_tensor_reference(problem);
+  }
 }; // class ZeroBoundary
 
 
@@ -0,0 +1,801 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_SERVER_HH
+#define DUNE_HDD_LINEARELLIPTIC_SERVER_HH
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <dune/common/exceptions.hh>
+
+#include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/common/timedlogging.hh>
+
+#include <dune/pymor/common/exceptions.hh>
+#include <dune/pymor/parameters/base.hh>
+
+namespace Dune {
+namespace HDD {
+namespace LinearElliptic {
+namespace internal {
+
+
+/**
+ * \brief The binary protocol of SolveServer and SolveClient (native byte order, both ends live on the same node).
+ *
+ *        A request is a header (magic, opcode, payload size) followed by the payload, a response is a status (ok or
+ *        error) and a payload size followed by the payload (the result, or the error message). Payloads larger than
+ *        max_payload_size are rejected by both ends. The payloads are sequences of the following fields:
+ *        - uint:      uint64
+ *        - double:    float64
+ *        - string:    uint: size, chars
+ *        - vector:    uint: size, doubles
+ *        - parameter: uint: number of keys, for each key: string: key, vector: values
+ *
+ *        The requests and the fields of their payloads and results are:
+ *        - info:     ()                                     -> (uint: dofs, parameter: the parameter type, zeros)
+ *        - solve:    (parameter: mu, string: solver type)   -> (vector: solution)
+ *        - apply:    (parameter: mu, vector: source)        -> (vector: system operator applied to source)
+ *        - product:  (parameter: mu, string: id, vector: left, vector: right) -> (double: left^T product right)
+ *        - estimate: (parameter: mu, string: type, vector: solution)          -> (double: estimate)
+ *        - shutdown: ()                                     -> ()
+ */
+struct SolveProtocol
+{
+  static const std::uint32_t magic = 0x53444448; // "HDDS"
+  static const std::uint64_t max_payload_size = std::uint64_t(1) << 28; // 256 MiB, 32M doubles
+
+  enum class Request : std::uint32_t
+  {
+    info     = 0,
+    solve    = 1,
+    apply    = 2,
+    product  = 3,
+    estimate = 4,
+    shutdown = 5
+  };
+
+  enum class Status : std::uint32_t
+  {
+    ok    = 0,
+    error = 1
+  };
+
+  typedef std::map< std::string, std::vector< double > > ParameterType;
+
+  class Writer
+  {
+  public:
+    void uint(const std::uint64_t value)
+    {
+      raw(&value, sizeof(value));
+    }
+
+    void real(const double value)
+    {
+      raw(&value, sizeof(value));
+    }
+
+    void string(const std::string& value)
+    {
+      uint(value.size());
+      raw(value.data(), value.size());
+    }
+
+    void vector(const std::vector< double >& values)
+    {
+      uint(values.size());
+      raw(values.data(), values.size()*sizeof(double));
+    }
+
+    void parameter(const ParameterType& mu)
+    {
+      uint(mu.size());
+      for (const auto& element : mu) {
+        string(element.first);
+        vector(element.second);
+      }
+    }
+
+    void raw(const void* data, const size_t bytes)
+    {
+      const char* ptr = static_cast< const char* >(data);
+      buffer_.insert(buffer_.end(), ptr, ptr + bytes);
+    }
+
+    const std::vector< char >& buffer() const
+    {
+      return buffer_;
+    }
+
+  private:
+    std::vector< char > buffer_;
+  }; // class Writer
+
+  class Reader
+  {
+  public:
+    Reader(const std::vector< char >& buffer)
+      : buffer_(buffer)
+      , position_(0)
+    {}
+
+    std::uint64_t uint()
+    {
+      std::uint64_t ret;
+      raw(&ret, sizeof(ret));
+      return ret;
+    }
+
+    double real()
+    {
+      double ret;
+      raw(&ret, sizeof(ret));
+      return ret;
+    }
+
+    std::string string()
+    {
+      const size_t size = uint();
+      check(size);
+      std::string ret(buffer_.data() + position_, size);
+      position_ += size;
+      return ret;
+    }
+
+    std::vector< double > vector()
+    {
+      const size_t size = uint();
+      if (size > (buffer_.size() - position_)/sizeof(double))
+        DUNE_THROW(IOError, "Truncated message!");
+      std::vector< double > ret(size);
+      raw(ret.data(), size*sizeof(double));
+      return ret;
+    }
+
+    ParameterType parameter()
+    {
+      ParameterType ret;
+      const size_t num_keys = uint();
+      for (size_t ii = 0; ii < num_keys; ++ii) {
+        const std::string key = string();
+        ret[key] = vector();
+      }
+      return ret;
+    }
+
+  private:
+    void check(const size_t bytes) const
+    {
+      if (bytes > buffer_.size() - position_)
+        DUNE_THROW(IOError, "Truncated message!");
+    }
+
+    void raw(void* data, const size_t bytes)
+    {
+      check(bytes);
+      std::memcpy(data, buffer_.data() + position_, bytes);
+      position_ += bytes;
+    }
+
+    const std::vector< char >& buffer_;
+    size_t position_;
+  }; // class Reader
+
+  static void send_all(const int fd, const void* data, const size_t bytes)
+  {
+    const char* ptr = static_cast< const char* >(data);
+    size_t sent = 0;
+    while (sent < bytes) {
+      const ssize_t result = ::send(fd, ptr + sent, bytes - sent, MSG_NOSIGNAL);
+      if (result < 0) {
+        if (errno == EINTR)
+          continue;
+        DUNE_THROW(IOError, "Failed to send: " << std::strerror(errno));
+      }
+      sent += result;
+    }
+  } // ... send_all(...)
+
+  static void receive_all(const int fd, void* data, const size_t bytes)
+  {
+    char* ptr = static_cast< char* >(data);
+    size_t received = 0;
+    while (received < bytes) {
+      const ssize_t result = ::recv(fd, ptr + received, bytes - received, 0);
+      if (result < 0 && errno == EINTR)
+        continue;
+      if (result <= 0)
+        DUNE_THROW(IOError, "Connection lost!");
+      received += result;
+    }
+  } // ... receive_all(...)
+
+  static void write_header(std::vector< char >& out, const std::uint32_t first, const std::uint32_t second,
+                           const std::uint64_t size)
+  {
+    const char* ptr = reinterpret_cast< const char* >(&first);
+    out.insert(out.end(), ptr, ptr + sizeof(first));
+    ptr = reinterpret_cast< const char* >(&second);
+    out.insert(out.end(), ptr, ptr + sizeof(second));
+    ptr = reinterpret_cast< const char* >(&size);
+    out.insert(out.end(), ptr, ptr + sizeof(size));
+  } // ... write_header(...)
+
+  static const size_t request_header_size = 2*sizeof(std::uint32_t) + sizeof(std::uint64_t);
+  static const size_t response_header_size = sizeof(std::uint32_t) + sizeof(std::uint64_t);
+}; // struct SolveProtocol
+
+
+} // namespace internal
+
+
+/**
+ * \brief Serves one (initialized) discretization to many clients over a Unix domain socket, see
+ *        internal::SolveProtocol and SolveClient.
+ *
+ *        The server is single threaded: all requests which are complete after one round of polling the clients are
+ *        processed as a batch, identical solve requests (same parameter and solver type) within a batch are solved only
+ *        once. The solution cache of the discretization is cleared after each batch, so the memory of a long running
+ *        server does not grow with the number of parameters it was asked for. Responses are buffered per client and
+ *        sent without blocking, further requests of a client are only read once its pending responses are sent.
+ *        Estimates are only available if an estimator is given, since they depend on the type of the discretization.
+ */
+template< class DiscretizationImp >
+class SolveServer
+{
+public:
+  typedef DiscretizationImp                         DiscretizationType;
+  typedef typename DiscretizationType::VectorType   VectorType;
+  typedef internal::SolveProtocol                   ProtocolType;
+  typedef std::function< double(const VectorType& /*solution*/,
+                                const Pymor::Parameter& /*mu*/,
+                                const std::string& /*type*/) > EstimatorType;
+
+  /**
+   * \brief Listens on socket_path, a socket left behind there by a server which is gone is replaced.
+   * \note  Throws if anything else than a socket exists at socket_path, or if another server is listening on it.
+   */
+  SolveServer(const DiscretizationType& discretization,
+              const std::string socket_path,
+              const EstimatorType estimator = nullptr)
+    : discretization_(discretization)
+    , socket_path_(socket_path)
+    , estimator_(estimator)
+    , socket_(-1)
+  {
+    sockaddr_un address;
+    if (socket_path_.size() >= sizeof(address.sun_path))
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given, "The socket path '" << socket_path_ << "' is too long!");
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socket_path_.c_str(), sizeof(address.sun_path) - 1);
+    remove_stale_socket(socket_path_, address);
+    socket_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (socket_ < 0)
+      DUNE_THROW(IOError, "Could not create socket: " << std::strerror(errno));
+    struct stat status;
+    if (::bind(socket_, reinterpret_cast< sockaddr* >(&address), sizeof(address)) != 0
+        || ::listen(socket_, SOMAXCONN) != 0
+        || ::lstat(socket_path_.c_str(), &status) != 0) {
+      const std::string error = std::strerror(errno);
+      ::close(socket_);
+      DUNE_THROW(IOError, "Could not listen on '" << socket_path_ << "': " << error);
+    }
+    socket_device_ = status.st_dev;
+    socket_inode_ = status.st_ino;
+  } // SolveServer(...)
+
+  SolveServer(const SolveServer& /*other*/) = delete;
+
+  SolveServer& operator=(const SolveServer& /*other*/) = delete;
+
+  ~SolveServer()
+  {
+    for (const auto& client : clients_)
+      ::close(client.first);
+    ::close(socket_);
+    // only remove the socket if it is still ours
+    struct stat status;
+    if (::lstat(socket_path_.c_str(), &status) == 0
+        && S_ISSOCK(status.st_mode)
+        && status.st_dev == socket_device_
+        && status.st_ino == socket_inode_)
+      ::unlink(socket_path_.c_str());
+  } // ~SolveServer(...)
+
+  /**
+   * \brief Serves requests until a shutdown request is received.
+   */
+  void run()
+  {
+    auto logger = Stuff::Common::TimedLogger().get("hdd.linearelliptic.solveserver");
+    logger.info() << "serving on '" << socket_path_ << "'..." << std::endl;
+    bool shutdown = false;
+    while (!shutdown) {
+      std::vector< pollfd > fds(1, {socket_, POLLIN, 0});
+      for (const auto& client : clients_)
+        fds.push_back({client.first, short(client.second.output.empty() ? POLLIN : POLLOUT), 0});
+      if (::poll(fds.data(), fds.size(), -1) < 0) {
+        if (errno == EINTR)
+          continue;
+        DUNE_THROW(IOError, "poll() failed: " << std::strerror(errno));
+      }
+      if (fds[0].revents & POLLIN) {
+        const int client = ::accept(socket_, nullptr, nullptr);
+        if (client >= 0)
+          clients_[client];
+      }
+      // send pending responses, read all available data and collect the complete requests
+      std::vector< Request > batch;
+      for (size_t ii = 1; ii < fds.size(); ++ii) {
+        const int fd = fds[ii].fd;
+        if (fds[ii].events == POLLOUT) {
+          if (fds[ii].revents & (POLLOUT | POLLHUP | POLLERR))
+            flush(fd);
+          continue;
+        }
+        if (!(fds[ii].revents & (POLLIN | POLLHUP | POLLERR)))
+          continue;
+        char chunk[65536];
+        const ssize_t received = ::recv(fd, chunk, sizeof(chunk), MSG_DONTWAIT);
+        if (received <= 0) {
+          if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+            continue;
+          drop(fd);
+          continue;
+        }
+        auto& buffer = clients_[fd].input;
+        buffer.insert(buffer.end(), chunk, chunk + received);
+        if (!extract_requests(fd, buffer, batch)) {
+          logger.warn() << "dropping client with malformed or oversized request" << std::endl;
+          drop(fd);
+        }
+      }
+      if (!batch.empty()) {
+        shutdown = process(batch);
+        discretization_.clear_cache();
+      }
+    }
+    drain();
+    logger.info() << "shutting down" << std::endl;
+  } // ... run(...)
+
+private:
+  static const int drain_timeout = 1000; // ms
+
+  struct Request
+  {
+    int client;
+    ProtocolType::Request type;
+    std::vector< char > payload;
+  };
+
+  struct Client
+  {
+    std::vector< char > input;
+    std::vector< char > output;
+  };
+
+  /**
+   * \brief Removes a socket at path which nobody listens on any more, refuses to remove anything else.
+   */
+  static void remove_stale_socket(const std::string& path, const sockaddr_un& address)
+  {
+    struct stat status;
+    if (::lstat(path.c_str(), &status) != 0) {
+      if (errno == ENOENT)
+        return;
+      DUNE_THROW(IOError, "Could not stat '" << path << "': " << std::strerror(errno));
+    }
+    if (!S_ISSOCK(status.st_mode))
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                 "'" << path << "' exists and is not a socket, refusing to remove it!");
+    const int probe = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (probe < 0)
+      DUNE_THROW(IOError, "Could not create socket: " << std::strerror(errno));
+    const bool alive = (::connect(probe, reinterpret_cast< const sockaddr* >(&address), sizeof(address)) == 0);
+    ::close(probe);
+    if (alive)
+      DUNE_THROW(IOError, "Another server is listening on '" << path << "'!");
+    if (::unlink(path.c_str()) != 0 && errno != ENOENT)
+      DUNE_THROW(IOError, "Could not remove '" << path << "': " << std::strerror(errno));
+  } // ... remove_stale_socket(...)
+
+  /**
+   * \return false if the buffer does not start with a valid request, or if a request is larger than allowed
+   */
+  static bool extract_requests(const int fd, std::vector< char >& buffer, std::vector< Request >& batch)
+  {
+    size_t position = 0;
+    while (buffer.size() - position >= ProtocolType::request_header_size) {
+      std::uint32_t magic, type;
+      std::uint64_t size;
+      std::memcpy(&magic, buffer.data() + position, sizeof(magic));
+      std::memcpy(&type, buffer.data() + position + sizeof(magic), sizeof(type));
+      std::memcpy(&size, buffer.data() + position + 2*sizeof(magic), sizeof(size));
+      if (magic != ProtocolType::magic
+          || type > std::uint32_t(ProtocolType::Request::shutdown)
+          || size > ProtocolType::max_payload_size)
+        return false;
+      if (buffer.size() - position - ProtocolType::request_header_size < size)
+        break;
+      const auto begin = buffer.begin() + position + ProtocolType::request_header_size;
+      batch.push_back({fd, ProtocolType::Request(type), std::vector< char >(begin, begin + size)});
+      position += ProtocolType::request_header_size + size;
+    }
+    buffer.erase(buffer.begin(), buffer.begin() + position);
+    return true;
+  } // ... extract_requests(...)
+
+  /**
+   * \return true if a shutdown was requested
+   */
+  bool process(const std::vector< Request >& batch)
+  {
+    bool shutdown = false;
+    // identical solve requests are only solved once
+    std::map< std::vector< char >, std::vector< char > > solutions;
+    for (const auto& request : batch) {
+      if (clients_.find(request.client) == clients_.end())
+        continue; // the client is gone
+      ProtocolType::Writer result;
+      ProtocolType::Status status = ProtocolType::Status::ok;
+      try {
+        if (request.type == ProtocolType::Request::solve) {
+          const auto cached = solutions.find(request.payload);
+          if (cached != solutions.end())
+            result.raw(cached->second.data(), cached->second.size());
+          else {
+            handle(request, result);
+            solutions[request.payload] = result.buffer();
+          }
+        } else if (request.type == ProtocolType::Request::shutdown)
+          shutdown = true;
+        else
+          handle(request, result);
+        if (result.buffer().size() > ProtocolType::max_payload_size)
+          DUNE_THROW(IOError, "The result exceeds the maximal message size!");
+      } catch (Dune::Exception& ee) {
+        status = ProtocolType::Status::error;
+        result = ProtocolType::Writer();
+        result.raw(ee.what().c_str(), ee.what().size());
+      } catch (std::exception& ee) {
+        status = ProtocolType::Status::error;
+        result = ProtocolType::Writer();
+        result.raw(ee.what(), std::strlen(ee.what()));
+      }
+      respond(request.client, status, result.buffer());
+    }
+    return shutdown;
+  } // ... process(...)
+
+  /**
+   * \brief Queues the response and sends as much of it as possible without blocking.
+   */
+  void respond(const int client, const ProtocolType::Status status, const std::vector< char >& payload)
+  {
+    auto& output = clients_[client].output;
+    const std::uint64_t size = payload.size();
+    const std::uint32_t st = std::uint32_t(status);
+    const char* ptr = reinterpret_cast< const char* >(&st);
+    output.insert(output.end(), ptr, ptr + sizeof(st));
+    ptr = reinterpret_cast< const char* >(&size);
+    output.insert(output.end(), ptr, ptr + sizeof(size));
+    output.insert(output.end(), payload.begin(), payload.end());
+    flush(client);
+  } // ... respond(...)
+
+  /**
+   * \brief Sends as much of the pending output of the client as possible without blocking, drops it on errors.
+   */
+  void flush(const int fd)
+  {
+    const auto client = clients_.find(fd);
+    if (client == clients_.end())
+      return;
+    auto& output = client->second.output;
+    size_t sent = 0;
+    while (sent < output.size()) {
+      const ssize_t result = ::send(fd, output.data() + sent, output.size() - sent, MSG_DONTWAIT | MSG_NOSIGNAL);
+      if (result < 0) {
+        if (errno == EINTR)
+          continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+          break;
+        drop(fd);
+        return;
+      }
+      sent += result;
+    }
+    output.erase(output.begin(), output.begin() + sent);
+  } // ... flush(...)
+
+  /**
+   * \brief Sends the pending responses (e.g., the one to a shutdown request) to all clients which keep reading.
+   */
+  void drain()
+  {
+    while (true) {
+      std::vector< pollfd > fds;
+      for (const auto& client : clients_)
+        if (!client.second.output.empty())
+          fds.push_back({client.first, POLLOUT, 0});
+      if (fds.empty())
+        return;
+      const int ready = ::poll(fds.data(), fds.size(), drain_timeout);
+      if (ready < 0 && errno == EINTR)
+        continue;
+      if (ready <= 0)
+        return;
+      for (const auto& fd : fds)
+        if (fd.revents)
+          flush(fd.fd);
+    }
+  } // ... drain(...)
+
+  void drop(const int fd)
+  {
+    ::close(fd);
+    clients_.erase(fd);
+  }
+
+  void handle(const Request& request, ProtocolType::Writer& result) const
+  {
+    ProtocolType::Reader payload(request.payload);
+    switch (request.type) {
+      case ProtocolType::Request::info: {
+        result.uint(discretization_.ansatz_space().mapper().size());
+        ProtocolType::ParameterType parameter_type;
+        for (const auto& key : discretization_.parameter_type().keys())
+          parameter_type[key] = std::vector< double >(discretization_.parameter_type().get(key), 0.0);
+        result.parameter(parameter_type);
+        break;
+      }
+      case ProtocolType::Request::solve: {
+        const auto mu = to_parameter(payload.parameter());
+        const std::string type = payload.string();
+        auto solution = discretization_.create_vector();
+        discretization_.solve(type.empty() ? discretization_.solver_options()
+                                           : discretization_.solver_options(type),
+                              solution,
+                              mu);
+        result.vector(from_vector(solution));
+        break;
+      }
+      case ProtocolType::Request::apply: {
+        const auto mu = to_parameter(payload.parameter());
+        const auto source = to_vector(payload.vector());
+        auto range = discretization_.create_vector();
+        const auto op = discretization_.get_operator();
+        if (op.parametric())
+          op.apply(source, range, restrict_parameter(mu, op));
+        else
+          op.apply(source, range);
+        result.vector(from_vector(range));
+        break;
+      }
+      case ProtocolType::Request::product: {
+        const auto mu = to_parameter(payload.parameter());
+        const std::string id = payload.string();
+        const auto left = to_vector(payload.vector());
+        const auto right = to_vector(payload.vector());
+        const auto product = discretization_.get_product(id);
+        result.real(product.parametric() ? product.apply2(left, right, restrict_parameter(mu, product))
+                                         : product.apply2(left, right));
+        break;
+      }
+      case ProtocolType::Request::estimate: {
+        if (!estimator_)
+          DUNE_THROW(Stuff::Exceptions::you_are_using_this_wrong, "This server does not provide estimates!");
+        const auto mu = to_parameter(payload.parameter());
+        const std::string type = payload.string();
+        result.real(estimator_(to_vector(payload.vector()), mu, type));
+        break;
+      }
+      default:
+        DUNE_THROW(Stuff::Exceptions::internal_error, "Unknown request!");
+    }
+  } // ... handle(...)
+
+  /**
+   * \brief The part of mu (which has to be a parameter of the discretization) the given operator or product depends
+   *        on, the same for all requests.
+   */
+  template< class ContainerType >
+  Pymor::Parameter restrict_parameter(const Pymor::Parameter& mu, const ContainerType& container) const
+  {
+    if (mu.type() != discretization_.parameter_type())
+      DUNE_THROW(Pymor::Exceptions::wrong_parameter_type,
+                 "mu is " << mu.type() << ", should be " << discretization_.parameter_type() << "!");
+    Pymor::Parameter ret;
+    for (const auto& key : container.parameter_type().keys()) {
+      if (!mu.hasKey(key))
+        DUNE_THROW(Pymor::Exceptions::wrong_parameter_type,
+                   "mu is " << mu.type() << ", should contain " << container.parameter_type() << "!");
+      ret.set(key, mu.get(key));
+    }
+    return ret;
+  } // ... restrict_parameter(...)
+
+  static Pymor::Parameter to_parameter(const ProtocolType::ParameterType& mu)
+  {
+    Pymor::Parameter ret;
+    for (const auto& element : mu)
+      ret.set(element.first, element.second);
+    return ret;
+  }
+
+  VectorType to_vector(const std::vector< double >& values) const
+  {
+    auto ret = discretization_.create_vector();
+    if (values.size() != ret.size())
+      DUNE_THROW(Stuff::Exceptions::shapes_do_not_match,
+                 "The given vector has size " << values.size() << ", should be " << ret.size() << "!");
+    for (size_t ii = 0; ii < values.size(); ++ii)
+      ret.set_entry(ii, values[ii]);
+    return ret;
+  } // ... to_vector(...)
+
+  static std::vector< double > from_vector(const VectorType& vector)
+  {
+    std::vector< double > ret(vector.size());
+    for (size_t ii = 0; ii < ret.size(); ++ii)
+      ret[ii] = vector.get_entry(ii);
+    return ret;
+  }
+
+  const DiscretizationType& discretization_;
+  const std::string socket_path_;
+  const EstimatorType estimator_;
+  int socket_;
+  dev_t socket_device_;
+  ino_t socket_inode_;
+  std::map< int, Client > clients_;
+}; // class SolveServer
+
+
+/**
+ * \brief Connects to a SolveServer, each method sends one request and waits for its result.
+ */
+class SolveClient
+{
+public:
+  typedef internal::SolveProtocol         ProtocolType;
+  typedef ProtocolType::ParameterType     ParameterType;
+
+  explicit SolveClient(const std::string socket_path)
+    : socket_(::socket(AF_UNIX, SOCK_STREAM, 0))
+  {
+    if (socket_ < 0)
+      DUNE_THROW(IOError, "Could not create socket: " << std::strerror(errno));
+    sockaddr_un address;
+    if (socket_path.size() >= sizeof(address.sun_path))
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given, "The socket path '" << socket_path << "' is too long!");
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+    if (::connect(socket_, reinterpret_cast< sockaddr* >(&address), sizeof(address)) != 0) {
+      const std::string error = std::strerror(errno);
+      ::close(socket_);
+      DUNE_THROW(IOError, "Could not connect to '" << socket_path << "': " << error);
+    }
+  } // SolveClient(...)
+
+  SolveClient(const SolveClient& /*other*/) = delete;
+
+  SolveClient& operator=(const SolveClient& /*other*/) = delete;
+
+  ~SolveClient()
+  {
+    ::close(socket_);
+  }
+
+  /**
+   * \return the number of DoFs and the parameter type of the discretization (with zero values)
+   */
+  std::pair< size_t, ParameterType > info()
+  {
+    const auto result = request(ProtocolType::Request::info, ProtocolType::Writer());
+    ProtocolType::Reader reader(result);
+    const size_t dofs = reader.uint();
+    return std::make_pair(dofs, reader.parameter());
+  }
+
+  std::vector< double > solve(const ParameterType& mu = ParameterType(), const std::string type = "")
+  {
+    ProtocolType::Writer payload;
+    payload.parameter(mu);
+    payload.string(type);
+    const auto result = request(ProtocolType::Request::solve, payload);
+    return ProtocolType::Reader(result).vector();
+  }
+
+  std::vector< double > apply(const std::vector< double >& source, const ParameterType& mu = ParameterType())
+  {
+    ProtocolType::Writer payload;
+    payload.parameter(mu);
+    payload.vector(source);
+    const auto result = request(ProtocolType::Request::apply, payload);
+    return ProtocolType::Reader(result).vector();
+  }
+
+  double product(const std::string id,
+                 const std::vector< double >& left,
+                 const std::vector< double >& right,
+                 const ParameterType& mu = ParameterType())
+  {
+    ProtocolType::Writer payload;
+    payload.parameter(mu);
+    payload.string(id);
+    payload.vector(left);
+    payload.vector(right);
+    const auto result = request(ProtocolType::Request::product, payload);
+    return ProtocolType::Reader(result).real();
+  }
+
+  double estimate(const std::vector< double >& solution,
+                  const ParameterType& mu = ParameterType(),
+                  const std::string type = "")
+  {
+    ProtocolType::Writer payload;
+    payload.parameter(mu);
+    payload.string(type);
+    payload.vector(solution);
+    const auto result = request(ProtocolType::Request::estimate, payload);
+    return ProtocolType::Reader(result).real();
+  }
+
+  void shutdown()
+  {
+    request(ProtocolType::Request::shutdown, ProtocolType::Writer());
+  }
+
+private:
+  std::vector< char > request(const ProtocolType::Request type, const ProtocolType::Writer& payload)
+  {
+    if (payload.buffer().size() > ProtocolType::max_payload_size)
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given, "The request exceeds the maximal message size!");
+    std::vector< char > message;
+    ProtocolType::write_header(message, ProtocolType::magic, std::uint32_t(type), payload.buffer().size());
+    message.insert(message.end(), payload.buffer().begin(), payload.buffer().end());
+    ProtocolType::send_all(socket_, message.data(), message.size());
+    std::uint32_t status;
+    std::uint64_t size;
+    ProtocolType::receive_all(socket_, &status, sizeof(status));
+    ProtocolType::receive_all(socket_, &size, sizeof(size));
+    if (size > ProtocolType::max_payload_size)
+      DUNE_THROW(IOError, "The response exceeds the maximal message size!");
+    std::vector< char > result(size);
+    if (size > 0)
+      ProtocolType::receive_all(socket_, result.data(), size);
+    if (status != std::uint32_t(ProtocolType::Status::ok))
+      DUNE_THROW(Stuff::Exceptions::internal_error,
+                 "The server reported: " << std::string(result.begin(), result.end()));
+    return result;
+  } // ... request(...)
+
+  const int socket_;
+}; // class SolveClient
+
+
+} // namespace LinearElliptic
+} // namespace HDD
+} // namespace Dune
+
+#endif // DUNE_HDD_LINEARELLIPTIC_SERVER_HH
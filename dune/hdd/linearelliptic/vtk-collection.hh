@@ -0,0 +1,406 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_VTK_COLLECTION_HH
+#define DUNE_HDD_LINEARELLIPTIC_VTK_COLLECTION_HH
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if DUNE_HDD_HAVE_ZLIB
+# include <zlib.h>
+#endif
+
+#include <dune/common/exceptions.hh>
+
+#include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/common/string.hh>
+
+#include "parallel.hh"
+
+namespace Dune {
+namespace HDD {
+namespace LinearElliptic {
+namespace internal {
+
+
+/**
+ * \brief The layout of the data of a serial VTK unstructured grid file (.vtu), as required for a .pvtu collection.
+ *
+ *        Only the XML header of the file is read (up to the appended data, if any), so the layout is exactly the one
+ *        the writer of the pieces chose (precision, number of components, point or cell data).
+ */
+class VTUHeader
+{
+public:
+  explicit VTUHeader(const std::string& filename)
+  {
+    std::ifstream file(filename, std::ifstream::binary);
+    if (!file)
+      DUNE_THROW(IOError, "Could not open '" << filename << "'!");
+    std::string header;
+    std::string line;
+    while (std::getline(file, line)) {
+      const auto appended = line.find("<AppendedData");
+      header += line.substr(0, appended) + "\n";
+      if (appended != std::string::npos)
+        break;
+    }
+    const auto vtk_file = find_tag(header, "VTKFile", 0);
+    if (vtk_file == std::string::npos)
+      DUNE_THROW(IOError, "'" << filename << "' is not a VTK file!");
+    file_attributes_ = attributes(header, vtk_file, "VTKFile");
+    if (attribute(file_attributes_, "type") != "UnstructuredGrid")
+      DUNE_THROW(IOError, "'" << filename << "' does not contain an unstructured grid!");
+    point_data_ = read_section(header, "PointData");
+    cell_data_ = read_section(header, "CellData");
+    points_ = read_section(header, "Points");
+    if (!points_.present)
+      DUNE_THROW(IOError, "'" << filename << "' does not contain points!");
+  } // VTUHeader(...)
+
+  bool operator==(const VTUHeader& other) const
+  {
+    return file_attributes_ == other.file_attributes_
+        && point_data_ == other.point_data_
+        && cell_data_ == other.cell_data_
+        && points_ == other.points_;
+  }
+
+  bool operator!=(const VTUHeader& other) const
+  {
+    return !(*this == other);
+  }
+
+  /**
+   * \brief Writes the collection of the given pieces (the filenames of which are relative to the collection) in the
+   *        layout of this header.
+   */
+  void write_collection(std::ostream& out, const std::vector< std::string >& sources) const
+  {
+    std::string file_attributes = file_attributes_;
+    file_attributes.replace(file_attributes.find("UnstructuredGrid"), 16, "PUnstructuredGrid");
+    out << "<?xml version=\"1.0\"?>\n"
+        << "<VTKFile" << file_attributes << ">\n"
+        << "  <PUnstructuredGrid GhostLevel=\"0\">\n";
+    write_section(out, "PointData", point_data_);
+    write_section(out, "CellData", cell_data_);
+    write_section(out, "Points", points_);
+    for (const auto& source : sources)
+      out << "    <Piece Source=\"" << source << "\"/>\n";
+    out << "  </PUnstructuredGrid>\n"
+        << "</VTKFile>\n";
+  } // ... write_collection(...)
+
+private:
+  struct Section
+  {
+    Section()
+      : present(false)
+    {}
+
+    bool operator==(const Section& other) const
+    {
+      return present == other.present && attributes == other.attributes && data_arrays == other.data_arrays;
+    }
+
+    bool present;
+    std::string attributes;
+    std::vector< std::string > data_arrays;
+  }; // struct Section
+
+  // the position of the first tag <name ...> or <name> at or after pos
+  static size_t find_tag(const std::string& header, const std::string& name, size_t pos)
+  {
+    for (pos = header.find("<" + name, pos); pos != std::string::npos; pos = header.find("<" + name, pos + 1)) {
+      const char next = header[pos + name.size() + 1];
+      if (next == ' ' || next == '>' || next == '/' || next == '\n' || next == '\t' || next == '\r')
+        return pos;
+    }
+    return std::string::npos;
+  }
+
+  // the attributes of the tag at pos, including the leading whitespace, excluding a trailing slash
+  static std::string attributes(const std::string& header, const size_t pos, const std::string& name)
+  {
+    const auto end = header.find('>', pos);
+    if (end == std::string::npos)
+      DUNE_THROW(IOError, "Unterminated <" << name << "> tag!");
+    auto ret = header.substr(pos + name.size() + 1, end - pos - name.size() - 1);
+    if (!ret.empty() && ret[ret.size() - 1] == '/')
+      ret.resize(ret.size() - 1);
+    return ret;
+  }
+
+  static std::string attribute(const std::string& attributes, const std::string& key)
+  {
+    const auto pos = attributes.find(" " + key + "=\"");
+    if (pos == std::string::npos)
+      return "";
+    const auto begin = pos + key.size() + 3;
+    return attributes.substr(begin, attributes.find('"', begin) - begin);
+  }
+
+  static Section read_section(const std::string& header, const std::string& name)
+  {
+    Section ret;
+    const auto begin = find_tag(header, name, 0);
+    if (begin == std::string::npos)
+      return ret;
+    ret.present = true;
+    ret.attributes = attributes(header, begin, name);
+    const auto tag_end = header.find('>', begin);
+    if (header[tag_end - 1] == '/')
+      return ret;
+    const auto end = header.find("</" + name + ">", tag_end);
+    if (end == std::string::npos)
+      DUNE_THROW(IOError, "Unterminated <" << name << "> section!");
+    for (auto pos = find_tag(header, "DataArray", tag_end); pos < end; pos = find_tag(header, "DataArray", pos + 1)) {
+      const auto data_array = attributes(header, pos, "DataArray");
+      std::string layout;
+      for (const std::string key : {"type", "Name", "NumberOfComponents"}) {
+        const auto value = attribute(data_array, key);
+        if (!value.empty())
+          layout += " " + key + "=\"" + value + "\"";
+      }
+      ret.data_arrays.push_back(layout);
+    }
+    return ret;
+  } // ... read_section(...)
+
+  static void write_section(std::ostream& out, const std::string& name, const Section& section)
+  {
+    if (!section.present)
+      return;
+    out << "    <P" << name << section.attributes << ">\n";
+    for (const auto& data_array : section.data_arrays)
+      out << "      <PDataArray" << data_array << "/>\n";
+    out << "    </P" << name << ">\n";
+  }
+
+  std::string file_attributes_;
+  Section point_data_;
+  Section cell_data_;
+  Section points_;
+}; // class VTUHeader
+
+
+/**
+ * \brief Writes filename.pvtu, collecting the serial pieces filename_0.vtu, ..., filename_<num_pieces - 1>.vtu, in the
+ *        layout of the pieces (which have to coincide).
+ */
+inline void write_vtu_collection(const std::string& filename, const size_t num_pieces)
+{
+  if (num_pieces == 0)
+    DUNE_THROW(Stuff::Exceptions::wrong_input_given, "num_pieces has to be positive!");
+  const std::string basename = filename.substr(filename.find_last_of('/') + 1);
+  const VTUHeader header(filename + "_0.vtu");
+  std::vector< std::string > sources(1, basename + "_0.vtu");
+  for (size_t ss = 1; ss < num_pieces; ++ss) {
+    if (VTUHeader(filename + "_" + Stuff::Common::toString(ss) + ".vtu") != header)
+      DUNE_THROW(IOError,
+                 "The layout of '" << filename << "_" << ss << ".vtu' does not match the one of '" << filename
+                 << "_0.vtu'!");
+    sources.push_back(basename + "_" + Stuff::Common::toString(ss) + ".vtu");
+  }
+  std::ofstream file(filename + ".pvtu");
+  if (!file)
+    DUNE_THROW(IOError, "Could not open '" << filename << ".pvtu' for writing!");
+  header.write_collection(file, sources);
+} // ... write_vtu_collection(...)
+
+
+#if DUNE_HDD_HAVE_ZLIB
+
+
+template< class HeaderType >
+void append_compressed(const std::string& data, const size_t block_size, std::string& ret)
+{
+  const size_t num_blocks = (data.size() + block_size - 1) / block_size;
+  std::vector< HeaderType > header(3 + num_blocks);
+  header[0] = HeaderType(num_blocks);
+  header[1] = HeaderType(block_size);
+  header[2] = HeaderType(data.size() % block_size);
+  std::string blocks;
+  std::vector< Bytef > buffer(compressBound(uLong(block_size)));
+  for (size_t bb = 0; bb < num_blocks; ++bb) {
+    const size_t size = std::min(block_size, data.size() - bb*block_size);
+    uLongf compressed_size = uLongf(buffer.size());
+    if (compress2(buffer.data(), &compressed_size, reinterpret_cast< const Bytef* >(data.data() + bb*block_size),
+                  uLong(size), Z_DEFAULT_COMPRESSION) != Z_OK)
+      DUNE_THROW(IOError, "zlib failed to compress a block of " << size << " bytes!");
+    header[3 + bb] = HeaderType(compressed_size);
+    blocks.append(reinterpret_cast< const char* >(buffer.data()), compressed_size);
+  }
+  ret.append(reinterpret_cast< const char* >(header.data()), header.size()*sizeof(HeaderType));
+  ret += blocks;
+} // ... append_compressed(...)
+
+template< class HeaderType >
+std::string read_raw_array(const std::string& content, const size_t begin, size_t& end)
+{
+  HeaderType size;
+  if (begin + sizeof(HeaderType) > content.size())
+    DUNE_THROW(IOError, "Truncated appended data!");
+  std::memcpy(&size, content.data() + begin, sizeof(HeaderType));
+  if (begin + sizeof(HeaderType) + size > content.size())
+    DUNE_THROW(IOError, "Truncated appended data!");
+  end = begin + sizeof(HeaderType) + size;
+  return content.substr(begin + sizeof(HeaderType), size);
+}
+
+template< class HeaderType >
+std::string compress_appended(const std::string& content, const size_t data_begin,
+                              const std::vector< size_t >& offsets, std::vector< size_t >& new_offsets,
+                              const size_t block_size, size_t& data_end)
+{
+  std::string ret;
+  data_end = data_begin;
+  for (const size_t offset : offsets) {
+    new_offsets.push_back(ret.size());
+    append_compressed< HeaderType >(read_raw_array< HeaderType >(content, data_begin + offset, data_end),
+                                    block_size, ret);
+  }
+  return ret;
+} // ... compress_appended(...)
+
+
+#endif // DUNE_HDD_HAVE_ZLIB
+
+
+/**
+ * \brief Compresses the appended raw data of a serial piece (as written by the VTKWriter with VTK::appendedraw) with
+ *        zlib, in the block layout of the vtkZLibDataCompressor (which ParaView reads).
+ *
+ *        The VTKWriter of dune-grid has no compressed output, so the piece is rewritten after it has been written.
+ *        This only touches the given file and is thus safe to call concurrently for different pieces.
+ * \return false if the piece was left unchanged, since dune-hdd was built without zlib or the piece does not contain
+ *         uncompressed appended raw data.
+ */
+inline bool compress_vtu(const std::string& filename, const size_t block_size = 32768)
+{
+#if DUNE_HDD_HAVE_ZLIB
+  if (block_size == 0)
+    DUNE_THROW(Stuff::Exceptions::wrong_input_given, "block_size has to be positive!");
+  std::string content;
+  {
+    std::ifstream file(filename, std::ifstream::binary);
+    if (!file)
+      DUNE_THROW(IOError, "Could not open '" << filename << "'!");
+    std::stringstream ss;
+    ss << file.rdbuf();
+    content = ss.str();
+  }
+  const auto appended = content.find("<AppendedData");
+  if (appended == std::string::npos)
+    return false;
+  const auto appended_end = content.find('>', appended);
+  if (appended_end == std::string::npos
+      || content.substr(appended, appended_end - appended).find("encoding=\"raw\"") == std::string::npos)
+    return false;
+  std::string header = content.substr(0, appended);
+  const auto vtk_file = header.find("<VTKFile");
+  if (vtk_file == std::string::npos)
+    DUNE_THROW(IOError, "'" << filename << "' is not a VTK file!");
+  const std::string file_tag = header.substr(vtk_file, header.find('>', vtk_file) - vtk_file);
+  if (file_tag.find("compressor=") != std::string::npos)
+    return false;
+  const bool long_headers = file_tag.find("header_type=\"UInt64\"") != std::string::npos;
+  const auto underscore = content.find('_', appended_end);
+  if (underscore == std::string::npos)
+    DUNE_THROW(IOError, "'" << filename << "' contains no appended data!");
+  // the positions of the offset values in the header, and the offsets in increasing order
+  const std::string offset_key = "offset=\"";
+  std::vector< std::pair< size_t, size_t > > positions;
+  for (auto pos = header.find(offset_key); pos != std::string::npos; pos = header.find(offset_key, pos + 1)) {
+    const size_t begin = pos + offset_key.size();
+    const size_t end = header.find('"', begin);
+    positions.emplace_back(begin, Stuff::Common::fromString< size_t >(header.substr(begin, end - begin)));
+  }
+  std::vector< size_t > offsets;
+  for (const auto& position : positions)
+    offsets.push_back(position.second);
+  std::sort(offsets.begin(), offsets.end());
+  offsets.erase(std::unique(offsets.begin(), offsets.end()), offsets.end());
+  std::vector< size_t > new_offsets;
+  size_t data_end = 0;
+  const std::string data = long_headers
+      ? compress_appended< std::uint64_t >(content, underscore + 1, offsets, new_offsets, block_size, data_end)
+      : compress_appended< std::uint32_t >(content, underscore + 1, offsets, new_offsets, block_size, data_end);
+  // replace the offsets back to front, so that the positions of the remaining ones stay valid
+  for (auto it = positions.rbegin(); it != positions.rend(); ++it) {
+    const size_t index = std::lower_bound(offsets.begin(), offsets.end(), it->second) - offsets.begin();
+    header.replace(it->first,
+                   header.find('"', it->first) - it->first,
+                   Stuff::Common::toString(new_offsets[index]));
+  }
+  header.insert(vtk_file + 8, " compressor=\"vtkZLibDataCompressor\"");
+  const std::string tmp_filename = filename + ".tmp";
+  {
+    std::ofstream file(tmp_filename, std::ofstream::binary);
+    if (!file)
+      DUNE_THROW(IOError, "Could not open '" << tmp_filename << "' for writing!");
+    file << header << content.substr(appended, underscore + 1 - appended) << data << content.substr(data_end);
+    if (!file)
+      DUNE_THROW(IOError, "Could not write '" << tmp_filename << "'!");
+  }
+  if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0)
+    DUNE_THROW(IOError, "Could not replace '" << filename << "'!");
+  return true;
+#else // DUNE_HDD_HAVE_ZLIB
+  static_cast< void >(filename);
+  static_cast< void >(block_size);
+  return false;
+#endif // DUNE_HDD_HAVE_ZLIB
+} // ... compress_vtu(...)
+
+
+/**
+ * \brief Writes the pieces filename_0.vtu, ..., filename_<num_pieces - 1>.vtu by calling write_piece(ii, filename_ii)
+ *        (which has to create filename_ii.vtu), compresses them (see compress_vtu()) and writes their collection (see
+ *        write_vtu_collection()).
+ *
+ *        The first piece is written alone, the remaining ones concurrently on num_threads threads (0 meaning as many as
+ *        the hardware supports) if concurrent is set. The VTKWriters of the pieces are independent, but the static data
+ *        of dune-geometry and dune-fem used by the evaluations (quadrature rules, shape function sets) is created
+ *        lazily and not thread safe. Writing the first piece creates it for the geometry type of its entities, which
+ *        is why concurrent must only be set if all pieces contain the same geometry type.
+ */
+template< class WriterType >
+void write_vtu_pieces(const std::string& filename,
+                      const size_t num_pieces,
+                      const bool concurrent,
+                      const size_t num_threads,
+                      const WriterType& write_piece)
+{
+  if (num_pieces == 0)
+    DUNE_THROW(Stuff::Exceptions::wrong_input_given, "num_pieces has to be positive!");
+  const auto write_and_compress = [&](const size_t& ii) {
+    const std::string piece = filename + "_" + Stuff::Common::toString(ii);
+    write_piece(ii, piece);
+    compress_vtu(piece + ".vtu");
+  };
+  write_and_compress(0);
+  std::vector< size_t > remaining(num_pieces - 1);
+  std::iota(remaining.begin(), remaining.end(), 1);
+  parallel_for_each(remaining, concurrent ? num_threads : 1, write_and_compress);
+  write_vtu_collection(filename, num_pieces);
+} // ... write_vtu_pieces(...)
+
+
+} // namespace internal
+} // namespace LinearElliptic
+} // namespace HDD
+} // namespace Dune
+
+#endif // DUNE_HDD_LINEARELLIPTIC_VTK_COLLECTION_HH
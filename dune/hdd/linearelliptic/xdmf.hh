@@ -0,0 +1,370 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_XDMF_HH
+#define DUNE_HDD_LINEARELLIPTIC_XDMF_HH
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if DUNE_HDD_HAVE_HDF5
+# include <hdf5.h>
+#endif
+
+#include <dune/common/exceptions.hh>
+#include <dune/geometry/type.hh>
+
+#include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/common/string.hh>
+
+namespace Dune {
+namespace HDD {
+namespace LinearElliptic {
+
+#if DUNE_HDD_HAVE_HDF5
+
+
+/**
+ * \brief Writes functions on a grid view as a series of steps (time steps or parameters of a sweep) to an HDF5 file
+ *        (filename.h5), together with an XDMF file (filename.xdmf) describing it, e.g. for ParaView.
+ *
+ *        The geometry is stored once (nonconforming, i.e. the corners of each element, like the VTK output of
+ *        discrete functions), each function added to a step is appended as a chunked and compressed dataset of its
+ *        values at these corners. Each step is flushed to disk immediately and only the (small) XDMF file is
+ *        rewritten, so a running sweep may be inspected at any time. If append is true, the steps of an existing
+ *        file (for the same grid view) are kept and new steps are appended to them.
+ * \note  Only grid views with a single (simplex or cube) element type are supported.
+ */
+template< class GridViewImp >
+class XdmfWriter
+{
+  typedef XdmfWriter< GridViewImp > ThisType;
+public:
+  typedef GridViewImp GridViewType;
+  typedef typename GridViewType::template Codim< 0 >::Entity EntityType;
+  static const unsigned int dimDomain = GridViewType::dimension;
+
+private:
+  struct Step
+  {
+    double time;
+    std::vector< std::pair< std::string, size_t > > datasets;
+  };
+
+public:
+  XdmfWriter(const GridViewType& grid_view,
+             const std::string filename,
+             const bool append = false,
+             const unsigned int compression = 6)
+    : grid_view_(grid_view)
+    , filename_(filename)
+    , basename_(filename.substr(filename.find_last_of('/') + 1))
+    , compression_(compression)
+    , file_(-1)
+    , num_elements_(0)
+    , num_corners_(0)
+  {
+    analyze_grid_view();
+    FILE* existing = append ? std::fopen((filename_ + ".h5").c_str(), "r") : nullptr;
+    if (existing) {
+      std::fclose(existing);
+      file_ = H5Fopen((filename_ + ".h5").c_str(), H5F_ACC_RDWR, H5P_DEFAULT);
+      if (file_ < 0)
+        DUNE_THROW(IOError, "Could not open '" << filename_ << ".h5'!");
+      read_steps();
+    } else {
+      file_ = H5Fcreate((filename_ + ".h5").c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+      if (file_ < 0)
+        DUNE_THROW(IOError, "Could not create '" << filename_ << ".h5'!");
+      write_geometry();
+      close(H5Gclose, H5Gcreate2(file_, "/steps", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT), "/steps");
+      H5Fflush(file_, H5F_SCOPE_GLOBAL);
+    }
+    write_xdmf();
+  } // XdmfWriter(...)
+
+  XdmfWriter(const ThisType& other) = delete;
+
+  ThisType& operator=(const ThisType& other) = delete;
+
+  ~XdmfWriter()
+  {
+    if (file_ >= 0)
+      H5Fclose(file_);
+  }
+
+  size_t num_steps() const
+  {
+    return steps_.size();
+  }
+
+  /**
+   * \brief Starts a new step, all functions added afterwards belong to this step.
+   */
+  size_t new_step(const double time)
+  {
+    const std::string group_name = "/steps/" + DSC::toString(steps_.size());
+    const hid_t group = H5Gcreate2(file_, group_name.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    if (group < 0)
+      DUNE_THROW(IOError, "Could not create '" << group_name << "' in '" << filename_ << ".h5'!");
+    const hid_t space = H5Screate(H5S_SCALAR);
+    const hid_t attribute = H5Acreate2(group, "time", H5T_NATIVE_DOUBLE, space, H5P_DEFAULT, H5P_DEFAULT);
+    H5Awrite(attribute, H5T_NATIVE_DOUBLE, &time);
+    H5Aclose(attribute);
+    H5Sclose(space);
+    H5Gclose(group);
+    H5Fflush(file_, H5F_SCOPE_GLOBAL);
+    steps_.push_back(Step{time, {}});
+    write_xdmf();
+    return steps_.size() - 1;
+  } // ... new_step(...)
+
+  /**
+   * \brief Adds the values of the given (localizable) function at the corners of all elements to the current step.
+   */
+  template< class FunctionType >
+  void add(const FunctionType& function, const std::string name)
+  {
+    static_assert(FunctionType::dimRangeCols == 1, "Matrix valued functions are not supported!");
+    static_assert(FunctionType::dimRange <= 3, "Only scalar functions or vectors of at most 3 components are supported!");
+    if (steps_.empty())
+      DUNE_THROW(Stuff::Exceptions::you_are_using_this_wrong, "Call new_step() first!");
+    const size_t num_components = FunctionType::dimRange == 1 ? 1 : 3;
+    std::vector< double > values(num_elements_*num_corners_*num_components, 0.0);
+    typename FunctionType::RangeType value(0.0);
+    size_t pp = 0;
+    for (auto it = grid_view_.template begin< 0 >(); it != grid_view_.template end< 0 >(); ++it) {
+      const auto& entity = *it;
+      const auto geometry = entity.geometry();
+      const auto local_function = function.local_function(entity);
+      for (size_t cc = 0; cc < num_corners_; ++cc, ++pp) {
+        local_function->evaluate(geometry.local(geometry.corner(int(cc))), value);
+        for (size_t ii = 0; ii < FunctionType::dimRange; ++ii)
+          values[pp*num_components + ii] = value[ii];
+      }
+    }
+    const std::string dataset_name = "/steps/" + DSC::toString(steps_.size() - 1) + "/" + name;
+    write_dataset(dataset_name, values, num_components, H5T_NATIVE_DOUBLE, H5T_NATIVE_DOUBLE);
+    H5Fflush(file_, H5F_SCOPE_GLOBAL);
+    steps_.back().datasets.emplace_back(name, num_components);
+    write_xdmf();
+  } // ... add(...)
+
+  template< class FunctionType >
+  void add(const FunctionType& function)
+  {
+    add(function, function.name());
+  }
+
+private:
+  template< class CloseType >
+  void close(const CloseType& closer, const hid_t id, const std::string name) const
+  {
+    if (id < 0)
+      DUNE_THROW(IOError, "Could not create '" << name << "' in '" << filename_ << ".h5'!");
+    closer(id);
+  }
+
+  void analyze_grid_view()
+  {
+    for (auto it = grid_view_.template begin< 0 >(); it != grid_view_.template end< 0 >(); ++it) {
+      const auto type = it->type();
+      if (num_elements_ == 0) {
+        type_ = type;
+        num_corners_ = it->geometry().corners();
+      } else if (type != type_)
+        DUNE_THROW(NotImplemented, "Only grid views with a single element type are supported!");
+      ++num_elements_;
+    }
+    if (num_elements_ == 0)
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given, "The given grid view is empty!");
+    if (dimDomain == 1)
+      topology_type_ = "Polyline";
+    else if (type_.isTriangle())
+      topology_type_ = "Triangle";
+    else if (type_.isQuadrilateral())
+      topology_type_ = "Quadrilateral";
+    else if (type_.isTetrahedron())
+      topology_type_ = "Tetrahedron";
+    else if (type_.isHexahedron())
+      topology_type_ = "Hexahedron";
+    else
+      DUNE_THROW(NotImplemented, "Elements of type " << type_ << " are not supported!");
+  } // ... analyze_grid_view(...)
+
+  // the corner of a cube in the ordering of XDMF (Dune orders the corners lexicographically)
+  size_t corner(const size_t cc) const
+  {
+    if (type_.isCube() && dimDomain > 1) {
+      static const size_t cube_corners[8] = {0, 1, 3, 2, 4, 5, 7, 6};
+      return cube_corners[cc];
+    }
+    return cc;
+  }
+
+  void write_geometry()
+  {
+    std::vector< double > coordinates(num_elements_*num_corners_*3, 0.0);
+    std::vector< long long > topology(num_elements_*num_corners_);
+    size_t pp = 0;
+    for (auto it = grid_view_.template begin< 0 >(); it != grid_view_.template end< 0 >(); ++it) {
+      const auto geometry = it->geometry();
+      for (size_t cc = 0; cc < num_corners_; ++cc) {
+        const auto xx = geometry.corner(int(cc));
+        for (size_t dd = 0; dd < dimDomain; ++dd)
+          coordinates[(pp + cc)*3 + dd] = xx[dd];
+        topology[pp + cc] = pp + corner(cc);
+      }
+      pp += num_corners_;
+    }
+    close(H5Gclose, H5Gcreate2(file_, "/geometry", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT), "/geometry");
+    write_dataset("/geometry/coordinates", coordinates, 3, H5T_NATIVE_DOUBLE, H5T_NATIVE_DOUBLE);
+    write_dataset("/geometry/topology", topology, num_corners_, H5T_NATIVE_LLONG, H5T_STD_I64LE);
+  } // ... write_geometry(...)
+
+  template< class T >
+  void write_dataset(const std::string name,
+                     const std::vector< T >& data,
+                     const size_t num_columns,
+                     const hid_t memory_type,
+                     const hid_t file_type) const
+  {
+    const hsize_t dims[2] = {hsize_t(data.size()/num_columns), hsize_t(num_columns)};
+    const hsize_t chunk[2] = {std::max(hsize_t(1), std::min(dims[0], hsize_t(65536))), dims[1]};
+    const hid_t space = H5Screate_simple(2, dims, nullptr);
+    const hid_t properties = H5Pcreate(H5P_DATASET_CREATE);
+    H5Pset_chunk(properties, 2, chunk);
+    if (compression_ > 0)
+      H5Pset_deflate(properties, compression_);
+    const hid_t dataset = H5Dcreate2(file_, name.c_str(), file_type, space, H5P_DEFAULT, properties, H5P_DEFAULT);
+    H5Pclose(properties);
+    H5Sclose(space);
+    if (dataset < 0)
+      DUNE_THROW(IOError, "Could not create '" << name << "' in '" << filename_ << ".h5' (does it exist already?)!");
+    const herr_t status = H5Dwrite(dataset, memory_type, H5S_ALL, H5S_ALL, H5P_DEFAULT, data.data());
+    H5Dclose(dataset);
+    if (status < 0)
+      DUNE_THROW(IOError, "Could not write '" << name << "' to '" << filename_ << ".h5'!");
+  } // ... write_dataset(...)
+
+  size_t num_rows(const hid_t location, const std::string name, size_t& columns) const
+  {
+    const hid_t dataset = H5Dopen2(location, name.c_str(), H5P_DEFAULT);
+    if (dataset < 0)
+      DUNE_THROW(IOError, "Could not open '" << name << "' in '" << filename_ << ".h5'!");
+    const hid_t space = H5Dget_space(dataset);
+    hsize_t dims[2] = {0, 0};
+    H5Sget_simple_extent_dims(space, dims, nullptr);
+    H5Sclose(space);
+    H5Dclose(dataset);
+    columns = dims[1];
+    return dims[0];
+  } // ... num_rows(...)
+
+  void read_steps()
+  {
+    size_t columns = 0;
+    if (num_rows(file_, "/geometry/coordinates", columns) != num_elements_*num_corners_)
+      DUNE_THROW(Stuff::Exceptions::wrong_input_given,
+                 "The geometry of '" << filename_ << ".h5' does not match the given grid view!");
+    const hid_t steps = H5Gopen2(file_, "/steps", H5P_DEFAULT);
+    if (steps < 0)
+      DUNE_THROW(IOError, "Could not open '/steps' in '" << filename_ << ".h5'!");
+    H5G_info_t steps_info;
+    H5Gget_info(steps, &steps_info);
+    for (size_t ss = 0; ss < steps_info.nlinks; ++ss) {
+      const hid_t group = H5Gopen2(steps, DSC::toString(ss).c_str(), H5P_DEFAULT);
+      if (group < 0)
+        DUNE_THROW(IOError, "Could not open '/steps/" << ss << "' in '" << filename_ << ".h5'!");
+      Step step;
+      const hid_t attribute = H5Aopen(group, "time", H5P_DEFAULT);
+      H5Aread(attribute, H5T_NATIVE_DOUBLE, &step.time);
+      H5Aclose(attribute);
+      H5G_info_t group_info;
+      H5Gget_info(group, &group_info);
+      for (hsize_t ii = 0; ii < group_info.nlinks; ++ii) {
+        const ssize_t length = H5Lget_name_by_idx(group, ".", H5_INDEX_NAME, H5_ITER_INC, ii,
+                                                  nullptr, 0, H5P_DEFAULT);
+        std::vector< char > name(std::max(ssize_t(0), length) + 1, '\0');
+        H5Lget_name_by_idx(group, ".", H5_INDEX_NAME, H5_ITER_INC, ii, name.data(), name.size(), H5P_DEFAULT);
+        const std::string dataset_name(name.data());
+        num_rows(group, dataset_name, columns);
+        step.datasets.emplace_back(dataset_name, columns);
+      }
+      H5Gclose(group);
+      steps_.push_back(step);
+    }
+    H5Gclose(steps);
+  } // ... read_steps(...)
+
+  void write_xdmf() const
+  {
+    const size_t num_points = num_elements_*num_corners_;
+    const std::string heavy = basename_ + ".h5:";
+    // write to a temporary file first, so that readers never see an incomplete file
+    const std::string tmp_filename = filename_ + ".xdmf.tmp";
+    std::ofstream file(tmp_filename);
+    if (!file)
+      DUNE_THROW(IOError, "Could not open '" << tmp_filename << "' for writing!");
+    file << std::setprecision(std::numeric_limits< double >::digits10 + 2);
+    file << "<?xml version=\"1.0\" ?>\n"
+         << "<Xdmf Version=\"2.0\">\n"
+         << "  <Domain>\n"
+         << "    <Grid Name=\"" << basename_ << "\" GridType=\"Collection\" CollectionType=\"Temporal\">\n";
+    for (size_t ss = 0; ss < steps_.size(); ++ss) {
+      file << "      <Grid Name=\"step_" << ss << "\" GridType=\"Uniform\">\n"
+           << "        <Time Value=\"" << steps_[ss].time << "\"/>\n"
+           << "        <Topology TopologyType=\"" << topology_type_ << "\" NumberOfElements=\"" << num_elements_
+           << "\" NodesPerElement=\"" << num_corners_ << "\">\n"
+           << "          <DataItem Dimensions=\"" << num_elements_ << " " << num_corners_
+           << "\" NumberType=\"Int\" Precision=\"8\" Format=\"HDF\">" << heavy << "/geometry/topology</DataItem>\n"
+           << "        </Topology>\n"
+           << "        <Geometry GeometryType=\"XYZ\">\n"
+           << "          <DataItem Dimensions=\"" << num_points << " 3\" NumberType=\"Float\" Precision=\"8\" "
+           << "Format=\"HDF\">" << heavy << "/geometry/coordinates</DataItem>\n"
+           << "        </Geometry>\n";
+      for (const auto& dataset : steps_[ss].datasets)
+        file << "        <Attribute Name=\"" << dataset.first << "\" AttributeType=\""
+             << (dataset.second == 1 ? "Scalar" : "Vector") << "\" Center=\"Node\">\n"
+             << "          <DataItem Dimensions=\"" << num_points << " " << dataset.second
+             << "\" NumberType=\"Float\" Precision=\"8\" Format=\"HDF\">" << heavy << "/steps/" << ss << "/"
+             << dataset.first << "</DataItem>\n"
+             << "        </Attribute>\n";
+      file << "      </Grid>\n";
+    }
+    file << "    </Grid>\n"
+         << "  </Domain>\n"
+         << "</Xdmf>\n";
+    file.close();
+    if (std::rename(tmp_filename.c_str(), (filename_ + ".xdmf").c_str()) != 0)
+      DUNE_THROW(IOError, "Could not rename '" << tmp_filename << "' to '" << filename_ << ".xdmf'!");
+  } // ... write_xdmf(...)
+
+  const GridViewType grid_view_;
+  const std::string filename_;
+  const std::string basename_;
+  const unsigned int compression_;
+  hid_t file_;
+  size_t num_elements_;
+  size_t num_corners_;
+  GeometryType type_;
+  std::string topology_type_;
+  std::vector< Step > steps_;
+}; // class XdmfWriter
+
+
+#endif // DUNE_HDD_HAVE_HDF5
+
+} // namespace LinearElliptic
+} // namespace HDD
+} // namespace Dune
+
+#endif // DUNE_HDD_LINEARELLIPTIC_XDMF_HH
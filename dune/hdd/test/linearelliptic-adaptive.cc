@@ -0,0 +1,141 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
+# define DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
+#endif
+
+// This one has to come first (includes the config.h)!
+#include <dune/stuff/test/main.hxx>
+
+#if HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
+# include <algorithm>
+# include <cmath>
+# include <numeric>
+# include <vector>
+
+# include <dune/grid/alugrid.hh>
+
+# include <dune/stuff/common/configuration.hh>
+# include <dune/stuff/common/ranges.hh>
+# include <dune/stuff/functions/expression.hh>
+
+# include <dune/gdt/discretefunction/default.hh>
+# include <dune/gdt/operators/projections.hh>
+
+# include <dune/hdd/linearelliptic/adaptive.hh>
+# include <dune/hdd/linearelliptic/discretizations/swipdg.hh>
+# include <dune/hdd/linearelliptic/testcases/OS2014.hh>
+
+using namespace Dune;
+using namespace HDD;
+
+
+typedef ALUGrid< 2, 2, simplex, conforming >           GridType;
+typedef LinearElliptic::TestCases::OS2014< GridType >  TestCaseType;
+typedef LinearElliptic::Discretizations::SWIPDG< GridType, Stuff::Grid::ChooseLayer::leaf, double, 1, 1,
+                                                 GDT::ChooseSpaceBackend::fem,
+                                                 Stuff::LA::ChooseBackend::istl_sparse > DiscretizationType;
+typedef DiscretizationType::AnsatzSpaceType                                               SpaceType;
+typedef DiscretizationType::VectorType                                                    VectorType;
+typedef LinearElliptic::AdaptiveDriver< DiscretizationType >                              DriverType;
+
+
+TEST(PiecewiseLinearTransfer, is_exact_for_linear_functions)
+{
+  TestCaseType test_case(0);
+  auto& grid = test_case.grid();
+  const Stuff::Functions::Expression< GridType::Codim< 0 >::Entity, double, 2, double, 1 >
+      linear_function("x", "1.0 + 2.0*x[0] - 3.0*x[1]", 1);
+  LinearElliptic::internal::PiecewiseLinearTransfer< GridType, double > transfer(grid);
+  {
+    const DiscretizationType discretization(test_case, test_case.boundary_info(), test_case.problem());
+    const auto& space = discretization.ansatz_space();
+    GDT::DiscreteFunction< SpaceType, VectorType > projection(space);
+    GDT::Operators::Projection< SpaceType::GridViewType >(space.grid_view()).apply(linear_function, projection);
+    transfer.store(space, projection.vector());
+    // refine every other entity
+    size_t ii = 0;
+    for (const auto& entity : Stuff::Common::entityRange(space.grid_view()))
+      if (ii++ % 2 == 0)
+        grid.mark(1, entity);
+  }
+  grid.preAdapt();
+  grid.adapt();
+  grid.postAdapt();
+  const DiscretizationType discretization(test_case, test_case.boundary_info(), test_case.problem());
+  const auto& space = discretization.ansatz_space();
+  GDT::DiscreteFunction< SpaceType, VectorType > expected(space);
+  GDT::Operators::Projection< SpaceType::GridViewType >(space.grid_view()).apply(linear_function, expected);
+  VectorType actual(space.mapper().size());
+  transfer.apply(space, actual);
+  ASSERT_EQ(expected.vector().size(), actual.size());
+  for (size_t ii = 0; ii < actual.size(); ++ii)
+    EXPECT_NEAR(expected.vector().get_entry(ii), actual.get_entry(ii), 1e-12) << "DoF " << ii;
+} // TEST(PiecewiseLinearTransfer, is_exact_for_linear_functions)
+
+TEST(AdaptiveDriver, doerfler_marking_is_minimal)
+{
+  using LinearElliptic::internal::doerfler_marking;
+  const std::vector< double > indicators = {0.1, 0.4, 0.2, 0.3};
+  EXPECT_EQ(std::vector< bool >({false, true, false, false}), doerfler_marking(indicators, 0.4));
+  EXPECT_EQ(std::vector< bool >({false, true, false, true}), doerfler_marking(indicators, 0.5));
+  EXPECT_EQ(std::vector< bool >({false, true, true, true}), doerfler_marking(indicators, 0.75));
+  EXPECT_EQ(std::vector< bool >({true, true, true, true}), doerfler_marking(indicators, 1.0));
+  // compare against all subsets
+  const std::vector< double > values = {0.05, 0.3, 0.01, 0.12, 0.12, 0.2, 0.07, 0.13};
+  const double total = std::accumulate(values.begin(), values.end(), 0.0);
+  for (const double theta : {0.1, 0.25, 0.5, 0.8, 0.95}) {
+    const auto marked = doerfler_marking(values, theta);
+    double marked_sum = 0.0;
+    for (size_t ii = 0; ii < values.size(); ++ii)
+      if (marked[ii])
+        marked_sum += values[ii];
+    EXPECT_GE(marked_sum, theta * total) << "theta = " << theta;
+    size_t minimal_size = values.size();
+    for (size_t subset = 0; subset < (size_t(1) << values.size()); ++subset) {
+      double sum = 0.0;
+      size_t size = 0;
+      for (size_t ii = 0; ii < values.size(); ++ii)
+        if (subset & (size_t(1) << ii)) {
+          sum += values[ii];
+          ++size;
+        }
+      if (sum >= theta * total)
+        minimal_size = std::min(minimal_size, size);
+    }
+    EXPECT_EQ(minimal_size, size_t(std::count(marked.begin(), marked.end(), true))) << "theta = " << theta;
+  }
+} // TEST(AdaptiveDriver, doerfler_marking_is_minimal)
+
+TEST(AdaptiveDriver, reduces_the_estimate)
+{
+  TestCaseType test_case(0);
+  auto config = DriverType::default_config();
+  config.set("max_steps", "4", /*overwrite=*/true);
+  DriverType driver(test_case, test_case.boundary_info(), test_case.problem(), config);
+  const auto& steps = driver.run();
+  ASSERT_EQ(size_t(4), steps.size());
+  for (size_t ii = 1; ii < steps.size(); ++ii) {
+    EXPECT_GT(steps[ii].num_entities, steps[ii - 1].num_entities) << "step " << ii;
+    EXPECT_GT(steps[ii].num_dofs, steps[ii - 1].num_dofs) << "step " << ii;
+  }
+  EXPECT_LT(steps.back().estimate, steps.front().estimate);
+  EXPECT_EQ(steps.back().num_dofs, driver.solution().size());
+} // TEST(AdaptiveDriver, reduces_the_estimate)
+
+
+#else // HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
+
+
+TEST(DISABLED_PiecewiseLinearTransfer, is_exact_for_linear_functions)
+{
+  std::cerr << "You are missing dune-fem or alugrid!" << std::endl;
+}
+TEST(DISABLED_AdaptiveDriver, doerfler_marking_is_minimal) {}
+TEST(DISABLED_AdaptiveDriver, reduces_the_estimate) {}
+
+
+#endif // HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
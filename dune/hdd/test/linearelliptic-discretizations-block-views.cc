@@ -0,0 +1,157 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
+# define DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
+#endif
+
+// This one has to come first (includes the config.h)!
+#include <dune/stuff/test/main.hxx>
+
+#if HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
+# include <random>
+# include <vector>
+
+# include <dune/grid/alugrid.hh>
+
+# include <dune/pymor/parameters/base.hh>
+
+# include <dune/hdd/linearelliptic/testcases/OS2015.hh>
+
+# include "linearelliptic-block-swipdg.hh"
+
+using namespace Dune;
+using namespace HDD;
+
+
+typedef ALUGrid< 2, 2, simplex, conforming >                   GridType;
+typedef LinearElliptic::TestCases::OS2015::Academic< GridType > TestCaseType;
+typedef LinearElliptic::Tests::internal::DiscretizationBlockSWIPDG
+    < TestCaseType, 1, Stuff::LA::ChooseBackend::istl_sparse >::Type DiscretizationType;
+typedef DiscretizationType::VectorType                        VectorType;
+
+
+class SubdomainBlockViewTest
+  : public ::testing::Test
+{
+protected:
+  SubdomainBlockViewTest()
+    : test_case_({{"mu_hat", Pymor::Parameter("mu", 0.1)},
+                  {"mu_bar", Pymor::Parameter("mu", 1)},
+                  {"mu",     Pymor::Parameter("mu", 0.5)}},
+                 "[2 2 1]")
+    , discretization_(*test_case_.level_provider(0), test_case_.boundary_info(), test_case_.problem())
+    , num_subdomains_(size_t(discretization_.num_subdomains()))
+  {
+    discretization_.init();
+  }
+
+  VectorType random_vector() const
+  {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution< double > distribution(-1.0, 1.0);
+    VectorType ret = discretization_.create_vector();
+    for (size_t ii = 0; ii < ret.size(); ++ii)
+      ret.set_entry(ii, distribution(generator));
+    return ret;
+  }
+
+  static void expect_equal(const VectorType& expected, const VectorType& actual)
+  {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t ii = 0; ii < expected.size(); ++ii)
+      EXPECT_EQ(expected.get_entry(ii), actual.get_entry(ii)) << "entry " << ii;
+  }
+
+  const TestCaseType test_case_;
+  DiscretizationType discretization_;
+  const size_t num_subdomains_;
+}; // class SubdomainBlockViewTest
+
+
+TEST_F(SubdomainBlockViewTest, localize_and_globalize_are_inverse)
+{
+  const auto global_vector = random_vector();
+  std::vector< VectorType > local_vectors;
+  size_t offset = 0;
+  for (size_t ss = 0; ss < num_subdomains_; ++ss) {
+    local_vectors.emplace_back(discretization_.localize_vector(global_vector, ss));
+    const auto view = discretization_.local_view(global_vector, ss);
+    EXPECT_EQ(offset, view.offset());
+    EXPECT_EQ(discretization_.block_offset(ss), view.offset());
+    ASSERT_EQ(local_vectors[ss].size(), view.size());
+    for (size_t ii = 0; ii < view.size(); ++ii)
+      EXPECT_EQ(global_vector.get_entry(offset + ii), view.get_entry(ii));
+    EXPECT_DOUBLE_EQ(local_vectors[ss].dot(local_vectors[ss]), view.dot(local_vectors[ss]));
+    // the overload without allocation has to give the same
+    VectorType local_vector = discretization_.get_local_discretization(ss).create_vector();
+    discretization_.localize_vector(global_vector, ss, local_vector);
+    expect_equal(local_vectors[ss], local_vector);
+    offset += view.size();
+  }
+  EXPECT_EQ(global_vector.size(), offset);
+  expect_equal(global_vector, discretization_.globalize_vectors(local_vectors));
+  VectorType globalized = random_vector();
+  globalized.scal(2.0);
+  discretization_.globalize_vectors(local_vectors, globalized);
+  expect_equal(global_vector, globalized);
+  // wrong sizes are rejected
+  VectorType too_small(1);
+  EXPECT_THROW(discretization_.localize_vector(too_small, 0), Stuff::Exceptions::index_out_of_range);
+  EXPECT_THROW(discretization_.localize_vector(global_vector, 0, too_small), Stuff::Exceptions::wrong_input_given);
+  EXPECT_THROW(discretization_.local_view(global_vector, num_subdomains_), Stuff::Exceptions::index_out_of_range);
+  local_vectors.pop_back();
+  EXPECT_THROW(discretization_.globalize_vectors(local_vectors), Stuff::Exceptions::wrong_input_given);
+} // TEST_F(SubdomainBlockViewTest, localize_and_globalize_are_inverse)
+
+TEST_F(SubdomainBlockViewTest, writes_reach_the_global_vector)
+{
+  const auto original = random_vector();
+  auto global_vector = original.copy();
+  auto expected = original.copy();
+  // touch the first and last entry of each block, so that overlapping or shifted blocks would be detected
+  for (size_t ss = 0; ss < num_subdomains_; ++ss) {
+    auto view = discretization_.local_view(global_vector, ss);
+    ASSERT_GT(view.size(), 1u);
+    const size_t last = view.size() - 1;
+    view.set_entry(0, double(ss));
+    expected.set_entry(view.offset(), double(ss));
+    view.add_to_entry(last, 1.0);
+    expected.add_to_entry(view.offset() + last, 1.0);
+  }
+  expect_equal(expected, global_vector);
+  // assign() and axpy() only touch their own block
+  const size_t ss = num_subdomains_ - 1;
+  const auto local_vector = discretization_.localize_vector(original, 0);
+  auto first_view = discretization_.local_view(global_vector, 0);
+  first_view.assign(local_vector);
+  first_view.axpy(-1.0, local_vector);
+  discretization_.local_view(global_vector, ss).axpy(2.0, discretization_.localize_vector(original, ss));
+  for (size_t ii = 0; ii < first_view.size(); ++ii)
+    EXPECT_EQ(0.0, global_vector.get_entry(ii));
+  expect_equal(discretization_.localize_vector(expected, 1), discretization_.localize_vector(global_vector, 1));
+  const auto last_block = discretization_.localize_vector(global_vector, ss);
+  for (size_t ii = 0; ii < last_block.size(); ++ii)
+    EXPECT_DOUBLE_EQ(expected.get_entry(discretization_.block_offset(ss) + ii)
+                     + 2.0*original.get_entry(discretization_.block_offset(ss) + ii),
+                     last_block.get_entry(ii));
+  // copy_to() copies out of the view
+  VectorType copied = discretization_.get_local_discretization(ss).create_vector();
+  discretization_.local_view(global_vector, ss).copy_to(copied);
+  expect_equal(last_block, copied);
+} // TEST_F(SubdomainBlockViewTest, writes_reach_the_global_vector)
+
+
+#else // HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
+
+
+TEST(DISABLED_SubdomainBlockViewTest, localize_and_globalize_are_inverse)
+{
+  std::cerr << "You are missing dune-fem or dune-grid-multiscale or alugrid!" << std::endl;
+}
+TEST(DISABLED_SubdomainBlockViewTest, writes_reach_the_global_vector) {}
+
+
+#endif // HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
@@ -0,0 +1,210 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
+# define DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
+#endif
+
+// This one has to come first (includes the config.h)!
+#include <dune/stuff/test/main.hxx>
+
+#if HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
+# include <algorithm>
+# include <cmath>
+# include <cstdio>
+# include <string>
+# include <vector>
+
+# include <dune/grid/alugrid.hh>
+
+# include <dune/stuff/common/exceptions.hh>
+
+# include <dune/pymor/parameters/base.hh>
+
+# include <dune/hdd/linearelliptic/discretizations/swipdg.hh>
+# include <dune/hdd/linearelliptic/testcases/OS2015.hh>
+
+# include "linearelliptic-block-swipdg.hh"
+
+using namespace Dune;
+using namespace HDD;
+
+
+typedef ALUGrid< 2, 2, simplex, conforming >                   GridType;
+typedef LinearElliptic::TestCases::OS2015::Academic< GridType > TestCaseType;
+typedef LinearElliptic::Discretizations::SWIPDG< GridType, Stuff::Grid::ChooseLayer::leaf, double, 1, 1,
+                                                 GDT::ChooseSpaceBackend::fem,
+                                                 Stuff::LA::ChooseBackend::istl_sparse > SWIPDGType;
+typedef LinearElliptic::Tests::internal::DiscretizationBlockSWIPDG
+    < TestCaseType, 1, Stuff::LA::ChooseBackend::istl_sparse >::Type BlockSWIPDGType;
+
+
+template< class OperatorType, class VectorType >
+double apply2(const OperatorType& op, const VectorType& uu, const VectorType& vv, const Pymor::Parameter& mu)
+{
+  return op.parametric() ? op.apply2(uu, vv, mu) : op.apply2(uu, vv);
+}
+
+
+class RenumberingTest
+  : public ::testing::Test
+{
+protected:
+  RenumberingTest()
+    : test_case_({{"mu_hat", Pymor::Parameter("mu", 0.1)},
+                  {"mu_bar", Pymor::Parameter("mu", 1)},
+                  {"mu",     Pymor::Parameter("mu", 0.5)}},
+                 "[2 2 1]")
+    , types_({"rcm", "hilbert"})
+    , filename_("linearelliptic_discretizations_renumbering_test.bin")
+  {}
+
+  ~RenumberingTest()
+  {
+    std::remove(filename_.c_str());
+  }
+
+  static void expect_permutation(const std::vector< size_t >& permutation, const size_t size)
+  {
+    ASSERT_EQ(size, permutation.size());
+    auto sorted = permutation;
+    std::sort(sorted.begin(), sorted.end());
+    for (size_t ii = 0; ii < size; ++ii)
+      ASSERT_EQ(ii, sorted[ii]);
+  }
+
+  static void expect_near(const double expected, const double actual)
+  {
+    EXPECT_NEAR(expected, actual, 1e-10 * std::max(1.0, std::abs(expected)));
+  }
+
+  /**
+   * \brief Solves accurately, the result of iterative solvers depends on the numbering otherwise.
+   */
+  template< class DiscretizationType >
+  static typename DiscretizationType::VectorType solve(const DiscretizationType& discretization,
+                                                       const Pymor::Parameter& mu)
+  {
+    auto options = discretization.solver_options();
+    if (options.has_key("precision"))
+      options.set("precision", "1e-14", /*overwrite=*/true);
+    auto solution = discretization.create_vector();
+    discretization.solve(options, solution, mu);
+    return solution;
+  } // ... solve(...)
+
+  /**
+   * \brief The solutions of the renumbered discretization have to coincide with the ones of the original one, once
+   *        converted to the numbering of the space.
+   */
+  template< class DiscretizationType >
+  void expect_same_solutions(const DiscretizationType& original, const DiscretizationType& renumbered) const
+  {
+    for (const double mu : {0.1, 0.5, 1.0}) {
+      const auto expected = solve(original, Pymor::Parameter("mu", mu));
+      const auto solution = solve(renumbered, Pymor::Parameter("mu", mu));
+      const double tolerance = 1e-10 * std::max(1.0, expected.sup_norm());
+      EXPECT_LE((expected - renumbered.to_space_numbering(solution)).sup_norm(), tolerance) << "for mu = " << mu;
+      EXPECT_LE((renumbered.from_space_numbering(expected) - solution).sup_norm(), tolerance) << "for mu = " << mu;
+      for (const auto& id : original.available_products())
+        expect_near(apply2(original.get_product(id), expected, expected, Pymor::Parameter("mu", mu)),
+                    apply2(renumbered.get_product(id), solution, solution, Pymor::Parameter("mu", mu)));
+    }
+  } // ... expect_same_solutions(...)
+
+  const TestCaseType test_case_;
+  const std::vector< std::string > types_;
+  const std::string filename_;
+}; // class RenumberingTest
+
+
+TEST_F(RenumberingTest, swipdg_solution_is_invariant)
+{
+  SWIPDGType original(*test_case_.level_provider(0), test_case_.boundary_info(), test_case_.problem(), 0, {"l2"});
+  original.init();
+  EXPECT_TRUE(original.permutation().empty());
+  for (const auto& type : types_) {
+    SWIPDGType renumbered(*test_case_.level_provider(0), test_case_.boundary_info(), test_case_.problem(), 0, {"l2"});
+    EXPECT_THROW(renumbered.renumber(type), Stuff::Exceptions::you_are_using_this_wrong); // <- not initialized
+    renumbered.init();
+    renumbered.renumber(type);
+    expect_permutation(renumbered.permutation(), renumbered.ansatz_space().mapper().size());
+    expect_same_solutions(original, renumbered);
+    EXPECT_THROW(renumbered.renumber(type), Stuff::Exceptions::you_are_using_this_wrong);
+  }
+  SWIPDGType other(*test_case_.level_provider(0), test_case_.boundary_info(), test_case_.problem(), 0);
+  other.init();
+  EXPECT_THROW(other.renumber("metis"), Stuff::Exceptions::wrong_input_given);
+  EXPECT_TRUE(other.permutation().empty());
+} // TEST_F(RenumberingTest, swipdg_solution_is_invariant)
+
+TEST_F(RenumberingTest, block_swipdg_solution_is_invariant)
+{
+  BlockSWIPDGType original(*test_case_.level_provider(0), test_case_.boundary_info(), test_case_.problem(), {"l2"});
+  original.init();
+  const Pymor::Parameter mu("mu", 0.5);
+  const auto expected = solve(original, mu);
+  for (const auto& type : types_) {
+    BlockSWIPDGType renumbered(*test_case_.level_provider(0), test_case_.boundary_info(), test_case_.problem(), {"l2"});
+    renumbered.init();
+    renumbered.renumber(type);
+    expect_permutation(renumbered.permutation(), renumbered.ansatz_space().mapper().size());
+    expect_same_solutions(original, renumbered);
+    // the DoFs stay in their subdomain blocks, renumbered within each block as the local discretization
+    const auto solution = solve(renumbered, mu);
+    for (size_t ss = 0; ss < size_t(original.num_subdomains()); ++ss) {
+      EXPECT_EQ(original.block_offset(ss), renumbered.block_offset(ss));
+      const auto& local_discretization = *renumbered.local_discretizations()[ss];
+      expect_permutation(local_discretization.permutation(), local_discretization.ansatz_space().mapper().size());
+      const auto expected_uu = original.localize_vector(expected, ss);
+      const auto uu = renumbered.localize_vector(solution, ss);
+      EXPECT_LE((expected_uu - local_discretization.to_space_numbering(uu)).sup_norm(),
+                1e-10 * std::max(1.0, expected_uu.sup_norm()))
+          << "on subdomain " << ss;
+      // as are the local and coupling operators (used by the estimators)
+      expect_near(apply2(original.get_local_operator(ss), expected_uu, expected_uu, mu),
+                  apply2(renumbered.get_local_operator(ss), uu, uu, mu));
+      for (const auto& nn : original.neighbouring_subdomains(ss)) {
+        const auto expected_vv = original.localize_vector(expected, nn);
+        const auto vv = renumbered.localize_vector(solution, nn);
+        expect_near(apply2(original.get_coupling_operator(ss, nn), expected_uu, expected_vv, mu),
+                    apply2(renumbered.get_coupling_operator(ss, nn), uu, vv, mu));
+      }
+    }
+    EXPECT_THROW(renumbered.renumber(type), Stuff::Exceptions::you_are_using_this_wrong);
+  }
+} // TEST_F(RenumberingTest, block_swipdg_solution_is_invariant)
+
+TEST_F(RenumberingTest, block_swipdg_round_trip)
+{
+  BlockSWIPDGType renumbered(*test_case_.level_provider(0), test_case_.boundary_info(), test_case_.problem());
+  renumbered.init();
+  renumbered.renumber("rcm");
+  renumbered.save(filename_);
+  BlockSWIPDGType loaded(*test_case_.level_provider(0), test_case_.boundary_info(), test_case_.problem());
+  ASSERT_TRUE(loaded.load(filename_));
+  EXPECT_EQ(renumbered.permutation(), loaded.permutation());
+  for (size_t ss = 0; ss < size_t(renumbered.num_subdomains()); ++ss)
+    EXPECT_EQ(renumbered.local_discretizations()[ss]->permutation(), loaded.local_discretizations()[ss]->permutation())
+        << "on subdomain " << ss;
+  const Pymor::Parameter mu("mu", 0.5);
+  const auto expected = solve(renumbered, mu);
+  EXPECT_LE((expected - solve(loaded, mu)).sup_norm(), 1e-12 * std::max(1.0, expected.sup_norm()));
+  EXPECT_THROW(loaded.renumber("rcm"), Stuff::Exceptions::you_are_using_this_wrong);
+} // TEST_F(RenumberingTest, block_swipdg_round_trip)
+
+
+#else // HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
+
+
+TEST(DISABLED_RenumberingTest, swipdg_solution_is_invariant)
+{
+  std::cerr << "You are missing dune-fem or dune-grid-multiscale or alugrid!" << std::endl;
+}
+TEST(DISABLED_RenumberingTest, block_swipdg_solution_is_invariant) {}
+TEST(DISABLED_RenumberingTest, block_swipdg_round_trip) {}
+
+
+#endif // HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
@@ -0,0 +1,204 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
+# define DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
+#endif
+
+// This one has to come first (includes the config.h)!
+#include <dune/stuff/test/main.hxx>
+
+#if HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
+# include <algorithm>
+# include <cmath>
+# include <cstdio>
+# include <random>
+# include <string>
+# include <vector>
+
+# include <dune/grid/alugrid.hh>
+
+# include <dune/stuff/common/exceptions.hh>
+
+# include <dune/pymor/parameters/base.hh>
+
+# include <dune/hdd/linearelliptic/discretizations/swipdg.hh>
+# include <dune/hdd/linearelliptic/testcases/OS2015.hh>
+
+# include "linearelliptic-block-swipdg.hh"
+
+using namespace Dune;
+using namespace HDD;
+
+
+typedef ALUGrid< 2, 2, simplex, conforming >                   GridType;
+typedef LinearElliptic::TestCases::OS2015::Academic< GridType > TestCaseType;
+typedef LinearElliptic::Discretizations::SWIPDG< GridType, Stuff::Grid::ChooseLayer::leaf, double, 1, 1,
+                                                 GDT::ChooseSpaceBackend::fem,
+                                                 Stuff::LA::ChooseBackend::istl_sparse > SWIPDGType;
+typedef LinearElliptic::Tests::internal::DiscretizationBlockSWIPDG
+    < TestCaseType, 1, Stuff::LA::ChooseBackend::istl_sparse >::Type BlockSWIPDGType;
+
+
+template< class OperatorType, class VectorType >
+double apply2(const OperatorType& op, const VectorType& uu, const VectorType& vv, const Pymor::Parameter& mu)
+{
+  return op.parametric() ? op.apply2(uu, vv, mu) : op.apply2(uu, vv);
+}
+
+template< class FunctionalType, class VectorType >
+double apply(const FunctionalType& functional, const VectorType& uu, const Pymor::Parameter& mu)
+{
+  return functional.parametric() ? functional.apply(uu, mu) : functional.apply(uu);
+}
+
+
+class SerializationTest
+  : public ::testing::Test
+{
+protected:
+  SerializationTest()
+    : test_case_({{"mu_hat", Pymor::Parameter("mu", 0.1)},
+                  {"mu_bar", Pymor::Parameter("mu", 1)},
+                  {"mu",     Pymor::Parameter("mu", 0.5)}},
+                 "[2 2 1]")
+    , mu_("mu", 0.3)
+    , filename_("linearelliptic_discretizations_serialization_test.bin")
+  {}
+
+  ~SerializationTest()
+  {
+    std::remove(filename_.c_str());
+  }
+
+  template< class DiscretizationType >
+  std::vector< typename DiscretizationType::VectorType > random_vectors(const DiscretizationType& discretization) const
+  {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution< double > distribution(-1.0, 1.0);
+    std::vector< typename DiscretizationType::VectorType > ret;
+    for (size_t ii = 0; ii < 2; ++ii) {
+      ret.emplace_back(discretization.create_vector());
+      for (size_t jj = 0; jj < ret.back().size(); ++jj)
+        ret.back().set_entry(jj, distribution(generator));
+    }
+    return ret;
+  } // ... random_vectors(...)
+
+  static void expect_near(const double expected, const double actual)
+  {
+    EXPECT_NEAR(expected, actual, 1e-12 * std::max(1.0, std::abs(expected)));
+  }
+
+  /**
+   * \brief The loaded discretization has to behave exactly as the assembled one.
+   */
+  template< class DiscretizationType >
+  void expect_equal(const DiscretizationType& assembled, const DiscretizationType& loaded) const
+  {
+    ASSERT_EQ(assembled.parameter_type(), loaded.parameter_type());
+    const auto vectors = random_vectors(assembled);
+    const auto& uu = vectors[0];
+    const auto& vv = vectors[1];
+    expect_near(apply2(assembled.get_operator(), uu, vv, mu_), apply2(loaded.get_operator(), uu, vv, mu_));
+    expect_near(apply(assembled.get_rhs(), uu, mu_), apply(loaded.get_rhs(), uu, mu_));
+    ASSERT_EQ(assembled.available_products(), loaded.available_products());
+    for (const auto& id : assembled.available_products())
+      expect_near(apply2(assembled.get_product(id), uu, vv, mu_), apply2(loaded.get_product(id), uu, vv, mu_));
+    auto expected_solution = assembled.create_vector();
+    assembled.solve(expected_solution, mu_);
+    auto solution = loaded.create_vector();
+    loaded.solve(solution, mu_);
+    EXPECT_LE((expected_solution - solution).sup_norm(), 1e-12 * std::max(1.0, expected_solution.sup_norm()));
+  } // ... expect_equal(...)
+
+  const TestCaseType test_case_;
+  const Pymor::Parameter mu_;
+  const std::string filename_;
+}; // class SerializationTest
+
+
+TEST_F(SerializationTest, swipdg_round_trip)
+{
+  SWIPDGType assembled(*test_case_.level_provider(0), test_case_.boundary_info(), test_case_.problem(), 0, {"l2"});
+  assembled.init();
+  assembled.save(filename_);
+  SWIPDGType loaded(*test_case_.level_provider(0), test_case_.boundary_info(), test_case_.problem(), 0, {"l2"});
+  ASSERT_TRUE(loaded.load(filename_));
+  loaded.init(); // <- a no-op after load()
+  expect_equal(assembled, loaded);
+} // TEST_F(SerializationTest, swipdg_round_trip)
+
+TEST_F(SerializationTest, block_swipdg_round_trip)
+{
+  BlockSWIPDGType assembled(*test_case_.level_provider(0), test_case_.boundary_info(), test_case_.problem(), {"l2"});
+  assembled.init();
+  assembled.save(filename_);
+  BlockSWIPDGType loaded(*test_case_.level_provider(0), test_case_.boundary_info(), test_case_.problem(), {"l2"});
+  ASSERT_TRUE(loaded.load(filename_));
+  loaded.init(); // <- a no-op after load()
+  expect_equal(assembled, loaded);
+  // the local and coupling containers are restored as well
+  ASSERT_EQ(assembled.num_subdomains(), loaded.num_subdomains());
+  const auto vectors = random_vectors(assembled);
+  for (size_t ss = 0; ss < size_t(assembled.num_subdomains()); ++ss) {
+    const auto uu = assembled.localize_vector(vectors[0], ss);
+    const auto vv = assembled.localize_vector(vectors[1], ss);
+    expect_near(apply2(assembled.get_local_operator(ss), uu, vv, mu_),
+                apply2(loaded.get_local_operator(ss), uu, vv, mu_));
+    expect_near(apply(assembled.get_local_functional(ss), uu, mu_), apply(loaded.get_local_functional(ss), uu, mu_));
+    expect_near(apply2(assembled.get_local_discretization(ss).get_operator(), uu, vv, mu_),
+                apply2(loaded.get_local_discretization(ss).get_operator(), uu, vv, mu_));
+    for (const auto& nn : assembled.neighbouring_subdomains(ss)) {
+      const auto ww = assembled.localize_vector(vectors[1], nn);
+      expect_near(apply2(assembled.get_coupling_operator(ss, nn), uu, ww, mu_),
+                  apply2(loaded.get_coupling_operator(ss, nn), uu, ww, mu_));
+    }
+  }
+} // TEST_F(SerializationTest, block_swipdg_round_trip)
+
+TEST_F(SerializationTest, rejects_other_problem)
+{
+  // both problems are of the same type and lead to the same spaces, but differ in the diffusion
+  const auto problem = test_case_.problem().with_mu(Pymor::Parameter("mu", 0.3));
+  const auto other_problem = test_case_.problem().with_mu(Pymor::Parameter("mu", 0.7));
+  SWIPDGType assembled(*test_case_.level_provider(0), test_case_.boundary_info(), *problem, 0);
+  assembled.init();
+  assembled.save(filename_);
+  SWIPDGType other(*test_case_.level_provider(0), test_case_.boundary_info(), *other_problem, 0);
+  EXPECT_THROW(other.load(filename_), Stuff::Exceptions::wrong_input_given);
+  SWIPDGType same(*test_case_.level_provider(0), test_case_.boundary_info(), *problem, 0);
+  EXPECT_TRUE(same.load(filename_));
+} // TEST_F(SerializationTest, rejects_other_problem)
+
+TEST_F(SerializationTest, rejects_other_grid_and_type)
+{
+  BlockSWIPDGType block(*test_case_.level_provider(0), test_case_.boundary_info(), test_case_.problem());
+  block.init();
+  block.save(filename_);
+  SWIPDGType swipdg(*test_case_.level_provider(0), test_case_.boundary_info(), test_case_.problem(), 0);
+  EXPECT_THROW(swipdg.load(filename_), Stuff::Exceptions::wrong_input_given);
+  swipdg.init();
+  swipdg.save(filename_);
+  SWIPDGType refined(*test_case_.reference_provider(), test_case_.boundary_info(), test_case_.problem(), 0);
+  EXPECT_THROW(refined.load(filename_), Stuff::Exceptions::wrong_input_given);
+  std::remove(filename_.c_str());
+  EXPECT_FALSE(refined.load(filename_));
+} // TEST_F(SerializationTest, rejects_other_grid_and_type)
+
+
+#else // HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
+
+
+TEST(DISABLED_SerializationTest, swipdg_round_trip)
+{
+  std::cerr << "You are missing dune-fem or dune-grid-multiscale or alugrid!" << std::endl;
+}
+TEST(DISABLED_SerializationTest, block_swipdg_round_trip) {}
+TEST(DISABLED_SerializationTest, rejects_other_problem) {}
+TEST(DISABLED_SerializationTest, rejects_other_grid_and_type) {}
+
+
+#endif // HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
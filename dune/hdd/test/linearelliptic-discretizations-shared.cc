@@ -0,0 +1,170 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
+# define DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
+#endif
+
+// This one has to come first (includes the config.h)!
+#include <dune/stuff/test/main.hxx>
+
+#if HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
+# include <algorithm>
+# include <cmath>
+# include <cstdio>
+# include <string>
+
+# include <dune/grid/alugrid.hh>
+
+# include <dune/stuff/common/exceptions.hh>
+
+# include <dune/pymor/parameters/base.hh>
+
+# include <dune/hdd/linearelliptic/discretizations/swipdg.hh>
+# include <dune/hdd/linearelliptic/testcases/OS2015.hh>
+
+# include "linearelliptic-block-swipdg.hh"
+
+using namespace Dune;
+using namespace HDD;
+
+
+typedef ALUGrid< 2, 2, simplex, conforming >                   GridType;
+typedef LinearElliptic::TestCases::OS2015::Academic< GridType > TestCaseType;
+typedef LinearElliptic::Discretizations::SWIPDG< GridType, Stuff::Grid::ChooseLayer::leaf, double, 1, 1,
+                                                 GDT::ChooseSpaceBackend::fem,
+                                                 Stuff::LA::ChooseBackend::istl_sparse > SWIPDGType;
+typedef LinearElliptic::Tests::internal::DiscretizationBlockSWIPDG
+    < TestCaseType, 1, Stuff::LA::ChooseBackend::istl_sparse >::Type BlockSWIPDGType;
+
+
+class SharedTest
+  : public ::testing::Test
+{
+protected:
+  SharedTest()
+    : test_case_({{"mu_hat", Pymor::Parameter("mu", 0.1)},
+                  {"mu_bar", Pymor::Parameter("mu", 1)},
+                  {"mu",     Pymor::Parameter("mu", 0.5)}},
+                 "[2 2 1]")
+    , filename_("linearelliptic_discretizations_shared_test.bin")
+  {}
+
+  ~SharedTest()
+  {
+    std::remove(filename_.c_str());
+  }
+
+  /**
+   * \brief The attached discretization has to solve as the assembled one, for several parameters.
+   */
+  template< class DiscretizationType >
+  void expect_same_solutions(const DiscretizationType& assembled, const DiscretizationType& attached) const
+  {
+    ASSERT_EQ(assembled.parameter_type(), attached.parameter_type());
+    for (const double mu : {0.1, 0.5, 1.0}) {
+      auto expected_solution = assembled.create_vector();
+      assembled.solve(expected_solution, Pymor::Parameter("mu", mu));
+      auto solution = attached.create_vector();
+      attached.solve(solution, Pymor::Parameter("mu", mu));
+      EXPECT_LE((expected_solution - solution).sup_norm(), 1e-10 * std::max(1.0, expected_solution.sup_norm()))
+          << "for mu = " << mu;
+    }
+  } // ... expect_same_solutions(...)
+
+  template< class DiscretizationType >
+  void expect_matrix_is_unavailable(DiscretizationType& attached) const
+  {
+    EXPECT_THROW(attached.get_operator(), Stuff::Exceptions::you_are_using_this_wrong);
+    EXPECT_THROW(attached.system_matrix(), Stuff::Exceptions::you_are_using_this_wrong);
+    EXPECT_THROW(static_cast< const DiscretizationType& >(attached).system_matrix(),
+                 Stuff::Exceptions::you_are_using_this_wrong);
+    EXPECT_THROW(attached.save(filename_ + ".saved"), Stuff::Exceptions::you_are_using_this_wrong);
+    EXPECT_THROW(attached.export_shared(filename_ + ".exported"), Stuff::Exceptions::you_are_using_this_wrong);
+    EXPECT_TRUE(attached.available_products().empty());
+  } // ... expect_matrix_is_unavailable(...)
+
+  const TestCaseType test_case_;
+  const std::string filename_;
+}; // class SharedTest
+
+
+TEST_F(SharedTest, swipdg_export_attach_solve)
+{
+  SWIPDGType assembled(*test_case_.level_provider(0), test_case_.boundary_info(), test_case_.problem(), 0, {"l2"});
+  EXPECT_FALSE(assembled.attach_shared(filename_));
+  assembled.init();
+  assembled.export_shared(filename_);
+  SWIPDGType attached(*test_case_.level_provider(0), test_case_.boundary_info(), test_case_.problem(), 0, {"l2"});
+  ASSERT_TRUE(attached.attach_shared(filename_));
+  attached.init(); // <- a no-op after attach_shared()
+  expect_same_solutions(assembled, attached);
+  expect_matrix_is_unavailable(attached);
+  // the rhs is available
+  const auto expected_rhs = assembled.get_rhs();
+  const auto rhs = attached.get_rhs();
+  ASSERT_EQ(expected_rhs.parametric(), rhs.parametric());
+  if (!rhs.parametric()) {
+    auto vector = assembled.create_vector();
+    vector.set_all(1.0);
+    EXPECT_NEAR(expected_rhs.apply(vector), rhs.apply(vector), 1e-12 * std::max(1.0, std::abs(rhs.apply(vector))));
+  }
+} // TEST_F(SharedTest, swipdg_export_attach_solve)
+
+TEST_F(SharedTest, block_swipdg_export_attach_solve)
+{
+  BlockSWIPDGType assembled(*test_case_.level_provider(0), test_case_.boundary_info(), test_case_.problem());
+  assembled.init();
+  assembled.export_shared(filename_);
+  BlockSWIPDGType attached(*test_case_.level_provider(0), test_case_.boundary_info(), test_case_.problem());
+  ASSERT_TRUE(attached.attach_shared(filename_));
+  attached.init(); // <- a no-op after attach_shared()
+  expect_same_solutions(assembled, attached);
+  expect_matrix_is_unavailable(attached);
+  // the local and coupling operators (used by the estimators) are restored as well
+  const Pymor::Parameter mu("mu", 0.5);
+  auto solution = assembled.create_vector();
+  assembled.solve(solution, mu);
+  for (size_t ss = 0; ss < size_t(assembled.num_subdomains()); ++ss) {
+    const auto uu = assembled.localize_vector(solution, ss);
+    const double expected = assembled.get_local_operator(ss).apply2(uu, uu, mu);
+    EXPECT_NEAR(expected, attached.get_local_operator(ss).apply2(uu, uu, mu), 1e-12 * std::max(1.0, expected))
+        << "on subdomain " << ss;
+    for (const auto& nn : assembled.neighbouring_subdomains(ss)) {
+      const auto vv = assembled.localize_vector(solution, nn);
+      const double expected_coupling = assembled.get_coupling_operator(ss, nn).apply2(uu, vv, mu);
+      EXPECT_NEAR(expected_coupling,
+                  attached.get_coupling_operator(ss, nn).apply2(uu, vv, mu),
+                  1e-12 * std::max(1.0, std::abs(expected_coupling)))
+          << "on subdomain " << ss << ", neighbour " << nn;
+    }
+  }
+} // TEST_F(SharedTest, block_swipdg_export_attach_solve)
+
+TEST_F(SharedTest, rejects_other_discretization)
+{
+  SWIPDGType assembled(*test_case_.level_provider(0), test_case_.boundary_info(), test_case_.problem(), 0);
+  assembled.init();
+  assembled.export_shared(filename_);
+  const auto other_problem = test_case_.problem().with_mu(Pymor::Parameter("mu", 0.7));
+  SWIPDGType other(*test_case_.level_provider(0), test_case_.boundary_info(), *other_problem, 0);
+  EXPECT_THROW(other.attach_shared(filename_), Stuff::Exceptions::wrong_input_given);
+  BlockSWIPDGType block(*test_case_.level_provider(0), test_case_.boundary_info(), test_case_.problem());
+  EXPECT_THROW(block.attach_shared(filename_), Stuff::Exceptions::wrong_input_given);
+} // TEST_F(SharedTest, rejects_other_discretization)
+
+
+#else // HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
+
+
+TEST(DISABLED_SharedTest, swipdg_export_attach_solve)
+{
+  std::cerr << "You are missing dune-fem or dune-grid-multiscale or alugrid!" << std::endl;
+}
+TEST(DISABLED_SharedTest, block_swipdg_export_attach_solve) {}
+TEST(DISABLED_SharedTest, rejects_other_discretization) {}
+
+
+#endif // HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
@@ -0,0 +1,147 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
+# define DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
+#endif
+
+// This one has to come first (includes the config.h)!
+#include <dune/stuff/test/main.hxx>
+
+#if HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
+# include <cmath>
+# include <map>
+# include <random>
+# include <vector>
+
+# include <dune/grid/alugrid.hh>
+
+# include <dune/pymor/parameters/base.hh>
+
+# include <dune/hdd/linearelliptic/enrichment.hh>
+# include <dune/hdd/linearelliptic/testcases/OS2015.hh>
+
+# include "linearelliptic-block-swipdg.hh"
+
+using namespace Dune;
+using namespace HDD;
+
+
+typedef ALUGrid< 2, 2, simplex, conforming >                   GridType;
+typedef LinearElliptic::TestCases::OS2015::Academic< GridType > TestCaseType;
+typedef LinearElliptic::Tests::internal::DiscretizationBlockSWIPDG
+    < TestCaseType, 1, Stuff::LA::ChooseBackend::istl_sparse >::Type DiscretizationType;
+typedef DiscretizationType::VectorType                        VectorType;
+typedef LinearElliptic::LocalizedBasis< DiscretizationType >  LocalizedBasisType;
+
+
+class LocalizedBasisTest
+  : public ::testing::Test
+{
+protected:
+  LocalizedBasisTest()
+    : test_case_({{"mu_hat", Pymor::Parameter("mu", 0.1)},
+                  {"mu_bar", Pymor::Parameter("mu", 1)},
+                  {"mu",     Pymor::Parameter("mu", 0.5)}},
+                 "[2 2 1]")
+    , discretization_(*test_case_.level_provider(0), test_case_.boundary_info(), test_case_.problem(), {"l2"})
+  {
+    discretization_.init();
+  }
+
+  /**
+   * \brief Three random vectors per subdomain, followed by a linear combination of the first two.
+   */
+  std::map< size_t, std::vector< VectorType > > local_vectors()
+  {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution< double > distribution(-1.0, 1.0);
+    std::map< size_t, std::vector< VectorType > > ret;
+    for (size_t ss = 0; ss < size_t(discretization_.num_subdomains()); ++ss) {
+      auto& vectors = ret[ss];
+      for (size_t ii = 0; ii < 3; ++ii) {
+        vectors.emplace_back(discretization_.get_local_discretization(ss).create_vector());
+        for (size_t jj = 0; jj < vectors.back().size(); ++jj)
+          vectors.back().set_entry(jj, distribution(generator));
+      }
+      VectorType dependent = vectors[0];
+      dependent.axpy(2.0, vectors[1]);
+      vectors.emplace_back(dependent);
+    }
+    return ret;
+  } // ... local_vectors(...)
+
+  const TestCaseType test_case_;
+  DiscretizationType discretization_;
+}; // class LocalizedBasisTest
+
+
+TEST_F(LocalizedBasisTest, orthonormalizes_and_drops_dependent_vectors)
+{
+  LocalizedBasisType localized_basis(discretization_, "l2");
+  const auto added = localized_basis.extend(local_vectors(), 2);
+  for (size_t ss = 0; ss < localized_basis.num_subdomains(); ++ss) {
+    EXPECT_EQ(3u, added[ss]);
+    const auto product = discretization_.get_local_product(ss, "l2");
+    const auto& basis = localized_basis.local_basis(ss);
+    ASSERT_EQ(3u, basis.size());
+    for (size_t ii = 0; ii < basis.size(); ++ii)
+      for (size_t jj = 0; jj < basis.size(); ++jj)
+        EXPECT_NEAR(ii == jj ? 1.0 : 0.0, product.apply2(basis[ii], basis[jj]), 1e-12);
+  }
+  // already contained vectors are dropped
+  const auto added_again = localized_basis.extend(local_vectors(), 2);
+  for (const auto& num : added_again)
+    EXPECT_EQ(0u, num);
+} // TEST_F(LocalizedBasisTest, orthonormalizes_and_drops_dependent_vectors)
+
+TEST_F(LocalizedBasisTest, block_update_coincides_with_projection)
+{
+  const auto vectors = local_vectors();
+  // extend the first subdomain only, then all others (one at a time), to touch the coupling blocks from both sides
+  LocalizedBasisType incremental(discretization_, "l2");
+  incremental.extend({{0, vectors.at(0)}}, 4);
+  for (size_t ss = 1; ss < incremental.num_subdomains(); ++ss)
+    incremental.extend({{ss, vectors.at(ss)}}, 4);
+  LocalizedBasisType at_once(discretization_, "l2");
+  at_once.extend(vectors, 1);
+  ASSERT_EQ(at_once.size(), incremental.size());
+  // the reduced quantities have to coincide with the projection of the full ones
+  const auto mu = test_case_.parameters().at("mu");
+  const auto op = discretization_.get_operator();
+  const auto rhs = discretization_.get_rhs();
+  std::vector< VectorType > reduced_basis;
+  for (size_t ii = 0; ii < at_once.size(); ++ii) {
+    LocalizedBasisType::ReducedVectorType unit(at_once.size(), 0.0);
+    unit.set_entry(ii, 1.0);
+    reduced_basis.emplace_back(at_once.reconstruct(unit));
+  }
+  for (const auto& localized_basis : {&incremental, &at_once}) {
+    const auto reduced_operator = localized_basis->reduced_operator(mu);
+    const auto reduced_functional = localized_basis->reduced_functional(mu);
+    for (size_t ii = 0; ii < reduced_basis.size(); ++ii) {
+      const double expected_rhs = rhs.apply(reduced_basis[ii], mu);
+      EXPECT_NEAR(expected_rhs, reduced_functional.get_entry(ii), 1e-10 * std::max(1.0, std::abs(expected_rhs)));
+      for (size_t jj = 0; jj < reduced_basis.size(); ++jj) {
+        const double expected = op.apply2(reduced_basis[ii], reduced_basis[jj], mu);
+        EXPECT_NEAR(expected, reduced_operator.get_entry(ii, jj), 1e-10 * std::max(1.0, std::abs(expected)))
+            << "entry (" << ii << ", " << jj << ")";
+      }
+    }
+  }
+} // TEST_F(LocalizedBasisTest, block_update_coincides_with_projection)
+
+
+#else // HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
+
+
+TEST(DISABLED_LocalizedBasisTest, orthonormalizes_and_drops_dependent_vectors)
+{
+  std::cerr << "You are missing dune-fem or dune-grid-multiscale or alugrid!" << std::endl;
+}
+TEST(DISABLED_LocalizedBasisTest, block_update_coincides_with_projection) {}
+
+
+#endif // HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
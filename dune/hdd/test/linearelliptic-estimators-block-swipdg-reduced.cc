@@ -0,0 +1,108 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
+# define DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
+#endif
+
+// This one has to come first (includes the config.h)!
+#include <dune/stuff/test/main.hxx>
+
+#if HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
+# include <vector>
+
+# include <dune/grid/alugrid.hh>
+
+# include <dune/stuff/common/exceptions.hh>
+
+# include <dune/pymor/parameters/base.hh>
+
+# include <dune/hdd/linearelliptic/testcases/OS2015.hh>
+# include <dune/hdd/linearelliptic/estimators/block-swipdg-reduced.hh>
+
+# include "linearelliptic-block-swipdg.hh"
+
+using namespace Dune;
+using namespace HDD;
+
+
+typedef ALUGrid< 2, 2, simplex, conforming >                   GridType;
+typedef LinearElliptic::TestCases::OS2015::Academic< GridType > TestCaseType;
+typedef LinearElliptic::Tests::internal::DiscretizationBlockSWIPDG
+    < TestCaseType, 1, Stuff::LA::ChooseBackend::istl_sparse >  DiscretizationProviderType;
+typedef DiscretizationProviderType::Type                        DiscretizationType;
+typedef DiscretizationProviderType::EstimatorType               EstimatorType;
+typedef DiscretizationType::VectorType                          VectorType;
+typedef LinearElliptic::Estimators::ReducedBlockSWIPDG< DiscretizationType::AnsatzSpaceType,
+                                                        VectorType,
+                                                        DiscretizationType::ProblemType,
+                                                        GridType > ReducedEstimatorType;
+
+
+TEST(ReducedBlockSWIPDG, coincides_with_OS2014_for_reduced_solutions)
+{
+  using Pymor::Parameter;
+  const TestCaseType test_case({{"mu_hat", Parameter("mu", 0.5)},
+                                {"mu_bar", Parameter("mu", 1)},
+                                {"mu",     Parameter("mu", 1)}},
+                               "[2 2 1]");
+  const auto& grid_provider = test_case.level_provider(0);
+  DiscretizationType discretization(*grid_provider, test_case.boundary_info(), test_case.problem());
+  discretization.init();
+  // the reduced basis is given by a few snapshots
+  std::vector< VectorType > basis;
+  for (auto mu : {0.1, 0.5, 1.0}) {
+    basis.emplace_back(discretization.create_vector());
+    discretization.solve(basis.back(), Parameter("mu", mu));
+  }
+  const ReducedEstimatorType reduced_estimator(discretization.ansatz_space(),
+                                               discretization.problem(),
+                                               basis,
+                                               test_case.parameters());
+  ReducedEstimatorType::CoefficientsType coefficients(basis.size(), 0.0);
+  coefficients[0] = 0.3;
+  coefficients[1] = -0.2;
+  coefficients[2] = 0.9;
+  auto reduced_solution = discretization.create_vector();
+  for (size_t ii = 0; ii < basis.size(); ++ii)
+    reduced_solution.axpy(coefficients[ii], basis[ii]);
+  for (auto mu : {0.1, 0.7}) {
+    auto parameters = test_case.parameters();
+    parameters["mu"] = Parameter("mu", mu);
+    const double expected = EstimatorType::estimate(discretization.ansatz_space(),
+                                                    reduced_solution,
+                                                    discretization.problem(),
+                                                    "eta_OS2014",
+                                                    parameters);
+    EXPECT_NEAR(expected, reduced_estimator.estimate(coefficients, parameters), 1e-10 * expected) << "mu = " << mu;
+    const auto expected_local = EstimatorType::estimate_local(discretization.ansatz_space(),
+                                                              reduced_solution,
+                                                              discretization.problem(),
+                                                              "eta_OS2014",
+                                                              parameters);
+    const auto local = reduced_estimator.estimate_local(coefficients, parameters);
+    ASSERT_EQ(expected_local.size(), local.size());
+    for (size_t ss = 0; ss < local.size(); ++ss)
+      EXPECT_NEAR(expected_local[ss], local[ss], 1e-10 * std::max(1.0, std::abs(expected_local[ss])))
+          << "mu = " << mu << ", subdomain " << ss;
+  }
+  // the gram matrices were assembled for the offline mu_hat
+  auto parameters = test_case.parameters();
+  parameters["mu_hat"] = Parameter("mu", 0.1);
+  EXPECT_THROW(reduced_estimator.estimate(coefficients, parameters), Stuff::Exceptions::wrong_input_given);
+  EXPECT_THROW(reduced_estimator.estimate_local(coefficients, parameters), Stuff::Exceptions::wrong_input_given);
+} // TEST(ReducedBlockSWIPDG, coincides_with_OS2014_for_reduced_solutions)
+
+
+#else // HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
+
+
+TEST(DISABLED_ReducedBlockSWIPDG, coincides_with_OS2014_for_reduced_solutions)
+{
+  std::cerr << "You are missing dune-fem or dune-grid-multiscale or alugrid!" << std::endl;
+}
+
+
+#endif // HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
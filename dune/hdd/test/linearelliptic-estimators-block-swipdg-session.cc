@@ -0,0 +1,84 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
+# define DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
+#endif
+
+// This one has to come first (includes the config.h)!
+#include <dune/stuff/test/main.hxx>
+
+#if HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
+# include <algorithm>
+# include <cmath>
+
+# include <dune/grid/alugrid.hh>
+
+# include <dune/pymor/parameters/base.hh>
+
+# include <dune/hdd/linearelliptic/testcases/OS2015.hh>
+
+# include "linearelliptic-block-swipdg.hh"
+
+using namespace Dune;
+using namespace HDD;
+
+
+typedef ALUGrid< 2, 2, simplex, conforming >                   GridType;
+typedef LinearElliptic::TestCases::OS2015::Academic< GridType > TestCaseType;
+typedef LinearElliptic::Tests::internal::DiscretizationBlockSWIPDG
+    < TestCaseType, 1, Stuff::LA::ChooseBackend::istl_sparse > DiscretizationProviderType;
+typedef DiscretizationProviderType::Type                       DiscretizationType;
+typedef DiscretizationProviderType::EstimatorType              EstimatorType;
+typedef EstimatorType::SessionType                             SessionType;
+
+
+TEST(BlockSWIPDGSession, coincides_with_estimators)
+{
+  using Pymor::Parameter;
+  const TestCaseType test_case({{"mu_hat", Parameter("mu", 0.1)},
+                                {"mu_bar", Parameter("mu", 1)},
+                                {"mu",     Parameter("mu", 0.5)}},
+                               "[2 2 1]");
+  const auto& grid_provider = test_case.level_provider(0);
+  DiscretizationType discretization(*grid_provider, test_case.boundary_info(), test_case.problem());
+  discretization.init();
+  const auto& space = discretization.ansatz_space();
+  const auto& problem = discretization.problem();
+  const auto& parameters = test_case.parameters();
+  auto solution = discretization.create_vector();
+  discretization.solve(solution, parameters.at("mu"));
+  ASSERT_TRUE(SessionType::handles(problem));
+  SessionType session(space, solution, problem, parameters);
+  EXPECT_TRUE(session.matches(solution, parameters));
+  // the session covers all estimators
+  const auto session_types = SessionType::available_types();
+  for (const auto& type : EstimatorType::available())
+    EXPECT_NE(std::find(session_types.begin(), session_types.end(), type), session_types.end()) << type;
+  for (const auto& type : session_types) {
+    const double expected = EstimatorType::estimate(space, solution, problem, type, parameters);
+    EXPECT_NEAR(expected, session.estimate(type), 1e-12 * std::max(1.0, expected)) << type;
+  }
+  for (const auto& type : SessionType::available_local_types()) {
+    const auto expected = EstimatorType::estimate_local(space, solution, problem, type, parameters);
+    const auto actual = session.estimate_local(type);
+    ASSERT_EQ(expected.size(), actual.size()) << type;
+    for (size_t ss = 0; ss < actual.size(); ++ss)
+      EXPECT_NEAR(expected[ss], actual[ss], 1e-12 * std::max(1.0, std::abs(expected[ss])))
+          << type << ", subdomain " << ss;
+  }
+} // TEST(BlockSWIPDGSession, coincides_with_estimators)
+
+
+#else // HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
+
+
+TEST(DISABLED_BlockSWIPDGSession, coincides_with_estimators)
+{
+  std::cerr << "You are missing dune-fem or dune-grid-multiscale or alugrid!" << std::endl;
+}
+
+
+#endif // HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
@@ -0,0 +1,59 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+// This one has to come first (includes the config.h)!
+#include <dune/stuff/test/main.hxx>
+
+#include <memory>
+#include <vector>
+
+#include <dune/hdd/linearelliptic/estimators/data-terms-cache.hh>
+
+using namespace Dune;
+using namespace HDD;
+
+
+struct DataTermsCacheTestTag {};
+typedef LinearElliptic::Estimators::internal::DataTermsCache< DataTermsCacheTestTag, double > CacheType;
+
+
+TEST(DataTermsCache, computes_each_entry_once) {
+  CacheType::clear();
+  const auto data = std::make_shared< const int >(1);
+  size_t computations = 0;
+  const auto compute = [&]() { ++computations; return std::vector< double >(3, 1.0); };
+  const auto first = CacheType::get({data}, {Pymor::Parameter()}, compute, "key");
+  const auto second = CacheType::get({data}, {Pymor::Parameter()}, compute, "key");
+  EXPECT_EQ(1, computations);
+  EXPECT_EQ(first, second);
+  CacheType::get({data}, {Pymor::Parameter()}, compute, "other key");
+  EXPECT_EQ(2, computations);
+}
+
+TEST(DataTermsCache, drops_entries_of_destroyed_dependencies) {
+  CacheType::clear();
+  auto data = std::make_shared< const int >(1);
+  const auto values = CacheType::get({data}, {}, []() { return std::vector< double >(1, 2.0); });
+  EXPECT_EQ(1, CacheType::size());
+  data.reset();
+  CacheType::get({std::make_shared< const int >(2)}, {}, []() { return std::vector< double >(1, 3.0); });
+  EXPECT_EQ(1, CacheType::size());
+  // the values handed out stay valid
+  EXPECT_EQ(2.0, values->at(0));
+}
+
+TEST(DataTermsCache, is_bounded) {
+  CacheType::clear();
+  const auto data = std::make_shared< const int >(1);
+  size_t computations = 0;
+  const auto compute = [&]() { ++computations; return std::vector< double >(1, 1.0); };
+  for (size_t ii = 0; ii < 2*CacheType::max_entries; ++ii) {
+    CacheType::get({data}, {}, compute, std::to_string(ii));
+    // keep the first entry in use
+    CacheType::get({data}, {}, compute, "0");
+  }
+  EXPECT_EQ(CacheType::max_entries, CacheType::size());
+  EXPECT_EQ(2*CacheType::max_entries, computations);
+}
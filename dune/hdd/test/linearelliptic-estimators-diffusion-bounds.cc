@@ -0,0 +1,93 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
+# define DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
+#endif
+
+// This one has to come first (includes the config.h)!
+#include <dune/stuff/test/main.hxx>
+
+#if HAVE_DUNE_GRID_MULTISCALE && HAVE_ALUGRID
+# include <algorithm>
+# include <cmath>
+# include <type_traits>
+
+# include <dune/grid/alugrid.hh>
+
+# include <dune/stuff/common/ranges.hh>
+
+# include <dune/pymor/parameters/base.hh>
+
+# include <dune/hdd/linearelliptic/testcases/OS2015.hh>
+# include <dune/hdd/linearelliptic/estimators/diffusion-bounds.hh>
+
+using namespace Dune;
+using namespace HDD;
+
+
+typedef ALUGrid< 2, 2, simplex, conforming >                   GridType;
+typedef LinearElliptic::TestCases::OS2015::Academic< GridType > TestCaseType;
+
+
+// the diffusion factor 1 + (1 - mu) cos(1/2 pi x) cos(1/2 pi y) is not piecewise constant, its coefficient is
+// negative for mu > 1
+TEST(DiffusionBounds, coincide_with_direct_evaluation)
+{
+  using Pymor::Parameter;
+  const TestCaseType test_case({{"mu_hat", Parameter("mu", 1)},
+                                {"mu_bar", Parameter("mu", 1)},
+                                {"mu",     Parameter("mu", 1)}},
+                               "[2 2 1]");
+  const auto grid_view = test_case.reference_provider()->template global< Stuff::Grid::ChoosePartView::view >();
+  typedef typename std::remove_const< decltype(grid_view) >::type GridViewType;
+  typedef LinearElliptic::Estimators::DiffusionBounds< GridViewType, TestCaseType::ProblemType > DiffusionBoundsType;
+  const auto& problem = test_case.problem();
+  const DiffusionBoundsType bounds(grid_view, problem);
+  const auto& diffusion_tensor = *problem.diffusion_tensor()->affine_part();
+  for (auto mu_value : {0.1, 0.5, 1.0, 1.5}) {
+    const Parameter mu("mu", mu_value);
+    const auto problem_mu = problem.with_mu(mu);
+    const auto& diffusion_factor = *problem_mu->diffusion_factor()->affine_part();
+    const auto thetas = bounds.coefficients(problem.map_parameter(mu, "diffusion_factor"));
+    const auto min_ev = bounds.min_ev(problem.map_parameter(mu, "diffusion_factor"));
+    const auto max_ev = bounds.max_ev(problem.map_parameter(mu, "diffusion_factor"));
+    for (const auto& entity : Stuff::Common::entityRange(grid_view)) {
+      const size_t index = bounds.index(entity);
+      // the quadrature based values of the estimators
+      const double expected_min = LinearElliptic::Estimators::internal::compute_minimum(diffusion_factor, entity);
+      const double expected_max = LinearElliptic::Estimators::internal::compute_maximum(diffusion_factor, entity);
+      EXPECT_NEAR(expected_min, bounds.factor_min(index, thetas), 1e-13) << "mu = " << mu_value;
+      EXPECT_NEAR(expected_max, bounds.factor_max(index, thetas), 1e-13) << "mu = " << mu_value;
+      const double tensor_min = LinearElliptic::Estimators::internal::compute_minimum(diffusion_tensor, entity);
+      const double tensor_max = LinearElliptic::Estimators::internal::compute_maximum(diffusion_tensor, entity);
+      // the product of the intervals, which is the product of the lower bounds for positive values
+      const double lower_bound = std::min({expected_min * tensor_min, expected_min * tensor_max,
+                                           expected_max * tensor_min, expected_max * tensor_max});
+      EXPECT_NEAR(lower_bound, bounds.ev_lower_bound(index, thetas), 1e-13) << "mu = " << mu_value;
+      if (expected_min > 0.0)
+        EXPECT_NEAR(expected_min * tensor_min, bounds.ev_lower_bound(index, thetas), 1e-13) << "mu = " << mu_value;
+      // the center based values of min_diffusion_ev()
+      const auto& reference_element = ReferenceElements< double, 2 >::general(entity.type());
+      const double center_value = diffusion_factor.local_function(entity)->evaluate(reference_element.position(0, 0));
+      EXPECT_NEAR(std::min(center_value * tensor_min, center_value * tensor_max), min_ev[index], 1e-13)
+          << "mu = " << mu_value;
+      EXPECT_NEAR(std::max(center_value * tensor_min, center_value * tensor_max), max_ev[index], 1e-13)
+          << "mu = " << mu_value;
+    }
+  }
+} // TEST(DiffusionBounds, coincide_with_direct_evaluation)
+
+
+#else // HAVE_DUNE_GRID_MULTISCALE && HAVE_ALUGRID
+
+
+TEST(DISABLED_DiffusionBounds, coincide_with_direct_evaluation)
+{
+  std::cerr << "You are missing dune-grid-multiscale or alugrid!" << std::endl;
+}
+
+
+#endif // HAVE_DUNE_GRID_MULTISCALE && HAVE_ALUGRID
@@ -0,0 +1,138 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+// This one has to come first (includes the config.h)!
+#include <dune/stuff/test/main.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+
+#include <dune/hdd/linearelliptic/estimators/eigenvalues.hh>
+
+using namespace Dune;
+using namespace HDD;
+
+
+/**
+ * Returns Q diag(eigenvalues) Q^T for a random orthogonal Q (a product of Householder reflections).
+ */
+template< int d >
+FieldMatrix< double, d, d > matrix_with_eigenvalues(const FieldVector< double, d >& eigenvalues,
+                                                    std::mt19937& generator)
+{
+  std::uniform_real_distribution< double > distribution(-1.0, 1.0);
+  FieldMatrix< double, d, d > orthogonal(0.0);
+  for (int ii = 0; ii < d; ++ii)
+    orthogonal[ii][ii] = 1.0;
+  for (int rr = 0; rr < d; ++rr) {
+    FieldVector< double, d > vv(0.0);
+    for (int ii = 0; ii < d; ++ii)
+      vv[ii] = distribution(generator);
+    const double norm2 = vv.two_norm2();
+    if (norm2 < 1e-8)
+      continue;
+    // orthogonal = orthogonal * (I - 2 v v^T / |v|^2)
+    for (int ii = 0; ii < d; ++ii) {
+      double projection = 0.0;
+      for (int jj = 0; jj < d; ++jj)
+        projection += orthogonal[ii][jj] * vv[jj];
+      for (int jj = 0; jj < d; ++jj)
+        orthogonal[ii][jj] -= 2.0 * projection * vv[jj] / norm2;
+    }
+  }
+  FieldMatrix< double, d, d > ret(0.0);
+  for (int ii = 0; ii < d; ++ii)
+    for (int jj = 0; jj < d; ++jj)
+      for (int kk = 0; kk < d; ++kk)
+        ret[ii][jj] += orthogonal[ii][kk] * eigenvalues[kk] * orthogonal[jj][kk];
+  // make it exactly symmetric
+  for (int ii = 0; ii < d; ++ii)
+    for (int jj = ii + 1; jj < d; ++jj)
+      ret[jj][ii] = ret[ii][jj];
+  return ret;
+} // ... matrix_with_eigenvalues(...)
+
+
+template< int d >
+void check_eigenvalues(const FieldVector< double, d >& expected, const FieldMatrix< double, d, d >& matrix)
+{
+  const auto actual = LinearElliptic::Estimators::internal::symmetric_eigenvalues(matrix);
+  double scale = 1.0;
+  for (int ii = 0; ii < d; ++ii)
+    scale = std::max(scale, std::abs(expected[ii]));
+  for (int ii = 0; ii < d; ++ii)
+    EXPECT_NEAR(expected[ii], actual[ii], 1e-12 * scale) << "eigenvalue " << ii;
+} // ... check_eigenvalues(...)
+
+
+template< int d >
+void check_random_matrices()
+{
+  std::mt19937 generator(42);
+  std::uniform_real_distribution< double > distribution(-10.0, 10.0);
+  for (size_t run = 0; run < 100; ++run) {
+    FieldVector< double, d > eigenvalues(0.0);
+    for (int ii = 0; ii < d; ++ii)
+      eigenvalues[ii] = distribution(generator);
+    // include multiple eigenvalues
+    if (run % 3 == 0)
+      eigenvalues[d - 1] = eigenvalues[0];
+    std::sort(eigenvalues.begin(), eigenvalues.end());
+    check_eigenvalues< d >(eigenvalues, matrix_with_eigenvalues< d >(eigenvalues, generator));
+  }
+} // ... check_random_matrices(...)
+
+
+TEST(SymmetricEigenvalues, random_2x2) {
+  check_random_matrices< 2 >();
+}
+TEST(SymmetricEigenvalues, random_3x3) {
+  check_random_matrices< 3 >();
+}
+TEST(SymmetricEigenvalues, diagonal_and_scaled_identity) {
+  FieldMatrix< double, 3, 3 > matrix(0.0);
+  matrix[0][0] = 3.0;
+  matrix[1][1] = -1.0;
+  matrix[2][2] = 2.0;
+  FieldVector< double, 3 > expected(0.0);
+  expected[0] = -1.0;
+  expected[1] = 2.0;
+  expected[2] = 3.0;
+  check_eigenvalues< 3 >(expected, matrix);
+  for (int ii = 0; ii < 3; ++ii)
+    matrix[ii][ii] = 1e-3;
+  check_eigenvalues< 3 >(FieldVector< double, 3 >(1e-3), matrix);
+  FieldMatrix< double, 2, 2 > matrix_2d(0.0);
+  matrix_2d[0][0] = matrix_2d[1][1] = 5.0;
+  check_eigenvalues< 2 >(FieldVector< double, 2 >(5.0), matrix_2d);
+}
+TEST(SymmetricEigenvalues, strongly_anisotropic) {
+  std::mt19937 generator(4711);
+  FieldVector< double, 3 > eigenvalues(0.0);
+  eigenvalues[0] = 1e-6;
+  eigenvalues[1] = 1.0;
+  eigenvalues[2] = 1e6;
+  check_eigenvalues< 3 >(eigenvalues, matrix_with_eigenvalues< 3 >(eigenvalues, generator));
+}
+
+#if HAVE_EIGEN
+
+TEST(SymmetricEigenvalues, coincides_with_eigen) {
+  std::mt19937 generator(1);
+  std::uniform_real_distribution< double > distribution(-10.0, 10.0);
+  for (size_t run = 0; run < 100; ++run) {
+    FieldMatrix< double, 3, 3 > matrix(0.0);
+    for (int ii = 0; ii < 3; ++ii)
+      for (int jj = ii; jj < 3; ++jj)
+        matrix[ii][jj] = matrix[jj][ii] = distribution(generator);
+    check_eigenvalues< 3 >(LinearElliptic::Estimators::internal::general_eigenvalues(matrix), matrix);
+  }
+}
+
+#endif // HAVE_EIGEN
@@ -0,0 +1,94 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
+# define DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
+#endif
+
+// This one has to come first (includes the config.h)!
+#include <dune/stuff/test/main.hxx>
+
+#if HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
+# include <algorithm>
+# include <cmath>
+
+# include <dune/grid/alugrid.hh>
+
+# include <dune/pymor/parameters/base.hh>
+
+# include <dune/gdt/discretefunction/default.hh>
+# include <dune/gdt/playground/operators/fluxreconstruction.hh>
+
+# include <dune/hdd/linearelliptic/testcases/OS2015.hh>
+# include <dune/hdd/linearelliptic/estimators/flux-reconstruction.hh>
+
+# include "linearelliptic-block-swipdg.hh"
+
+using namespace Dune;
+using namespace HDD;
+
+
+typedef ALUGrid< 2, 2, simplex, conforming >                   GridType;
+typedef LinearElliptic::TestCases::OS2015::Academic< GridType > TestCaseType;
+typedef LinearElliptic::Tests::internal::DiscretizationBlockSWIPDG
+    < TestCaseType, 1, Stuff::LA::ChooseBackend::istl_sparse >::Type DiscretizationType;
+typedef DiscretizationType::VectorType                               VectorType;
+typedef LinearElliptic::Estimators::DiffusiveFluxReconstructionOperator
+    < DiscretizationType::AnsatzSpaceType, VectorType, DiscretizationType::ProblemType > OperatorType;
+
+
+TEST(DiffusiveFluxReconstructionOperator, coincides_with_gdt_reconstruction)
+{
+  using Pymor::Parameter;
+  const TestCaseType test_case({{"mu_hat", Parameter("mu", 1)},
+                                {"mu_bar", Parameter("mu", 1)},
+                                {"mu",     Parameter("mu", 1)}},
+                               "[2 2 1]");
+  const auto& grid_provider = test_case.level_provider(0);
+  DiscretizationType discretization(*grid_provider, test_case.boundary_info(), test_case.problem());
+  discretization.init();
+  const auto& space = discretization.ansatz_space();
+  const auto& problem = discretization.problem();
+  const auto reconstruction_operator = OperatorType::get(space, problem);
+  EXPECT_EQ(reconstruction_operator, OperatorType::get(space, problem));
+  auto solution = discretization.create_vector();
+  discretization.solve(solution, Parameter("mu", 0.5));
+  for (auto mu : {0.1, 0.5, 1.0}) {
+    const auto problem_mu = problem.with_mu(Parameter("mu", mu));
+    typedef DiscretizationType::ProblemType::DiffusionFactorType::NonparametricType DiffusionFactorType;
+    typedef DiscretizationType::ProblemType::DiffusionTensorType::NonparametricType DiffusionTensorType;
+    const GDT::Operators::DiffusiveFluxReconstruction< OperatorType::GridViewType,
+                                                       DiffusionFactorType,
+                                                       DiffusionTensorType >
+        reconstruction(space.grid_view(),
+                       *problem_mu->diffusion_factor()->affine_part(),
+                       *problem_mu->diffusion_tensor()->affine_part(),
+                       LinearElliptic::Estimators::internal::SWIPDG::over_integrate);
+    const GDT::ConstDiscreteFunction< DiscretizationType::AnsatzSpaceType, VectorType > solution_function(space,
+                                                                                                         solution);
+    OperatorType::RTN0DiscreteFunctionType expected(reconstruction_operator->range_space());
+    reconstruction.apply(solution_function, expected);
+    const auto actual = reconstruction_operator->apply(solution, Parameter("mu", mu));
+    ASSERT_EQ(expected.vector().size(), actual.size());
+    double max_value = 0.0;
+    for (size_t ii = 0; ii < actual.size(); ++ii)
+      max_value = std::max(max_value, std::abs(expected.vector().get_entry(ii)));
+    for (size_t ii = 0; ii < actual.size(); ++ii)
+      EXPECT_NEAR(expected.vector().get_entry(ii), actual.get_entry(ii), 1e-10 * max_value)
+          << "mu = " << mu << ", DoF " << ii;
+  }
+} // TEST(DiffusiveFluxReconstructionOperator, coincides_with_gdt_reconstruction)
+
+
+#else // HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
+
+
+TEST(DISABLED_DiffusiveFluxReconstructionOperator, coincides_with_gdt_reconstruction)
+{
+  std::cerr << "You are missing dune-fem or dune-grid-multiscale or alugrid!" << std::endl;
+}
+
+
+#endif // HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
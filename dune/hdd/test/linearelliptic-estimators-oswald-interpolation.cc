@@ -0,0 +1,84 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
+# define DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
+#endif
+
+// This one has to come first (includes the config.h)!
+#include <dune/stuff/test/main.hxx>
+
+#if HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
+# include <algorithm>
+# include <cmath>
+
+# include <dune/grid/alugrid.hh>
+
+# include <dune/pymor/parameters/base.hh>
+
+# include <dune/gdt/discretefunction/default.hh>
+# include <dune/gdt/operators/oswaldinterpolation.hh>
+
+# include <dune/hdd/linearelliptic/discretizations/swipdg.hh>
+# include <dune/hdd/linearelliptic/testcases/OS2015.hh>
+# include <dune/hdd/linearelliptic/estimators/oswald-interpolation.hh>
+
+using namespace Dune;
+using namespace HDD;
+
+
+typedef ALUGrid< 2, 2, simplex, conforming >                   GridType;
+typedef LinearElliptic::TestCases::OS2015::Academic< GridType > TestCaseType;
+typedef LinearElliptic::Discretizations::SWIPDG< GridType, Stuff::Grid::ChooseLayer::leaf, double, 1, 1,
+                                                 GDT::ChooseSpaceBackend::fem,
+                                                 Stuff::LA::ChooseBackend::istl_sparse > DiscretizationType;
+typedef DiscretizationType::AnsatzSpaceType                                               SpaceType;
+typedef DiscretizationType::VectorType                                                    VectorType;
+typedef LinearElliptic::Estimators::OswaldInterpolationOperator< SpaceType >              OperatorType;
+
+
+TEST(OswaldInterpolationOperator, coincides_with_gdt_oswald_interpolation)
+{
+  using Pymor::Parameter;
+  const TestCaseType test_case({{"mu_hat", Parameter("mu", 1)},
+                                {"mu_bar", Parameter("mu", 1)},
+                                {"mu",     Parameter("mu", 1)}},
+                               "[2 2 1]");
+  DiscretizationType discretization(*test_case.level_provider(0), test_case.boundary_info(), test_case.problem());
+  discretization.init();
+  const auto& space = discretization.ansatz_space();
+  auto solution = discretization.create_vector();
+  discretization.solve(solution, Parameter("mu", 0.5));
+  const GDT::ConstDiscreteFunction< SpaceType, VectorType > solution_function(space, solution);
+  for (const bool zero_boundary : {true, false}) {
+    const auto oswald_interpolation_operator = OperatorType::get(space, zero_boundary);
+    EXPECT_EQ(oswald_interpolation_operator, OperatorType::get(space, zero_boundary));
+    GDT::DiscreteFunction< SpaceType, VectorType > expected(space);
+    const GDT::Operators::OswaldInterpolation< SpaceType::GridViewType > gdt_operator(space.grid_view(),
+                                                                                       zero_boundary);
+    gdt_operator.apply(solution_function, expected);
+    const auto actual = oswald_interpolation_operator->apply(solution);
+    ASSERT_EQ(expected.vector().size(), actual.size());
+    double max_value = 0.0;
+    for (size_t ii = 0; ii < actual.size(); ++ii)
+      max_value = std::max(max_value, std::abs(expected.vector().get_entry(ii)));
+    for (size_t ii = 0; ii < actual.size(); ++ii)
+      EXPECT_NEAR(expected.vector().get_entry(ii), actual.get_entry(ii), 1e-12 * max_value)
+          << "zero_boundary = " << zero_boundary << ", DoF " << ii;
+  }
+  EXPECT_NE(OperatorType::get(space, true), OperatorType::get(space, false));
+} // TEST(OswaldInterpolationOperator, coincides_with_gdt_oswald_interpolation)
+
+
+#else // HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
+
+
+TEST(DISABLED_OswaldInterpolationOperator, coincides_with_gdt_oswald_interpolation)
+{
+  std::cerr << "You are missing dune-fem or dune-grid-multiscale or alugrid!" << std::endl;
+}
+
+
+#endif // HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
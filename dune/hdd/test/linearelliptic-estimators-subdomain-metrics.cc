@@ -0,0 +1,57 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+// This one has to come first (includes the config.h)!
+#include <dune/stuff/test/main.hxx>
+
+#include <random>
+#include <vector>
+
+#include <dune/common/fvector.hh>
+
+#include <dune/hdd/linearelliptic/estimators/subdomain-metrics.hh>
+
+using namespace Dune;
+using namespace HDD;
+
+
+template< int d >
+double brute_force_diameter(const std::vector< FieldVector< double, d > >& points)
+{
+  double ret = 0;
+  for (size_t ii = 0; ii < points.size(); ++ii)
+    for (size_t jj = 0; jj < points.size(); ++jj)
+      ret = std::max(ret, (points[ii] - points[jj]).two_norm());
+  return ret;
+}
+
+template< int d >
+void check_diameter()
+{
+  typedef LinearElliptic::Estimators::internal::Diameter< double, d > DiameterType;
+  std::mt19937 generator(42);
+  std::uniform_real_distribution< double > distribution(-1.0, 1.0);
+  for (size_t num_points : {1, 2, 3, 7, 100}) {
+    std::vector< FieldVector< double, d > > points(num_points);
+    for (auto& point : points)
+      for (size_t dd = 0; dd < d; ++dd)
+        point[dd] = distribution(generator);
+    // duplicate points, as the vertices of a subdomain are shared by several elements
+    auto duplicated = points;
+    duplicated.insert(duplicated.end(), points.begin(), points.end());
+    EXPECT_DOUBLE_EQ(brute_force_diameter< d >(points), DiameterType::compute(duplicated));
+  }
+} // ... check_diameter(...)
+
+
+TEST(SubdomainMetrics, diameter_1d) {
+  check_diameter< 1 >();
+}
+TEST(SubdomainMetrics, diameter_2d) {
+  check_diameter< 2 >();
+}
+TEST(SubdomainMetrics, diameter_3d) {
+  check_diameter< 3 >();
+}
@@ -0,0 +1,158 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+// This one has to come first (includes the config.h)!
+#include <dune/stuff/test/main.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <dune/grid/yaspgrid.hh>
+#if HAVE_ALUGRID
+# include <dune/grid/alugrid.hh>
+#endif
+
+#include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/grid/provider/cube.hh>
+
+#include <dune/hdd/linearelliptic/partitioning.hh>
+
+using namespace Dune;
+using namespace HDD;
+
+
+typedef YaspGrid< 2 >                                      GridType;
+typedef GridType::LeafGridView                             GridViewType;
+typedef GridType::Codim< 0 >::Entity                       EntityType;
+typedef LinearElliptic::GraphPartitioner< GridViewType >   PartitionerType;
+
+
+class GraphPartitionerTest
+  : public ::testing::Test
+{
+protected:
+  GraphPartitionerTest()
+  {
+    auto grid_cfg = Stuff::Grid::Providers::Cube< GridType >::default_config();
+    grid_cfg["lower_left"] = "[0 0]";
+    grid_cfg["upper_right"] = "[1 1]";
+    grid_cfg["num_elements"] = "[16 12]";
+    grid_provider_ = Stuff::Grid::Providers::Cube< GridType >::create(grid_cfg);
+  }
+
+  /**
+   * \brief Each subdomain has to contain elements, and their weights may only deviate from the average by the weight
+   *        of one element per level of bisection.
+   */
+  static void expect_balanced(const PartitionerType& partitioner,
+                              const std::vector< size_t >& partition,
+                              const size_t num_subdomains,
+                              const size_t max_element_weight)
+  {
+    const auto weights = partitioner.subdomain_weights(partition, num_subdomains);
+    size_t total_weight = 0;
+    for (const auto& weight : weights)
+      total_weight += weight;
+    const double average = double(total_weight) / num_subdomains;
+    const double tolerance = std::ceil(std::log2(double(num_subdomains))) * max_element_weight;
+    for (size_t ss = 0; ss < num_subdomains; ++ss) {
+      EXPECT_GT(weights[ss], 0u) << "subdomain " << ss << " of " << num_subdomains << " is empty";
+      EXPECT_LE(std::abs(weights[ss] - average), tolerance) << "subdomain " << ss << " of " << num_subdomains;
+    }
+  } // ... expect_balanced(...)
+
+  std::unique_ptr< Stuff::Grid::Providers::Cube< GridType > > grid_provider_;
+}; // class GraphPartitionerTest
+
+
+TEST_F(GraphPartitionerTest, bisection_is_balanced)
+{
+  const auto grid_view = grid_provider_->leaf_view();
+  const PartitionerType partitioner(grid_view);
+  for (size_t num_subdomains = 1; num_subdomains <= 9; ++num_subdomains) {
+    const auto partition = partitioner.partition(num_subdomains, "bisection");
+    ASSERT_EQ(size_t(grid_view.indexSet().size(0)), partition.size());
+    expect_balanced(partitioner, partition, num_subdomains, 1);
+  }
+  // two halves of 16x12 elements can not be separated by less than 12 faces
+  const auto halves = partitioner.partition(2, "bisection");
+  EXPECT_GE(partitioner.interface_faces(halves), 12u);
+  EXPECT_LE(partitioner.interface_faces(halves), 2*16u);
+  EXPECT_EQ(0u, partitioner.interface_faces(partitioner.partition(1, "bisection")));
+} // TEST_F(GraphPartitionerTest, bisection_is_balanced)
+
+TEST_F(GraphPartitionerTest, bisection_balances_weights)
+{
+  const auto grid_view = grid_provider_->leaf_view();
+  const PartitionerType partitioner(grid_view, [](const EntityType& entity) {
+    return entity.geometry().center()[0] < 0.5 ? size_t(1) : size_t(3);
+  });
+  for (size_t num_subdomains = 1; num_subdomains <= 9; ++num_subdomains)
+    expect_balanced(partitioner, partitioner.partition(num_subdomains, "bisection"), num_subdomains, 3);
+} // TEST_F(GraphPartitionerTest, bisection_balances_weights)
+
+TEST_F(GraphPartitionerTest, no_subdomain_is_empty)
+{
+  const auto grid_view = grid_provider_->leaf_view();
+  const size_t num_elements = grid_view.indexSet().size(0);
+  const PartitionerType partitioner(grid_view);
+  // as many subdomains as elements, for all backends (METIS leaves parts empty here, which has to be caught)
+  for (const std::string type : {std::string("bisection"), PartitionerType::backend()}) {
+    const auto partition = partitioner.partition(num_elements, type);
+    auto sorted = partition;
+    std::sort(sorted.begin(), sorted.end());
+    for (size_t ii = 0; ii < num_elements; ++ii)
+      EXPECT_EQ(ii, sorted[ii]) << type;
+  }
+  for (size_t num_subdomains = 1; num_subdomains <= 9; ++num_subdomains) {
+    const auto weights = partitioner.subdomain_weights(partitioner.partition(num_subdomains), num_subdomains);
+    EXPECT_EQ(0, std::count(weights.begin(), weights.end(), size_t(0)));
+  }
+} // TEST_F(GraphPartitionerTest, no_subdomain_is_empty)
+
+TEST_F(GraphPartitionerTest, rejects_wrong_input)
+{
+  const auto grid_view = grid_provider_->leaf_view();
+  const PartitionerType partitioner(grid_view);
+  EXPECT_THROW(partitioner.partition(0), Stuff::Exceptions::wrong_input_given);
+  EXPECT_THROW(partitioner.partition(grid_view.indexSet().size(0) + 1), Stuff::Exceptions::wrong_input_given);
+  EXPECT_THROW(partitioner.partition(2, "scotch"), Stuff::Exceptions::wrong_input_given);
+#if !DUNE_HDD_HAVE_METIS
+  EXPECT_THROW(partitioner.partition(2, "metis"), Stuff::Exceptions::wrong_input_given);
+#endif
+} // TEST_F(GraphPartitionerTest, rejects_wrong_input)
+
+
+#if HAVE_DUNE_GRID_MULTISCALE && HAVE_ALUGRID
+
+
+TEST(GraphPartitionedMsGridProvider, creates_the_subdomains)
+{
+  typedef ALUGrid< 2, 2, simplex, conforming >                             MsGridGridType;
+  typedef LinearElliptic::GraphPartitionedMsGridProvider< MsGridGridType > ProviderType;
+  auto config = ProviderType::default_config();
+  config["lower_left"] = "[0 0]";
+  config["upper_right"] = "[1 1]";
+  config["num_elements"] = "[8 8]";
+  config["num_subdomains"] = "5";
+  config["partitioner"] = "bisection";
+  const auto provider = ProviderType::create(config);
+  EXPECT_EQ(5u, provider->ms_grid()->size());
+  EXPECT_EQ(size_t(provider->grid().size(0)), size_t(provider->ms_grid()->globalGridView().indexSet().size(0)));
+} // TEST(GraphPartitionedMsGridProvider, creates_the_subdomains)
+
+
+#else // HAVE_DUNE_GRID_MULTISCALE && HAVE_ALUGRID
+
+
+TEST(DISABLED_GraphPartitionedMsGridProvider, creates_the_subdomains)
+{
+  std::cerr << "You are missing dune-grid-multiscale or alugrid!" << std::endl;
+}
+
+
+#endif // HAVE_DUNE_GRID_MULTISCALE && HAVE_ALUGRID
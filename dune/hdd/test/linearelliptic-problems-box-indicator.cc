@@ -0,0 +1,94 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+// This one has to come first (includes the config.h)!
+#include <dune/stuff/test/main.hxx>
+
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include <dune/common/fvector.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/stuff/grid/provider/cube.hh>
+#include <dune/stuff/playground/functions/indicator.hh>
+
+#include <dune/hdd/linearelliptic/problems/box-indicator.hh>
+
+using namespace Dune;
+using namespace HDD;
+
+
+typedef YaspGrid< 2 >                                                 GridType;
+typedef GridType::Codim< 0 >::Entity                                  E;
+typedef LinearElliptic::Problems::BoxIndicator< E, double, 2, double, 1 > BoxIndicatorType;
+typedef Stuff::Functions::DomainIndicator< E, double, 2, double, 1 >  DomainIndicatorType;
+typedef BoxIndicatorType::DomainType                                  DomainType;
+typedef BoxIndicatorType::RangeType                                   RangeType;
+typedef BoxIndicatorType::ValuesType                                  ValuesType;
+
+
+/**
+ * \brief Boxes of a 16x16 grid, the edges of which lie on, slightly below or slightly above the centers of its
+ *        entities, in various combinations; the later boxes overlap the earlier ones.
+ */
+ValuesType create_boxes()
+{
+  const std::vector< double > offsets = {0., 1e-15, -1e-15, 1e-13, -1e-13, 1e-9, -1e-9};
+  ValuesType boxes;
+  size_t ii = 0;
+  for (size_t xx = 0; xx < 14; xx += 3) {
+    for (size_t yy = 0; yy < 14; yy += 2) {
+      DomainType lower_left;
+      DomainType upper_right;
+      lower_left[0] = (2.*xx + 1.)/32. + offsets[ii % offsets.size()];
+      lower_left[1] = (2.*yy + 1.)/32. + offsets[(ii + 1) % offsets.size()];
+      upper_right[0] = (2.*(xx + 3) + 1.)/32. + offsets[(ii + 2) % offsets.size()];
+      upper_right[1] = (2.*(yy + 3) + 1.)/32. + offsets[(ii + 3) % offsets.size()];
+      boxes.emplace_back(lower_left, upper_right, RangeType(ii + 1.));
+      ++ii;
+    }
+  }
+  return boxes;
+} // ... create_boxes(...)
+
+
+TEST(BoxIndicator, coincides_with_domain_indicator)
+{
+  const ValuesType boxes = create_boxes();
+  const BoxIndicatorType box_indicator(boxes, "box");
+  const DomainIndicatorType domain_indicator(boxes, "domain");
+  const BoxIndicatorType summed_box_indicator(boxes, "summed", /*sum_overlapping=*/true);
+  std::vector< std::unique_ptr< DomainIndicatorType > > single_domain_indicators;
+  for (const auto& box : boxes)
+    single_domain_indicators.emplace_back(new DomainIndicatorType(ValuesType(1, box), "single"));
+  auto grid_cfg = Stuff::Grid::Providers::Cube< GridType >::default_config();
+  grid_cfg["lower_left"] = "[0 0]";
+  grid_cfg["upper_right"] = "[1 1]";
+  grid_cfg["num_elements"] = "[16 16]";
+  const auto grid_provider = Stuff::Grid::Providers::Cube< GridType >::create(grid_cfg);
+  const auto grid_view = grid_provider->leaf_view();
+  size_t num_overlapping = 0;
+  for (auto it = grid_view.begin< 0 >(); it != grid_view.end< 0 >(); ++it) {
+    const auto& entity = *it;
+    const auto center = entity.geometry().center();
+    const auto xx = entity.geometry().local(center);
+    EXPECT_EQ(domain_indicator.local_function(entity)->evaluate(xx)[0],
+              box_indicator.local_function(entity)->evaluate(xx)[0])
+        << "at " << center;
+    double sum = 0.;
+    size_t num_containing = 0;
+    for (const auto& single_domain_indicator : single_domain_indicators) {
+      const double value = single_domain_indicator->local_function(entity)->evaluate(xx)[0];
+      sum += value;
+      num_containing += (value != 0.);
+    }
+    num_overlapping += (num_containing > 1);
+    EXPECT_DOUBLE_EQ(sum, summed_box_indicator.local_function(entity)->evaluate(xx)[0]) << "at " << center;
+  }
+  // otherwise this test would not cover the first match
+  EXPECT_GT(num_overlapping, 0u);
+} // TEST(BoxIndicator, coincides_with_domain_indicator)
@@ -0,0 +1,208 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
+# define DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
+#endif
+
+// This one has to come first (includes the config.h)!
+#include <dune/stuff/test/main.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <dune/common/fvector.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/stuff/functions/interfaces.hh>
+#include <dune/stuff/grid/provider/cube.hh>
+
+#include <dune/hdd/linearelliptic/problems/cached.hh>
+
+#if HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
+# include <dune/grid/alugrid.hh>
+
+# include <dune/pymor/parameters/base.hh>
+
+# include <dune/hdd/linearelliptic/discretizations/swipdg.hh>
+# include <dune/hdd/linearelliptic/testcases/OS2015.hh>
+#endif
+
+using namespace Dune;
+using namespace HDD;
+
+
+typedef YaspGrid< 2 >                                               YaspGridType;
+typedef YaspGridType::Codim< 0 >::Entity                            YaspEntityType;
+typedef Stuff::LocalizableFunctionInterface< YaspEntityType, double, 2, double, 1 > YaspFunctionType;
+
+
+/**
+ * \brief The function x[0] + 2 x[1], counting its evaluations.
+ */
+class CountingFunction
+  : public YaspFunctionType
+{
+  class Localfunction
+    : public YaspFunctionType::LocalfunctionType
+  {
+    typedef YaspFunctionType::LocalfunctionType BaseType;
+  public:
+    typedef BaseType::DomainType        DomainType;
+    typedef BaseType::RangeType         RangeType;
+    typedef BaseType::JacobianRangeType JacobianRangeType;
+
+    Localfunction(const YaspEntityType& ent, size_t& evaluations)
+      : BaseType(ent)
+      , evaluations_(evaluations)
+    {}
+
+    virtual size_t order() const override final
+    {
+      return 1;
+    }
+
+    virtual void evaluate(const DomainType& xx, RangeType& ret) const override final
+    {
+      ++evaluations_;
+      const auto xx_global = this->entity().geometry().global(xx);
+      ret[0] = xx_global[0] + 2.0*xx_global[1];
+    }
+
+    virtual void jacobian(const DomainType& /*xx*/, JacobianRangeType& ret) const override final
+    {
+      ret[0][0] = 1.0;
+      ret[0][1] = 2.0;
+    }
+
+    using BaseType::evaluate;
+    using BaseType::jacobian;
+
+  private:
+    size_t& evaluations_;
+  }; // class Localfunction
+
+public:
+  CountingFunction()
+    : evaluations(0)
+  {}
+
+  virtual std::string type() const override
+  {
+    return "counting";
+  }
+
+  virtual std::string name() const override
+  {
+    return "counting";
+  }
+
+  virtual std::unique_ptr< LocalfunctionType > local_function(const EntityType& entity) const override
+  {
+    return std::unique_ptr< LocalfunctionType >(new Localfunction(entity, evaluations));
+  }
+
+  mutable size_t evaluations;
+}; // class CountingFunction
+
+
+TEST(CachedFunction, evaluates_once_per_point)
+{
+  auto grid_cfg = Stuff::Grid::Providers::Cube< YaspGridType >::default_config();
+  grid_cfg["lower_left"] = "[0 0]";
+  grid_cfg["upper_right"] = "[1 1]";
+  grid_cfg["num_elements"] = "[4 4]";
+  const auto grid_provider = Stuff::Grid::Providers::Cube< YaspGridType >::create(grid_cfg);
+  const auto grid_view = grid_provider->leaf_view();
+  typedef std::remove_const< decltype(grid_view) >::type::IndexSet IndexSetType;
+  typedef LinearElliptic::Problems::internal::CachedFunction< IndexSetType, YaspFunctionType > CachedType;
+  const auto function = std::make_shared< const CountingFunction >();
+  const CachedType cached(function, grid_view.indexSet(), /*max_points=*/2);
+  std::vector< FieldVector< double, 2 > > points(3, FieldVector< double, 2 >(0.5));
+  points[1] = FieldVector< double, 2 >(0.25);
+  points[2][0] = 0.75;
+  const size_t num_entities = grid_view.indexSet().size(0);
+  // the first two points are cached, the third is beyond max_points
+  for (size_t pass = 0; pass < 3; ++pass) {
+    if (pass == 2)
+      cached.clear();
+    for (auto it = grid_view.begin< 0 >(); it != grid_view.end< 0 >(); ++it) {
+      const auto& entity = *it;
+      const auto local_function = cached.local_function(entity);
+      for (const auto& xx : points) {
+        const auto xx_global = entity.geometry().global(xx);
+        EXPECT_DOUBLE_EQ(xx_global[0] + 2.0*xx_global[1], local_function->evaluate(xx)[0]) << "at " << xx_global;
+        EXPECT_DOUBLE_EQ(2.0, local_function->jacobian(xx)[0][1]);
+      }
+    }
+    EXPECT_EQ(std::vector< size_t >({3, 4, 7})[pass]*num_entities, function->evaluations) << "in pass " << pass;
+  }
+  EXPECT_THROW(CachedType(function, grid_view.indexSet(), 0), Stuff::Exceptions::wrong_input_given);
+} // TEST(CachedFunction, evaluates_once_per_point)
+
+
+#if HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
+
+
+typedef ALUGrid< 2, 2, simplex, conforming >                   GridType;
+typedef LinearElliptic::TestCases::OS2015::Academic< GridType > TestCaseType;
+typedef LinearElliptic::Discretizations::SWIPDG< GridType, Stuff::Grid::ChooseLayer::leaf, double, 1, 1,
+                                                 GDT::ChooseSpaceBackend::fem,
+                                                 Stuff::LA::ChooseBackend::istl_sparse > DiscretizationType;
+typedef LinearElliptic::Problems::Cached< GridType::LeafGridView, GridType::Codim< 0 >::Entity, double, 2, double, 1 >
+    CachedProblemType;
+
+
+template< class OperatorType, class VectorType >
+double apply2(const OperatorType& op, const VectorType& uu, const VectorType& vv, const Pymor::Parameter& mu)
+{
+  return op.parametric() ? op.apply2(uu, vv, mu) : op.apply2(uu, vv);
+}
+
+
+TEST(CachedProblem, gives_the_same_discretization)
+{
+  const TestCaseType test_case({{"mu_hat", Pymor::Parameter("mu", 0.1)},
+                                {"mu_bar", Pymor::Parameter("mu", 1)},
+                                {"mu",     Pymor::Parameter("mu", 0.5)}},
+                               "[2 2 1]");
+  auto& grid_provider = *test_case.level_provider(0);
+  const CachedProblemType cached_problem(test_case.problem(), grid_provider.leaf_view());
+  DiscretizationType original(grid_provider, test_case.boundary_info(), test_case.problem());
+  original.init();
+  DiscretizationType cached(grid_provider, test_case.boundary_info(), cached_problem);
+  cached.init();
+  for (const double mu : {0.1, 0.5, 1.0}) {
+    const Pymor::Parameter parameter("mu", mu);
+    auto expected = original.create_vector();
+    original.solve(expected, parameter);
+    auto solution = cached.create_vector();
+    cached.solve(solution, parameter);
+    EXPECT_LE((expected - solution).sup_norm(), 1e-10 * std::max(1.0, expected.sup_norm())) << "for mu = " << mu;
+    for (const auto& id : original.available_products()) {
+      const double expected_product = apply2(original.get_product(id), expected, expected, parameter);
+      EXPECT_NEAR(expected_product,
+                  apply2(cached.get_product(id), expected, expected, parameter),
+                  1e-10 * std::max(1.0, std::abs(expected_product)))
+          << "for " << id << " and mu = " << mu;
+    }
+  }
+} // TEST(CachedProblem, gives_the_same_discretization)
+
+
+#else // HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
+
+
+TEST(DISABLED_CachedProblem, gives_the_same_discretization)
+{
+  std::cerr << "You are missing dune-fem or dune-grid-multiscale or alugrid!" << std::endl;
+}
+
+
+#endif // HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
@@ -0,0 +1,167 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+// This one has to come first (includes the config.h)!
+#include <dune/stuff/test/main.hxx>
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <dune/common/fvector.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/stuff/functions/spe10.hh>
+#include <dune/stuff/functions/spe10model2.hh>
+#include <dune/stuff/grid/provider/cube.hh>
+
+#include <dune/hdd/linearelliptic/problems/spe10-cache.hh>
+
+using namespace Dune;
+using namespace HDD;
+
+
+/**
+ * \brief Writes num_values (arbitrary, but distinct for neighboring cells) values to an ASCII file.
+ */
+void write_ascii_data(const std::string& filename, const size_t num_values)
+{
+  std::ofstream file(filename);
+  for (size_t ii = 0; ii < num_values; ++ii)
+    file << (ii*7919) % 997 + 1 << (ii % 10 == 9 ? "\n" : " ");
+  ASSERT_TRUE(bool(file));
+}
+
+
+/**
+ * \brief Compares the mapped and the original function on all entities of a grid which is not aligned with the cells
+ *        of the data, at the center and at points away from the center.
+ */
+template< class GridType, class MappedType, class OriginalType >
+void expect_equal_on_grid(const std::string lower_left,
+                          const std::string upper_right,
+                          const std::string num_elements,
+                          const MappedType& mapped,
+                          const OriginalType& original)
+{
+  auto grid_cfg = Stuff::Grid::Providers::Cube< GridType >::default_config();
+  grid_cfg["lower_left"] = lower_left;
+  grid_cfg["upper_right"] = upper_right;
+  grid_cfg["num_elements"] = num_elements;
+  const auto grid_provider = Stuff::Grid::Providers::Cube< GridType >::create(grid_cfg);
+  const auto grid_view = grid_provider->leaf_view();
+  static const int dimDomain = GridType::dimension;
+  typedef FieldVector< double, dimDomain > DomainType;
+  std::vector< DomainType > local_points(3, DomainType(0.5));
+  local_points[1] = DomainType(0.1);
+  local_points[2] = DomainType(0.9);
+  size_t num_compared = 0;
+  for (auto it = grid_view.template begin< 0 >(); it != grid_view.template end< 0 >(); ++it) {
+    const auto& entity = *it;
+    const auto mapped_local = mapped.local_function(entity);
+    const auto original_local = original.local_function(entity);
+    for (const auto& xx : local_points) {
+      const auto expected = original_local->evaluate(xx);
+      const auto actual = mapped_local->evaluate(xx);
+      for (size_t ii = 0; ii < dimDomain; ++ii)
+        for (size_t jj = 0; jj < dimDomain; ++jj)
+          EXPECT_DOUBLE_EQ(expected[ii][jj], actual[ii][jj]) << "at " << entity.geometry().global(xx);
+      ++num_compared;
+    }
+  }
+  EXPECT_GT(num_compared, 0u);
+} // ... expect_equal_on_grid(...)
+
+
+TEST(Spe10Cache, mapped_model1_coincides_with_stuff_model1)
+{
+  typedef YaspGrid< 2 >                                                   GridType;
+  typedef GridType::Codim< 0 >::Entity                                    E;
+  typedef LinearElliptic::Problems::Spe10::MappedModel1< E, double, double > MappedType;
+  typedef Stuff::Functions::Spe10::Model1< E, double, 2, double, 2, 2 >  OriginalType;
+  const std::string filename = "spe10_cache_test_model1.dat";
+  const std::string cache_filename = "spe10_cache_test_model1.cache";
+  write_ascii_data(filename,
+                   Stuff::Functions::Spe10::internal::model1_x_elements
+                   * Stuff::Functions::Spe10::internal::model1_z_elements);
+  const OriginalType original(filename, {0., 0.}, {5., 1.},
+                              Stuff::Functions::Spe10::internal::model1_min_value,
+                              Stuff::Functions::Spe10::internal::model1_max_value,
+                              "original");
+  for (size_t ii = 0; ii < 2; ++ii) { // <- first creates, then maps the cache file
+    const MappedType mapped(filename, {0., 0.}, {5., 1.},
+                            Stuff::Functions::Spe10::internal::model1_min_value,
+                            Stuff::Functions::Spe10::internal::model1_max_value,
+                            "mapped",
+                            cache_filename);
+    expect_equal_on_grid< GridType >("[0 0]", "[5 1]", "[37 11]", mapped, original);
+  }
+  std::remove(filename.c_str());
+  std::remove(cache_filename.c_str());
+} // TEST(Spe10Cache, mapped_model1_coincides_with_stuff_model1)
+
+TEST(Spe10Cache, mapped_model2_coincides_with_stuff_model2)
+{
+  typedef YaspGrid< 3 >                                                   GridType;
+  typedef GridType::Codim< 0 >::Entity                                    E;
+  typedef LinearElliptic::Problems::Spe10::MappedModel2< E, double, double > MappedType;
+  typedef Stuff::Functions::Spe10::Model2< E, double, 3, double, 3, 3 >  OriginalType;
+  const std::string filename = "spe10_cache_test_model2.dat";
+  const std::string cache_filename = "spe10_cache_test_model2.cache";
+  const auto num_elements = MappedType::num_elements();
+  write_ascii_data(filename, 3*num_elements[0]*num_elements[1]*num_elements[2]);
+  const OriginalType original(filename, "original", {0., 0., 0.}, {1., 1., 1.});
+  const MappedType mapped(filename, "mapped", {0., 0., 0.}, {1., 1., 1.}, cache_filename);
+  // entities span several cells of the data in each direction
+  expect_equal_on_grid< GridType >("[0 0 0]", "[1 1 1]", "[13 29 11]", mapped, original);
+  std::remove(filename.c_str());
+  std::remove(cache_filename.c_str());
+} // TEST(Spe10Cache, mapped_model2_coincides_with_stuff_model2)
+
+TEST(Spe10Cache, recreates_corrupt_cache_file)
+{
+  const std::string filename = "spe10_cache_test_corrupt.dat";
+  const std::string cache_filename = "spe10_cache_test_corrupt.cache";
+  write_ascii_data(filename, 100);
+  {
+    std::ofstream cache_file(cache_filename, std::ofstream::binary);
+    cache_file << "not a cache file";
+  }
+  const auto data = LinearElliptic::Problems::Spe10::BinaryCache::get(filename, cache_filename);
+  ASSERT_EQ(100u, data->size());
+  EXPECT_TRUE(data->mapped());
+  for (size_t ii = 0; ii < data->size(); ++ii)
+    EXPECT_EQ(double((ii*7919) % 997 + 1), (*data)[ii]);
+  std::remove(filename.c_str());
+  std::remove(cache_filename.c_str());
+} // TEST(Spe10Cache, recreates_corrupt_cache_file)
+
+TEST(Spe10Cache, recreates_cache_file_of_replaced_source)
+{
+  const std::string filename = "spe10_cache_test_replaced.dat";
+  const std::string cache_filename = "spe10_cache_test_replaced.cache";
+  const size_t num_values = 100;
+  write_ascii_data(filename, num_values);
+  const auto data = LinearElliptic::Problems::Spe10::BinaryCache::get(filename, cache_filename);
+  ASSERT_EQ(num_values, data->size());
+  // replace the source by a file of the same size, containing the same values in reverse order
+  {
+    std::ofstream file(filename + ".new");
+    for (size_t ii = 0; ii < num_values; ++ii)
+      file << ((num_values - 1 - ii)*7919) % 997 + 1 << (ii % 10 == 9 ? "\n" : " ");
+  }
+  ASSERT_EQ(0, std::rename((filename + ".new").c_str(), filename.c_str()));
+  const auto replaced_data = LinearElliptic::Problems::Spe10::BinaryCache::get(filename, cache_filename);
+  ASSERT_EQ(num_values, replaced_data->size());
+  EXPECT_NE(data, replaced_data);
+  for (size_t ii = 0; ii < num_values; ++ii) {
+    EXPECT_EQ(double((ii*7919) % 997 + 1), (*data)[ii]); // <- still mapped
+    EXPECT_EQ(double(((num_values - 1 - ii)*7919) % 997 + 1), (*replaced_data)[ii]);
+  }
+  std::remove(filename.c_str());
+  std::remove(cache_filename.c_str());
+} // TEST(Spe10Cache, recreates_cache_file_of_replaced_source)
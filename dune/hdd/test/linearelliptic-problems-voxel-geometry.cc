@@ -0,0 +1,114 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+// This one has to come first (includes the config.h)!
+#include <dune/stuff/test/main.hxx>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <dune/common/fvector.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/stuff/grid/provider/cube.hh>
+
+#include <dune/hdd/linearelliptic/problems/voxel-geometry.hh>
+
+using namespace Dune;
+using namespace HDD;
+
+
+typedef YaspGrid< 2 >                                                                 GridType;
+typedef GridType::Codim< 0 >::Entity                                                  E;
+typedef LinearElliptic::Problems::internal::MaterialFunction< E, double, 2, double > MaterialFunctionType;
+typedef LinearElliptic::Problems::internal::VoxelData                                VoxelDataType;
+
+
+TEST(MaterialFunction, regions_are_half_open)
+{
+  // 2x2 voxels with the classes 0, 1 (bottom) and 2, 3 (top) on the unit square
+  const auto voxels = std::make_shared< const VoxelDataType >(std::vector< std::uint8_t >{0, 1, 2, 3});
+  // a region the left boundary of which contains the centers of the second column of a 4x4 grid, as does its right
+  // boundary for the fourth column
+  MaterialFunctionType::DomainType region_lower_left(0.0);
+  region_lower_left[0] = 0.375;
+  MaterialFunctionType::DomainType region_upper_right(1.0);
+  region_upper_right[0] = 0.875;
+  const MaterialFunctionType::RegionType region(region_lower_left, region_upper_right);
+  auto materials = std::make_shared< MaterialFunctionType >(voxels,
+                                                            FieldVector< double, 2 >(0.0),
+                                                            FieldVector< double, 2 >(1.0),
+                                                            Stuff::Common::FieldVector< size_t, 2 >(2),
+                                                            std::vector< MaterialFunctionType::RegionType >(1, region));
+  const size_t index = materials->register_component({{1., 2., 3., 4.}, {10., 20., 30., 40.}}, "component");
+  const auto component = materials->component(index);
+  EXPECT_EQ("component", component->name());
+  auto grid_cfg = Stuff::Grid::Providers::Cube< GridType >::default_config();
+  grid_cfg["lower_left"] = "[0 0]";
+  grid_cfg["upper_right"] = "[1 1]";
+  grid_cfg["num_elements"] = "[4 4]";
+  const auto grid_provider = Stuff::Grid::Providers::Cube< GridType >::create(grid_cfg);
+  const auto grid_view = grid_provider->leaf_view();
+  size_t num_inside = 0;
+  for (auto it = grid_view.begin< 0 >(); it != grid_view.end< 0 >(); ++it) {
+    const auto& entity = *it;
+    const auto center = entity.geometry().center();
+    const size_t material_class = (center[0] > 0.5 ? 1 : 0) + (center[1] > 0.5 ? 2 : 0);
+    const bool inside = center[0] > 0.25 && center[0] < 0.75;
+    num_inside += inside;
+    EXPECT_EQ(material_class + (inside ? MaterialFunctionType::num_classes : 0), materials->material(entity))
+        << "at " << center;
+    const auto local_function = component->local_function(entity);
+    EXPECT_DOUBLE_EQ((material_class + 1.)*(inside ? 10. : 1.),
+                     local_function->evaluate(entity.geometry().local(center))[0])
+        << "at " << center;
+  }
+  EXPECT_EQ(8u, num_inside);
+} // TEST(MaterialFunction, regions_are_half_open)
+
+TEST(MaterialFunction, rejects_mismatching_voxels)
+{
+  const auto voxels = std::make_shared< const VoxelDataType >(std::vector< std::uint8_t >{0, 1, 2});
+  EXPECT_THROW(MaterialFunctionType(voxels,
+                                    FieldVector< double, 2 >(0.0),
+                                    FieldVector< double, 2 >(1.0),
+                                    Stuff::Common::FieldVector< size_t, 2 >(2)),
+               Stuff::Exceptions::wrong_input_given);
+} // TEST(MaterialFunction, rejects_mismatching_voxels)
+
+TEST(MaterialFunction, combination_matches_components)
+{
+  const auto voxels = std::make_shared< const VoxelDataType >(std::vector< std::uint8_t >{0, 1, 2, 3});
+  auto materials = std::make_shared< MaterialFunctionType >(voxels,
+                                                            FieldVector< double, 2 >(0.0),
+                                                            FieldVector< double, 2 >(1.0),
+                                                            Stuff::Common::FieldVector< size_t, 2 >(2));
+  const size_t first = materials->register_component({{1., 2., 3., 4.}}, "first");
+  const size_t second = materials->register_component({{0., 1., 0., 1.}}, "second");
+  const std::vector< double > coefficients = {2., -3.};
+  const auto combination = materials->combination(coefficients, "combination");
+  EXPECT_EQ("combination", combination->name());
+  EXPECT_THROW(materials->combination({1., 2., 3.}, "too_many"), Stuff::Exceptions::wrong_input_given);
+  auto grid_cfg = Stuff::Grid::Providers::Cube< GridType >::default_config();
+  grid_cfg["lower_left"] = "[0 0]";
+  grid_cfg["upper_right"] = "[1 1]";
+  grid_cfg["num_elements"] = "[4 4]";
+  const auto grid_provider = Stuff::Grid::Providers::Cube< GridType >::create(grid_cfg);
+  const auto grid_view = grid_provider->leaf_view();
+  std::vector< double > values;
+  for (auto it = grid_view.begin< 0 >(); it != grid_view.end< 0 >(); ++it) {
+    const auto& entity = *it;
+    const auto xx = entity.geometry().local(entity.geometry().center());
+    const double first_value = materials->component(first)->local_function(entity)->evaluate(xx)[0];
+    const double second_value = materials->component(second)->local_function(entity)->evaluate(xx)[0];
+    materials->values(entity, values);
+    ASSERT_EQ(materials->num_components(), values.size());
+    EXPECT_DOUBLE_EQ(first_value, values[first]);
+    EXPECT_DOUBLE_EQ(second_value, values[second]);
+    EXPECT_DOUBLE_EQ(2.*first_value - 3.*second_value, combination->local_function(entity)->evaluate(xx)[0])
+        << "at " << entity.geometry().center();
+  }
+} // TEST(MaterialFunction, combination_matches_components)
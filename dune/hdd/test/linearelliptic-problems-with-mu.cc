@@ -0,0 +1,151 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+// This one has to come first (includes the config.h)!
+#include <dune/stuff/test/main.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <dune/common/fvector.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/stuff/functions/constant.hh>
+#include <dune/stuff/functions/expression.hh>
+#include <dune/stuff/grid/provider/cube.hh>
+
+#include <dune/pymor/functions/default.hh>
+#include <dune/pymor/parameters/base.hh>
+#include <dune/pymor/parameters/functional.hh>
+
+#include <dune/hdd/linearelliptic/problems/default.hh>
+
+using namespace Dune;
+using namespace HDD;
+
+
+typedef YaspGrid< 2 >                                                             GridType;
+typedef GridType::Codim< 0 >::Entity                                              E;
+typedef LinearElliptic::Problems::Default< E, double, 2, double, 1 >               ProblemType;
+typedef Stuff::Functions::Expression< E, double, 2, double, 1 >                   ExpressionType;
+typedef Stuff::Functions::Constant< E, double, 2, double, 2, 2 >                  ConstantMatrixType;
+typedef Pymor::Functions::AffinelyDecomposableDefault< E, double, 2, double, 1 >     ScalarFunctionType;
+typedef Pymor::Functions::AffinelyDecomposableDefault< E, double, 2, double, 2, 2 >  MatrixFunctionType;
+
+
+/**
+ * \brief A problem with parametric functions with and without an affine part as well as nonparametric ones.
+ */
+std::unique_ptr< ProblemType > create_problem()
+{
+  auto diffusion_factor = std::make_shared< ScalarFunctionType >("diffusion_factor");
+  diffusion_factor->register_affine_part(new ExpressionType("x", "1.0 + x[0]*x[1]", 2));
+  diffusion_factor->register_component(new ExpressionType("x", "x[0]", 1),
+                                       new Pymor::ParameterFunctional("mu", 2, "mu[0]"));
+  diffusion_factor->register_component(new ExpressionType("x", "sin(x[1])", 3),
+                                       new Pymor::ParameterFunctional("mu", 2, "mu[0]*mu[1]"));
+  auto diffusion_tensor = std::make_shared< MatrixFunctionType >("diffusion_tensor");
+  diffusion_tensor->register_affine_part(ConstantMatrixType::create(ConstantMatrixType::default_config()).release());
+  auto force = std::make_shared< ScalarFunctionType >("force");
+  force->register_component(new ExpressionType("x", "x[1]*x[1]", 2),
+                            new Pymor::ParameterFunctional("mu", 2, "mu[1]"));
+  auto dirichlet = std::make_shared< ScalarFunctionType >("dirichlet");
+  dirichlet->register_affine_part(new ExpressionType("x", "x[0]", 1));
+  auto neumann = std::make_shared< ScalarFunctionType >("neumann");
+  neumann->register_affine_part(new ExpressionType("x", "0.0", 0));
+  return std::unique_ptr< ProblemType >(
+        new ProblemType(std::shared_ptr< const ProblemType::DiffusionFactorType >(diffusion_factor),
+                        std::shared_ptr< const ProblemType::DiffusionTensorType >(diffusion_tensor),
+                        std::shared_ptr< const ProblemType::FunctionType >(force),
+                        std::shared_ptr< const ProblemType::FunctionType >(dirichlet),
+                        std::shared_ptr< const ProblemType::FunctionType >(neumann)));
+} // ... create_problem(...)
+
+
+/**
+ * \brief Compares the frozen function to the one of F::with_mu() (which builds linear combinations of the
+ *        components), at the center and at points away from the center of each entity.
+ */
+template< class F, class FrozenType, class GridViewType >
+void expect_equal(const F& function, const Pymor::Parameter& mu, const FrozenType& frozen, const GridViewType& grid_view)
+{
+  std::shared_ptr< const typename F::NonparametricType > expected = function.affine_part();
+  if (function.parametric())
+    expected = function.with_mu(mu);
+  std::vector< FieldVector< double, 2 > > local_points(3, FieldVector< double, 2 >(0.5));
+  local_points[1] = FieldVector< double, 2 >(0.1);
+  local_points[2][0] = 0.8;
+  for (auto it = grid_view.template begin< 0 >(); it != grid_view.template end< 0 >(); ++it) {
+    const auto& entity = *it;
+    const auto expected_local_function = expected->local_function(entity);
+    const auto frozen_local_function = frozen.local_function(entity);
+    for (const auto& xx : local_points) {
+      const auto expected_value = expected_local_function->evaluate(xx);
+      const auto actual_value = frozen_local_function->evaluate(xx);
+      auto difference = expected_value;
+      difference -= actual_value;
+      EXPECT_LE(difference.infinity_norm(), 1e-13 * std::max(1.0, expected_value.infinity_norm()))
+          << function.name() << " at " << entity.geometry().global(xx) << " for mu = " << mu;
+    }
+  }
+} // ... expect_equal(...)
+
+
+TEST(ProblemInterface, with_mu_coincides_with_linear_combinations)
+{
+  const auto problem = create_problem();
+  auto grid_cfg = Stuff::Grid::Providers::Cube< GridType >::default_config();
+  grid_cfg["lower_left"] = "[0 0]";
+  grid_cfg["upper_right"] = "[1 1]";
+  grid_cfg["num_elements"] = "[4 4]";
+  const auto grid_provider = Stuff::Grid::Providers::Cube< GridType >::create(grid_cfg);
+  const auto grid_view = grid_provider->leaf_view();
+  for (const auto& values : {std::vector< double >({0.1, 0.2}),
+                             std::vector< double >({1.0, 2.0}),
+                             std::vector< double >({-0.5, 3.0})}) {
+    const Pymor::Parameter mu("mu", values);
+    const auto frozen = problem->with_mu(mu);
+    EXPECT_FALSE(frozen->parametric());
+    expect_equal(*problem->diffusion_factor(), problem->map_parameter(mu, "diffusion_factor"),
+                 *frozen->diffusion_factor()->affine_part(), grid_view);
+    expect_equal(*problem->diffusion_tensor(), problem->map_parameter(mu, "diffusion_tensor"),
+                 *frozen->diffusion_tensor()->affine_part(), grid_view);
+    expect_equal(*problem->force(), problem->map_parameter(mu, "force"),
+                 *frozen->force()->affine_part(), grid_view);
+    expect_equal(*problem->dirichlet(), problem->map_parameter(mu, "dirichlet"),
+                 *frozen->dirichlet()->affine_part(), grid_view);
+    expect_equal(*problem->neumann(), problem->map_parameter(mu, "neumann"),
+                 *frozen->neumann()->affine_part(), grid_view);
+  }
+} // TEST(ProblemInterface, with_mu_coincides_with_linear_combinations)
+
+TEST(ProblemInterface, with_mu_remembers_the_last_problems)
+{
+  const auto problem = create_problem();
+  const size_t max_size = LinearElliptic::Problems::internal::FrozenProblems< ProblemType >::max_size;
+  ASSERT_EQ(8u, max_size);
+  const auto mu = [](const size_t ii) { return Pymor::Parameter("mu", {double(ii), 1.0}); };
+  const auto first = problem->with_mu(mu(0));
+  EXPECT_EQ(first, problem->with_mu(mu(0)));
+  // seven other parameters keep the first one
+  for (size_t ii = 1; ii < max_size; ++ii)
+    problem->with_mu(mu(ii));
+  EXPECT_EQ(first, problem->with_mu(mu(0)));
+  // which is now the most recent, so the next parameter evicts the least recent (1) instead
+  const auto second = problem->with_mu(mu(2));
+  problem->with_mu(mu(max_size));
+  EXPECT_EQ(first, problem->with_mu(mu(0)));
+  EXPECT_EQ(second, problem->with_mu(mu(2)));
+  // eight other parameters evict it
+  for (size_t ii = max_size + 1; ii <= 2*max_size; ++ii)
+    problem->with_mu(mu(ii));
+  const auto recreated = problem->with_mu(mu(0));
+  EXPECT_NE(first, recreated);
+  EXPECT_EQ(recreated, problem->with_mu(mu(0)));
+  EXPECT_THROW(problem->with_mu(Pymor::Parameter("nu", 1.0)), Pymor::Exceptions::wrong_parameter_type);
+} // TEST(ProblemInterface, with_mu_remembers_the_last_problems)
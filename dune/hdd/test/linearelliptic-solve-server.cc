@@ -0,0 +1,270 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
+# define DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
+#endif
+
+// This one has to come first (includes the config.h)!
+#include <dune/stuff/test/main.hxx>
+
+#if HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
+# include <chrono>
+# include <cmath>
+# include <cstdio>
+# include <fstream>
+# include <memory>
+# include <string>
+# include <thread>
+# include <vector>
+
+# include <sys/socket.h>
+# include <sys/stat.h>
+# include <sys/un.h>
+# include <unistd.h>
+
+# include <dune/grid/alugrid.hh>
+
+# include <dune/stuff/common/exceptions.hh>
+
+# include <dune/pymor/parameters/base.hh>
+
+# include <dune/hdd/linearelliptic/discretizations/swipdg.hh>
+# include <dune/hdd/linearelliptic/server.hh>
+# include <dune/hdd/linearelliptic/testcases/OS2015.hh>
+
+using namespace Dune;
+using namespace HDD;
+
+
+typedef ALUGrid< 2, 2, simplex, conforming >                   GridType;
+typedef LinearElliptic::TestCases::OS2015::Academic< GridType > TestCaseType;
+typedef LinearElliptic::Discretizations::SWIPDG< GridType, Stuff::Grid::ChooseLayer::leaf, double, 1, 1,
+                                                 GDT::ChooseSpaceBackend::fem,
+                                                 Stuff::LA::ChooseBackend::istl_sparse > DiscretizationType;
+typedef LinearElliptic::SolveServer< DiscretizationType >      ServerType;
+typedef LinearElliptic::SolveClient                            ClientType;
+typedef LinearElliptic::internal::SolveProtocol                ProtocolType;
+
+
+std::vector< double > to_std(const DiscretizationType::VectorType& vector)
+{
+  std::vector< double > ret(vector.size());
+  for (size_t ii = 0; ii < ret.size(); ++ii)
+    ret[ii] = vector.get_entry(ii);
+  return ret;
+}
+
+/**
+ * \brief A raw connection, to send requests the SolveClient would not send.
+ */
+int connect_raw(const std::string& socket_path)
+{
+  const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+  EXPECT_EQ(0, ::connect(fd, reinterpret_cast< sockaddr* >(&address), sizeof(address)));
+  return fd;
+}
+
+std::vector< char > message(const ProtocolType::Request type, const ProtocolType::Writer& payload)
+{
+  std::vector< char > ret;
+  ProtocolType::write_header(ret, ProtocolType::magic, std::uint32_t(type), payload.buffer().size());
+  ret.insert(ret.end(), payload.buffer().begin(), payload.buffer().end());
+  return ret;
+}
+
+
+class SolveServerTest
+  : public ::testing::Test
+{
+protected:
+  SolveServerTest()
+    : test_case_({{"mu_hat", Pymor::Parameter("mu", 0.1)},
+                  {"mu_bar", Pymor::Parameter("mu", 1)},
+                  {"mu",     Pymor::Parameter("mu", 0.5)}},
+                 "[2 2 1]")
+    , discretization_(*test_case_.level_provider(0), test_case_.boundary_info(), test_case_.problem(), 0, {"l2"})
+    , socket_path_("linearelliptic_solve_server_test.socket")
+  {
+    discretization_.init();
+    std::remove(socket_path_.c_str());
+  }
+
+  ~SolveServerTest()
+  {
+    std::remove(socket_path_.c_str());
+  }
+
+  /**
+   * \brief Starts the server in a thread, everything the test wants to compare has to be computed before, since the
+   *        discretization is not thread safe.
+   */
+  void start()
+  {
+    server_ = std::unique_ptr< ServerType >(new ServerType(discretization_, socket_path_));
+    thread_ = std::thread([&]() { server_->run(); });
+  }
+
+  void stop()
+  {
+    ClientType(socket_path_).shutdown();
+    thread_.join();
+    server_ = nullptr;
+  }
+
+  const TestCaseType test_case_;
+  DiscretizationType discretization_;
+  const std::string socket_path_;
+  std::unique_ptr< ServerType > server_;
+  std::thread thread_;
+}; // class SolveServerTest
+
+
+TEST_F(SolveServerTest, answers_like_the_discretization)
+{
+  const Pymor::Parameter mu("mu", 0.3);
+  const ClientType::ParameterType mu_client = {{"mu", {0.3}}};
+  auto expected_solution = discretization_.create_vector();
+  discretization_.solve(expected_solution, mu);
+  auto expected_range = discretization_.create_vector();
+  const auto op = discretization_.get_operator();
+  op.apply(expected_solution, expected_range, mu);
+  const auto product = discretization_.get_product("l2");
+  const double expected_product = product.parametric()
+                                  ? product.apply2(expected_solution, expected_solution, mu)
+                                  : product.apply2(expected_solution, expected_solution);
+  start();
+  {
+    ClientType client(socket_path_);
+    const auto info = client.info();
+    EXPECT_EQ(discretization_.create_vector().size(), info.first);
+    ASSERT_EQ(1u, info.second.size());
+    EXPECT_EQ(1u, info.second.at("mu").size());
+    const auto solution = client.solve(mu_client);
+    const auto expected = to_std(expected_solution);
+    ASSERT_EQ(expected.size(), solution.size());
+    for (size_t ii = 0; ii < solution.size(); ++ii)
+      EXPECT_DOUBLE_EQ(expected[ii], solution[ii]);
+    const auto range = client.apply(solution, mu_client);
+    const auto expected_range_std = to_std(expected_range);
+    for (size_t ii = 0; ii < range.size(); ++ii)
+      EXPECT_NEAR(expected_range_std[ii], range[ii], 1e-12 * std::max(1.0, std::abs(expected_range_std[ii])));
+    EXPECT_NEAR(expected_product,
+                client.product("l2", solution, solution, mu_client),
+                1e-12 * std::max(1.0, expected_product));
+    // errors are reported, the connection stays usable
+    EXPECT_THROW(client.product("h1", solution, solution, mu_client), Stuff::Exceptions::internal_error);
+    EXPECT_THROW(client.apply(solution, {{"nu", {0.3}}}), Stuff::Exceptions::internal_error);
+    EXPECT_THROW(client.apply(std::vector< double >(3, 1.0), mu_client), Stuff::Exceptions::internal_error);
+    EXPECT_THROW(client.estimate(solution, mu_client), Stuff::Exceptions::internal_error);
+    EXPECT_EQ(info.first, client.info().first);
+  }
+  stop();
+  struct stat status;
+  EXPECT_NE(0, ::lstat(socket_path_.c_str(), &status)); // <- the socket is removed
+} // TEST_F(SolveServerTest, answers_like_the_discretization)
+
+TEST_F(SolveServerTest, serves_other_clients_while_one_does_not_read)
+{
+  const ClientType::ParameterType mu = {{"mu", {0.5}}};
+  const std::vector< double > source(discretization_.create_vector().size(), 1.0);
+  start();
+  // the slow client sends many requests without reading the responses (which exceed the socket buffers)
+  const int slow = connect_raw(socket_path_);
+  const size_t num_requests = 1000;
+  std::thread writer([&]() {
+    ProtocolType::Writer payload;
+    payload.parameter(mu);
+    payload.vector(source);
+    const auto request = message(ProtocolType::Request::apply, payload);
+    for (size_t ii = 0; ii < num_requests; ++ii)
+      ProtocolType::send_all(slow, request.data(), request.size());
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  {
+    ClientType client(socket_path_);
+    EXPECT_EQ(source.size(), client.info().first);
+    EXPECT_EQ(source.size(), client.solve(mu).size());
+  }
+  // now the slow client reads all of its responses
+  for (size_t ii = 0; ii < num_requests; ++ii) {
+    std::uint32_t status;
+    std::uint64_t size;
+    ProtocolType::receive_all(slow, &status, sizeof(status));
+    ProtocolType::receive_all(slow, &size, sizeof(size));
+    std::vector< char > result(size);
+    ProtocolType::receive_all(slow, result.data(), size);
+    ASSERT_EQ(std::uint32_t(ProtocolType::Status::ok), status);
+    EXPECT_EQ(source.size(), ProtocolType::Reader(result).vector().size());
+  }
+  writer.join();
+  ::close(slow);
+  stop();
+} // TEST_F(SolveServerTest, serves_other_clients_while_one_does_not_read)
+
+TEST_F(SolveServerTest, drops_oversized_and_malformed_requests)
+{
+  start();
+  for (const auto& header : {std::make_pair(std::uint32_t(ProtocolType::magic), ProtocolType::max_payload_size + 1),
+                             std::make_pair(std::uint32_t(0), std::uint64_t(0))}) {
+    const int fd = connect_raw(socket_path_);
+    std::vector< char > request;
+    ProtocolType::write_header(request, header.first, std::uint32_t(ProtocolType::Request::info), header.second);
+    ProtocolType::send_all(fd, request.data(), request.size());
+    char byte;
+    EXPECT_EQ(0, ::recv(fd, &byte, 1, 0)); // <- the server closed the connection
+    ::close(fd);
+  }
+  ClientType client(socket_path_);
+  EXPECT_EQ(discretization_.create_vector().size(), client.info().first);
+  stop();
+} // TEST_F(SolveServerTest, drops_oversized_and_malformed_requests)
+
+TEST_F(SolveServerTest, only_replaces_stale_sockets)
+{
+  {
+    std::ofstream file(socket_path_);
+    file << "not a socket";
+  }
+  EXPECT_THROW(ServerType(discretization_, socket_path_), Stuff::Exceptions::wrong_input_given);
+  struct stat status;
+  ASSERT_EQ(0, ::lstat(socket_path_.c_str(), &status));
+  EXPECT_TRUE(S_ISREG(status.st_mode)); // <- the file was left alone
+  std::remove(socket_path_.c_str());
+  {
+    // a socket left behind by a server which is gone is replaced
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socket_path_.c_str(), sizeof(address.sun_path) - 1);
+    ASSERT_EQ(0, ::bind(fd, reinterpret_cast< sockaddr* >(&address), sizeof(address)));
+    ::close(fd);
+    ASSERT_EQ(0, ::lstat(socket_path_.c_str(), &status));
+    EXPECT_TRUE(S_ISSOCK(status.st_mode));
+  }
+  start();
+  EXPECT_THROW(ServerType(discretization_, socket_path_), IOError); // <- another server is listening
+  stop();
+} // TEST_F(SolveServerTest, only_replaces_stale_sockets)
+
+
+#else // HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
+
+
+TEST(DISABLED_SolveServerTest, answers_like_the_discretization)
+{
+  std::cerr << "You are missing dune-fem or dune-grid-multiscale or alugrid!" << std::endl;
+}
+TEST(DISABLED_SolveServerTest, serves_other_clients_while_one_does_not_read) {}
+TEST(DISABLED_SolveServerTest, drops_oversized_and_malformed_requests) {}
+TEST(DISABLED_SolveServerTest, only_replaces_stale_sockets) {}
+
+
+#endif // HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
@@ -0,0 +1,188 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
+# define DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
+#endif
+
+// This one has to come first (includes the config.h)!
+#include <dune/stuff/test/main.hxx>
+
+#if HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
+# include <algorithm>
+# include <cmath>
+# include <memory>
+# include <random>
+# include <vector>
+
+# include <dune/grid/alugrid.hh>
+
+# include <dune/stuff/common/exceptions.hh>
+# include <dune/stuff/functions/constant.hh>
+
+# include <dune/pymor/functions/default.hh>
+# include <dune/pymor/parameters/base.hh>
+# include <dune/pymor/parameters/functional.hh>
+
+# include <dune/hdd/linearelliptic/discretizations/swipdg.hh>
+# include <dune/hdd/linearelliptic/problems/default.hh>
+# include <dune/hdd/linearelliptic/testcases/OS2015.hh>
+
+# include "linearelliptic-block-swipdg.hh"
+
+using namespace Dune;
+using namespace HDD;
+
+
+typedef ALUGrid< 2, 2, simplex, conforming >                   GridType;
+typedef LinearElliptic::TestCases::OS2015::Academic< GridType > TestCaseType;
+typedef LinearElliptic::Discretizations::SWIPDG< GridType, Stuff::Grid::ChooseLayer::leaf, double, 1, 1,
+                                                 GDT::ChooseSpaceBackend::fem,
+                                                 Stuff::LA::ChooseBackend::istl_sparse > SWIPDGType;
+typedef LinearElliptic::Tests::internal::DiscretizationBlockSWIPDG
+    < TestCaseType, 1, Stuff::LA::ChooseBackend::istl_sparse >::Type BlockSWIPDGType;
+
+typedef TestCaseType::EntityType     E;
+typedef TestCaseType::DomainFieldType D;
+typedef TestCaseType::RangeFieldType  R;
+typedef LinearElliptic::Problems::Default< E, D, 2, R, 1 >                 ProblemType;
+typedef Stuff::Functions::Constant< E, D, 2, R, 1 >                         ScalarConstantFunctionType;
+typedef Stuff::Functions::Constant< E, D, 2, R, 2, 2 >                      MatrixConstantFunctionType;
+typedef Pymor::Functions::NonparametricDefault< E, D, 2, R, 1 >             ScalarFunctionType;
+typedef Pymor::Functions::NonparametricDefault< E, D, 2, R, 2, 2 >          NonparametricMatrixFunctionType;
+typedef Pymor::Functions::AffinelyDecomposableDefault< E, D, 2, R, 2, 2 >   ParametricMatrixFunctionType;
+
+
+/**
+ * \brief A(mu) = 1 + mu*B with a symmetric, indefinite B and nonzero Dirichlet values, to have all parametric terms.
+ */
+std::shared_ptr< ProblemType > create_parametric_problem()
+{
+  MatrixConstantFunctionType::RangeType identity(0.);
+  identity[0][0] = identity[1][1] = 1.;
+  MatrixConstantFunctionType::RangeType anisotropy(0.);
+  anisotropy[0][0] = 1.;
+  anisotropy[0][1] = anisotropy[1][0] = 0.5;
+  auto diffusion_tensor = std::make_shared< ParametricMatrixFunctionType >("diffusion_tensor");
+  diffusion_tensor->register_affine_part(new MatrixConstantFunctionType(identity));
+  diffusion_tensor->register_component(new MatrixConstantFunctionType(anisotropy),
+                                       new Pymor::ParameterFunctional("mu", 1, "mu[0]"));
+  return std::make_shared< ProblemType >(
+        std::make_shared< ScalarFunctionType >(std::make_shared< ScalarConstantFunctionType >(1., "diffusion_factor")),
+        diffusion_tensor,
+        std::make_shared< ScalarFunctionType >(std::make_shared< ScalarConstantFunctionType >(1., "force")),
+        std::make_shared< ScalarFunctionType >(std::make_shared< ScalarConstantFunctionType >(0.5, "dirichlet")),
+        std::make_shared< ScalarFunctionType >(std::make_shared< ScalarConstantFunctionType >(0., "neumann")));
+} // ... create_parametric_problem(...)
+
+
+class AffineDiffusionTest
+  : public ::testing::Test
+{
+protected:
+  AffineDiffusionTest()
+    : test_case_({{"mu_hat", Pymor::Parameter("mu", 0.1)},
+                  {"mu_bar", Pymor::Parameter("mu", 1)},
+                  {"mu",     Pymor::Parameter("mu", 0.5)}},
+                 "[2 2 1]")
+    , mu_ref_("mu", 0.5)
+    , parametric_problem_(create_parametric_problem())
+  {
+    parametric_problem_->set_diffusion_tensor_reference(mu_ref_);
+    frozen_problem_ = parametric_problem_->with_mu(mu_ref_);
+  }
+
+  template< class DiscretizationType >
+  std::vector< typename DiscretizationType::VectorType > random_vectors(const DiscretizationType& discretization) const
+  {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution< double > distribution(-1.0, 1.0);
+    std::vector< typename DiscretizationType::VectorType > ret;
+    for (size_t ii = 0; ii < 2; ++ii) {
+      ret.emplace_back(discretization.create_vector());
+      for (size_t jj = 0; jj < ret.back().size(); ++jj)
+        ret.back().set_entry(jj, distribution(generator));
+    }
+    return ret;
+  } // ... random_vectors(...)
+
+  /**
+   * \brief At mu_ref the affine decomposition has to reproduce the nonparametric discretization of A(mu_ref).
+   */
+  template< class DiscretizationType >
+  void expect_equivalent(const DiscretizationType& parametric, const DiscretizationType& nonparametric) const
+  {
+    ASSERT_TRUE(parametric.parametric());
+    ASSERT_FALSE(nonparametric.parametric());
+    const auto vectors = random_vectors(nonparametric);
+    const auto& uu = vectors[0];
+    const auto& vv = vectors[1];
+    const double expected_energy = nonparametric.get_operator().apply2(uu, vv);
+    EXPECT_NEAR(expected_energy,
+                parametric.get_operator().apply2(uu, vv, mu_ref_),
+                1e-10 * std::max(1.0, std::abs(expected_energy)));
+    const double expected_rhs = nonparametric.get_rhs().apply(uu);
+    EXPECT_NEAR(expected_rhs,
+                parametric.get_rhs().apply(uu, mu_ref_),
+                1e-10 * std::max(1.0, std::abs(expected_rhs)));
+    auto expected_solution = nonparametric.create_vector();
+    nonparametric.solve(expected_solution);
+    auto solution = parametric.create_vector();
+    parametric.solve(solution, mu_ref_);
+    const double error = (expected_solution - solution).sup_norm();
+    EXPECT_LE(error, 1e-8 * std::max(1.0, expected_solution.sup_norm()));
+  } // ... expect_equivalent(...)
+
+  const TestCaseType test_case_;
+  const Pymor::Parameter mu_ref_;
+  const std::shared_ptr< ProblemType > parametric_problem_;
+  std::shared_ptr< const ProblemType::NonparametricType > frozen_problem_;
+}; // class AffineDiffusionTest
+
+
+TEST_F(AffineDiffusionTest, swipdg_coincides_with_nonparametric_discretization_at_reference)
+{
+  SWIPDGType parametric(*test_case_.level_provider(0), test_case_.boundary_info(), *parametric_problem_, 0, {"penalty"});
+  parametric.init();
+  SWIPDGType nonparametric(*test_case_.level_provider(0), test_case_.boundary_info(), *frozen_problem_, 0, {"penalty"});
+  nonparametric.init();
+  expect_equivalent(parametric, nonparametric);
+  // the penalty product is decomposed as well
+  const auto vectors = random_vectors(nonparametric);
+  const double expected_penalty = nonparametric.get_product("penalty").apply2(vectors[0], vectors[1]);
+  EXPECT_NEAR(expected_penalty,
+              parametric.get_product("penalty").apply2(vectors[0], vectors[1], mu_ref_),
+              1e-10 * std::max(1.0, std::abs(expected_penalty)));
+} // TEST_F(AffineDiffusionTest, swipdg_coincides_with_nonparametric_discretization_at_reference)
+
+TEST_F(AffineDiffusionTest, block_swipdg_coincides_with_nonparametric_discretization_at_reference)
+{
+  BlockSWIPDGType parametric(*test_case_.level_provider(0), test_case_.boundary_info(), *parametric_problem_, {"l2"});
+  parametric.init();
+  BlockSWIPDGType nonparametric(*test_case_.level_provider(0), test_case_.boundary_info(), *frozen_problem_, {"l2"});
+  nonparametric.init();
+  expect_equivalent(parametric, nonparametric);
+} // TEST_F(AffineDiffusionTest, block_swipdg_coincides_with_nonparametric_discretization_at_reference)
+
+TEST_F(AffineDiffusionTest, requires_reference_for_parametric_tensor)
+{
+  const auto problem = create_parametric_problem();
+  SWIPDGType discretization(*test_case_.level_provider(0), test_case_.boundary_info(), *problem);
+  EXPECT_THROW(discretization.init(), Stuff::Exceptions::requirements_not_met);
+} // TEST_F(AffineDiffusionTest, requires_reference_for_parametric_tensor)
+
+
+#else // HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
+
+
+TEST(DISABLED_AffineDiffusionTest, swipdg_coincides_with_nonparametric_discretization_at_reference)
+{
+  std::cerr << "You are missing dune-fem or dune-grid-multiscale or alugrid!" << std::endl;
+}
+TEST(DISABLED_AffineDiffusionTest, block_swipdg_coincides_with_nonparametric_discretization_at_reference) {}
+TEST(DISABLED_AffineDiffusionTest, requires_reference_for_parametric_tensor) {}
+
+
+#endif // HAVE_DUNE_GRID_MULTISCALE && HAVE_DUNE_FEM && HAVE_DUNE_ISTL && HAVE_ALUGRID
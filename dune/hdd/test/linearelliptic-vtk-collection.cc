@@ -0,0 +1,208 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+// This one has to come first (includes the config.h)!
+#include <dune/stuff/test/main.hxx>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if DUNE_HDD_HAVE_ZLIB
+# include <zlib.h>
+#endif
+
+#include <dune/hdd/linearelliptic/vtk-collection.hh>
+
+using namespace Dune;
+using namespace HDD;
+
+
+/**
+ * \brief A piece as written by the serial VTKWriter, followed by (binary) appended data.
+ */
+void write_piece(const std::string& filename, const std::string& precision, const size_t num_components)
+{
+  std::ofstream file(filename, std::ofstream::binary);
+  file << "<?xml version=\"1.0\"?>\n"
+       << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"LittleEndian\">\n"
+       << "  <UnstructuredGrid>\n"
+       << "    <Piece NumberOfCells=\"2\" NumberOfPoints=\"6\">\n"
+       << "      <PointData Scalars=\"solution\">\n"
+       << "        <DataArray type=\"" << precision << "\" Name=\"solution\" NumberOfComponents=\""
+       << num_components << "\" format=\"appended\" offset=\"0\"/>\n"
+       << "      </PointData>\n"
+       << "      <CellData>\n"
+       << "        <DataArray type=\"Int32\" Name=\"subdomain\" NumberOfComponents=\"1\" format=\"appended\""
+       << " offset=\"28\"/>\n"
+       << "      </CellData>\n"
+       << "      <Points>\n"
+       << "        <DataArray type=\"" << precision << "\" Name=\"Coordinates\" NumberOfComponents=\"3\""
+       << " format=\"appended\" offset=\"40\"/>\n"
+       << "      </Points>\n"
+       << "    </Piece>\n"
+       << "  </UnstructuredGrid>\n"
+       << "  <AppendedData encoding=\"raw\">\n"
+       << "   _" << std::string("\0\x01<DataArray type=\"Int8\"/>\n\xff", 28) << "\n"
+       << "  </AppendedData>\n"
+       << "</VTKFile>\n";
+} // ... write_piece(...)
+
+/**
+ * \brief A piece with the given (binary) data arrays as appended raw data, as written by the serial VTKWriter.
+ */
+void write_raw_piece(const std::string& filename, const std::vector< std::string >& data_arrays)
+{
+  std::ofstream file(filename, std::ofstream::binary);
+  file << "<?xml version=\"1.0\"?>\n"
+       << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"LittleEndian\">\n"
+       << "  <UnstructuredGrid>\n"
+       << "    <Piece NumberOfCells=\"2\" NumberOfPoints=\"6\">\n"
+       << "      <PointData>\n";
+  size_t offset = 0;
+  for (size_t ii = 0; ii < data_arrays.size(); ++ii) {
+    file << "        <DataArray type=\"Int8\" Name=\"data_" << ii << "\" NumberOfComponents=\"1\" format=\"appended\""
+         << " offset=\"" << offset << "\"/>\n";
+    offset += sizeof(std::uint32_t) + data_arrays[ii].size();
+  }
+  file << "      </PointData>\n"
+       << "      <Points>\n"
+       << "        <DataArray type=\"Float32\" Name=\"Coordinates\" NumberOfComponents=\"3\" format=\"appended\""
+       << " offset=\"0\"/>\n"
+       << "      </Points>\n"
+       << "    </Piece>\n"
+       << "  </UnstructuredGrid>\n"
+       << "  <AppendedData encoding=\"raw\">\n"
+       << "   _";
+  for (const auto& data_array : data_arrays) {
+    const std::uint32_t size = std::uint32_t(data_array.size());
+    file.write(reinterpret_cast< const char* >(&size), sizeof(size));
+    file << data_array;
+  }
+  file << "\n"
+       << "  </AppendedData>\n"
+       << "</VTKFile>\n";
+} // ... write_raw_piece(...)
+
+std::string read(const std::string& filename)
+{
+  std::ifstream file(filename);
+  std::stringstream ss;
+  ss << file.rdbuf();
+  return ss.str();
+}
+
+
+TEST(VTUCollection, is_derived_from_the_pieces)
+{
+  write_piece("vtk_collection_test_0.vtu", "Float64", 1);
+  write_piece("vtk_collection_test_1.vtu", "Float64", 1);
+  LinearElliptic::internal::write_vtu_collection("vtk_collection_test", 2);
+  EXPECT_EQ("<?xml version=\"1.0\"?>\n"
+            "<VTKFile type=\"PUnstructuredGrid\" version=\"0.1\" byte_order=\"LittleEndian\">\n"
+            "  <PUnstructuredGrid GhostLevel=\"0\">\n"
+            "    <PPointData Scalars=\"solution\">\n"
+            "      <PDataArray type=\"Float64\" Name=\"solution\" NumberOfComponents=\"1\"/>\n"
+            "    </PPointData>\n"
+            "    <PCellData>\n"
+            "      <PDataArray type=\"Int32\" Name=\"subdomain\" NumberOfComponents=\"1\"/>\n"
+            "    </PCellData>\n"
+            "    <PPoints>\n"
+            "      <PDataArray type=\"Float64\" Name=\"Coordinates\" NumberOfComponents=\"3\"/>\n"
+            "    </PPoints>\n"
+            "    <Piece Source=\"vtk_collection_test_0.vtu\"/>\n"
+            "    <Piece Source=\"vtk_collection_test_1.vtu\"/>\n"
+            "  </PUnstructuredGrid>\n"
+            "</VTKFile>\n",
+            read("vtk_collection_test.pvtu"));
+  for (const std::string suffix : {"_0.vtu", "_1.vtu", ".pvtu"})
+    std::remove(("vtk_collection_test" + suffix).c_str());
+} // TEST(VTUCollection, is_derived_from_the_pieces)
+
+TEST(VTUCollection, rejects_mismatching_pieces)
+{
+  write_piece("vtk_collection_test_0.vtu", "Float32", 1);
+  write_piece("vtk_collection_test_1.vtu", "Float32", 3);
+  EXPECT_THROW(LinearElliptic::internal::write_vtu_collection("vtk_collection_test", 2), IOError);
+  EXPECT_THROW(LinearElliptic::internal::write_vtu_collection("vtk_collection_test_missing", 1), IOError);
+  for (const std::string suffix : {"_0.vtu", "_1.vtu"})
+    std::remove(("vtk_collection_test" + suffix).c_str());
+} // TEST(VTUCollection, rejects_mismatching_pieces)
+
+TEST(VTUCollection, writes_all_pieces)
+{
+  std::vector< size_t > written(4, 0);
+  LinearElliptic::internal::write_vtu_pieces("vtk_collection_test", 4, /*concurrent=*/true, 2,
+                                             [&](const size_t ii, const std::string& piece) {
+    ++written[ii];
+    write_raw_piece(piece + ".vtu", std::vector< std::string >(1, std::string(100 + ii, char(ii))));
+  });
+  EXPECT_EQ(std::vector< size_t >(4, 1), written);
+  const auto collection = read("vtk_collection_test.pvtu");
+  for (size_t ii = 0; ii < 4; ++ii)
+    EXPECT_NE(std::string::npos,
+              collection.find("<Piece Source=\"vtk_collection_test_" + Stuff::Common::toString(ii) + ".vtu\"/>"));
+  for (const std::string suffix : {"_0.vtu", "_1.vtu", "_2.vtu", "_3.vtu", ".pvtu"})
+    std::remove(("vtk_collection_test" + suffix).c_str());
+} // TEST(VTUCollection, writes_all_pieces)
+
+
+#if DUNE_HDD_HAVE_ZLIB
+
+
+TEST(VTUCollection, compresses_the_appended_data)
+{
+  // several blocks, a single (partial) block, an empty and a full block
+  std::vector< std::string > data_arrays(4);
+  for (size_t ii = 0; ii < 100000; ++ii)
+    data_arrays[0].push_back(char((ii*3) % 7));
+  data_arrays[1] = "abcdefgh";
+  data_arrays[3] = std::string(1024, 'x');
+  write_raw_piece("vtk_collection_test.vtu", data_arrays);
+  EXPECT_TRUE(LinearElliptic::internal::compress_vtu("vtk_collection_test.vtu", 1024));
+  EXPECT_FALSE(LinearElliptic::internal::compress_vtu("vtk_collection_test.vtu", 1024)); // <- already compressed
+  const auto content = read("vtk_collection_test.vtu");
+  std::remove("vtk_collection_test.vtu");
+  EXPECT_NE(std::string::npos, content.find("<VTKFile compressor=\"vtkZLibDataCompressor\""));
+  const size_t begin = content.find('_', content.find("<AppendedData")) + 1;
+  for (size_t ii = 0; ii < data_arrays.size(); ++ii) {
+    const auto name = content.find("Name=\"data_" + Stuff::Common::toString(ii) + "\"");
+    ASSERT_NE(std::string::npos, name);
+    size_t pos = begin + Stuff::Common::fromString< size_t >(content.substr(content.find("offset=\"", name) + 8));
+    std::uint32_t header[3];
+    std::memcpy(header, content.data() + pos, sizeof(header));
+    EXPECT_EQ(std::uint32_t(1024), header[1]);
+    std::vector< std::uint32_t > compressed_sizes(header[0]);
+    std::memcpy(compressed_sizes.data(), content.data() + pos + sizeof(header), header[0]*sizeof(std::uint32_t));
+    pos += sizeof(header) + header[0]*sizeof(std::uint32_t);
+    std::string data;
+    for (size_t bb = 0; bb < header[0]; ++bb) {
+      uLongf size = (bb + 1 == header[0] && header[2] > 0) ? header[2] : header[1];
+      std::string block(size, '\0');
+      ASSERT_EQ(Z_OK, uncompress(reinterpret_cast< Bytef* >(&block[0]), &size,
+                                 reinterpret_cast< const Bytef* >(content.data() + pos), compressed_sizes[bb]));
+      data += block.substr(0, size);
+      pos += compressed_sizes[bb];
+    }
+    EXPECT_EQ(data_arrays[ii], data) << "data array " << ii;
+  }
+  // the points share the offset of the first array
+  const auto points = content.find("Name=\"Coordinates\"");
+  EXPECT_EQ("0", content.substr(content.find("offset=\"", points) + 8, 1));
+  EXPECT_NE(std::string::npos, content.find("</AppendedData>\n</VTKFile>\n"));
+} // TEST(VTUCollection, compresses_the_appended_data)
+
+
+#else // DUNE_HDD_HAVE_ZLIB
+
+
+TEST(DISABLED_VTUCollection, compresses_the_appended_data) {}
+
+
+#endif // DUNE_HDD_HAVE_ZLIB
@@ -0,0 +1,127 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+// This one has to come first (includes the config.h)!
+#include <dune/stuff/test/main.hxx>
+
+#if DUNE_HDD_HAVE_HDF5
+
+# include <cstdio>
+# include <fstream>
+# include <sstream>
+# include <string>
+# include <vector>
+
+# include <hdf5.h>
+
+# include <dune/grid/yaspgrid.hh>
+
+# include <dune/stuff/functions/constant.hh>
+# include <dune/stuff/grid/provider/cube.hh>
+
+# include <dune/hdd/linearelliptic/xdmf.hh>
+
+using namespace Dune;
+using namespace HDD;
+
+
+typedef YaspGrid< 2 >                                                        GridType;
+typedef GridType::LeafGridView                                               GridViewType;
+typedef GridType::Codim< 0 >::Entity                                         E;
+typedef Stuff::Functions::Constant< E, double, 2, double, 1 >                ScalarFunctionType;
+typedef Stuff::Functions::Constant< E, double, 2, double, 2 >                VectorFunctionType;
+typedef LinearElliptic::XdmfWriter< GridViewType >                           WriterType;
+
+
+std::vector< double > read_dataset(const std::string& filename, const std::string& name)
+{
+  const hid_t file = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  EXPECT_GE(file, 0);
+  const hid_t dataset = H5Dopen2(file, name.c_str(), H5P_DEFAULT);
+  EXPECT_GE(dataset, 0) << name;
+  const hid_t space = H5Dget_space(dataset);
+  hsize_t dims[2] = {0, 0};
+  H5Sget_simple_extent_dims(space, dims, nullptr);
+  H5Sclose(space);
+  std::vector< double > values(dims[0]*dims[1]);
+  H5Dread(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, values.data());
+  H5Dclose(dataset);
+  H5Fclose(file);
+  return values;
+} // ... read_dataset(...)
+
+size_t count(const std::string& filename, const std::string& pattern)
+{
+  std::ifstream file(filename);
+  std::stringstream ss;
+  ss << file.rdbuf();
+  const std::string content = ss.str();
+  size_t ret = 0;
+  for (auto pos = content.find(pattern); pos != std::string::npos; pos = content.find(pattern, pos + 1))
+    ++ret;
+  return ret;
+}
+
+
+TEST(XdmfWriter, writes_and_appends_steps)
+{
+  auto grid_cfg = Stuff::Grid::Providers::Cube< GridType >::default_config();
+  grid_cfg["lower_left"] = "[0 0]";
+  grid_cfg["upper_right"] = "[1 1]";
+  grid_cfg["num_elements"] = "[3 2]";
+  const auto grid_provider = Stuff::Grid::Providers::Cube< GridType >::create(grid_cfg);
+  const auto grid_view = grid_provider->leaf_view();
+  const size_t num_points = 6*4;
+  const std::string filename = "xdmf_writer_test";
+  {
+    WriterType writer(grid_view, filename);
+    EXPECT_THROW(writer.add(ScalarFunctionType(1.), "no_step"), Stuff::Exceptions::you_are_using_this_wrong);
+    for (size_t ss = 0; ss < 2; ++ss) {
+      EXPECT_EQ(ss, writer.new_step(0.5*ss));
+      writer.add(ScalarFunctionType(ss + 1.), "scalar");
+    }
+    EXPECT_EQ(2u, writer.num_steps());
+  }
+  {
+    WriterType writer(grid_view, filename, /*append=*/true);
+    EXPECT_EQ(2u, writer.num_steps());
+    EXPECT_EQ(2u, writer.new_step(1.));
+    writer.add(ScalarFunctionType(3.), "scalar");
+    VectorFunctionType::RangeType vector_value;
+    vector_value[0] = 4.;
+    vector_value[1] = 5.;
+    writer.add(VectorFunctionType(vector_value), "vector");
+  }
+  EXPECT_EQ(3u, count(filename + ".xdmf", "<Grid Name=\"step_"));
+  EXPECT_EQ(4u, count(filename + ".xdmf", "<Attribute Name="));
+  for (size_t ss = 0; ss < 3; ++ss) {
+    const auto scalar = read_dataset(filename + ".h5", "/steps/" + DSC::toString(ss) + "/scalar");
+    ASSERT_EQ(num_points, scalar.size());
+    for (const auto& value : scalar)
+      EXPECT_DOUBLE_EQ(ss + 1., value);
+  }
+  const auto vector = read_dataset(filename + ".h5", "/steps/2/vector");
+  ASSERT_EQ(3*num_points, vector.size());
+  for (size_t pp = 0; pp < num_points; ++pp) {
+    EXPECT_DOUBLE_EQ(4., vector[3*pp]);
+    EXPECT_DOUBLE_EQ(5., vector[3*pp + 1]);
+    EXPECT_DOUBLE_EQ(0., vector[3*pp + 2]);
+  }
+  EXPECT_EQ(3*num_points, read_dataset(filename + ".h5", "/geometry/coordinates").size());
+  for (const std::string suffix : {".h5", ".xdmf"})
+    std::remove((filename + suffix).c_str());
+} // TEST(XdmfWriter, writes_and_appends_steps)
+
+
+#else // DUNE_HDD_HAVE_HDF5
+
+
+TEST(DISABLED_XdmfWriter, writes_and_appends_steps)
+{
+  std::cerr << "You are missing hdf5!" << std::endl;
+}
+
+
+#endif // DUNE_HDD_HAVE_HDF5
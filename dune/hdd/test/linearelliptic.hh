@@ -537,7 +537,7 @@ protected:
   size_t current_refinement_;
   size_t last_computed_refinement_;
   double time_to_solution_;
-  std::shared_ptr< NonparametricProblemType > nonparametric_problem_;
+  std::shared_ptr< const NonparametricProblemType > nonparametric_problem_;
   bool reference_solution_computed_;
   std::unique_ptr< DiscretizationType > current_discretization_;
   std::unique_ptr< VectorType > current_solution_vector_on_level_;
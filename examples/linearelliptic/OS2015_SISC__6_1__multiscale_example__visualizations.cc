@@ -29,6 +29,7 @@
 # include <dune/hdd/linearelliptic/testcases/OS2015.hh>
 # include <dune/hdd/linearelliptic/discretizations/block-swipdg.hh>
 # include <dune/hdd/linearelliptic/estimators/block-swipdg.hh>
+# include <dune/hdd/linearelliptic/xdmf.hh>
 
 using namespace Dune;
 using namespace Dune::Stuff;
@@ -167,6 +168,15 @@ int main(int argc, char** argv)
     logger.info() << "visualizing solutions ..." << std::endl;
     pressure_mu_min.visualize("pressure_mu_min");
     pressure_mu_max.visualize("pressure_mu_max");
+# if DUNE_HDD_HAVE_HDF5
+    // both solutions in one file, with the parameter as time, e.g. for ParaView
+    LinearElliptic::XdmfWriter< typename std::remove_reference< decltype(disc) >::type::GridViewType >
+        pressure_sweep(disc.grid_view(), "pressure_sweep");
+    pressure_sweep.new_step(mu_min.get("mu")[0]);
+    pressure_sweep.add(pressure_mu_min);
+    pressure_sweep.new_step(mu_max.get("mu")[0]);
+    pressure_sweep.add(pressure_mu_max);
+# endif
 
     logger.info() << "reconstructing diffusive fluxes ..." << std::endl;
     Spaces::RT::PdelabBased< typename std::remove_reference< decltype(disc) >::type::GridViewType, 0, double, 2 >
@@ -8,6 +8,11 @@
 
 #define DUNE_HDD_LINEARELLIPTIC_TESTCASES_BASE_DISABLE_WARNING
 
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <vector>
+
 #include <boost/numeric/conversion/cast.hpp>
 
 #if HAVE_DUNE_FEM
@@ -30,6 +35,7 @@
 
 #include <dune/hdd/linearelliptic/testcases/OS2015.hh>
 #include <dune/hdd/linearelliptic/discretizations/block-swipdg.hh>
+#include <dune/hdd/linearelliptic/enrichment.hh>
 #include <dune/hdd/linearelliptic/estimators/block-swipdg.hh>
 
 namespace internal {
@@ -73,6 +79,7 @@ public:
   typedef Dune::HDD::LinearElliptic::Discretizations::BlockSWIPDG< GridType, RangeFieldType, 1 > DiscretizationType;
   typedef typename DiscretizationType::VectorType VectorType;
   typedef typename TestCaseType::ParametersMapType ParametersMapType;
+  typedef Dune::HDD::LinearElliptic::LocalizedBasis< DiscretizationType > LocalizedBasisType;
 
 private:
   typedef Dune::HDD::LinearElliptic::Estimators::BlockSWIPDG< typename DiscretizationType::AnsatzSpaceType,
@@ -179,7 +186,7 @@ public:
     GDT::Operators::Projection< typename DiscretizationType::GridViewType > projection(discretization_.grid_view());
     projection.apply(func, discrete_function);
 
-    return discrete_function.vector();
+    return discretization_.from_space_numbering(discrete_function.vector());
   } // ... project(...)
 
   RangeFieldType compute_error(const VectorType& solution,
@@ -197,7 +204,8 @@ public:
     using namespace Dune;
     typedef typename DiscretizationType::AnsatzSpaceType AnsatzSpaceType;
     typedef GDT::ConstDiscreteFunction< AnsatzSpaceType, VectorType > ConstDiscreteFunctionType;
-    ConstDiscreteFunctionType coarse_solution(discretization_.ansatz_space(), solution);
+    const auto space_solution = discretization_.to_space_numbering(solution);
+    ConstDiscreteFunctionType coarse_solution(discretization_.ansatz_space(), space_solution);
     // prolong to reference grid view
     typedef GDT::DiscreteFunction< AnsatzSpaceType, VectorType > DiscreteFunctionType;
     DiscreteFunctionType fine_solution(reference_discretization_->ansatz_space());
@@ -224,8 +232,9 @@ public:
                  "There was an error in boost converting " << subdomain << " to "
                  << Stuff::Common::Typename< size_t >::value() << ": \n\n" << ee.what());
     }
+    const auto space_vector = discretization_.to_space_numbering(global_vector);
     const GDT::ConstDiscreteFunction< typename DiscretizationType::AnsatzSpaceType, VectorType >
-        global_function(discretization_.ansatz_space(), global_vector);
+        global_function(discretization_.ansatz_space(), space_vector);
     const auto oversampled_discretization = discretization_.get_oversampled_discretization(subdomain, "dirichlet");
     GDT::DiscreteFunction< typename DiscretizationType::OversampledDiscretizationType::AnsatzSpaceType, VectorType >
         oversampled_function(oversampled_discretization.ansatz_space());
@@ -246,15 +255,16 @@ public:
                  "There was an error in boost converting " << subdomain << " to "
                  << Stuff::Common::Typename< size_t >::value() << ": \n\n" << ee.what());
     }
+    const auto space_vector = discretization_.to_space_numbering(global_vector);
     const GDT::ConstDiscreteFunction< typename DiscretizationType::AnsatzSpaceType, VectorType >
-        global_function(discretization_.ansatz_space(), global_vector);
+        global_function(discretization_.ansatz_space(), space_vector);
     const auto local_discretization = discretization_.get_local_discretization(subdomain);
     GDT::DiscreteFunction< typename DiscretizationType::LocalDiscretizationType::AnsatzSpaceType, VectorType >
         local_function(local_discretization.ansatz_space());
     const GDT::Operators::Projection< typename DiscretizationType::LocalDiscretizationType::GridViewType >
         projection_operator(local_discretization.grid_view());
     projection_operator.apply(global_function, local_function);
-    return new VectorType(local_function.vector());
+    return new VectorType(local_discretization.from_space_numbering(local_function.vector()));
   } // ... pb_project_global_to_local(...)
 
   VectorType* pb_project_oversampled_to_local(const VectorType& oversampled_vector, const DUNE_STUFF_SSIZE_T subdomain) const
@@ -279,7 +289,7 @@ public:
     const GDT::Operators::Projection< typename DiscretizationType::LocalDiscretizationType::GridViewType >
         projection_operator(local_space.grid_view());
     projection_operator.apply(oversampled_function, local_function);
-    return new VectorType(local_function.vector());
+    return new VectorType(local_discretization.from_space_numbering(local_function.vector()));
   } // ... pb_project_oversampled_to_local(...)
 
   std::vector< std::string > available_estimators() const
@@ -287,20 +297,24 @@ public:
     return Estimator::available();
   }
 
+  /**
+   * \note Subsequent calls for the same vector and parameters share all intermediate quantities (see
+   *       Estimators::BlockSWIPDG::SessionType), if the session supports the problem and the type. Otherwise the
+   *       estimator is called directly.
+   */
   RangeFieldType estimate(const VectorType& vector,
                           const std::string type,
                           const Dune::Pymor::Parameter mu_hat = Dune::Pymor::Parameter(),
                           const Dune::Pymor::Parameter mu_bar = Dune::Pymor::Parameter(),
                           const Dune::Pymor::Parameter mu     = Dune::Pymor::Parameter())
   {
-    return Estimator::estimate(discretization_.ansatz_space(),
-                               vector,
-                               discretization_.problem(),
-                               type,
-                               merge_parameters({{"mu_hat", mu_hat},
-                                                 {"mu_bar", mu_bar},
-                                                 {"mu",     mu}},
-                                                parameter_range_));
+    const auto parameters = merge_parameters({{"mu_hat", mu_hat}, {"mu_bar", mu_bar}, {"mu", mu}}, parameter_range_);
+    // the estimators expect the numbering of the space, see DiscretizationType::renumber()
+    const auto space_vector = discretization_.to_space_numbering(vector);
+    if (session_handles(type, Estimator::SessionType::available_types()))
+      return estimator_session(space_vector, parameters).estimate(type);
+    return Estimator::estimate(discretization_.ansatz_space(), space_vector, discretization_.problem(), type,
+                               parameters);
   } // ... estimate(...)
 
   std::vector< std::string > available_local_estimators() const
@@ -314,14 +328,19 @@ public:
                                                const Dune::Pymor::Parameter mu_bar = Dune::Pymor::Parameter(),
                                                const Dune::Pymor::Parameter mu     = Dune::Pymor::Parameter())
   {
-    return Estimator::estimate_local(discretization_.ansatz_space(),
-                                     vector,
-                                     discretization_.problem(),
-                                     type,
-                                     merge_parameters({{"mu_hat", mu_hat},
-                                                       {"mu_bar", mu_bar},
-                                                       {"mu",     mu}},
-                                                      parameter_range_));
+    const auto parameters = merge_parameters({{"mu_hat", mu_hat}, {"mu_bar", mu_bar}, {"mu", mu}}, parameter_range_);
+    const auto space_vector = discretization_.to_space_numbering(vector);
+    const auto indicators = session_handles(type, Estimator::SessionType::available_local_types())
+                            ? estimator_session(space_vector, parameters).estimate_local(type)
+                            : Estimator::estimate_local(discretization_.ansatz_space(),
+                                                        space_vector,
+                                                        discretization_.problem(),
+                                                        type,
+                                                        parameters);
+    std::vector< RangeFieldType > ret(indicators.size());
+    for (size_t ii = 0; ii < indicators.size(); ++ii)
+      ret[ii] = indicators[ii];
+    return ret;
   } // ... estimate_local(...)
 
   VectorType solve_for_local_correction(const std::vector< VectorType >& local_vectors,
@@ -345,32 +364,120 @@ public:
       boundary_cfg = Stuff::Grid::BoundaryInfoConfigs::AllNeumann::default_config();
     else
       DUNE_THROW(Stuff::Exceptions::wrong_input_given, "Unknown boundary_value_type given: " << boundary_value_type);
-    // we need this one temporarily for the space
-    const auto tmp_oversampled_discretization = discretization_.get_oversampled_discretization(boost::numeric_cast< size_t >(subdomain),
-                                                                                               boundary_value_type);
-    const auto oversampled_space = tmp_oversampled_discretization.ansatz_space();
     typedef typename DiscretizationType::OversampledDiscretizationType OversampledDiscretizationType;
     typedef typename HDD::LinearElliptic::Problems::ConvertToDefault< typename TestCaseType::ProblemType >::Type
                                                                        OversampledProblemType;
     typedef typename OversampledDiscretizationType::AnsatzSpaceType    OversampledAnsatzSpaceType;
-    auto bv_function = std::make_shared< GDT::ConstDiscreteFunction< OversampledAnsatzSpaceType, VectorType > >(
-          oversampled_space, boundary_values, "boundary_values");
-    auto nonparametric_problem = test_case_.problem().with_mu(mu);
-    const OversampledProblemType oversampled_problem(nonparametric_problem->diffusion_factor()->affine_part(),
-                                                     nonparametric_problem->diffusion_tensor()->affine_part(),
-                                                     nonparametric_problem->force()->affine_part(),
-                                                     bv_function,
-                                                     bv_function);
-    OversampledDiscretizationType discretization(*test_case_.reference_provider(),
-                                                 boundary_cfg,
-                                                 oversampled_problem,
-                                                 boost::numeric_cast< int >(subdomain));
-    discretization.init();
-    VectorType solution = discretization.create_vector();
-    discretization.solve(solution);
+    std::unique_ptr< OversampledProblemType > oversampled_problem;
+    std::unique_ptr< OversampledDiscretizationType > discretization;
+    {
+      // neither the creation of spaces (and the lazy creation of the oversampled discretizations) nor the assembly by
+      // GDT and dune-fem is thread safe, only the solution below is (see enrich())
+      std::lock_guard< std::mutex > lock(assembly_mutex_);
+      // we need this one temporarily for the space
+      const auto tmp_oversampled_discretization
+          = discretization_.get_oversampled_discretization(boost::numeric_cast< size_t >(subdomain),
+                                                           boundary_value_type);
+      const auto oversampled_space = tmp_oversampled_discretization.ansatz_space();
+      auto bv_function = std::make_shared< GDT::ConstDiscreteFunction< OversampledAnsatzSpaceType, VectorType > >(
+            oversampled_space, boundary_values, "boundary_values");
+      auto nonparametric_problem = test_case_.problem().with_mu(mu);
+      oversampled_problem = DSC::make_unique< OversampledProblemType >(
+            nonparametric_problem->diffusion_factor()->affine_part(),
+            nonparametric_problem->diffusion_tensor()->affine_part(),
+            nonparametric_problem->force()->affine_part(),
+            bv_function,
+            bv_function);
+      discretization = DSC::make_unique< OversampledDiscretizationType >(*test_case_.reference_provider(),
+                                                                         boundary_cfg,
+                                                                         *oversampled_problem,
+                                                                         boost::numeric_cast< int >(subdomain));
+      discretization->init();
+    }
+    VectorType solution = discretization->create_vector();
+    discretization->solve(solution);
     return solution;
   } // ... solve_oversampled(...)
 
+  /**
+   * \brief Empty local bases (orthonormal w.r.t. the given local product), to be filled by enrich().
+   */
+  LocalizedBasisType* create_localized_basis(const std::string product = "",
+                                             const Dune::Pymor::Parameter mu_product = Dune::Pymor::Parameter()) const
+  {
+    return new LocalizedBasisType(discretization_, product, mu_product);
+  }
+
+  /**
+   * \brief One sweep of online enrichment (see OS2015, Sect. 4.3).
+   *
+   *        For each marked subdomain, the oversampled problem with boundary values given by global_vector is solved
+   *        (as in solve_oversampled()) and the solution is restricted to the subdomain. Only these oversampled solves
+   *        run concurrently on num_threads threads (0 meaning as many as the hardware supports), with their assembly
+   *        serialized, since GDT and dune-fem are not thread safe. The restrictions to the subdomains (which use the
+   *        lazily created local and oversampled discretizations and GDT projections) are then computed serially. The
+   *        local solutions are finally orthonormalized and appended to the local bases, the reduced blocks of which
+   *        are updated incrementally (see LocalizedBasisType::extend(), which only uses already assembled matrices).
+   * \return The number of basis vectors added to each subdomain.
+   */
+  std::vector< size_t > enrich(LocalizedBasisType& localized_basis,
+                               const VectorType& global_vector,
+                               const std::vector< DUNE_STUFF_SSIZE_T >& marked_subdomains,
+                               const std::string& boundary_value_type,
+                               const Dune::Pymor::Parameter mu = Dune::Pymor::Parameter(),
+                               const DUNE_STUFF_SSIZE_T num_threads = 0) const
+  {
+    auto logger = DSC::TimedLogger().get("OS2015.example.enrich");
+    // the projections use the (lazily created) oversampled discretizations, so we prepare them serially
+    std::vector< size_t > subdomains;
+    std::map< size_t, VectorType > boundary_values;
+    for (const auto& subdomain : marked_subdomains) {
+      const size_t ss = boost::numeric_cast< size_t >(subdomain);
+      if (boundary_values.count(ss) > 0)
+        continue;
+      subdomains.push_back(ss);
+      std::unique_ptr< VectorType > oversampled_vector(pb_project_global_to_oversampled(global_vector, subdomain));
+      boundary_values.insert(std::make_pair(ss, *oversampled_vector));
+      discretization_.get_oversampled_discretization(ss, boundary_value_type);
+    }
+    logger.info() << "solving on " << subdomains.size() << " oversampled subdomains... " << std::endl;
+    // each thread only writes the (already present) entry of its subdomain
+    std::map< size_t, std::unique_ptr< VectorType > > oversampled_solutions;
+    for (const auto& ss : subdomains)
+      oversampled_solutions[ss] = nullptr;
+    Dune::HDD::LinearElliptic::internal::parallel_for_each(
+          subdomains,
+          boost::numeric_cast< size_t >(num_threads),
+          [&](const size_t& ss) {
+            oversampled_solutions.at(ss) = DSC::make_unique< VectorType >(
+                  solve_oversampled(ss, boundary_value_type, boundary_values.at(ss), mu));
+          });
+    logger.info() << "restricting to the subdomains... " << std::endl;
+    std::map< size_t, std::vector< VectorType > > local_solutions;
+    for (const auto& ss : subdomains) {
+      std::unique_ptr< VectorType > local_solution(pb_project_oversampled_to_local(*oversampled_solutions.at(ss),
+                                                                                   ss));
+      local_solutions[ss].push_back(*local_solution);
+      oversampled_solutions.at(ss).reset();
+    }
+    logger.info() << "extending local bases... " << std::endl;
+    return localized_basis.extend(local_solutions, boost::numeric_cast< size_t >(num_threads));
+  } // ... enrich(...)
+
+  std::vector< DUNE_STUFF_SSIZE_T > pb_enrich(LocalizedBasisType& localized_basis,
+                                              const VectorType& global_vector,
+                                              const std::vector< DUNE_STUFF_SSIZE_T >& marked_subdomains,
+                                              const std::string& boundary_value_type,
+                                              const Dune::Pymor::Parameter mu,
+                                              const DUNE_STUFF_SSIZE_T num_threads) const
+  {
+    const auto added = enrich(localized_basis, global_vector, marked_subdomains, boundary_value_type, mu, num_threads);
+    std::vector< DUNE_STUFF_SSIZE_T > ret;
+    for (const auto& num : added)
+      ret.push_back(boost::numeric_cast< DUNE_STUFF_SSIZE_T >(num));
+    return ret;
+  } // ... pb_enrich(...)
+
   void visualize_on_coarse_grid(const std::vector< double >& vector,
                                 const std::string& filename,
                                 const std::string& name)
@@ -406,6 +513,24 @@ public:
   }
 
 private:
+  bool session_handles(const std::string& type, const std::vector< std::string >& session_types) const
+  {
+    return Estimator::SessionType::available
+        && Estimator::SessionType::handles(discretization_.problem())
+        && std::find(session_types.begin(), session_types.end(), type) != session_types.end();
+  }
+
+  //! \param vector in the numbering of the space
+  typename Estimator::SessionType& estimator_session(const VectorType& vector, const ParametersMapType& parameters)
+  {
+    if (!estimator_session_ || !estimator_session_->matches(vector, parameters))
+      estimator_session_ = DSC::make_unique< typename Estimator::SessionType >(discretization_.ansatz_space(),
+                                                                               vector,
+                                                                               discretization_.problem(),
+                                                                               parameters);
+    return *estimator_session_;
+  } // ... estimator_session(...)
+
   static ParametersMapType merge_parameters(const ParametersMapType& first,
                                             const ParametersMapType& second)
   {
@@ -421,6 +546,8 @@ private:
   std::unique_ptr< TestCaseType > reference_test_case_;
   DiscretizationType discretization_;
   std::unique_ptr< DiscretizationType > reference_discretization_;
+  std::unique_ptr< typename Estimator::SessionType > estimator_session_;
+  mutable std::mutex assembly_mutex_;
 }; // class Example
 
 
@@ -83,6 +83,31 @@ def inject_Example(module, exceptions, interfaces, CONFIG_H):
                     'OversampledDiscretizationType': OversampledDiscretizationFullName},
             template_parameters=[GridType, RangeFieldType,
                                  dimRange, polOrder, la_backend])
+    # the localized reduced bases for online enrichment
+    ReducedVectorType = 'Dune::Stuff::LA::CommonDenseVector< ' + RangeFieldType + ' >'
+    ReducedMatrixType = 'Dune::Stuff::LA::CommonDenseMatrix< ' + RangeFieldType + ' >'
+    LocalizedBasisFullName = 'Dune::HDD::LinearElliptic::LocalizedBasis< ' + DiscretizationFullName + ' >'
+    LocalizedBasis = (module.add_cpp_namespace('Dune').add_cpp_namespace('HDD').add_cpp_namespace('LinearElliptic')
+                      .add_class('LocalizedBasis', template_parameters=[DiscretizationFullName],
+                                 custom_name='LocalizedBasis'))
+    LocalizedBasis.add_method('num_subdomains', retval('size_t'), [], is_const=True, throw=exceptions)
+    LocalizedBasis.add_method('size', retval('size_t'), [], is_const=True, throw=exceptions)
+    LocalizedBasis.add_method('reduced_operator',
+                              retval(ReducedMatrixType),
+                              [param('const Dune::Pymor::Parameter', 'mu')],
+                              is_const=True, throw=exceptions)
+    LocalizedBasis.add_method('reduced_functional',
+                              retval(ReducedVectorType),
+                              [param('const Dune::Pymor::Parameter', 'mu')],
+                              is_const=True, throw=exceptions)
+    LocalizedBasis.add_method('solve',
+                              retval(ReducedVectorType),
+                              [param('const Dune::Pymor::Parameter', 'mu')],
+                              is_const=True, throw=exceptions)
+    LocalizedBasis.add_method('reconstruct',
+                              retval(VectorType),
+                              [param('const ' + ReducedVectorType + '&', 'coefficients')],
+                              is_const=True, throw=exceptions)
     # then add the example
     def add_example(name):
         Example = module.add_class(name, template_parameters=[GridType], custom_name=name)
@@ -286,6 +311,25 @@ def inject_Example(module, exceptions, interfaces, CONFIG_H):
                             param('const std::string&', 'boundary_value_type'),
                             param('const ' + VectorType + '&', 'boundary_value_type')],
                            is_const=True, throw=exceptions)
+        Example.add_method('create_localized_basis',
+                           retval(LocalizedBasisFullName + ' *', caller_owns_return=True),
+                           [param('const std::string', 'product'),
+                            param('const Dune::Pymor::Parameter', 'mu_product')],
+                           is_const=True, throw=exceptions)
+        Example.add_method('create_localized_basis',
+                           retval(LocalizedBasisFullName + ' *', caller_owns_return=True),
+                           [param('const std::string', 'product')],
+                           is_const=True, throw=exceptions)
+        Example.add_method('pb_enrich',
+                           retval('std::vector< ' + ssize_t + ' >'),
+                           [param(LocalizedBasisFullName + '&', 'localized_basis'),
+                            param('const ' + VectorType + '&', 'global_vector'),
+                            param('const std::vector< ' + ssize_t + ' >&', 'marked_subdomains'),
+                            param('const std::string&', 'boundary_value_type'),
+                            param('const Dune::Pymor::Parameter', 'mu'),
+                            param('const ' + ssize_t, 'num_threads')],
+                           is_const=True, throw=exceptions,
+                           custom_name='enrich')
         Example.add_method('visualize_on_coarse_grid',
                            None,
                            [param('const std::vector< double >&', 'vector'),
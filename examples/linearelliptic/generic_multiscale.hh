@@ -19,6 +19,8 @@
 #include <dune/gdt/spaces/interface.hh>
 
 #include <dune/hdd/linearelliptic/discretizations/block-swipdg.hh>
+#include <dune/hdd/linearelliptic/estimators/diffusion-bounds.hh>
+#include <dune/hdd/linearelliptic/partitioning.hh>
 #include <dune/hdd/linearelliptic/problems.hh>
 
 
@@ -37,9 +39,15 @@ public:
 private:
   typedef typename DiscretizationType::MatrixType                                        MatrixType;
   typedef Dune::grid::Multiscale::MsGridProviders< GridType >                            GridProvider;
+  typedef Dune::HDD::LinearElliptic::GraphPartitionedMsGridProvider< GridType >          GraphPartitionedGridProvider;
   typedef Dune::Stuff::Grid::BoundaryInfoProvider< typename GridType::LeafIntersection > BoundaryProvider;
   typedef Dune::HDD::LinearElliptic::ProblemsProvider< E, D, d, R, r >                   ProblemProvider;
+  typedef Dune::HDD::LinearElliptic::Problems::Cached< typename GridType::LeafGridView, E, D, d, R, r >
+      CachedProblemType;
   typedef Dune::Stuff::LA::Solver< MatrixType >                                          SolverProvider;
+  typedef Dune::HDD::LinearElliptic::Estimators::DiffusionBounds
+      < typename DiscretizationType::AnsatzSpaceType::GridViewType
+      , Dune::HDD::LinearElliptic::ProblemInterface< E, D, d, R, r > >                   DiffusionBoundsType;
 public:
   static Dune::Stuff::Common::Configuration logger_options();
 
@@ -106,6 +114,8 @@ public:
   double domain_diameter() const;
 
 private:
+  std::shared_ptr< const DiffusionBoundsType > diffusion_bounds() const;
+
   const Dune::Stuff::Common::Configuration boundary_cfg_;
   std::unique_ptr< Dune::grid::Multiscale::ProviderInterface< GridType > > grid_;
   std::unique_ptr< Dune::HDD::LinearElliptic::ProblemInterface< E, D, d, R, r > > problem_;
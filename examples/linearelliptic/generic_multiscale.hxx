@@ -30,13 +30,17 @@ template< class G, Dune::GDT::ChooseSpaceBackend sp, Dune::Stuff::LA::ChooseBack
     std::vector< std::string > GenericLinearellipticMultiscaleExample< G, sp, la >::
 grid_options()
 {
-  return GridProvider::available();
+  auto ret = GridProvider::available();
+  ret.push_back(GraphPartitionedGridProvider::static_id());
+  return ret;
 }
 
 template< class G, Dune::GDT::ChooseSpaceBackend sp, Dune::Stuff::LA::ChooseBackend la >
     Dune::Stuff::Common::Configuration GenericLinearellipticMultiscaleExample< G, sp, la >::
 grid_options(const std::string& type)
 {
+  if (type == GraphPartitionedGridProvider::static_id())
+    return GraphPartitionedGridProvider::default_config();
   return GridProvider::default_config(type);
 }
 
@@ -111,11 +115,20 @@ GenericLinearellipticMultiscaleExample(const Dune::Stuff::Common::Configuration&
   } catch (Dune::Stuff::Exceptions::you_are_using_this_wrong&) {}
   auto logger = DSC::TimedLogger().get("example.linearelliptic.genericmultiscale");
   logger.info() << "creating grid (" << grid_cfg.get< std::string >("type") << "):" << std::endl;
-  grid_ = GridProvider::create(grid_cfg.get< std::string >("type"), grid_cfg);
+  if (grid_cfg.get< std::string >("type") == GraphPartitionedGridProvider::static_id())
+    grid_ = GraphPartitionedGridProvider::create(grid_cfg);
+  else
+    grid_ = GridProvider::create(grid_cfg.get< std::string >("type"), grid_cfg);
   logger.info() << "  done (has " << grid_->grid().size(0) << " elements)" << std::endl;
 
   logger.info() << "creating problem (" << problem_cfg.get< std::string >("type") << ")... " << std::endl;
   problem_= ProblemProvider::create(problem_cfg.get< std::string >("type"), problem_cfg);
+  if (problem_cfg.get("cache_coefficients", false)) {
+    // the local, coupling and boundary operators, the products and the estimators evaluate the data functions at the
+    // same quadrature points, share these evaluations
+    logger.info() << "  caching its values at the quadrature points" << std::endl;
+    problem_ = DSC::make_unique< CachedProblemType >(*problem_, grid_->grid().leafGridView());
+  }
 
   logger.info() << "creating discretization:" << std::endl;
   discretization_ = DSC::make_unique< DiscretizationType >(*grid_,
@@ -154,7 +167,7 @@ project(const std::string& expression) const
   logger.info() << "projecting '" << expression << "'... " << std::endl;
   auto discrete_function = GDT::make_discrete_function< VectorType >(discretization_->ansatz_space());
   GDT::project(Stuff::Functions::Expression< E, D, d, R, r >("x", expression), discrete_function);
-  return discrete_function.vector();
+  return discretization_->from_space_numbering(discrete_function.vector());
 } // ... project(...)
 
 template< class G, Dune::GDT::ChooseSpaceBackend sp, Dune::Stuff::LA::ChooseBackend la >
@@ -164,7 +177,9 @@ prolong(const typename GenericLinearellipticMultiscaleExample< G, sp, la >::Disc
 {
   using namespace Dune;
   auto logger = DSC::TimedLogger().get("example.linearelliptic.genericmultiscale.prolong");
-  auto source_func = GDT::make_const_discrete_function(source_disc.ansatz_space(), source_vec);
+  // the discrete functions expect the numbering of the spaces, see DiscretizationType::renumber()
+  const auto source_space_vec = source_disc.to_space_numbering(source_vec);
+  auto source_func = GDT::make_const_discrete_function(source_disc.ansatz_space(), source_space_vec);
   auto range_func = GDT::make_discrete_function< VectorType >(discretization_->ansatz_space());
   if (source_vec.size() >= range_func.vector().size())
     logger.warn() << "prolonging from space of size " << source_vec.size() << " onto space of size "
@@ -173,7 +188,7 @@ prolong(const typename GenericLinearellipticMultiscaleExample< G, sp, la >::Disc
     logger.info() << "prolonging from space of size " << source_vec.size() << " onto space of size "
                   << range_func.vector().size() << "... " << std::endl;
   GDT::Operators::prolong(source_func, range_func);
-  return range_func.vector();
+  return discretization_->from_space_numbering(range_func.vector());
 } // ... project(...)
 
 
@@ -184,10 +199,11 @@ oswald_interpolate(const GenericLinearellipticMultiscaleExample< G, sp, la >::Ve
   using namespace Dune;
   auto logger = DSC::TimedLogger().get("example.linearelliptic.genericmultiscale.prolong");
   logger.info() << "computing Oswald interpolation... " << std::endl;
-  auto discontinuous_func = GDT::make_const_discrete_function(discretization_->ansatz_space(), vector);
+  const auto space_vector = discretization_->to_space_numbering(vector);
+  auto discontinuous_func = GDT::make_const_discrete_function(discretization_->ansatz_space(), space_vector);
   auto continuous_func = GDT::make_discrete_function< VectorType >(discretization_->ansatz_space());
   GDT::Operators::make_oswald_interpolation(discretization_->grid_view())->apply(discontinuous_func, continuous_func);
-  return continuous_func.vector();
+  return discretization_->from_space_numbering(continuous_func.vector());
 }
 
 
@@ -212,6 +228,8 @@ template< class G, Dune::GDT::ChooseSpaceBackend sp, Dune::Stuff::LA::ChooseBack
 min_diffusion_ev(const Dune::Pymor::Parameter& mu) const
 {
   using namespace Dune;
+  if (!problem_->diffusion_tensor()->parametric())
+    return diffusion_bounds()->min_diffusion_ev(problem_->map_parameter(mu, "diffusion_factor"));
   auto diffusion_factor = problem_->diffusion_factor()->with_mu(problem_->map_parameter(mu, "diffusion_factor"));
   auto diffusion_tensor = problem_->diffusion_tensor()->with_mu(problem_->map_parameter(mu, "diffusion_tensor"));
   const auto diffusion = *diffusion_factor * *diffusion_tensor;
@@ -230,6 +248,8 @@ template< class G, Dune::GDT::ChooseSpaceBackend sp, Dune::Stuff::LA::ChooseBack
 max_diffusion_ev(const Dune::Pymor::Parameter& mu) const
 {
   using namespace Dune;
+  if (!problem_->diffusion_tensor()->parametric())
+    return diffusion_bounds()->max_diffusion_ev(problem_->map_parameter(mu, "diffusion_factor"));
   auto diffusion_factor = problem_->diffusion_factor()->with_mu(problem_->map_parameter(mu, "diffusion_factor"));
   auto diffusion_tensor = problem_->diffusion_tensor()->with_mu(problem_->map_parameter(mu, "diffusion_tensor"));
   const auto diffusion = *diffusion_factor * *diffusion_tensor;
@@ -243,6 +263,15 @@ max_diffusion_ev(const Dune::Pymor::Parameter& mu) const
 }
 
 
+template< class G, Dune::GDT::ChooseSpaceBackend sp, Dune::Stuff::LA::ChooseBackend la >
+    std::shared_ptr< const typename GenericLinearellipticMultiscaleExample< G, sp, la >::DiffusionBoundsType >
+    GenericLinearellipticMultiscaleExample< G, sp, la >::
+diffusion_bounds() const
+{
+  return DiffusionBoundsType::get(discretization_->grid_view(), *problem_, discretization_->ansatz_space().ms_grid());
+}
+
+
 template< class G, Dune::GDT::ChooseSpaceBackend sp, Dune::Stuff::LA::ChooseBackend la >
     double GenericLinearellipticMultiscaleExample< G, sp, la >::
 elliptic_reconstruction_estimate(const GenericLinearellipticMultiscaleExample< G, sp, la >::VectorType& p_h,
@@ -260,7 +289,7 @@ elliptic_reconstruction_estimate(const GenericLinearellipticMultiscaleExample< G
   auto f_h = GDT::make_discrete_function< VectorType >(discretization_->ansatz_space(), "f_h");
   GDT::project(*f, f_h);
   if (do_visualize) {
-    GDT::make_const_discrete_function(discretization_->ansatz_space(), p_h, "p_h").visualize(visualize + ".p_h");
+    discretization_->visualize(p_h, visualize + ".p_h", "p_h", false);
     f->visualize(grid_view, visualize + ".f");
     f_h.visualize(visualize + ".f_h");
     (*f - f_h).visualize(grid_view, visualize + ".f_minus_f_h");
@@ -270,10 +299,11 @@ elliptic_reconstruction_estimate(const GenericLinearellipticMultiscaleExample< G
   const auto b_times_p = b_h.apply(p_h, mu);
   auto w_h = l2_prod.apply_inverse(b_times_p);
   if (do_visualize) {
-    GDT::make_const_discrete_function(discretization_->ansatz_space(), b_times_p, "b_h * p_h").visualize(visualize + ".b_h_times_p_h");
-    GDT::make_const_discrete_function(discretization_->ansatz_space(), w_h, "w_h").visualize(visualize + ".w_h");
+    discretization_->visualize(b_times_p, visualize + ".b_h_times_p_h", "b_h * p_h", false);
+    discretization_->visualize(w_h, visualize + ".w_h", "w_h", false);
   }
-  return elliptic_reconstruction_estimate(p_h, w_h, f_h.vector(), mu_min, mu_max, mu_hat, mu_bar, mu, visualize);
+  return elliptic_reconstruction_estimate(p_h, w_h, discretization_->from_space_numbering(f_h.vector()),
+                                          mu_min, mu_max, mu_hat, mu_bar, mu, visualize);
 }
 
 
@@ -293,7 +323,8 @@ elliptic_reconstruction_estimate(const GenericLinearellipticMultiscaleExample< G
   const bool do_visualize = !visualize.empty();
   const auto& grid_view = discretization_->grid_view();
   const auto f = problem_->force()->with_mu(problem_->map_parameter(mu, "force"));
-  const auto tmp_vec = w_h - f_h;
+  // the discrete functions and the estimator expect the numbering of the space, see DiscretizationType::renumber()
+  const auto tmp_vec = discretization_->to_space_numbering(w_h - f_h);
   const auto w_h_func = GDT::make_const_discrete_function(discretization_->ansatz_space(), tmp_vec);
   const auto rhs = std::make_shared< typename decltype(w_h_func)::SumType >(w_h_func, *f, "tmp_rhs");
   if (do_visualize) {
@@ -314,7 +345,8 @@ elliptic_reconstruction_estimate(const GenericLinearellipticMultiscaleExample< G
                                                         VectorType,
                                                         decltype(tmp_problem),
                                                         GridType > Estimator;
-  return Estimator::estimate(discretization_->ansatz_space(), p_h, tmp_problem, "eta_OS2014_*",
+  return Estimator::estimate(discretization_->ansatz_space(), discretization_->to_space_numbering(p_h), tmp_problem,
+                             "eta_OS2014_*",
                              {{"parameter_range_min", mu_min},
                               {"parameter_range_max", mu_max},
                               {"mu_hat", mu_hat},
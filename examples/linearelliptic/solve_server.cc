@@ -0,0 +1,82 @@
+// This file is part of the dune-hdd project:
+//   http://users.dune-project.org/projects/dune-hdd
+// Copyright holders: Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+// Serves one discretization of the generic example over a Unix domain socket, see
+// dune/hdd/linearelliptic/server.hh. Usage:
+//
+//   example_linearelliptic_solve_server SOCKET [key=value ...]
+//
+// where the keys are those of the grid, boundary and problem configurations (prefixed by 'grid.', 'boundary.' and
+// 'problem.'), e.g.
+//
+//   example_linearelliptic_solve_server /tmp/hdd.socket grid.num_elements=[64 64] problem.type=...
+
+#include "config.h"
+
+#include <string>
+
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/stuff/common/configuration.hh>
+#include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/grid/boundaryinfo.hh>
+#include <dune/stuff/grid/provider/cube.hh>
+
+#include <dune/hdd/linearelliptic/problems/default.hh>
+#include <dune/hdd/linearelliptic/server.hh>
+
+#include "generic.hh"
+
+using namespace Dune;
+
+
+int main(int argc, char** argv)
+{
+  try {
+    if (argc < 2) {
+      std::cerr << "usage: " << argv[0] << " SOCKET [key=value ...]" << std::endl;
+      return 1;
+    }
+    typedef YaspGrid< 2 > GridType;
+    typedef GenericLinearellipticExample< GridType,
+                                          GDT::ChooseSpaceBackend::pdelab,
+                                          Stuff::LA::ChooseBackend::istl_sparse > ExampleType;
+    typedef HDD::LinearElliptic::Problems::Default< GridType::Codim< 0 >::Entity, double, 2, double, 1 > ProblemType;
+    auto grid_cfg = ExampleType::grid_options(Stuff::Grid::Providers::Cube< GridType >::static_id());
+    auto boundary_cfg = ExampleType::boundary_options(Stuff::Grid::BoundaryInfoConfigs::AllDirichlet::static_id());
+    auto problem_cfg = ExampleType::problem_options(ProblemType::static_id());
+    for (int ii = 2; ii < argc; ++ii) {
+      const std::string argument(argv[ii]);
+      const auto separator = argument.find('=');
+      if (separator == std::string::npos)
+        DUNE_THROW(Stuff::Exceptions::wrong_input_given, "Arguments have to be of the form key=value, is '"
+                   << argument << "'!");
+      const std::string key = argument.substr(0, separator);
+      const std::string value = argument.substr(separator + 1);
+      if (key.compare(0, 5, "grid.") == 0)
+        grid_cfg.set(key.substr(5), value, /*overwrite=*/true);
+      else if (key.compare(0, 9, "boundary.") == 0)
+        boundary_cfg.set(key.substr(9), value, /*overwrite=*/true);
+      else if (key.compare(0, 8, "problem.") == 0)
+        problem_cfg.set(key.substr(8), value, /*overwrite=*/true);
+      else
+        DUNE_THROW(Stuff::Exceptions::wrong_input_given, "Unknown key '" << key << "'!");
+    }
+    ExampleType example(ExampleType::logger_options(), grid_cfg, boundary_cfg, problem_cfg);
+    HDD::LinearElliptic::SolveServer< ExampleType::DiscretizationType > server(example.discretization(), argv[1]);
+    server.run();
+
+    return EXIT_SUCCESS;
+  } catch (Dune::Exception& e) {
+    std::cerr << "\n" << e.what() << std::endl;
+    std::abort();
+  } catch (std::exception& e) {
+    std::cerr << "\n" << e.what() << std::endl;
+    std::abort();
+  } catch (...) {
+    std::cerr << "\nUnknown exception thrown!" << std::endl;
+    std::abort();
+  } // try
+} // ... main(...)